@@ -0,0 +1,355 @@
+/******************************************************************************
+* File Name:   button_capture.c
+*
+* Description: Interrupt-driven capture of user button presses. The GPIO interrupt
+*              queues every edge with its MCWDT_0 time base value and the
+*              debounce runs in the background against those timestamps.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "button_capture.h"
+#include "mcwdt_timebase.h"
+#include "timing_engine.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Edges timestamped by the interrupt; the event is the pin level after the
+ * edge */
+static timestamp_ring_t edge_ring;
+
+/* Debounce state, used from the main loop only */
+static timing_capture_t capture;
+
+#if (BUTTON_CAPTURE_EVENTS)
+/* Classifier of the debounced presses and releases, fed from the main loop */
+static button_events_t events;
+
+static const button_events_config_t events_config =
+{
+    .long_ticks = BUTTON_EVENTS_LONG_TICKS,
+    .repeat_ticks = BUTTON_EVENTS_REPEAT_TICKS,
+    .click_gap_ticks = BUTTON_EVENTS_CLICK_GAP_TICKS
+};
+#endif
+
+
+/*******************************************************************************
+* Function Name: button_capture_report
+********************************************************************************
+* Summary:
+*  Hands a settled press or release to the classifier, if enabled.
+*
+* Parameters:
+*  event: what the capture settled
+*  settled: time of its edge
+*  timestamp: receives the time of the press edge if it is a press
+*
+* Return:
+*  bool: true if it is a press
+*
+*******************************************************************************/
+static bool button_capture_report(timing_capture_event_t event, uint64_t settled,
+                                  uint64_t *timestamp)
+{
+#if (BUTTON_CAPTURE_EVENTS)
+    if (TIMING_CAPTURE_EVENT_PRESS == event)
+    {
+        button_events_press(&events, settled);
+    }
+    else if (TIMING_CAPTURE_EVENT_RELEASE == event)
+    {
+        button_events_release(&events, settled);
+    }
+    else
+    {
+        /* Nothing settled */
+    }
+#endif
+
+    if (TIMING_CAPTURE_EVENT_PRESS == event)
+    {
+        *timestamp = settled;
+    }
+
+    return (TIMING_CAPTURE_EVENT_PRESS == event);
+}
+
+
+/*******************************************************************************
+* Function Name: button_capture_isr
+********************************************************************************
+* Summary:
+*  User button GPIO interrupt handler. The time base is read before anything
+*  else so that the timestamp is as close to the edge as possible. Every edge,
+*  including the bounces, is queued for the main loop to debounce.
+*
+*******************************************************************************/
+static void button_capture_isr(void)
+{
+    uint64_t now = mcwdt_timebase_read64();
+
+    Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM);
+    NVIC_ClearPendingIRQ(CYBSP_USER_BTN_IRQ);
+
+    (void)timestamp_ring_push(&edge_ring, now, Cy_GPIO_Read(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM));
+}
+
+
+/*******************************************************************************
+* Function Name: button_capture_init
+********************************************************************************
+* Summary:
+*  Enables interrupts on both edges of the user button. MCWDT_0 must already be
+*  running with Counter 0 cascaded into Counter 1, and extended to 64 bits by
+*  mcwdt_timebase_init().
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the failing cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t button_capture_init(void)
+{
+    static const cy_stc_sysint_t button_intr_config =
+    {
+        .intrSrc = CYBSP_USER_BTN_IRQ,
+        .intrPriority = BUTTON_CAPTURE_INTR_PRIORITY
+    };
+    cy_en_sysint_status_t status;
+
+    timing_capture_init(&capture, BUTTON_CAPTURE_DEBOUNCE_TICKS);
+#if (BUTTON_CAPTURE_ADAPTIVE_DEBOUNCE)
+    timing_capture_adapt(&capture, BUTTON_CAPTURE_ADAPT_MARGIN_TICKS);
+#endif
+#if (BUTTON_CAPTURE_EVENTS)
+    button_events_init(&events, &events_config);
+#endif
+    timestamp_ring_init(&edge_ring);
+
+    status = Cy_SysInt_Init(&button_intr_config, button_capture_isr);
+    if (CY_SYSINT_SUCCESS != status)
+    {
+        return (cy_rslt_t)status;
+    }
+
+    Cy_GPIO_SetInterruptEdge(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM, CY_GPIO_INTR_BOTH);
+    Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM);
+    Cy_GPIO_SetInterruptMask(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM, 1u);
+
+    NVIC_ClearPendingIRQ(CYBSP_USER_BTN_IRQ);
+    NVIC_EnableIRQ(CYBSP_USER_BTN_IRQ);
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: button_capture_get_press
+********************************************************************************
+* Summary:
+*  Debounces the queued edges and never blocks. A press is reported once the
+*  switch has been stable in the pressed state for the debounce window after
+*  its last edge; the release is then debounced the same way before the next
+*  press can be captured. A press that bounces back before the window ends is
+*  discarded.
+*
+*  The queued edges are worked through as one batch. Because each edge carries
+*  its own timestamp, presses that happened while the main loop was busy are
+*  decided exactly as if they had been seen at once. At most one press is
+*  reported per call, so call again until it returns false.
+*
+* Parameters:
+*  timestamp: receives the time base value latched on the press edge
+*
+* Return:
+*  bool: true if a debounced press is reported
+*
+*******************************************************************************/
+bool button_capture_get_press(uint64_t *timestamp)
+{
+    uint32_t count = timestamp_ring_count(&edge_ring);
+    timestamp_record_t const *edge;
+    timing_capture_event_t event;
+    uint64_t settled;
+    uint64_t now;
+    uint32_t i;
+
+    for (i = 0u; i < count; i++)
+    {
+        edge = timestamp_ring_at(&edge_ring, i);
+
+        /* The window since the previous edge ran out before this edge */
+        if (timing_capture_expired(&capture, timestamp_record_time(edge)))
+        {
+            event = timing_capture_settle_event(&capture, capture.last_edge_level, &settled);
+            if (button_capture_report(event, settled, timestamp))
+            {
+                timestamp_ring_release(&edge_ring, i);
+                return true;
+            }
+        }
+
+        timing_capture_edge(&capture, timestamp_record_time(edge), edge->event);
+    }
+    timestamp_ring_release(&edge_ring, count);
+
+    /* An edge after this point is timestamped after 'now' and goes into the
+     * next batch, so the window is judged on complete information */
+    now = mcwdt_timebase_read64();
+
+    /* Nothing to settle without a queued edge while the switch is stable,
+     * so the button is not read again and again while it is held */
+    if ((0u != timestamp_ring_count(&edge_ring)) || !timing_capture_busy(&capture))
+    {
+        return false;
+    }
+    event = timing_capture_poll_event(&capture, now, &settled);
+
+    return button_capture_report(event, settled, timestamp);
+}
+
+
+/*******************************************************************************
+* Function Name: button_capture_busy
+********************************************************************************
+* Summary:
+*  Reports whether edges are queued or a debounce window is open, in which
+*  case button_capture_get_press() must be called again soon, for example on
+*  the low_power.c wake tick. With BUTTON_CAPTURE_EVENTS, the same holds
+*  while the classifier waits for the end of a click gap, a long press or the
+*  next hold repeat. Otherwise nothing happens until the next button edge and
+*  the CPU may sleep until then.
+*
+* Return:
+*  bool: true while a press or release is being debounced or classified
+*
+*******************************************************************************/
+bool button_capture_busy(void)
+{
+#if (BUTTON_CAPTURE_EVENTS)
+    uint64_t deadline;
+
+    if (button_events_deadline(&events, &deadline))
+    {
+        return true;
+    }
+#endif
+
+    return ((0u != timestamp_ring_count(&edge_ring)) || timing_capture_busy(&capture));
+}
+
+
+/*******************************************************************************
+* Function Name: button_capture_get_ring_stats
+********************************************************************************
+* Summary:
+*  Returns the statistics of the edge queue.
+*
+* Parameters:
+*  stats: receives the statistics
+*
+*******************************************************************************/
+void button_capture_get_ring_stats(timestamp_ring_stats_t *stats)
+{
+    timestamp_ring_get_stats(&edge_ring, stats);
+}
+
+
+/*******************************************************************************
+* Function Name: button_capture_window
+********************************************************************************
+* Summary:
+*  Returns the debounce window in use, which changes only with
+*  BUTTON_CAPTURE_ADAPTIVE_DEBOUNCE.
+*
+* Return:
+*  uint64_t: debounce window in LFCLK cycles
+*
+*******************************************************************************/
+uint64_t button_capture_window(void)
+{
+    return capture.window;
+}
+
+
+#if (BUTTON_CAPTURE_EVENTS)
+/*******************************************************************************
+* Function Name: button_capture_get_event
+********************************************************************************
+* Summary:
+*  Returns the next classified button event. Call after
+*  button_capture_get_press() has returned false, so that the presses and
+*  releases up to now have been taken, and again until it returns false.
+*
+*  Presses and releases are only known up to the first edge that is still
+*  queued or being debounced, so the classifier is polled up to there and no
+*  further: a click gap does not run out while the next press is being
+*  debounced, and a press released just before the long threshold is not
+*  called long.
+*
+* Parameters:
+*  event: receives the event
+*
+* Return:
+*  bool: true if an event is returned
+*
+*******************************************************************************/
+bool button_capture_get_event(button_event_t *event)
+{
+    uint64_t now = mcwdt_timebase_read64();
+    uint64_t edge;
+
+    if (0u != timestamp_ring_count(&edge_ring))
+    {
+        edge = timestamp_record_time(timestamp_ring_at(&edge_ring, 0u));
+        now = (edge < now) ? edge : now;
+    }
+    if (timing_capture_busy(&capture))
+    {
+        now = (capture.burst_count < now) ? capture.burst_count : now;
+    }
+    button_events_poll(&events, now);
+
+    return button_events_get(&events, event);
+}
+#endif
+
+
+/* [] END OF FILE */
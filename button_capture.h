@@ -0,0 +1,101 @@
+/******************************************************************************
+* File Name:   button_capture.h
+*
+* Description: Interrupt-driven capture of user button presses. The GPIO interrupt
+*              latches the MCWDT_0 time base on the press edge and the debounce
+*              runs in the background against that time base.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef BUTTON_CAPTURE_H
+#define BUTTON_CAPTURE_H
+
+#include "cy_pdl.h"
+#include "switch_debounce.h"
+#include "timestamp_ring.h"
+#include "button_events.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Debounce window in LFCLK cycles, the same period read_switch_status() uses */
+#define BUTTON_CAPTURE_DEBOUNCE_TICKS       ((SWITCH_DEBOUNCE_CHECK_UNIT * \
+                                              SWITCH_DEBOUNCE_MAX_PERIOD_UNITS * \
+                                              CY_SYSCLK_WCO_FREQ) / 1000u)
+
+/* Set to 1 to learn the debounce window from the bounce of the switch, with
+ * BUTTON_CAPTURE_DEBOUNCE_TICKS as the conservative window it starts from and
+ * falls back to */
+#ifndef BUTTON_CAPTURE_ADAPTIVE_DEBOUNCE
+#define BUTTON_CAPTURE_ADAPTIVE_DEBOUNCE    (0u)
+#endif
+
+/* Least adaptive debounce window in LFCLK cycles, also added to the learned
+ * bounce gap: 2 ms */
+#ifndef BUTTON_CAPTURE_ADAPT_MARGIN_TICKS
+#define BUTTON_CAPTURE_ADAPT_MARGIN_TICKS   ((2u * CY_SYSCLK_WCO_FREQ) / 1000u)
+#endif
+
+/* Set to 1 to classify the debounced presses and releases into clicks, long
+ * presses and hold repeats (button_events.c) */
+#ifndef BUTTON_CAPTURE_EVENTS
+#define BUTTON_CAPTURE_EVENTS               (0u)
+#endif
+
+/* Priority of the user button GPIO interrupt */
+#define BUTTON_CAPTURE_INTR_PRIORITY        (3u)
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t button_capture_init(void);
+bool      button_capture_get_press(uint64_t *timestamp);
+bool      button_capture_busy(void);
+void      button_capture_get_ring_stats(timestamp_ring_stats_t *stats);
+uint64_t  button_capture_window(void);
+#if (BUTTON_CAPTURE_EVENTS)
+bool      button_capture_get_event(button_event_t *event);
+#endif
+
+
+#endif /* BUTTON_CAPTURE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,366 @@
+/******************************************************************************
+* File Name:   button_events.c
+*
+* Description: Classifies debounced button presses and releases, timestamped
+*              with the MCWDT time base, into typed events. Each call does a
+*              fixed amount of work and never blocks, so the classifier can be
+*              fed from an interrupt.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#include "button_events.h"
+
+
+/*******************************************************************************
+* Function Name: button_events_emit
+********************************************************************************
+* Summary:
+*  Queues an event for the consumer, or counts it as dropped if the queue is
+*  full.
+*
+*******************************************************************************/
+static void button_events_emit(button_events_t *events, button_event_type_t type, uint32_t count,
+                               uint64_t timestamp, uint64_t duration)
+{
+    uint32_t head = events->head;
+    button_event_t *event;
+
+    if ((head - events->tail) >= BUTTON_EVENTS_QUEUE_SIZE)
+    {
+        events->dropped++;
+        return;
+    }
+
+    event = &events->queue[head & (BUTTON_EVENTS_QUEUE_SIZE - 1u)];
+    event->type = type;
+    event->count = count;
+    event->timestamp = timestamp;
+    event->duration = duration;
+
+    /* Publish the event */
+    __DMB();
+    events->head = head + 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: button_events_flush_clicks
+********************************************************************************
+* Summary:
+*  Reports the short presses waiting for the click gap to end as one event.
+*
+*******************************************************************************/
+static void button_events_flush_clicks(button_events_t *events)
+{
+    static const button_event_type_t types[] =
+    {
+        BUTTON_EVENT_SHORT, BUTTON_EVENT_DOUBLE, BUTTON_EVENT_TRIPLE
+    };
+
+    if (0u != events->clicks)
+    {
+        button_events_emit(events, types[events->clicks - 1u], events->clicks,
+                           events->first_press, events->release - events->first_press);
+        events->clicks = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: button_events_long
+********************************************************************************
+* Summary:
+*  Reports the current press as long, after any clicks before it.
+*
+*******************************************************************************/
+static void button_events_long(button_events_t *events)
+{
+    button_events_flush_clicks(events);
+    button_events_emit(events, BUTTON_EVENT_LONG, 0u, events->press, events->config.long_ticks);
+    events->long_sent = true;
+    events->repeats = 0u;
+    events->next_repeat = events->press + events->config.long_ticks + events->config.repeat_ticks;
+}
+
+
+/*******************************************************************************
+* Function Name: button_events_init
+********************************************************************************
+* Summary:
+*  Starts the classifier with the button released and no events queued.
+*
+* Parameters:
+*  events: classifier state
+*  config: thresholds in ticks, copied
+*
+*******************************************************************************/
+void button_events_init(button_events_t *events, button_events_config_t const *config)
+{
+    events->config = *config;
+    events->held = false;
+    events->long_sent = false;
+    events->clicks = 0u;
+    events->repeats = 0u;
+    events->first_press = 0u;
+    events->press = 0u;
+    events->release = 0u;
+    events->next_repeat = 0u;
+
+    events->head = 0u;
+    events->tail = 0u;
+    events->dropped = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: button_events_press
+********************************************************************************
+* Summary:
+*  Takes a debounced press. A press more than the click gap after the last
+*  release first reports the clicks before it, in case no poll did. A press
+*  while already held is ignored.
+*
+* Parameters:
+*  events: classifier state
+*  timestamp: time base value at the press edge
+*
+*******************************************************************************/
+void button_events_press(button_events_t *events, uint64_t timestamp)
+{
+    if (events->held)
+    {
+        return;
+    }
+
+    if ((0u != events->clicks) && ((timestamp - events->release) > events->config.click_gap_ticks))
+    {
+        button_events_flush_clicks(events);
+    }
+    if (0u == events->clicks)
+    {
+        events->first_press = timestamp;
+    }
+
+    events->held = true;
+    events->long_sent = false;
+    events->press = timestamp;
+}
+
+
+/*******************************************************************************
+* Function Name: button_events_release
+********************************************************************************
+* Summary:
+*  Takes a debounced release. A long press is reported long, in case no poll
+*  did, and then released. A short press adds a click; the third is reported
+*  at once, fewer wait for the click gap to end.
+*
+* Parameters:
+*  events: classifier state
+*  timestamp: time base value at the release edge
+*
+*******************************************************************************/
+void button_events_release(button_events_t *events, uint64_t timestamp)
+{
+    uint64_t duration = timestamp - events->press;
+
+    if (!events->held)
+    {
+        return;
+    }
+    events->held = false;
+
+    /* Clicks before the press end at the previous release */
+    if (!events->long_sent && (duration >= events->config.long_ticks))
+    {
+        button_events_long(events);
+    }
+    events->release = timestamp;
+    if (events->long_sent)
+    {
+        button_events_emit(events, BUTTON_EVENT_LONG_RELEASE, events->repeats, events->press, duration);
+        return;
+    }
+
+    events->clicks++;
+    if (3u == events->clicks)
+    {
+        button_events_flush_clicks(events);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: button_events_poll
+********************************************************************************
+* Summary:
+*  Reports what has happened by 'now' without an edge: the end of the click
+*  gap, a press becoming long, and hold repeats. Repeats missed by a late poll
+*  are reported as one event with the count of the latest.
+*
+* Parameters:
+*  events: classifier state
+*  now: time base value, after the last press or release taken
+*
+*******************************************************************************/
+void button_events_poll(button_events_t *events, uint64_t now)
+{
+    uint64_t missed;
+
+    if (!events->held)
+    {
+        if ((0u != events->clicks) && ((now - events->release) > events->config.click_gap_ticks))
+        {
+            button_events_flush_clicks(events);
+        }
+    }
+    else if (!events->long_sent)
+    {
+        if ((now - events->press) >= events->config.long_ticks)
+        {
+            button_events_long(events);
+        }
+    }
+    else if ((0u != events->config.repeat_ticks) && (now >= events->next_repeat))
+    {
+        missed = (now - events->next_repeat) / events->config.repeat_ticks;
+        events->repeats += (uint32_t)missed + 1u;
+        events->next_repeat += (missed + 1u) * events->config.repeat_ticks;
+        button_events_emit(events, BUTTON_EVENT_HOLD_REPEAT, events->repeats, events->press,
+                           events->next_repeat - events->config.repeat_ticks - events->press);
+    }
+    else
+    {
+        /* Held long, before the next repeat */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: button_events_deadline
+********************************************************************************
+* Summary:
+*  Returns when button_events_poll() next has something to report, so that
+*  the caller can stay awake or set a timer until then.
+*
+* Parameters:
+*  events: classifier state
+*  deadline: receives the time base value of the next poll needed
+*
+* Return:
+*  bool: true if a poll is needed before the next press or release
+*
+*******************************************************************************/
+bool button_events_deadline(button_events_t const *events, uint64_t *deadline)
+{
+    bool pending = true;
+
+    if (!events->held)
+    {
+        pending = (0u != events->clicks);
+        *deadline = events->release + events->config.click_gap_ticks + 1u;
+    }
+    else if (!events->long_sent)
+    {
+        *deadline = events->press + events->config.long_ticks;
+    }
+    else
+    {
+        pending = (0u != events->config.repeat_ticks);
+        *deadline = events->next_repeat;
+    }
+
+    return pending;
+}
+
+
+/*******************************************************************************
+* Function Name: button_events_get
+********************************************************************************
+* Summary:
+*  Takes the oldest queued event.
+*
+* Parameters:
+*  events: classifier state
+*  event: receives the event
+*
+* Return:
+*  bool: true if an event was queued
+*
+*******************************************************************************/
+bool button_events_get(button_events_t *events, button_event_t *event)
+{
+    uint32_t tail = events->tail;
+
+    if (events->head == tail)
+    {
+        return false;
+    }
+
+    /* Events up to the head are complete */
+    __DMB();
+    *event = events->queue[tail & (BUTTON_EVENTS_QUEUE_SIZE - 1u)];
+
+    /* Finish reading the event before the producer may overwrite it */
+    __DMB();
+    events->tail = tail + 1u;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: button_events_name
+********************************************************************************
+* Summary:
+*  Returns a printable name of an event type.
+*
+*******************************************************************************/
+const char *button_events_name(button_event_type_t type)
+{
+    static const char *const names[] =
+    {
+        "Short press", "Double click", "Triple click", "Long press", "Hold repeat",
+        "Long press released"
+    };
+
+    return ((uint32_t)type < (sizeof(names) / sizeof(names[0]))) ? names[type] : "?";
+}
+
+
+/* [] END OF FILE */
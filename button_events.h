@@ -0,0 +1,145 @@
+/******************************************************************************
+* File Name:   button_events.h
+*
+* Description: Classification of debounced button presses and releases into
+*              short, double and triple clicks, long presses and hold repeats.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef BUTTON_EVENTS_H
+#define BUTTON_EVENTS_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Default thresholds in LFCLK cycles: a press held for 600 ms is long, and
+ * repeats every 200 ms after that; a press within 300 ms of the previous
+ * release adds a click */
+#ifndef BUTTON_EVENTS_LONG_TICKS
+#define BUTTON_EVENTS_LONG_TICKS            ((600u * CY_SYSCLK_WCO_FREQ) / 1000u)
+#endif
+#ifndef BUTTON_EVENTS_REPEAT_TICKS
+#define BUTTON_EVENTS_REPEAT_TICKS          ((200u * CY_SYSCLK_WCO_FREQ) / 1000u)
+#endif
+#ifndef BUTTON_EVENTS_CLICK_GAP_TICKS
+#define BUTTON_EVENTS_CLICK_GAP_TICKS       ((300u * CY_SYSCLK_WCO_FREQ) / 1000u)
+#endif
+
+/* Number of events queued for the consumer. Must be a power of two. */
+#ifndef BUTTON_EVENTS_QUEUE_SIZE
+#define BUTTON_EVENTS_QUEUE_SIZE            (8u)
+#endif
+
+#if ((BUTTON_EVENTS_QUEUE_SIZE == 0u) || \
+     ((BUTTON_EVENTS_QUEUE_SIZE & (BUTTON_EVENTS_QUEUE_SIZE - 1u)) != 0u))
+#error "BUTTON_EVENTS_QUEUE_SIZE must be a power of two"
+#endif
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    BUTTON_EVENT_SHORT,         /* One short press, no other within the gap  */
+    BUTTON_EVENT_DOUBLE,        /* Two short presses                         */
+    BUTTON_EVENT_TRIPLE,        /* Three short presses, reported at once     */
+    BUTTON_EVENT_LONG,          /* Held for the long threshold               */
+    BUTTON_EVENT_HOLD_REPEAT,   /* Still held, once per repeat period        */
+    BUTTON_EVENT_LONG_RELEASE   /* Released after a long press               */
+} button_event_type_t;
+
+typedef struct
+{
+    button_event_type_t type;
+    uint32_t count;             /* Clicks, or repeats so far                 */
+    uint64_t timestamp;         /* Press edge of the first press             */
+    uint64_t duration;          /* Ticks from 'timestamp' to the last release
+                                 * of clicks, or held so far for long events */
+} button_event_t;
+
+typedef struct
+{
+    uint64_t long_ticks;        /* Held at least this long is a long press   */
+    uint64_t repeat_ticks;      /* Hold repeat period, 0 for none            */
+    uint64_t click_gap_ticks;   /* Longest release between clicks            */
+} button_events_config_t;
+
+/* Classifier state and its event queue. The press, release and poll
+ * functions are the producer and must all be called from one context, which
+ * may be an interrupt; button_events_get() is the consumer. Polls must not
+ * run ahead of a press or release that is still being debounced. */
+typedef struct
+{
+    button_events_config_t config;
+    bool     held;
+    bool     long_sent;         /* The current press has been reported long  */
+    uint32_t clicks;            /* Short presses waiting for the gap to end  */
+    uint32_t repeats;
+    uint64_t first_press;       /* Press edge of the first pending click     */
+    uint64_t press;             /* Edges of the latest press and release     */
+    uint64_t release;
+    uint64_t next_repeat;
+
+    volatile uint32_t head;     /* Written by the producer only              */
+    volatile uint32_t tail;     /* Written by the consumer only              */
+    volatile uint32_t dropped;
+    button_event_t queue[BUTTON_EVENTS_QUEUE_SIZE];
+} button_events_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void button_events_init(button_events_t *events, button_events_config_t const *config);
+void button_events_press(button_events_t *events, uint64_t timestamp);
+void button_events_release(button_events_t *events, uint64_t timestamp);
+void button_events_poll(button_events_t *events, uint64_t now);
+bool button_events_deadline(button_events_t const *events, uint64_t *deadline);
+bool button_events_get(button_events_t *events, button_event_t *event);
+const char *button_events_name(button_event_type_t type);
+
+
+#endif /* BUTTON_EVENTS_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name:   bench_util.c
+*
+* Description: Helpers shared by the host benchmarks and tests. The generator is
+*              a 64-bit xorshift, so every run of a benchmark replays the same
+*              scenario from its seed.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <time.h>
+
+#include "bench_util.h"
+#include "mcwdt_sim.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint64_t rng_state = BENCH_UTIL_RNG_SEED;
+
+
+/*******************************************************************************
+* Function Name: bench_util_rng_seed
+********************************************************************************
+* Summary:
+*  Restarts the generator, so that a scenario can be replayed.
+*
+* Parameters:
+*  seed: new state, not 0
+*
+*******************************************************************************/
+void bench_util_rng_seed(uint64_t seed)
+{
+    rng_state = seed;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_util_rng_next
+********************************************************************************
+* Summary:
+*  Advances the generator.
+*
+* Return:
+*  uint64_t: the next 64-bit value of the generator
+*
+*******************************************************************************/
+uint64_t bench_util_rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_util_rng_range
+********************************************************************************
+* Summary:
+*  Advances the generator and reduces its value to a range, with the small
+*  bias of a modulo, which the benchmarks do not mind.
+*
+* Parameters:
+*  n: number of values, not 0
+*
+* Return:
+*  uint32_t: the next value of the generator, from 0 to n - 1
+*
+*******************************************************************************/
+uint32_t bench_util_rng_range(uint32_t n)
+{
+    return (uint32_t)(bench_util_rng_next() % n);
+}
+
+
+/*******************************************************************************
+* Function Name: bench_util_wall_ns
+********************************************************************************
+* Summary:
+*  Reads the host's monotonic clock, for timing host code.
+*
+* Return:
+*  uint64_t: wall time in nanoseconds
+*
+*******************************************************************************/
+uint64_t bench_util_wall_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * MCWDT_SIM_NS_PER_S) + (uint64_t)ts.tv_nsec;
+}
+
+
+/* [] END OF FILE */
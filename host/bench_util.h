@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name:   bench_util.h
+*
+* Description: Helpers shared by the host benchmarks and tests: a seeded
+*              pseudo-random generator, the wall clock, and the start of the
+*              MCWDT_0 time base as main() does it.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "mcwdt_timebase.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* State of the generator until bench_util_rng_seed() is called */
+#define BENCH_UTIL_RNG_SEED                 (0x2545F4914F6CDD1DULL)
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void     bench_util_rng_seed(uint64_t seed);
+uint64_t bench_util_rng_next(void);
+uint32_t bench_util_rng_range(uint32_t n);
+uint64_t bench_util_wall_ns(void);
+
+
+/*******************************************************************************
+* Function Name: bench_util_start_mcwdt
+********************************************************************************
+* Summary:
+*  Starts the cascaded MCWDT_0 time base as main() does. Inline, so that the
+*  tests on mock hardware can include this header without the simulator.
+*
+*******************************************************************************/
+static inline void bench_util_start_mcwdt(void)
+{
+    CY_ASSERT(CY_MCWDT_SUCCESS == Cy_MCWDT_Init(MCWDT_0_HW, &MCWDT_0_config));
+    CY_ASSERT(CY_RSLT_SUCCESS == mcwdt_timebase_init());
+    Cy_MCWDT_Enable(MCWDT_0_HW, CY_MCWDT_CTR0 | CY_MCWDT_CTR1, 93U);
+}
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* BENCH_UTIL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,785 @@
+/******************************************************************************
+* File Name:   bounce_replay.c
+*
+* Description: Replays recorded button edge traces, such as logic-analyzer
+*              exports of worn switches, through read_switch_status() and the
+*              other debouncers on the simulator, and reports detection latency,
+*              false and missed presses, and CPU time per press. Also sweeps the
+*              debounce window on the same traces, and reports the latency that
+*              adaptive debounce saves.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "switch_debounce.h"
+#include "button_capture.h"
+#include "timer_debounce.h"
+#include "timer_wheel.h"
+#include "port_debounce.h"
+#include "timing_engine.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Where the trace starts in virtual time, after the application has started,
+ * and the gap between two trace files */
+#define REPLAY_START_NS                     (MCWDT_SIM_NS_PER_S)
+#define REPLAY_FILE_GAP_NS                  (MCWDT_SIM_NS_PER_S)
+
+/* Virtual time run after the last edge, to debounce it */
+#define REPLAY_TAIL_NS                      (MCWDT_SIM_NS_PER_S)
+
+/* Edges closer than this belong to one press or release. Longer than the
+ * gaps within any bounce, shorter than any hold. */
+#define REPLAY_DEFAULT_GAP_MS               (100.0)
+
+/* Built-in traces: worn switches that bounce for 20 to 150 ms on press and
+ * release, held 300 to 800 ms, with the odd glitch in between */
+#define REPLAY_PRESSES                      (50U)
+#define REPLAY_MIN_BOUNCE_MS                (20U)
+#define REPLAY_MAX_BOUNCE_MS                (150U)
+#define REPLAY_MIN_HOLD_MS                  (300U)
+#define REPLAY_MAX_HOLD_MS                  (800U)
+#define REPLAY_MAX_PULSE_US                 (12000U)
+#define REPLAY_GLITCH_EVERY                 (8U)
+#define REPLAY_MAX_GLITCH_US                (3000U)
+
+/* Built-in traces of clean switches that settle within 2 ms */
+#define REPLAY_CLEAN_MIN_BOUNCE_US          (200U)
+#define REPLAY_CLEAN_MAX_BOUNCE_US          (2000U)
+#define REPLAY_CLEAN_MAX_PULSE_US           (300U)
+
+/* port_debounce.c sampling period in LFCLK cycles, so that
+ * PORT_DEBOUNCE_SAMPLES samples span the read_switch_status() window */
+#define REPLAY_PORT_SAMPLE_CYCLES           ((SWITCH_DEBOUNCE_CHECK_UNIT * \
+                                              SWITCH_DEBOUNCE_MAX_PERIOD_UNITS * \
+                                              CY_SYSCLK_WCO_FREQ) / \
+                                             (1000u * PORT_DEBOUNCE_SAMPLES))
+
+/* Debounce windows of the sweep, in ms */
+#define REPLAY_SWEEP_WINDOWS                {5U, 10U, 20U, 40U, 60U, 80U, 100U, 120U, 160U}
+
+#define REPLAY_NS_PER_TICK                  (1e9 / (double)CY_SYSCLK_WCO_FREQ)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint64_t t_ns;
+    uint32_t level;
+} replay_edge_t;
+
+/* A press of the trace: the first edge of a burst that leaves the switch
+ * pressed after it was released */
+typedef struct
+{
+    uint64_t t_ns;
+    bool     matched;
+} replay_press_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t detected;
+    uint32_t false_presses;     /* Reported with no press of the trace     */
+    uint32_t missed;            /* Presses of the trace never reported     */
+    double   latency_sum_ms;    /* From the press edge to the report       */
+    double   latency_max_ms;
+    mcwdt_sim_stats_t stats;
+} replay_result_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static replay_edge_t *edges;
+static uint32_t edge_count;
+static uint32_t edge_capacity;
+static uint64_t trace_end_ns;
+
+static replay_press_t *presses;
+static uint32_t press_count;
+
+static uint64_t *detections;
+static uint32_t detection_count;
+
+static uint32_t max_pulse_us = REPLAY_MAX_PULSE_US;
+
+static port_debounce_t port_state;
+static timer_wheel_timer_t port_timer;
+
+
+/*******************************************************************************
+* Function Name: add_edge
+********************************************************************************
+* Summary:
+*  Appends a level to the trace. Repeated levels, as in analyzer exports that
+*  list every sample, are dropped.
+*******************************************************************************/
+static void add_edge(uint64_t t_ns, uint32_t level)
+{
+    uint32_t previous = (0U == edge_count) ? 1U : edges[edge_count - 1U].level;
+
+    if (level == previous)
+    {
+        return;
+    }
+    if (edge_count == edge_capacity)
+    {
+        edge_capacity = (0U == edge_capacity) ? 4096U : (2U * edge_capacity);
+        edges = realloc(edges, edge_capacity * sizeof(edges[0]));
+        CY_ASSERT(NULL != edges);
+    }
+    edges[edge_count].t_ns = t_ns;
+    edges[edge_count].level = level;
+    edge_count++;
+    trace_end_ns = t_ns;
+}
+
+
+/*******************************************************************************
+* Function Name: load_trace
+********************************************************************************
+* Summary:
+*  Appends a trace file after the edges already loaded. Each line is a time in
+*  seconds and the pin level, separated by a comma, as exported by most logic
+*  analyzers; lines that do not start with a number, such as a header, are
+*  skipped. Times are taken from the first line of the file.
+*******************************************************************************/
+static bool load_trace(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    uint64_t offset = (0U == edge_count) ? REPLAY_START_NS : (trace_end_ns + REPLAY_FILE_GAP_NS);
+    char line[256];
+    char *end;
+    double first = -1.0;
+    double t;
+    long level;
+
+    if (NULL == f)
+    {
+        perror(path);
+        return false;
+    }
+    while (NULL != fgets(line, sizeof(line), f))
+    {
+        t = strtod(line, &end);
+        if ((end == line) || (',' != *end))
+        {
+            continue;
+        }
+        level = strtol(end + 1, NULL, 0);
+        if (first < 0.0)
+        {
+            first = t;
+        }
+        add_edge(offset + (uint64_t)((t - first) * 1e9), (0L != level) ? 1U : 0U);
+    }
+    fclose(f);
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: add_bounce
+********************************************************************************
+* Summary:
+*  Adds a switch transition to 'level' at t_ns, followed by pulses of random
+*  width back to the other level for 'bounce_ns', settling on 'level'.
+*******************************************************************************/
+static void add_bounce(uint64_t t_ns, uint64_t bounce_ns, uint32_t level)
+{
+    uint64_t t = t_ns;
+
+    add_edge(t, level);
+    for (;;)
+    {
+        t += (50U + bench_util_rng_range(max_pulse_us)) * MCWDT_SIM_NS_PER_US;
+        if (t >= (t_ns + bounce_ns))
+        {
+            break;
+        }
+        add_edge(t, level ^ 1U);
+        t += (50U + bench_util_rng_range(max_pulse_us / 2U)) * MCWDT_SIM_NS_PER_US;
+        add_edge(t, level);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: make_traces
+********************************************************************************
+* Summary:
+*  Builds the built-in traces: switches that bounce for min_us to max_us on
+*  press and release, with pulses of up to max_pulse_us.
+*******************************************************************************/
+static void make_traces(uint32_t min_us, uint32_t max_us)
+{
+    uint64_t t = REPLAY_START_NS;
+    uint64_t hold;
+    uint32_t i;
+
+    for (i = 0U; i < REPLAY_PRESSES; i++)
+    {
+        hold = (REPLAY_MIN_HOLD_MS + bench_util_rng_range(REPLAY_MAX_HOLD_MS - REPLAY_MIN_HOLD_MS)) *
+               MCWDT_SIM_NS_PER_MS;
+        add_bounce(t, (min_us + bench_util_rng_range(max_us - min_us)) * MCWDT_SIM_NS_PER_US, 0U);
+        add_bounce(t + hold, (min_us + bench_util_rng_range(max_us - min_us)) * MCWDT_SIM_NS_PER_US,
+                   1U);
+        t += hold + ((500U + bench_util_rng_range(1000U)) * MCWDT_SIM_NS_PER_MS);
+
+        /* A short spike to the pressed level between presses */
+        if (0U == bench_util_rng_range(REPLAY_GLITCH_EVERY))
+        {
+            add_edge(t - (250U * MCWDT_SIM_NS_PER_MS), 0U);
+            add_edge(t - (250U * MCWDT_SIM_NS_PER_MS) +
+                     ((100U + bench_util_rng_range(REPLAY_MAX_GLITCH_US)) * MCWDT_SIM_NS_PER_US),
+                     1U);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: write_trace
+*******************************************************************************/
+static bool write_trace(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    uint32_t i;
+
+    if (NULL == f)
+    {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "Time [s],Button\n");
+    for (i = 0U; i < edge_count; i++)
+    {
+        fprintf(f, "%.9f,%u\n", (double)(edges[i].t_ns - REPLAY_START_NS) / 1e9,
+                (unsigned)edges[i].level);
+    }
+    fclose(f);
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: find_presses
+********************************************************************************
+* Summary:
+*  Splits the trace into bursts of edges less than gap_ns apart. A burst that
+*  leaves the switch pressed while it was released is a press of the trace, at
+*  the time of its first edge; one that leaves it released is its release.
+*******************************************************************************/
+static void find_presses(uint64_t gap_ns)
+{
+    bool held = false;
+    uint64_t burst_start = 0U;
+    uint32_t i;
+
+    presses = calloc(edge_count + 1U, sizeof(presses[0]));
+    detections = calloc(edge_count + 1U, sizeof(detections[0]));
+    CY_ASSERT((NULL != presses) && (NULL != detections));
+
+    press_count = 0U;
+    for (i = 0U; i < edge_count; i++)
+    {
+        if ((0U == i) || ((edges[i].t_ns - edges[i - 1U].t_ns) >= gap_ns))
+        {
+            burst_start = edges[i].t_ns;
+        }
+        if ((i + 1U < edge_count) && ((edges[i + 1U].t_ns - edges[i].t_ns) < gap_ns))
+        {
+            continue;
+        }
+
+        /* Last edge of a burst */
+        if (!held && (0U == edges[i].level))
+        {
+            presses[press_count].t_ns = burst_start;
+            press_count++;
+            held = true;
+        }
+        else if (held && (0U != edges[i].level))
+        {
+            held = false;
+        }
+        else
+        {
+            /* A glitch, or a burst that did not change the settled level */
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: score
+********************************************************************************
+* Summary:
+*  Matches each report with the last press of the trace before it. A second
+*  report of the same press, or one before any press, is a false press.
+*******************************************************************************/
+static void score(replay_result_t *r)
+{
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t mid;
+    uint32_t i;
+    double latency;
+
+    for (i = 0U; i < press_count; i++)
+    {
+        presses[i].matched = false;
+    }
+    r->detected = detection_count;
+    r->false_presses = 0U;
+    r->latency_sum_ms = 0.0;
+    r->latency_max_ms = 0.0;
+    for (i = 0U; i < detection_count; i++)
+    {
+        /* Number of presses at or before the report */
+        lo = 0U;
+        hi = press_count;
+        while (lo < hi)
+        {
+            mid = (lo + hi) / 2U;
+            if (presses[mid].t_ns <= detections[i])
+            {
+                lo = mid + 1U;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        if ((0U == lo) || presses[lo - 1U].matched)
+        {
+            r->false_presses++;
+            continue;
+        }
+        presses[lo - 1U].matched = true;
+        latency = (double)(detections[i] - presses[lo - 1U].t_ns) / 1e6;
+        r->latency_sum_ms += latency;
+        r->latency_max_ms = (latency > r->latency_max_ms) ? latency : r->latency_max_ms;
+    }
+    r->missed = 0U;
+    for (i = 0U; i < press_count; i++)
+    {
+        r->missed += presses[i].matched ? 0U : 1U;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: detect
+*******************************************************************************/
+static void detect(void)
+{
+    detections[detection_count++] = mcwdt_sim_now_ns();
+}
+
+
+/*******************************************************************************
+* Function Name: polling_app
+********************************************************************************
+* Summary:
+*  The original main loop around read_switch_status().
+*******************************************************************************/
+static void polling_app(void)
+{
+    bench_util_start_mcwdt();
+
+    for (;;)
+    {
+        if (0UL != read_switch_status())
+        {
+            detect();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: interrupt_app
+********************************************************************************
+* Summary:
+*  The interrupt capture main loop of main().
+*******************************************************************************/
+static void interrupt_app(void)
+{
+    uint64_t timestamp;
+    uint32_t intr_status;
+
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == button_capture_init());
+
+    for (;;)
+    {
+        while (button_capture_get_press(&timestamp))
+        {
+            detect();
+        }
+
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        if (!button_capture_busy())
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: timer_app
+********************************************************************************
+* Summary:
+*  The main loop of main() with ENABLE_TIMER_DEBOUNCE and no button interrupt.
+*******************************************************************************/
+static void timer_app(void)
+{
+    uint64_t timestamp;
+    uint32_t intr_status;
+
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == timer_debounce_init());
+
+    for (;;)
+    {
+        while (timer_debounce_get_press(&timestamp))
+        {
+            detect();
+        }
+
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        if (!timer_debounce_pending())
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: port_sample
+********************************************************************************
+* Summary:
+*  Periodic timer callback: one sample of the button through the vertical
+*  counters, reporting the change to the pressed level.
+*******************************************************************************/
+static void port_sample(timer_wheel_timer_t *timer, void *context)
+{
+    uint32_t bit = 1UL << CYBSP_USER_BTN_NUM;
+
+    if ((0U != (port_debounce_update(&port_state, GPIO_PRT_IN(CYBSP_USER_BTN_PORT)) & bit)) &&
+        (0U == (port_debounce_state(&port_state) & bit)))
+    {
+        detect();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: port_app
+********************************************************************************
+* Summary:
+*  port_debounce.c sampling the button port from a timer wheel timer, with the
+*  main loop asleep.
+*******************************************************************************/
+static void port_app(void)
+{
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == timer_wheel_init());
+    port_debounce_init(&port_state, GPIO_PRT_IN(CYBSP_USER_BTN_PORT));
+    memset(&port_timer, 0, sizeof(port_timer));
+    timer_wheel_start(&port_timer, REPLAY_PORT_SAMPLE_CYCLES, REPLAY_PORT_SAMPLE_CYCLES,
+                      port_sample, NULL);
+
+    for (;;)
+    {
+        __WFI();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(replay_result_t *r, mcwdt_sim_app_t app)
+{
+    uint32_t i;
+
+    mcwdt_sim_reset();
+    for (i = 0U; i < edge_count; i++)
+    {
+        mcwdt_sim_schedule_pin(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM, edges[i].t_ns,
+                               edges[i].level);
+    }
+    detection_count = 0U;
+    (void)mcwdt_sim_run(app, trace_end_ns + REPLAY_TAIL_NS);
+    r->stats = *mcwdt_sim_stats();
+    score(r);
+
+    printf("%-20s | %8u | %5u | %6u | %9.2f | %8.2f | %12.3f | %9.1f\n", r->name, r->detected,
+           r->false_presses, r->missed,
+           (r->detected > r->false_presses) ?
+               (r->latency_sum_ms / (double)(r->detected - r->false_presses)) : 0.0,
+           r->latency_max_ms, (double)r->stats.busy_ns / 1e6 / (double)press_count,
+           (double)r->stats.wakeups / (double)press_count);
+}
+
+
+/*******************************************************************************
+* Function Name: replay_capture
+********************************************************************************
+* Summary:
+*  Replays the trace through the capture engine of button_capture.c, without
+*  the simulator, and scores it. The main loop of the interrupt capture polls
+*  as soon as a window runs out, so each press is reported at the end of the
+*  window after its last edge.
+*******************************************************************************/
+static void replay_capture(replay_result_t *r, timing_capture_t *capture)
+{
+    uint64_t tick;
+    uint64_t end;
+    uint64_t ts;
+    uint32_t i;
+
+    detection_count = 0U;
+    for (i = 0U; i <= edge_count; i++)
+    {
+        tick = (i < edge_count) ? (uint64_t)((double)edges[i].t_ns / REPLAY_NS_PER_TICK) :
+                                  UINT64_MAX;
+
+        /* Settling may change an adaptive window: the report is due at the
+         * end of the window that ran out */
+        end = capture->last_edge_count + capture->window;
+        if (timing_capture_expired(capture, tick) &&
+            timing_capture_settle(capture, capture->last_edge_level, &ts))
+        {
+            detections[detection_count++] = (uint64_t)((double)end * REPLAY_NS_PER_TICK);
+        }
+        if (i < edge_count)
+        {
+            timing_capture_edge(capture, tick, edges[i].level);
+        }
+    }
+    score(r);
+}
+
+
+/*******************************************************************************
+* Function Name: mean_latency_ms
+*******************************************************************************/
+static double mean_latency_ms(replay_result_t const *r)
+{
+    return (r->detected > r->false_presses) ?
+               (r->latency_sum_ms / (double)(r->detected - r->false_presses)) : 0.0;
+}
+
+
+/*******************************************************************************
+* Function Name: sweep
+********************************************************************************
+* Summary:
+*  Replays the trace through the capture engine for a range of fixed debounce
+*  windows, then with adaptive debounce starting from the window of
+*  read_switch_status(), and reports the latency adaptive debounce saves on
+*  each press against that fixed window.
+*******************************************************************************/
+static void sweep(replay_result_t *adaptive)
+{
+    static const uint32_t windows_ms[] = REPLAY_SWEEP_WINDOWS;
+    replay_result_t fixed = { .name = "" };
+    replay_result_t r = { .name = "" };
+    timing_capture_t capture;
+    uint32_t w;
+
+    printf("\nbutton_capture window | reports | false | missed | mean (ms) | max (ms)\n");
+    printf("----------------------|---------|-------|--------|-----------|---------\n");
+    for (w = 0U; w < (sizeof(windows_ms) / sizeof(windows_ms[0])); w++)
+    {
+        timing_capture_init(&capture, ((uint64_t)windows_ms[w] * CY_SYSCLK_WCO_FREQ) / 1000U);
+        replay_capture(&r, &capture);
+        printf("%18u ms | %7u | %5u | %6u | %9.2f | %8.2f\n", (unsigned)windows_ms[w],
+               r.detected, r.false_presses, r.missed, mean_latency_ms(&r), r.latency_max_ms);
+    }
+
+    timing_capture_init(&capture, BUTTON_CAPTURE_DEBOUNCE_TICKS);
+    replay_capture(&fixed, &capture);
+    timing_capture_init(&capture, BUTTON_CAPTURE_DEBOUNCE_TICKS);
+    timing_capture_adapt(&capture, BUTTON_CAPTURE_ADAPT_MARGIN_TICKS);
+    replay_capture(adaptive, &capture);
+    printf("%21s | %7u | %5u | %6u | %9.2f | %8.2f\n", "adaptive", adaptive->detected,
+           adaptive->false_presses, adaptive->missed, mean_latency_ms(adaptive),
+           adaptive->latency_max_ms);
+    printf("\nadaptive debounce: window %.2f ms at the end, %u fallbacks, "
+           "%.2f ms saved per press against %u ms\n",
+           (double)capture.window * REPLAY_NS_PER_TICK / 1e6, (unsigned)capture.fallbacks,
+           mean_latency_ms(&fixed) - mean_latency_ms(adaptive),
+           (unsigned)(SWITCH_DEBOUNCE_CHECK_UNIT * SWITCH_DEBOUNCE_MAX_PERIOD_UNITS));
+}
+
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options] [trace.csv ...]\n"
+            "  -c, --clean      built-in traces of clean switches, bouncing for up to\n"
+            "                   %u us\n"
+            "  -g, --gap MS     edges closer than MS ms belong to one press or release\n"
+            "                   (default %.0f)\n"
+            "  -w, --write FILE write the built-in traces to FILE and exit\n"
+            "Each trace line is 'seconds,level'. Without trace files, %u presses of\n"
+            "switches bouncing for %u to %u ms are replayed.\n",
+            prog, REPLAY_CLEAN_MAX_BOUNCE_US, REPLAY_DEFAULT_GAP_MS, REPLAY_PRESSES,
+            REPLAY_MIN_BOUNCE_MS, REPLAY_MAX_BOUNCE_MS);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        { "clean", no_argument,       NULL, 'c' },
+        { "gap",   required_argument, NULL, 'g' },
+        { "write", required_argument, NULL, 'w' },
+        { NULL, 0, NULL, 0 }
+    };
+    replay_result_t polling = { .name = "read_switch_status" };
+    replay_result_t interrupt = { .name = "button_capture" };
+    replay_result_t timer = { .name = "timer_debounce" };
+    replay_result_t port = { .name = "port_debounce" };
+    replay_result_t adaptive = { .name = "adaptive" };
+    double gap_ms = REPLAY_DEFAULT_GAP_MS;
+    const char *write_path = NULL;
+    bool clean = false;
+    bool builtin;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "cg:w:", options, NULL)) != -1)
+    {
+        switch (opt)
+        {
+            case 'c':
+                clean = true;
+                break;
+            case 'g':
+                gap_ms = strtod(optarg, NULL);
+                break;
+            case 'w':
+                write_path = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    builtin = (optind == argc);
+    for (; optind < argc; optind++)
+    {
+        if (!load_trace(argv[optind]))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    if (builtin && clean)
+    {
+        max_pulse_us = REPLAY_CLEAN_MAX_PULSE_US;
+        make_traces(REPLAY_CLEAN_MIN_BOUNCE_US, REPLAY_CLEAN_MAX_BOUNCE_US);
+    }
+    else if (builtin)
+    {
+        make_traces(REPLAY_MIN_BOUNCE_MS * 1000U, REPLAY_MAX_BOUNCE_MS * 1000U);
+    }
+    if (NULL != write_path)
+    {
+        return write_trace(write_path) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (0U == edge_count)
+    {
+        fprintf(stderr, "no edges in the traces\n");
+        return EXIT_FAILURE;
+    }
+    find_presses((uint64_t)(gap_ms * 1e6));
+
+    printf("%u edges, %u presses over %.1f s; debounce period %u ms\n\n",
+           (unsigned)edge_count, (unsigned)press_count,
+           (double)(trace_end_ns - REPLAY_START_NS) / 1e9,
+           (unsigned)(SWITCH_DEBOUNCE_CHECK_UNIT * SWITCH_DEBOUNCE_MAX_PERIOD_UNITS));
+    printf("debouncer            | reports  | false | missed | mean (ms) | max (ms) | CPU ms/press | wakeups/press\n");
+    printf("---------------------|----------|-------|--------|-----------|----------|--------------|--------------\n");
+    run(&polling, polling_app);
+    run(&interrupt, interrupt_app);
+    run(&timer, timer_app);
+    run(&port, port_app);
+    printf("\nlatency is from the first edge of each press to its report\n");
+
+    sweep(&adaptive);
+
+    /* The built-in switches settle well within the window */
+    return (!builtin ||
+            ((0U == (polling.false_presses + polling.missed)) &&
+             (0U == (adaptive.false_presses + adaptive.missed)) &&
+             (0U == (interrupt.false_presses + interrupt.missed)) &&
+             (0U == (timer.false_presses + timer.missed)) &&
+             (0U == (port.false_presses + port.missed)))) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,480 @@
+/******************************************************************************
+* File Name:   button_events_test.c
+*
+* Description: Checks the button event classifier against a reference that
+*              sees each whole press sequence at once: random thresholds,
+*              press durations and gaps next to each threshold, and polls both
+*              at every deadline and at random times, including never.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cy_pdl.h"
+#include "button_events.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TEST_RUNS                           (20000U)
+#define TEST_PRESSES                        (40U)
+
+/* Events of one run: each press gives at most a click event, a long press,
+ * its release, and its repeats */
+#define TEST_MAX_REPEATS                    (20U)
+#define TEST_MAX_EVENTS                     (TEST_PRESSES * (TEST_MAX_REPEATS + 3U))
+
+#define TEST_QUEUE_OVERFLOW                 (3U * BUTTON_EVENTS_QUEUE_SIZE)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    POLL_AT_DEADLINES,      /* Every deadline, and at random times         */
+    POLL_SPARSE,            /* Only at random times                        */
+    POLL_NEVER              /* Only the presses and releases               */
+} test_polling_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t cases;
+    uint32_t failures;
+} test_result_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint64_t press_at[TEST_PRESSES];
+static uint64_t release_at[TEST_PRESSES];
+
+static button_event_t expected[TEST_MAX_EVENTS];
+static uint32_t expected_count;
+static button_event_t received[TEST_MAX_EVENTS];
+static uint32_t received_count;
+
+/* A poll at a deadline left the same deadline pending */
+static bool stalled;
+
+
+/*******************************************************************************
+* Function Name: rng_range
+********************************************************************************
+* Summary:
+*  bench_util_rng_range() over 64 bits, for the gaps between polls that can
+*  exceed the 32-bit range.
+*******************************************************************************/
+static uint64_t rng_range(uint64_t n)
+{
+    return bench_util_rng_next() % n;
+}
+
+
+/*******************************************************************************
+* Function Name: near
+********************************************************************************
+* Summary:
+*  A random number of ticks from 1 up, often right at or next to the
+*  threshold.
+*******************************************************************************/
+static uint64_t near(uint64_t threshold, uint64_t max)
+{
+    switch (rng_range(4U))
+    {
+        case 0U:
+            return threshold - 1U + rng_range(3U);
+        case 1U:
+            return 1U + rng_range(threshold);
+        default:
+            return 1U + rng_range(max);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: expect
+*******************************************************************************/
+static void expect(button_event_type_t type, uint32_t count, uint64_t timestamp, uint64_t duration)
+{
+    expected[expected_count].type = type;
+    expected[expected_count].count = count;
+    expected[expected_count].timestamp = timestamp;
+    expected[expected_count].duration = duration;
+    expected_count++;
+}
+
+
+/*******************************************************************************
+* Function Name: reference
+********************************************************************************
+* Summary:
+*  The events of a whole press sequence, with a hold repeat at every repeat
+*  period that has passed by the release.
+*******************************************************************************/
+static void reference(button_events_config_t const *config)
+{
+    static const button_event_type_t clicks_type[] =
+    {
+        BUTTON_EVENT_SHORT, BUTTON_EVENT_DOUBLE, BUTTON_EVENT_TRIPLE
+    };
+    uint32_t clicks = 0U;
+    uint64_t first = 0U;
+    uint64_t last_release = 0U;
+    uint64_t held;
+    uint32_t n;
+    uint32_t i;
+
+    expected_count = 0U;
+    for (i = 0U; i < TEST_PRESSES; i++)
+    {
+        if ((0U != clicks) && ((press_at[i] - last_release) > config->click_gap_ticks))
+        {
+            expect(clicks_type[clicks - 1U], clicks, first, last_release - first);
+            clicks = 0U;
+        }
+        if (0U == clicks)
+        {
+            first = press_at[i];
+        }
+
+        held = release_at[i] - press_at[i];
+        if (held >= config->long_ticks)
+        {
+            if (0U != clicks)
+            {
+                expect(clicks_type[clicks - 1U], clicks, first, last_release - first);
+                clicks = 0U;
+            }
+            expect(BUTTON_EVENT_LONG, 0U, press_at[i], config->long_ticks);
+            n = 0U;
+            while ((0U != config->repeat_ticks) &&
+                   ((config->long_ticks + ((n + 1U) * config->repeat_ticks)) <= held))
+            {
+                n++;
+                expect(BUTTON_EVENT_HOLD_REPEAT, n, press_at[i],
+                       config->long_ticks + (n * config->repeat_ticks));
+            }
+            expect(BUTTON_EVENT_LONG_RELEASE, n, press_at[i], held);
+        }
+        else
+        {
+            clicks++;
+            last_release = release_at[i];
+            if (3U == clicks)
+            {
+                expect(BUTTON_EVENT_TRIPLE, 3U, first, last_release - first);
+                clicks = 0U;
+            }
+        }
+    }
+    if (0U != clicks)
+    {
+        expect(clicks_type[clicks - 1U], clicks, first, last_release - first);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: drain
+*******************************************************************************/
+static void drain(button_events_t *events)
+{
+    button_event_t event;
+
+    while (button_events_get(events, &event))
+    {
+        if (received_count < TEST_MAX_EVENTS)
+        {
+            received[received_count] = event;
+        }
+        received_count++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: poll_until
+********************************************************************************
+* Summary:
+*  Polls up to time t, the way a main loop or a timer interrupt would.
+*******************************************************************************/
+static void poll_until(button_events_t *events, uint64_t from, uint64_t t, test_polling_t polling)
+{
+    uint32_t polls = (POLL_NEVER == polling) ? 0U : (uint32_t)rng_range(5U);
+    uint64_t now = from;
+    uint64_t previous = 0U;
+    uint64_t deadline;
+    uint64_t next;
+
+    /* Up to four polls at random, increasing times, and with
+     * POLL_AT_DEADLINES every deadline in between, in time order */
+    for (;;)
+    {
+        next = ((0U != polls) && (t > now)) ? (now + rng_range(((t - now) / polls) + 1U)) : t;
+        while ((POLL_AT_DEADLINES == polling) && button_events_deadline(events, &deadline) &&
+               (deadline <= next))
+        {
+            if ((deadline == previous) && (0U != previous))
+            {
+                stalled = true;
+                return;
+            }
+            button_events_poll(events, deadline);
+            drain(events);
+            previous = deadline;
+        }
+        if ((0U == polls) || (t <= now))
+        {
+            break;
+        }
+        now = next;
+        button_events_poll(events, now);
+        drain(events);
+        polls--;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: same_event
+*******************************************************************************/
+static bool same_event(button_event_t const *a, button_event_t const *b)
+{
+    return ((a->type == b->type) && (a->count == b->count) && (a->timestamp == b->timestamp) &&
+            (a->duration == b->duration));
+}
+
+
+/*******************************************************************************
+* Function Name: matches
+********************************************************************************
+* Summary:
+*  Compares the received events with the reference. When the poll is not
+*  called at every deadline, hold repeats may be missed or merged: the
+*  repeats received must be a subsequence of those expected, and each long
+*  press release must count the repeats up to the last one received.
+*******************************************************************************/
+static bool matches(test_polling_t polling)
+{
+    uint32_t e = 0U;
+    uint32_t r;
+
+    if (received_count > TEST_MAX_EVENTS)
+    {
+        return false;
+    }
+    if (POLL_AT_DEADLINES == polling)
+    {
+        return ((received_count == expected_count) &&
+                (0 == memcmp(received, expected, received_count * sizeof(received[0]))));
+    }
+
+    for (r = 0U; r < received_count; r++)
+    {
+        while ((e < expected_count) && (BUTTON_EVENT_HOLD_REPEAT == expected[e].type) &&
+               !same_event(&received[r], &expected[e]))
+        {
+            e++;
+        }
+        if (e == expected_count)
+        {
+            return false;
+        }
+        if (BUTTON_EVENT_LONG_RELEASE == received[r].type)
+        {
+            if ((received[r].timestamp != expected[e].timestamp) ||
+                (received[r].duration != expected[e].duration) ||
+                (received[r].count !=
+                 (((r > 0U) && (BUTTON_EVENT_HOLD_REPEAT == received[r - 1U].type)) ?
+                      received[r - 1U].count : 0U)))
+            {
+                return false;
+            }
+        }
+        else if (!same_event(&received[r], &expected[e]))
+        {
+            return false;
+        }
+        e++;
+    }
+
+    return (e == expected_count);
+}
+
+
+/*******************************************************************************
+* Function Name: test_sequences
+*******************************************************************************/
+static void test_sequences(test_result_t *r, test_polling_t polling)
+{
+    button_events_config_t config;
+    button_events_t events;
+    uint64_t t;
+    uint32_t n;
+    uint32_t i;
+
+    for (n = 0U; n < TEST_RUNS; n++)
+    {
+        config.long_ticks = 2U + rng_range(40000U);
+        config.repeat_ticks = (0U == rng_range(4U)) ? 0U : (1U + rng_range(config.long_ticks));
+        config.click_gap_ticks = 1U + rng_range(20000U);
+
+        /* Anywhere in the 64-bit range, often next to the 32-bit wrap */
+        t = (0U == (n & 1U)) ? (bench_util_rng_next() >> 2) : (0xFFFFFFFFULL - rng_range(100000U));
+        for (i = 0U; i < TEST_PRESSES; i++)
+        {
+            t += near(config.click_gap_ticks, 3U * config.click_gap_ticks);
+            press_at[i] = t;
+            t += near(config.long_ticks,
+                      config.long_ticks + ((TEST_MAX_REPEATS - 1U) * config.repeat_ticks) + 1U);
+            release_at[i] = t;
+        }
+        reference(&config);
+
+        button_events_init(&events, &config);
+        received_count = 0U;
+        stalled = false;
+        t = press_at[0] - 1U;
+        for (i = 0U; i < TEST_PRESSES; i++)
+        {
+            poll_until(&events, t, press_at[i], polling);
+            button_events_press(&events, press_at[i]);
+            drain(&events);
+            poll_until(&events, press_at[i], release_at[i], polling);
+            button_events_release(&events, release_at[i]);
+            drain(&events);
+            t = release_at[i];
+        }
+        button_events_poll(&events, t + config.click_gap_ticks + 1U);
+        drain(&events);
+
+        r->cases++;
+        if (!matches(polling) || (0U != events.dropped) || stalled)
+        {
+            if (r->failures < 5U)
+            {
+                printf("  %s: run %u, %u events against %u\n", r->name, (unsigned)n,
+                       (unsigned)received_count, (unsigned)expected_count);
+            }
+            r->failures++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_overflow
+********************************************************************************
+* Summary:
+*  Clicks with no consumer: the queue keeps the oldest events and counts the
+*  others as dropped.
+*******************************************************************************/
+static void test_overflow(test_result_t *r)
+{
+    static const button_events_config_t config = { 100U, 0U, 10U };
+    button_events_t events;
+    button_event_t event;
+    uint32_t got = 0U;
+    uint32_t i;
+
+    button_events_init(&events, &config);
+    for (i = 0U; i < TEST_QUEUE_OVERFLOW; i++)
+    {
+        button_events_press(&events, 1000U * i);
+        button_events_release(&events, (1000U * i) + 5U);
+        button_events_poll(&events, (1000U * i) + 500U);
+    }
+    while (button_events_get(&events, &event))
+    {
+        r->cases++;
+        if ((BUTTON_EVENT_SHORT != event.type) || (event.timestamp != (1000U * got)))
+        {
+            r->failures++;
+        }
+        got++;
+    }
+
+    r->cases++;
+    if ((BUTTON_EVENTS_QUEUE_SIZE != got) ||
+        ((TEST_QUEUE_OVERFLOW - BUTTON_EVENTS_QUEUE_SIZE) != events.dropped))
+    {
+        r->failures++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    test_result_t results[] = {
+        { .name = "polled at deadlines" },
+        { .name = "polled sparsely" },
+        { .name = "never polled" },
+        { .name = "queue overflow" },
+    };
+    uint32_t failures = 0U;
+    uint32_t i;
+
+    test_sequences(&results[0], POLL_AT_DEADLINES);
+    test_sequences(&results[1], POLL_SPARSE);
+    test_sequences(&results[2], POLL_NEVER);
+    test_overflow(&results[3]);
+
+    printf("\ntest                | cases   | failures\n");
+    printf("--------------------|---------|---------\n");
+    for (i = 0U; i < (sizeof(results) / sizeof(results[0])); i++)
+    {
+        printf("%-19s | %7u | %8u\n", results[i].name, (unsigned)results[i].cases,
+               (unsigned)results[i].failures);
+        failures += results[i].failures;
+    }
+
+    return (0U == failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,409 @@
+/******************************************************************************
+* File Name:   capture_bench.c
+*
+* Description: Compares the blocking read_switch_status() path, the interrupt
+*              capture path and the Deep Sleep mode on the simulator: timestamp
+*              error against the real press edge, the longest main-loop stall,
+*              CPU duty cycle, wakeups and edge-to-ISR latency.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "mcwdt_timebase.h"
+#include "bench_util.h"
+#include "button_capture.h"
+#include "switch_debounce.h"
+#include "low_power.h"
+#include "timer_debounce.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define BENCH_PRESSES                       (50U)
+#define BENCH_HOLD_MS                       (250U)
+
+/* Bounce trains last up to this long on press and release */
+#define BENCH_MAX_BOUNCE_US                 (5000U)
+
+/* Virtual time simulated after the last release edge, enough to debounce it */
+#define BENCH_TAIL_MS                       (100U)
+
+/* Main-loop time taken to print each press in the slow UART run, longer than
+ * the gap between presses so that several presses happen while printing */
+#define BENCH_SLOW_PRINT_MS                 (1000U)
+
+#define BENCH_TICK_US                       (1e6 / (double)CY_SYSCLK_WCO_FREQ)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    unsigned count;
+    double err_sum_us;
+    double err_max_us;
+    uint64_t max_stall_ns;
+    uint64_t print_ns;
+    unsigned isr_count;
+    double isr_latency_sum_us;
+    double isr_latency_max_us;
+    mcwdt_sim_stats_t stats;
+    timestamp_ring_stats_t ring;
+} bench_result_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint64_t press_edge_tick[BENCH_PRESSES];
+static uint64_t press_edge_ns[BENCH_PRESSES];
+static bench_result_t *current;
+
+
+/*******************************************************************************
+* Function Name: schedule_bouncy_edge
+********************************************************************************
+* Summary:
+*  Schedules a switch transition to 'level' at t_ns followed by a random train
+*  of bounces that settles on 'level'.
+*******************************************************************************/
+static void schedule_bouncy_edge(uint64_t t_ns, uint32_t level)
+{
+    uint32_t bounces = bench_util_rng_range(6U);
+    uint64_t t = t_ns;
+    uint32_t i;
+
+    mcwdt_sim_schedule_pin(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM, t, level);
+    for (i = 0U; i < bounces; i++)
+    {
+        t += (50U + bench_util_rng_range(BENCH_MAX_BOUNCE_US / 6U)) * MCWDT_SIM_NS_PER_US;
+        mcwdt_sim_schedule_pin(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM, t, level ^ 1U);
+        t += (50U + bench_util_rng_range(BENCH_MAX_BOUNCE_US / 6U)) * MCWDT_SIM_NS_PER_US;
+        mcwdt_sim_schedule_pin(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM, t, level);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: schedule_scenario
+********************************************************************************
+* Summary:
+*  Schedules the presses and returns the time at which the run should stop.
+*******************************************************************************/
+static uint64_t schedule_scenario(void)
+{
+    uint64_t t = MCWDT_SIM_NS_PER_S;
+    uint32_t i;
+
+    bench_util_rng_seed(BENCH_UTIL_RNG_SEED);
+    for (i = 0U; i < BENCH_PRESSES; i++)
+    {
+        t += (500U + bench_util_rng_range(2500U)) * MCWDT_SIM_NS_PER_MS;
+        press_edge_tick[i] = mcwdt_sim_ticks_at_ns(t);
+        press_edge_ns[i] = t;
+        schedule_bouncy_edge(t, 0U);
+        schedule_bouncy_edge(t + (BENCH_HOLD_MS * MCWDT_SIM_NS_PER_MS), 1U);
+    }
+
+    return t + ((BENCH_HOLD_MS + BENCH_TAIL_MS) * MCWDT_SIM_NS_PER_MS);
+}
+
+
+/*******************************************************************************
+* Function Name: record_press
+*******************************************************************************/
+static void record_press(uint64_t timestamp)
+{
+    double err;
+
+    if (current->count < BENCH_PRESSES)
+    {
+        err = (double)(timestamp - press_edge_tick[current->count]) *
+              BENCH_TICK_US;
+        current->err_sum_us += err;
+        current->err_max_us = (err > current->err_max_us) ? err : current->err_max_us;
+    }
+    current->count++;
+}
+
+
+/*******************************************************************************
+* Function Name: irq_hook
+********************************************************************************
+* Summary:
+*  Measures the time from each press edge to the entry of the first button
+*  interrupt handler that follows it, including any Deep Sleep wakeup.
+*******************************************************************************/
+static void irq_hook(uint32_t irqn)
+{
+    uint64_t now = mcwdt_sim_now_ns();
+    double latency;
+
+    if ((irqn == (uint32_t)CYBSP_USER_BTN_IRQ) && (current->isr_count < BENCH_PRESSES) &&
+        (now >= press_edge_ns[current->isr_count]))
+    {
+        latency = (double)(now - press_edge_ns[current->isr_count]) / 1e3;
+        current->isr_latency_sum_us += latency;
+        current->isr_latency_max_us = (latency > current->isr_latency_max_us) ?
+                                      latency : current->isr_latency_max_us;
+        current->isr_count++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: polling_app
+********************************************************************************
+* Summary:
+*  The original main loop: read_switch_status(), then read the counter.
+*  A call that sampled the pin more than once kept the main loop stalled.
+*******************************************************************************/
+static void polling_app(void)
+{
+    bench_util_start_mcwdt();
+
+    for (;;)
+    {
+        uint64_t t0 = mcwdt_sim_now_ns();
+        uint64_t reads0 = mcwdt_sim_stats()->gpio_reads;
+        uint32_t pressed = read_switch_status();
+        uint64_t stall = mcwdt_sim_now_ns() - t0;
+
+        if ((mcwdt_sim_stats()->gpio_reads - reads0) > 1U)
+        {
+            current->max_stall_ns = (stall > current->max_stall_ns) ? stall : current->max_stall_ns;
+        }
+        if (0UL != pressed)
+        {
+            record_press(mcwdt_timebase_read64());
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: interrupt_app
+********************************************************************************
+* Summary:
+*  The interrupt capture main loop of main().
+*******************************************************************************/
+static void interrupt_app(void)
+{
+    uint64_t timestamp;
+    uint32_t intr_status;
+
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == button_capture_init());
+    CY_ASSERT(CY_RSLT_SUCCESS == low_power_init());
+
+    for (;;)
+    {
+        uint64_t t0 = mcwdt_sim_now_ns();
+        bool pressed = button_capture_get_press(&timestamp);
+        uint64_t stall = mcwdt_sim_now_ns() - t0;
+
+        current->max_stall_ns = (stall > current->max_stall_ns) ? stall : current->max_stall_ns;
+        if (pressed)
+        {
+            record_press(timestamp);
+            mcwdt_sim_advance_ns(current->print_ns);
+            button_capture_get_ring_stats(&current->ring);
+        }
+
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        low_power_sleep(button_capture_busy());
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: timer_app
+********************************************************************************
+* Summary:
+*  The main loop of main() with ENABLE_TIMER_DEBOUNCE and no button interrupt.
+*******************************************************************************/
+static void timer_app(void)
+{
+    uint64_t timestamp;
+    uint32_t intr_status;
+
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == timer_debounce_init());
+
+    for (;;)
+    {
+        uint64_t t0 = mcwdt_sim_now_ns();
+        bool pressed = timer_debounce_get_press(&timestamp);
+        uint64_t stall = mcwdt_sim_now_ns() - t0;
+
+        current->max_stall_ns = (stall > current->max_stall_ns) ? stall : current->max_stall_ns;
+        if (pressed)
+        {
+            record_press(timestamp);
+        }
+
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        if (!timer_debounce_pending())
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: deep_sleep_app
+********************************************************************************
+* Summary:
+*  The main loop of main() with ENABLE_DEEP_SLEEP_MODE.
+*******************************************************************************/
+static void deep_sleep_app(void)
+{
+    uint64_t timestamp;
+    uint32_t intr_status;
+
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == button_capture_init());
+    CY_ASSERT(CY_RSLT_SUCCESS == low_power_init());
+
+    for (;;)
+    {
+        uint64_t t0 = mcwdt_sim_now_ns();
+        bool pressed = button_capture_get_press(&timestamp);
+        uint64_t stall = mcwdt_sim_now_ns() - t0;
+
+        current->max_stall_ns = (stall > current->max_stall_ns) ? stall : current->max_stall_ns;
+        if (pressed)
+        {
+            record_press(timestamp);
+        }
+
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        low_power_deep_sleep(button_capture_busy());
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(bench_result_t *res, mcwdt_sim_app_t app)
+{
+    current = res;
+    mcwdt_sim_reset();
+    mcwdt_sim_set_irq_hook(irq_hook);
+    mcwdt_sim_run(app, schedule_scenario());
+    res->stats = *mcwdt_sim_stats();
+
+    printf("%-18s | %7u | %12.1f | %11.1f | %13.3f\n", res->name, res->count,
+           res->err_sum_us / res->count, res->err_max_us, (double)res->max_stall_ns / 1e6);
+}
+
+
+/*******************************************************************************
+* Function Name: print_power
+*******************************************************************************/
+static void print_power(const bench_result_t *res)
+{
+    double total = (double)(res->stats.busy_ns + res->stats.sleep_ns);
+
+    printf("%-18s | %8.3f %% | %9.3f %% | %13.1f | %14.3f | ", res->name,
+           100.0 * (double)res->stats.busy_ns / total,
+           100.0 * (double)res->stats.deepsleep_ns / total,
+           (double)res->stats.wakeups / res->count,
+           (double)res->stats.busy_ns / 1e6 / res->count);
+    if (res->isr_count > 0U)
+    {
+        printf("%9.2f / %.2f\n", res->isr_latency_sum_us / res->isr_count, res->isr_latency_max_us);
+    }
+    else
+    {
+        printf("%9s\n", "n/a");
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    bench_result_t polling = { .name = "read_switch_status" };
+    bench_result_t interrupt = { .name = "button_capture" };
+    bench_result_t timer = { .name = "timer_debounce" };
+    bench_result_t deep_sleep = { .name = "deep sleep mode" };
+    bench_result_t slow_print = { .name = "slow UART",
+                                  .print_ns = BENCH_SLOW_PRINT_MS * MCWDT_SIM_NS_PER_MS };
+
+    printf("%u bouncing presses held %u ms; timestamp error is measured from the first press edge\n\n",
+           BENCH_PRESSES, BENCH_HOLD_MS);
+    printf("path               | presses | mean err(us) | max err(us) | max stall(ms)\n");
+    printf("-------------------|---------|--------------|-------------|--------------\n");
+    run(&polling, polling_app);
+    run(&interrupt, interrupt_app);
+    run(&timer, timer_app);
+    run(&deep_sleep, deep_sleep_app);
+    run(&slow_print, interrupt_app);
+
+    printf("\npath               | CPU active | Deep Sleep  | wakeups/press | CPU ms/press   | edge->ISR mean / max (us)\n");
+    printf("-------------------|------------|-------------|---------------|----------------|--------------------------\n");
+    print_power(&polling);
+    print_power(&interrupt);
+    print_power(&timer);
+    print_power(&deep_sleep);
+
+    printf("\nslow UART: button_capture with %u ms spent printing each press; edge queue\n"
+           "high-water mark %u of %u, %u edges dropped\n",
+           BENCH_SLOW_PRINT_MS, slow_print.ring.high_water, TIMESTAMP_RING_SIZE, slow_print.ring.dropped);
+
+    return ((polling.count == BENCH_PRESSES) && (interrupt.count == BENCH_PRESSES) &&
+            (timer.count == BENCH_PRESSES) &&
+            (deep_sleep.count == BENCH_PRESSES) && (slow_print.count == BENCH_PRESSES)) ?
+           EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
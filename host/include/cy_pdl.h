@@ -0,0 +1,460 @@
+/******************************************************************************
+* File Name:   cy_pdl.h
+*
+* Description: Host-side stand-in for the subset of the PSoC 6 PDL used by the
+*              application. Every function is backed by the MCWDT simulator in
+*              host/mcwdt_sim.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CY_PDL_H
+#define CY_PDL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+/*******************************************************************************
+* Common types and macros
+*******************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS                     ((cy_rslt_t)0x00000000U)
+
+#define CY_ASSERT(x)                        do { if (!(x)) { mcwdt_sim_assert_failed(__FILE__, __LINE__); } } while (0)
+#define CY_UNUSED_PARAMETER(x)              ((void)(x))
+
+/* Process memory is not cleared by a simulated reset, so .noinit needs no
+ * section here */
+#define CY_NOINIT
+#define CY_USED                             __attribute__((used))
+
+void mcwdt_sim_assert_failed(const char *file, int line);
+
+
+/*******************************************************************************
+* CMSIS core (interrupts and exclusive access)
+*******************************************************************************/
+typedef enum
+{
+    ioss_interrupts_gpio_0_IRQn        = 0,
+    ioss_interrupts_gpio_1_IRQn        = 1,
+    ioss_interrupts_gpio_2_IRQn        = 2,
+    ioss_interrupts_gpio_3_IRQn        = 3,
+    ioss_interrupts_gpio_4_IRQn        = 4,
+    ioss_interrupts_gpio_5_IRQn        = 5,
+    ioss_interrupts_gpio_6_IRQn        = 6,
+    ioss_interrupts_gpio_7_IRQn        = 7,
+    ioss_interrupts_gpio_8_IRQn        = 8,
+    ioss_interrupts_gpio_9_IRQn        = 9,
+    ioss_interrupts_gpio_10_IRQn       = 10,
+    ioss_interrupts_gpio_11_IRQn       = 11,
+    ioss_interrupts_gpio_12_IRQn       = 12,
+    ioss_interrupts_gpio_13_IRQn       = 13,
+    ioss_interrupts_gpio_14_IRQn       = 14,
+    srss_interrupt_mcwdt_0_IRQn        = 19,
+    srss_interrupt_mcwdt_1_IRQn        = 20,
+    scb_5_interrupt_IRQn               = 46,
+    SIM_IRQ_COUNT                      = 64
+} IRQn_Type;
+
+void     __enable_irq(void);
+void     __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void     __set_PRIMASK(uint32_t priMask);
+void     __WFI(void);
+void     __DMB(void);
+void     __DSB(void);
+void     __ISB(void);
+uint32_t __LDREXW(volatile uint32_t *addr);
+uint32_t __STREXW(uint32_t value, volatile uint32_t *addr);
+void     __CLREX(void);
+
+void     NVIC_EnableIRQ(IRQn_Type IRQn);
+void     NVIC_DisableIRQ(IRQn_Type IRQn);
+void     NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+void     NVIC_SetPendingIRQ(IRQn_Type IRQn);
+void     NVIC_SystemReset(void);
+
+/* SysTick, clocked by the CPU clock. Register writes take effect at the next
+ * simulated access; reads of VAL are not modeled. */
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+#define SysTick_CTRL_ENABLE_Msk             (1UL)
+#define SysTick_CTRL_TICKINT_Msk            (2UL)
+#define SysTick_CTRL_CLKSOURCE_Msk          (4UL)
+#define SysTick_LOAD_RELOAD_Msk             (0xFFFFFFUL)
+
+extern SysTick_Type mcwdt_sim_systick;
+#define SysTick                             (&mcwdt_sim_systick)
+
+extern uint32_t SystemCoreClock;
+
+uint32_t SysTick_Config(uint32_t ticks);
+void     SysTick_Handler(void);
+
+/* DWT cycle counter, clocked by the CPU clock while the CPU runs. Each use of
+ * DWT brings CYCCNT up to date; a value written to it counts on from there. */
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk              (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk          (1UL << 24U)
+
+extern CoreDebug_Type mcwdt_sim_coredebug;
+#define CoreDebug                           (&mcwdt_sim_coredebug)
+
+DWT_Type *mcwdt_sim_dwt(void);
+#define DWT                                 (mcwdt_sim_dwt())
+
+
+/*******************************************************************************
+* SysLib
+*******************************************************************************/
+void     Cy_SysLib_Delay(uint32_t milliseconds);
+void     Cy_SysLib_DelayUs(uint16_t microseconds);
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void     Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus);
+
+
+/*******************************************************************************
+* SysInt
+*******************************************************************************/
+typedef void (* cy_israddress)(void);
+
+typedef enum
+{
+    CY_SYSINT_SUCCESS   = 0x00UL,
+    CY_SYSINT_BAD_PARAM = 0x01UL
+} cy_en_sysint_status_t;
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    uint32_t  intrPriority;
+} cy_stc_sysint_t;
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr);
+
+
+/*******************************************************************************
+* SysPm
+*******************************************************************************/
+typedef enum
+{
+    CY_SYSPM_SUCCESS       = 0x0U,
+    CY_SYSPM_BAD_PARAM     = 0x01U,
+    CY_SYSPM_TIMEOUT       = 0x02U,
+    CY_SYSPM_INVALID_STATE = 0x03U,
+    CY_SYSPM_CANCELED      = 0x04U,
+    CY_SYSPM_SYSCALL_PENDING = 0x05U,
+    CY_SYSPM_FAIL          = 0x06U
+} cy_en_syspm_status_t;
+
+typedef enum
+{
+    CY_SYSPM_WAIT_FOR_INTERRUPT,
+    CY_SYSPM_WAIT_FOR_EVENT
+} cy_en_syspm_waitfor_t;
+
+typedef enum
+{
+    CY_SYSPM_SLEEP      = 0U,
+    CY_SYSPM_DEEPSLEEP  = 1U,
+    CY_SYSPM_HIBERNATE  = 2U
+} cy_en_syspm_callback_type_t;
+
+typedef enum
+{
+    CY_SYSPM_CHECK_READY        = 0x01U,
+    CY_SYSPM_CHECK_FAIL         = 0x02U,
+    CY_SYSPM_BEFORE_TRANSITION  = 0x04U,
+    CY_SYSPM_AFTER_TRANSITION   = 0x08U
+} cy_en_syspm_callback_mode_t;
+
+typedef struct
+{
+    void *base;
+    void *context;
+} cy_stc_syspm_callback_params_t;
+
+typedef cy_en_syspm_status_t (*Cy_SysPmCallback)(cy_stc_syspm_callback_params_t *callbackParams,
+                                                 cy_en_syspm_callback_mode_t mode);
+
+typedef struct cy_stc_syspm_callback
+{
+    Cy_SysPmCallback callback;
+    cy_en_syspm_callback_type_t type;
+    uint32_t skipMode;
+    cy_stc_syspm_callback_params_t *callbackParams;
+    struct cy_stc_syspm_callback *prevItm;
+    struct cy_stc_syspm_callback *nextItm;
+    uint8_t order;
+} cy_stc_syspm_callback_t;
+
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler);
+bool Cy_SysPm_UnregisterCallback(cy_stc_syspm_callback_t const *handler);
+cy_en_syspm_status_t Cy_SysPm_CpuEnterSleep(cy_en_syspm_waitfor_t waitFor);
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(cy_en_syspm_waitfor_t waitFor);
+
+
+/*******************************************************************************
+* SysClk
+*******************************************************************************/
+#define CY_SYSCLK_WCO_FREQ                  (32768UL)
+#define CY_SYSCLK_ILO_FREQ                  (32000UL)
+#define CY_SYSCLK_IMO_FREQ                  (8000000UL)
+
+typedef enum
+{
+    CY_SYSCLK_SUCCESS           = 0x00U,
+    CY_SYSCLK_BAD_PARAM         = 0x01U,
+    CY_SYSCLK_TIMEOUT           = 0x02U,
+    CY_SYSCLK_INVALID_STATE     = 0x03U,
+    CY_SYSCLK_UNSUPPORTED_STATE = 0x04U
+} cy_en_sysclk_status_t;
+
+typedef enum
+{
+    CY_SYSCLK_CLKLF_IN_ILO   = 0U,
+    CY_SYSCLK_CLKLF_IN_WCO   = 1U,
+    CY_SYSCLK_CLKLF_IN_ALTLF = 2U,
+    CY_SYSCLK_CLKLF_IN_PILO  = 3U
+} cy_en_clklf_in_sources_t;
+
+typedef enum
+{
+    CY_SYSCLK_MEAS_CLK_NC    = 0U,
+    CY_SYSCLK_MEAS_CLK_ILO   = 1U,
+    CY_SYSCLK_MEAS_CLK_WCO   = 2U,
+    CY_SYSCLK_MEAS_CLK_LFCLK = 5U,
+    CY_SYSCLK_MEAS_CLK_IMO   = 6U
+} cy_en_meas_clks_t;
+
+cy_en_clklf_in_sources_t Cy_SysClk_ClkLfGetSource(void);
+void     Cy_SysClk_ClkLfSetSource(cy_en_clklf_in_sources_t source);
+bool     Cy_SysClk_WcoOkay(void);
+void     Cy_SysClk_IloEnable(void);
+bool     Cy_SysClk_IloIsEnabled(void);
+int32_t  Cy_SysClk_IloTrim(uint32_t iloFreq);
+cy_en_sysclk_status_t Cy_SysClk_StartClkMeasurementCounters(cy_en_meas_clks_t clock1,
+                                                            uint32_t count1,
+                                                            cy_en_meas_clks_t clock2);
+bool     Cy_SysClk_ClkMeasurementCountersDone(void);
+uint32_t Cy_SysClk_ClkMeasurementCountersGetFreq(bool measuredClock, uint32_t refClkFreq);
+void     Cy_SysClk_ClkMeasurementCountersEnd(void);
+
+
+/*******************************************************************************
+* WDT
+*******************************************************************************/
+void     Cy_WDT_Lock(void);
+void     Cy_WDT_Unlock(void);
+
+
+/*******************************************************************************
+* GPIO
+*******************************************************************************/
+typedef struct mcwdt_sim_gpio_port GPIO_PRT_Type;
+
+/* Simulated port instances (see host/mcwdt_sim.c) */
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt0;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt1;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt2;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt3;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt4;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt5;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt6;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt7;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt8;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt9;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt10;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt11;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt12;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt13;
+extern GPIO_PRT_Type mcwdt_sim_gpio_prt14;
+
+#define GPIO_PRT0                           (&mcwdt_sim_gpio_prt0)
+#define GPIO_PRT1                           (&mcwdt_sim_gpio_prt1)
+#define GPIO_PRT2                           (&mcwdt_sim_gpio_prt2)
+#define GPIO_PRT3                           (&mcwdt_sim_gpio_prt3)
+#define GPIO_PRT4                           (&mcwdt_sim_gpio_prt4)
+#define GPIO_PRT5                           (&mcwdt_sim_gpio_prt5)
+#define GPIO_PRT6                           (&mcwdt_sim_gpio_prt6)
+#define GPIO_PRT7                           (&mcwdt_sim_gpio_prt7)
+#define GPIO_PRT8                           (&mcwdt_sim_gpio_prt8)
+#define GPIO_PRT9                           (&mcwdt_sim_gpio_prt9)
+#define GPIO_PRT10                          (&mcwdt_sim_gpio_prt10)
+#define GPIO_PRT11                          (&mcwdt_sim_gpio_prt11)
+#define GPIO_PRT12                          (&mcwdt_sim_gpio_prt12)
+#define GPIO_PRT13                          (&mcwdt_sim_gpio_prt13)
+#define GPIO_PRT14                          (&mcwdt_sim_gpio_prt14)
+
+#define CY_GPIO_INTR_DISABLE                (0x0UL)
+#define CY_GPIO_INTR_RISING                 (0x1UL)
+#define CY_GPIO_INTR_FALLING                (0x2UL)
+#define CY_GPIO_INTR_BOTH                   (0x3UL)
+
+uint32_t Cy_GPIO_Read(GPIO_PRT_Type *base, uint32_t pinNum);
+void     Cy_GPIO_Write(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value);
+void     Cy_GPIO_SetInterruptEdge(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value);
+void     Cy_GPIO_SetInterruptMask(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value);
+uint32_t Cy_GPIO_GetInterruptStatus(GPIO_PRT_Type *base, uint32_t pinNum);
+uint32_t Cy_GPIO_GetInterruptStatusMasked(GPIO_PRT_Type *base, uint32_t pinNum);
+void     Cy_GPIO_ClearInterrupt(GPIO_PRT_Type *base, uint32_t pinNum);
+
+/* Whole-port register views */
+uint32_t mcwdt_sim_gpio_port_in(GPIO_PRT_Type *base);
+uint32_t mcwdt_sim_gpio_port_intr_masked(GPIO_PRT_Type *base);
+void     mcwdt_sim_gpio_port_intr_clear(GPIO_PRT_Type *base, uint32_t mask);
+
+#define GPIO_PRT_IN(base)                   (mcwdt_sim_gpio_port_in(base))
+#define GPIO_PRT_INTR_MASKED(base)          (mcwdt_sim_gpio_port_intr_masked(base))
+
+
+/*******************************************************************************
+* MCWDT
+*******************************************************************************/
+typedef struct mcwdt_sim_block MCWDT_STRUCT_Type;
+
+/* Simulated block instances (see host/mcwdt_sim.c) */
+extern MCWDT_STRUCT_Type mcwdt_sim_mcwdt_struct0;
+extern MCWDT_STRUCT_Type mcwdt_sim_mcwdt_struct1;
+
+#define MCWDT_STRUCT0                       (&mcwdt_sim_mcwdt_struct0)
+#define MCWDT_STRUCT1                       (&mcwdt_sim_mcwdt_struct1)
+
+#define CY_MCWDT_CTR0                       (1UL)
+#define CY_MCWDT_CTR1                       (2UL)
+#define CY_MCWDT_CTR2                       (4UL)
+#define CY_MCWDT_CTR_Msk                    (CY_MCWDT_CTR0 | CY_MCWDT_CTR1 | CY_MCWDT_CTR2)
+
+typedef enum
+{
+    CY_MCWDT_COUNTER0,
+    CY_MCWDT_COUNTER1,
+    CY_MCWDT_COUNTER2
+} cy_en_mcwdtcounter_t;
+
+typedef enum
+{
+    CY_MCWDT_MODE_NONE,
+    CY_MCWDT_MODE_INT,
+    CY_MCWDT_MODE_RESET,
+    CY_MCWDT_MODE_INT_RESET
+} cy_en_mcwdtmode_t;
+
+typedef enum
+{
+    CY_MCWDT_CASCADE_NONE,
+    CY_MCWDT_CASCADE_C0C1,
+    CY_MCWDT_CASCADE_C1C2,
+    CY_MCWDT_CASCADE_BOTH
+} cy_en_mcwdtcascade_t;
+
+typedef enum
+{
+    CY_MCWDT_SUCCESS   = 0x00U,
+    CY_MCWDT_BAD_PARAM = 0x01U
+} cy_en_mcwdt_status_t;
+
+typedef struct
+{
+    uint16_t c0Match;
+    uint16_t c1Match;
+    uint32_t c0Mode;
+    uint32_t c1Mode;
+    uint32_t c2ToggleBit;
+    uint32_t c2Mode;
+    bool     c0ClearOnMatch;
+    bool     c1ClearOnMatch;
+    bool     c0c1Cascade;
+    bool     c1c2Cascade;
+} cy_stc_mcwdt_config_t;
+
+cy_en_mcwdt_status_t Cy_MCWDT_Init(MCWDT_STRUCT_Type *base, cy_stc_mcwdt_config_t const *config);
+void     Cy_MCWDT_DeInit(MCWDT_STRUCT_Type *base);
+void     Cy_MCWDT_Enable(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs);
+void     Cy_MCWDT_Disable(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs);
+uint32_t Cy_MCWDT_GetEnabledStatus(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter);
+uint32_t Cy_MCWDT_GetCount(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter);
+void     Cy_MCWDT_ResetCounters(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs);
+void     Cy_MCWDT_SetMatch(MCWDT_STRUCT_Type *base, cy_en_mcwdtcounter_t counter, uint32_t match, uint16_t waitUs);
+uint32_t Cy_MCWDT_GetMatch(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter);
+void     Cy_MCWDT_SetMode(MCWDT_STRUCT_Type *base, cy_en_mcwdtcounter_t counter, cy_en_mcwdtmode_t mode);
+cy_en_mcwdtmode_t Cy_MCWDT_GetMode(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter);
+void     Cy_MCWDT_SetClearOnMatch(MCWDT_STRUCT_Type *base, cy_en_mcwdtcounter_t counter, uint32_t enable);
+void     Cy_MCWDT_SetCascade(MCWDT_STRUCT_Type *base, cy_en_mcwdtcascade_t cascade);
+void     Cy_MCWDT_SetToggleBit(MCWDT_STRUCT_Type *base, uint32_t bit);
+uint32_t Cy_MCWDT_GetToggleBit(MCWDT_STRUCT_Type const *base);
+uint32_t Cy_MCWDT_GetInterruptStatus(MCWDT_STRUCT_Type const *base);
+void     Cy_MCWDT_ClearInterrupt(MCWDT_STRUCT_Type *base, uint32_t counters);
+void     Cy_MCWDT_SetInterrupt(MCWDT_STRUCT_Type *base, uint32_t counters);
+uint32_t Cy_MCWDT_GetInterruptMask(MCWDT_STRUCT_Type const *base);
+void     Cy_MCWDT_SetInterruptMask(MCWDT_STRUCT_Type *base, uint32_t counters);
+uint32_t Cy_MCWDT_GetInterruptStatusMasked(MCWDT_STRUCT_Type const *base);
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CY_PDL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/******************************************************************************
+* File Name:   cy_retarget_io.h
+*
+* Description: Host-side stand-in for retarget-io. printf() goes to the host stdout,
+*              paced by the simulated debug UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CY_RETARGET_IO_H
+#define CY_RETARGET_IO_H
+
+#include "cy_pdl.h"
+#include "cyhal.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define CY_RETARGET_IO_BAUDRATE             (115200)
+
+/* The debug UART opened by cy_retarget_io_init() */
+extern cyhal_uart_t cy_retarget_io_uart_obj;
+
+cy_rslt_t cy_retarget_io_init(uint32_t tx, uint32_t rx, uint32_t baudrate);
+
+/* printf() through retarget-io waits for space in the UART TX FIFO for every
+ * character, so in code that includes this header it is routed to the
+ * simulated UART, which charges that wait as busy CPU time */
+int mcwdt_sim_uart_printf(const char *format, ...) __attribute__((format(__printf__, 1, 2)));
+
+#ifndef MCWDT_SIM_NO_RETARGET_PRINTF
+#define printf                              mcwdt_sim_uart_printf
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CY_RETARGET_IO_H */
+
+
+/* [] END OF FILE */
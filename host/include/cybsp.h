@@ -0,0 +1,77 @@
+/******************************************************************************
+* File Name:   cybsp.h
+*
+* Description: Host-side stand-in for the board support package: pin aliases and
+*              the Device Configurator generated MCWDT_0 resources.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYBSP_H
+#define CYBSP_H
+
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Device Configurator output for MCWDT_0, mirrors templates design.modus */
+#define MCWDT_0_HW                          MCWDT_STRUCT0
+#define MCWDT_0_IRQ                         srss_interrupt_mcwdt_0_IRQn
+extern const cy_stc_mcwdt_config_t MCWDT_0_config;
+
+/* BSP pin aliases (CY8CPROTO-062S2-43439 mapping) */
+#define CYBSP_USER_BTN_PORT                 GPIO_PRT0
+#define CYBSP_USER_BTN_PORT_NUM             (0U)
+#define CYBSP_USER_BTN_NUM                  (4U)
+#define CYBSP_USER_BTN_IRQ                  ioss_interrupts_gpio_0_IRQn
+#define CYBSP_USER_LED_PORT                 GPIO_PRT13
+#define CYBSP_USER_LED_PORT_NUM             (13U)
+#define CYBSP_USER_LED_PIN                  (7U)
+#define CYBSP_DEBUG_UART_TX                 (0U)
+#define CYBSP_DEBUG_UART_RX                 (0U)
+
+cy_rslt_t cybsp_init(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CYBSP_H */
+
+
+/* [] END OF FILE */
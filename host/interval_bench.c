@@ -0,0 +1,206 @@
+/******************************************************************************
+* File Name:   interval_bench.c
+*
+* Description: Checks interval_format against exact arithmetic and compares
+*              its cost with division followed by snprintf().
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cy_pdl.h"
+#include "interval_format.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define BENCH_INTERVALS                     (4096U)
+#define BENCH_ROUNDS                        (500U)
+
+/* Intervals of up to 2^27 ticks (about 68 minutes) */
+#define BENCH_MAX_TICKS_SHIFT               (27U)
+
+/* Generator seed of the intervals */
+#define BENCH_RNG_SEED                      (0xD1B54A32D192ED03ULL)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint64_t intervals[BENCH_INTERVALS];
+
+/* Keeps the compiler from discarding the formatted strings */
+static volatile char sink;
+
+
+/*******************************************************************************
+* Function Name: format_division
+********************************************************************************
+* Summary:
+*  What main() did before: whole seconds by division, then "%d".
+*******************************************************************************/
+static void format_division(char *buf, uint64_t ticks)
+{
+    uint32_t timegap = (uint32_t)(ticks / CY_SYSCLK_WCO_FREQ);
+
+    snprintf(buf, INTERVAL_FORMAT_BUF_SIZE, "%d", (unsigned int)timegap);
+}
+
+
+/*******************************************************************************
+* Function Name: format_division_us
+********************************************************************************
+* Summary:
+*  Microsecond resolution the straightforward way, for reference.
+*******************************************************************************/
+static void format_division_us(char *buf, uint64_t ticks)
+{
+    uint64_t us = ((ticks * 1000000U) + (CY_SYSCLK_WCO_FREQ / 2U)) / CY_SYSCLK_WCO_FREQ;
+
+    snprintf(buf, INTERVAL_FORMAT_BUF_SIZE, "%u.%06u", (unsigned int)(us / 1000000U),
+             (unsigned int)(us % 1000000U));
+}
+
+
+/*******************************************************************************
+* Function Name: format_fixed
+*******************************************************************************/
+static void format_fixed(char *buf, uint64_t ticks)
+{
+    (void)interval_format_ticks(buf, ticks);
+}
+
+
+/*******************************************************************************
+* Function Name: time_formatter
+********************************************************************************
+* Summary:
+*  Returns the mean wall time in nanoseconds to format one interval.
+*******************************************************************************/
+static double time_formatter(void (*format)(char *, uint64_t))
+{
+    char buf[INTERVAL_FORMAT_BUF_SIZE];
+    uint64_t t0 = bench_util_wall_ns();
+    uint32_t r;
+    uint32_t i;
+
+    for (r = 0U; r < BENCH_ROUNDS; r++)
+    {
+        for (i = 0U; i < BENCH_INTERVALS; i++)
+        {
+            format(buf, intervals[i]);
+            sink = buf[0];
+        }
+    }
+
+    return (double)(bench_util_wall_ns() - t0) / ((double)BENCH_ROUNDS * BENCH_INTERVALS);
+}
+
+
+/*******************************************************************************
+* Function Name: check_formatter
+********************************************************************************
+* Summary:
+*  Compares interval_format_ticks(), interval_format32() and
+*  interval_ticks_to_us() with exact arithmetic, including 32-bit wraps and the
+*  largest fractions. Returns the number of mismatches.
+*******************************************************************************/
+static unsigned check_formatter(void)
+{
+    char expected[32];
+    char actual[INTERVAL_FORMAT_BUF_SIZE];
+    unsigned errors = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < 1000000U; i++)
+    {
+        uint64_t ticks = (i < 65536U) ? (uint64_t)i * 0x7FFFU :
+                                        (bench_util_rng_next() >> (64U - 47U));
+        unsigned __int128 us = (((unsigned __int128)ticks * 1000000U) + 16384U) >> 15;
+        uint32_t start = (uint32_t)bench_util_rng_next();
+
+        snprintf(expected, sizeof(expected), "%llu.%06llu",
+                 (unsigned long long)(us / 1000000U), (unsigned long long)(us % 1000000U));
+
+        (void)interval_format_ticks(actual, ticks);
+        errors += (0 != strcmp(expected, actual)) ? 1U : 0U;
+        errors += (interval_ticks_to_us(ticks) != (uint64_t)us) ? 1U : 0U;
+
+        if (ticks <= UINT32_MAX)
+        {
+            (void)interval_format32(actual, start, start + (uint32_t)ticks);
+            errors += (0 != strcmp(expected, actual)) ? 1U : 0U;
+        }
+    }
+
+    (void)interval_format_ticks(actual, UINT64_MAX);
+    errors += (0 != strcmp("4294967295.999969", actual)) ? 1U : 0U;
+
+    return errors;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    unsigned errors;
+    uint32_t i;
+
+    bench_util_rng_seed(BENCH_RNG_SEED);
+    for (i = 0U; i < BENCH_INTERVALS; i++)
+    {
+        intervals[i] = bench_util_rng_next() >> (64U - BENCH_MAX_TICKS_SHIFT);
+    }
+
+    errors = check_formatter();
+    printf("interval_format: %u mismatches against exact arithmetic\n\n", errors);
+
+    printf("formatter                        | resolution | ns/interval\n");
+    printf("---------------------------------|------------|------------\n");
+    printf("divide, snprintf(\"%%d\")           | 1 s        | %11.1f\n", time_formatter(format_division));
+    printf("divide, snprintf(\"%%u.%%06u\")      | 1 us       | %11.1f\n", time_formatter(format_division_us));
+    printf("interval_format_ticks()          | 1 us       | %11.1f\n", time_formatter(format_fixed));
+
+    return (0U == errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
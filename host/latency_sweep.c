@@ -0,0 +1,220 @@
+/******************************************************************************
+* File Name:   latency_sweep.c
+*
+* Description: Runs latency_bench.c on the simulator at several modeled MCWDT
+*              register read latencies, prints the cycle counts of each step side
+*              by side, and checks them against the model.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "latency_bench.h"
+#include "log_sink.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Modeled MCWDT register read latencies: the default, a slow peripheral bus,
+ * and one and two LFCLK cycles, as a read synchronized to LFCLK would take */
+#define SWEEP_POINTS                        (4U)
+
+#define SWEEP_GPIO_READ_NS                  (20U)
+#define SWEEP_IRQ_ENTRY_NS                  (120U)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const uint32_t read_costs_ns[SWEEP_POINTS] = { 120U, 1000U, 30518U, 61036U };
+
+static latency_bench_report_t reports[SWEEP_POINTS];
+static latency_bench_report_t *current;
+static char uart_capture[512];
+
+
+/*******************************************************************************
+* Function Name: sweep_app
+********************************************************************************
+* Summary:
+*  The start-up of main() up to the benchmark, with the log sink on the
+*  simulated UART.
+*******************************************************************************/
+static void sweep_app(void)
+{
+    __enable_irq();
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == log_sink_init());
+
+    CY_ASSERT(CY_RSLT_SUCCESS == latency_bench_run(current, true));
+}
+
+
+/*******************************************************************************
+* Function Name: near
+********************************************************************************
+* Summary:
+*  Checks a cycle count against a modeled cost. A cost that is not a whole
+*  number of cycles counts one cycle more or less depending on where it
+*  falls.
+*******************************************************************************/
+static bool near(uint32_t measured, uint64_t ns)
+{
+    uint32_t cycles = (uint32_t)((ns * SystemCoreClock) / MCWDT_SIM_NS_PER_S);
+
+    return (measured == cycles) ||
+           ((measured == (cycles + 1U)) && (((ns * SystemCoreClock) % MCWDT_SIM_NS_PER_S) != 0U));
+}
+
+
+/*******************************************************************************
+* Function Name: software
+********************************************************************************
+* Summary:
+*  Tells whether a step is only code, which the simulator does not time.
+*******************************************************************************/
+static bool software(latency_bench_step_t step)
+{
+    return (LATENCY_BENCH_RING_PUSH == step) || (LATENCY_BENCH_FORMAT == step) ||
+           (LATENCY_BENCH_LOG_PRINTF == step);
+}
+
+
+/*******************************************************************************
+* Function Name: check
+********************************************************************************
+* Summary:
+*  Checks the steps that are made only of modeled costs. The cascaded reads
+*  take at least three register reads, and one more when Counter 1 moves
+*  between them. The software steps must take no time: a register access or
+*  a wait for the UART there would show up as cycles.
+*******************************************************************************/
+static bool check(latency_bench_report_t const *report, uint32_t read_ns)
+{
+    latency_bench_result_t const *s = report->steps;
+    uint64_t read = read_ns;
+    bool ok = true;
+    uint32_t i;
+
+    for (i = 0U; i < (uint32_t)LATENCY_BENCH_STEPS; i++)
+    {
+        ok = ok && (s[i].samples == (((latency_bench_step_t)i == LATENCY_BENCH_LOG_PRINTF) ?
+                                     LATENCY_BENCH_LOG_SAMPLES : LATENCY_BENCH_SAMPLES));
+        ok = ok && (!software((latency_bench_step_t)i) || (0U == s[i].max));
+    }
+
+    ok = ok && (0U == report->overhead);
+    ok = ok && near(s[LATENCY_BENCH_MCWDT_READ].min, read) && near(s[LATENCY_BENCH_MCWDT_READ].max, read);
+    ok = ok && near(s[LATENCY_BENCH_GPIO_READ].max, SWEEP_GPIO_READ_NS);
+    ok = ok && near(s[LATENCY_BENCH_TWO_READS].max, 2U * read);
+    ok = ok && near(s[LATENCY_BENCH_READ32].min, 3U * read) &&
+         (s[LATENCY_BENCH_READ32].max <= (s[LATENCY_BENCH_MCWDT_READ].max * 4U));
+    ok = ok && (s[LATENCY_BENCH_READ64].min >= s[LATENCY_BENCH_READ32].min);
+    ok = ok && near(s[LATENCY_BENCH_IRQ_ENTRY].min, SWEEP_IRQ_ENTRY_NS) &&
+         near(s[LATENCY_BENCH_IRQ_ENTRY].max, SWEEP_IRQ_ENTRY_NS);
+    ok = ok && (s[LATENCY_BENCH_IRQ_TIMESTAMP].min >=
+                (s[LATENCY_BENCH_IRQ_ENTRY].min + s[LATENCY_BENCH_READ64].min - 1U));
+    return ok;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    bool ok = true;
+    uint32_t i;
+    uint32_t k;
+
+    for (k = 0U; k < SWEEP_POINTS; k++)
+    {
+        mcwdt_sim_costs_t costs =
+        {
+            .mcwdt_read_ns = read_costs_ns[k],
+            .gpio_read_ns = SWEEP_GPIO_READ_NS,
+            .irq_entry_ns = SWEEP_IRQ_ENTRY_NS
+        };
+
+        current = &reports[k];
+        mcwdt_sim_reset();
+        mcwdt_sim_set_costs(&costs);
+        mcwdt_sim_set_uart_capture(uart_capture, sizeof(uart_capture));
+        if (MCWDT_SIM_RUN_RETURNED != mcwdt_sim_run(sweep_app, 0U))
+        {
+            return EXIT_FAILURE;
+        }
+        ok = ok && check(current, read_costs_ns[k]) && (0U != mcwdt_sim_uart_captured());
+    }
+
+    printf("Mean CPU cycles at %u Hz of %u samples; only modeled register accesses and\n"
+           "interrupt entry take time on the simulator\n\n",
+           (unsigned int)reports[0].core_clock_hz, LATENCY_BENCH_SAMPLES);
+    printf("%-28s |", "MCWDT read latency (ns)");
+    for (k = 0U; k < SWEEP_POINTS; k++)
+    {
+        printf(" %8u |", (unsigned int)read_costs_ns[k]);
+    }
+    printf(" max at %u ns\n", (unsigned int)read_costs_ns[SWEEP_POINTS - 1U]);
+    printf("-----------------------------|----------|----------|----------|----------|-----------\n");
+    for (i = 0U; i < (uint32_t)LATENCY_BENCH_STEPS; i++)
+    {
+        printf("%-28s |", latency_bench_step_name((latency_bench_step_t)i));
+        if (software((latency_bench_step_t)i))
+        {
+            printf(" code only, not timed on the simulator\n");
+            continue;
+        }
+        for (k = 0U; k < SWEEP_POINTS; k++)
+        {
+            printf(" %8u |", (unsigned int)reports[k].steps[i].mean);
+        }
+        printf(" %u\n", (unsigned int)reports[SWEEP_POINTS - 1U].steps[i].max);
+    }
+
+    printf("\nmake interval-bench times interval_format_ticks() on the host CPU\n");
+    printf("\n%s\n", ok ? "All register and interrupt steps match the model, and the code-only steps\n"
+                          "make no register access and do not wait for the UART" :
+                          "Steps do not match the model");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,284 @@
+/******************************************************************************
+* File Name:   lfclk_source_test.c
+*
+* Description: Runs the application start-up and press timing with and without a
+*              WCO, with ILOs far from nominal, IMO errors and a drifting ILO, and
+*              checks that every converted interval is within its reported bound.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "button_capture.h"
+#include "low_power.h"
+#include "lfclk_source.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Presses a minute apart for half an hour of virtual time */
+#define TEST_PRESS_PERIOD_S                 (60U)
+#define TEST_PRESSES                        (31U)
+#define TEST_FIRST_PRESS_S                  (5U)
+#define TEST_HOLD_MS                        (150U)
+
+/* ILO drift of the warming-up runs: this many ppm per minute */
+#define TEST_RAMP_PPM_PER_MIN               (500)
+
+/* Time into each interval at which the ILO warms up in the late ramp run */
+#define TEST_LATE_RAMP_S                    (45U)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    bool wco;                   /* WCO present                            */
+    bool wco_selected;          /* WCO selected at start-up even if absent */
+    uint32_t ilo_hz;            /* Untrimmed ILO frequency                */
+    int32_t imo_ppm;            /* Error of the IMO                       */
+    bool ramp;                  /* ILO drifts during the run              */
+    bool late_ramp;             /* ILO drifts late in each interval       */
+    bool tick;                  /* Main loop wakes on every Counter 2 tick */
+    bool trim;                  /* ILO is trimmed after start-up          */
+    uint32_t intervals;
+    uint32_t across_trims;      /* Intervals with a trim before their end */
+    double raw_max_pct;         /* Largest error taking ticks as WCO ticks */
+    double max_pct;             /* Largest error of the converted interval */
+    double max_bound_pct;       /* Largest reported bound                 */
+    uint32_t outside;           /* Intervals off by more than their bound */
+    lfclk_source_stats_t stats;
+} test_result_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static test_result_t *current;
+static uint32_t trims_before;
+
+
+/*******************************************************************************
+* Function Name: record_interval
+********************************************************************************
+* Summary:
+*  Compares an interval, converted and raw, with the time between the press
+*  edges, and checks it against its error bound. Counts the intervals that
+*  the ILO was trimmed in, or after the end of but before they are taken.
+*******************************************************************************/
+static void record_interval(uint64_t start, uint64_t raw)
+{
+    double truth = (double)TEST_PRESS_PERIOD_S * CY_SYSCLK_WCO_FREQ;
+    uint64_t ticks = lfclk_source_to_wco_ticks(start, raw);
+    double bound = (double)lfclk_source_error_ticks(start, raw);
+    lfclk_source_stats_t stats;
+    double error = (double)ticks - truth;
+    double raw_error = (double)raw - truth;
+
+    error = (error < 0.0) ? -error : error;
+    raw_error = (raw_error < 0.0) ? -raw_error : raw_error;
+    current->max_pct = (100.0 * error / truth > current->max_pct) ?
+                       (100.0 * error / truth) : current->max_pct;
+    current->raw_max_pct = (100.0 * raw_error / truth > current->raw_max_pct) ?
+                           (100.0 * raw_error / truth) : current->raw_max_pct;
+    current->max_bound_pct = (100.0 * bound / truth > current->max_bound_pct) ?
+                             (100.0 * bound / truth) : current->max_bound_pct;
+    current->outside += (error > bound) ? 1U : 0U;
+    current->intervals++;
+
+    lfclk_source_get_stats(&stats);
+    current->across_trims += (stats.trims != trims_before) ? 1U : 0U;
+    trims_before = stats.trims;
+}
+
+
+/*******************************************************************************
+* Function Name: test_app
+********************************************************************************
+* Summary:
+*  The start-up and main loop of main() with interrupt capture and LFCLK
+*  source detection.
+*******************************************************************************/
+static void test_app(void)
+{
+    uint64_t timestamp;
+    uint64_t previous = 0U;
+    uint32_t presses = 0U;
+    uint32_t intr_status;
+    int64_t ppb;
+
+    CY_ASSERT(CY_RSLT_SUCCESS == lfclk_source_init());
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == button_capture_init());
+    if (current->tick)
+    {
+        CY_ASSERT(CY_RSLT_SUCCESS == low_power_init());
+    }
+    lfclk_source_get_stats(&current->stats);
+    trims_before = current->stats.trims;
+
+    for (;;)
+    {
+        lfclk_source_service();
+
+        while (button_capture_get_press(&timestamp))
+        {
+            if (presses > 0U)
+            {
+                record_interval(previous, timestamp - previous);
+            }
+            previous = timestamp;
+            presses++;
+
+            /* The ILO warms up: its frequency rises after every press */
+            if (current->ramp)
+            {
+                ppb = (int64_t)presses * TEST_RAMP_PPM_PER_MIN * 1000;
+                mcwdt_sim_set_lfclk_ppb(ppb);
+            }
+        }
+
+        /* Sleep until the next Counter 2 tick in the runs that wake on it,
+         * which measure the ILO every LFCLK_SOURCE_MEASURE_PERIOD_S. The
+         * others keep polling while a measurement runs, as main() does
+         * instead of entering Deep Sleep. */
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        if (current->tick)
+        {
+            low_power_sleep(true);
+        }
+        else if (!button_capture_busy() && !lfclk_source_busy())
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(test_result_t *res)
+{
+    uint32_t i;
+
+    current = res;
+    mcwdt_sim_reset();
+    if (!res->wco)
+    {
+        mcwdt_sim_set_wco_present(false);
+        mcwdt_sim_set_ilo_hz(res->ilo_hz);
+    }
+    if (res->wco_selected)
+    {
+        Cy_SysClk_ClkLfSetSource(CY_SYSCLK_CLKLF_IN_WCO);
+    }
+    mcwdt_sim_set_imo_ppb((int64_t)res->imo_ppm * 1000);
+
+    for (i = 0U; i < TEST_PRESSES; i++)
+    {
+        mcwdt_sim_schedule_press((TEST_FIRST_PRESS_S + (i * TEST_PRESS_PERIOD_S)) * MCWDT_SIM_NS_PER_S,
+                                 TEST_HOLD_MS * MCWDT_SIM_NS_PER_MS);
+
+        /* Warm up well after the press, so that a trim comes late in the
+         * interval and most of its ticks were counted before it */
+        if (res->late_ramp)
+        {
+            mcwdt_sim_schedule_drift((TEST_FIRST_PRESS_S + (i * TEST_PRESS_PERIOD_S) +
+                                      TEST_LATE_RAMP_S) * MCWDT_SIM_NS_PER_S,
+                                     (int64_t)(i + 1U) * TEST_RAMP_PPM_PER_MIN * 1000);
+        }
+    }
+    (void)mcwdt_sim_run(test_app, (TEST_FIRST_PRESS_S + (TEST_PRESSES * TEST_PRESS_PERIOD_S)) *
+                                  MCWDT_SIM_NS_PER_S);
+    lfclk_source_get_stats(&res->stats);
+
+    printf("%-28s | %-3s %5u Hz | %9.3f %% | %9.4f %% | %9.4f %% | %4u | %5u | %6u | %u\n", res->name,
+           (CY_SYSCLK_CLKLF_IN_ILO == res->stats.source) ? "ILO" : "WCO",
+           (unsigned int)res->stats.frequency, res->raw_max_pct, res->max_pct, res->max_bound_pct,
+           (unsigned int)res->stats.measurements, (unsigned int)res->stats.trims, res->across_trims,
+           res->outside);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    test_result_t runs[] =
+    {
+        { .name = "WCO", .wco = true },
+        { .name = "ILO 32000 Hz", .ilo_hz = 32000U },
+        { .name = "ILO -30%", .ilo_hz = 22400U },
+        { .name = "ILO +30%", .ilo_hz = 41600U },
+        { .name = "ILO -30%, IMO -1.5%", .ilo_hz = 22400U, .imo_ppm = -15000 },
+        { .name = "ILO +30%, IMO +1.5%", .ilo_hz = 41600U, .imo_ppm = 15000 },
+        { .name = "ILO warming +500 ppm/min", .ilo_hz = 30000U, .ramp = true, .trim = true },
+        { .name = "ILO trimmed late, IMO +1.5%", .ilo_hz = 33500U, .imo_ppm = 15000,
+          .late_ramp = true, .tick = true, .trim = true },
+        { .name = "WCO selected but missing", .ilo_hz = 26000U, .wco_selected = true },
+    };
+    bool ok = true;
+    uint32_t i;
+
+    printf("%u presses %u s apart; errors are the largest of any interval\n\n",
+           TEST_PRESSES, TEST_PRESS_PERIOD_S);
+    printf("run                          | LFCLK        | raw error   | error       | bound       | meas | trims | across | outside\n");
+    printf("-----------------------------|--------------|-------------|-------------|-------------|------|-------|--------|--------\n");
+    for (i = 0U; i < (sizeof(runs) / sizeof(runs[0])); i++)
+    {
+        run(&runs[i]);
+        ok = ok && (0U == runs[i].outside) && ((TEST_PRESSES - 1U) == runs[i].intervals) &&
+             (runs[i].wco == (CY_SYSCLK_CLKLF_IN_WCO == runs[i].stats.source)) &&
+             (runs[i].wco_selected == runs[i].stats.fallback) &&
+             (runs[i].trim == (0U != runs[i].across_trims));
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,236 @@
+/******************************************************************************
+* File Name:   log_bench.c
+*
+* Description: Main-loop stall per event of blocking printf() against the
+*              double-buffered log sink, on the simulated debug UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <string.h>
+
+/* Output under test is called explicitly; the report goes to stdout */
+#define MCWDT_SIM_NO_RETARGET_PRINTF
+
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "mcwdt_sim.h"
+#include "log_sink.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Events are reported in bursts, as main() does when it drains several
+ * queued presses at once */
+#define BENCH_BURSTS                        (50U)
+#define BENCH_BURST_EVENTS                  (4U)
+#define BENCH_BURST_GAP_MS                  (1000U)
+
+#define BENCH_CAPTURE_SIZE                  (64U * 1024U)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef bool (*bench_print_t)(const char *format, ...);
+
+typedef struct
+{
+    const char *name;
+    bench_print_t print;
+    uint64_t banner_ns;         /* Virtual time main() spent printing the banner */
+    uint64_t event_sum_ns;
+    uint64_t event_max_ns;
+    uint64_t uart_wait_ns;
+    log_sink_stats_t log_stats;
+    char capture[BENCH_CAPTURE_SIZE];
+    size_t captured;
+} bench_result_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static bench_result_t *current;
+
+
+/*******************************************************************************
+* Function Name: blocking_print
+********************************************************************************
+* Summary:
+*  printf() through retarget-io, which waits for the UART TX FIFO.
+*******************************************************************************/
+static bool blocking_print(const char *format, ...)
+{
+    char line[256];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    return (mcwdt_sim_uart_printf("%s", line) >= 0);
+}
+
+
+/*******************************************************************************
+* Function Name: bench_app
+********************************************************************************
+* Summary:
+*  Prints the banner and the per-event lines of main() and measures how long
+*  the main loop is held up by each.
+*******************************************************************************/
+static void bench_app(void)
+{
+    bench_print_t print = current->print;
+    uint32_t intr_status;
+    uint64_t t0;
+    uint32_t i;
+    uint32_t k;
+
+    CY_ASSERT(CY_RSLT_SUCCESS == cy_retarget_io_init(0U, 0U, CY_RETARGET_IO_BAUDRATE));
+    if (print == log_sink_printf)
+    {
+        CY_ASSERT(CY_RSLT_SUCCESS == log_sink_init());
+    }
+
+    t0 = mcwdt_sim_now_ns();
+    print("\x1b[2J\x1b[;H");
+    print("*************** "
+          "PSoC 6 MCU: Multi-Counter Watchdog Timer Example "
+          "*************** \r\n\n");
+    print("\r\nMCWDT initialization is complete. Press the user button to "
+          "display the time between two presses of the user button. \r\n");
+    current->banner_ns = mcwdt_sim_now_ns() - t0;
+
+    for (i = 0U; i < BENCH_BURSTS; i++)
+    {
+        mcwdt_sim_advance_ns(BENCH_BURST_GAP_MS * MCWDT_SIM_NS_PER_MS);
+
+        for (k = 0U; k < BENCH_BURST_EVENTS; k++)
+        {
+            uint64_t stall;
+
+            t0 = mcwdt_sim_now_ns();
+            print("\r\nThe time between two presses of user button = %u.%06us\r\n",
+                  (unsigned int)(i + 1U), (unsigned int)(k * 125000U));
+            print("CPU active time = %u.%02u%% over %u wakeups\r\n",
+                  (unsigned int)k, (unsigned int)i, (unsigned int)((i * BENCH_BURST_EVENTS) + k));
+
+            stall = mcwdt_sim_now_ns() - t0;
+            current->event_sum_ns += stall;
+            current->event_max_ns = (stall > current->event_max_ns) ? stall : current->event_max_ns;
+        }
+    }
+
+    /* Let the background transfer finish */
+    for (;;)
+    {
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        if ((print == log_sink_printf) && log_sink_busy())
+        {
+            __WFI();
+            Cy_SysLib_ExitCriticalSection(intr_status);
+        }
+        else
+        {
+            Cy_SysLib_ExitCriticalSection(intr_status);
+            break;
+        }
+    }
+    mcwdt_sim_advance_ns(MCWDT_SIM_UART_FIFO_DEPTH * 100U * MCWDT_SIM_NS_PER_US);
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(bench_result_t *res)
+{
+    current = res;
+    mcwdt_sim_reset();
+    mcwdt_sim_set_uart_capture(res->capture, sizeof(res->capture));
+    CY_ASSERT(MCWDT_SIM_RUN_RETURNED == mcwdt_sim_run(bench_app, 0U));
+
+    res->captured = mcwdt_sim_uart_captured();
+    res->uart_wait_ns = mcwdt_sim_stats()->uart_wait_ns;
+    if (res->print == log_sink_printf)
+    {
+        log_sink_get_stats(&res->log_stats);
+    }
+
+    printf("%-18s | %10.3f | %14.3f | %13.3f | %14.1f\n", res->name,
+           (double)res->banner_ns / 1e6,
+           (double)res->event_sum_ns / 1e6 / (BENCH_BURSTS * BENCH_BURST_EVENTS),
+           (double)res->event_max_ns / 1e6,
+           (double)res->uart_wait_ns / 1e6);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    static bench_result_t blocking = { .name = "printf", .print = blocking_print };
+    static bench_result_t async = { .name = "log_sink_printf", .print = log_sink_printf };
+    bool same;
+
+    printf("%u bursts of %u events, two lines each, at %u baud with a %u-byte TX FIFO\n\n",
+           BENCH_BURSTS, BENCH_BURST_EVENTS, CY_RETARGET_IO_BAUDRATE, MCWDT_SIM_UART_FIFO_DEPTH);
+    printf("output             | banner(ms) | event mean(ms) | event max(ms) | UART wait(ms)\n");
+    printf("-------------------|------------|----------------|---------------|--------------\n");
+    run(&blocking);
+    run(&async);
+
+    same = (blocking.captured == async.captured) &&
+           (0 == memcmp(blocking.capture, async.capture, blocking.captured));
+
+    printf("\nUART output identical: %s (%zu bytes); log_sink: %u lines, %u dropped, "
+           "buffer high-water %u of %u bytes\n",
+           same ? "yes" : "NO", async.captured, async.log_stats.lines, async.log_stats.dropped,
+           async.log_stats.high_water, LOG_SINK_BUF_SIZE);
+    printf("Stall is the main-loop time spent waiting for the UART; formatting, the same\n"
+           "for both, is not modeled\n");
+
+    return (same && (0U == async.log_stats.dropped)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,401 @@
+/******************************************************************************
+* File Name:   long_run_test.c
+*
+* Description: Runs the application for weeks of virtual time with button
+*              presses, LFCLK drift changes and device resets scheduled at
+*              arbitrary times, and checks every interval it prints against
+*              the LFCLK ticks that really elapsed between the presses.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "interval_format.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TEST_MAX_PRESSES                    (1024U)
+#define TEST_CAPTURE_SIZE                   (1024U * 1024U)
+
+#define TEST_HOUR_S                         (3600U)
+#define TEST_DAY_S                          (24U * TEST_HOUR_S)
+
+/* How long each press is held, and the virtual time run after the last one */
+#define TEST_HOLD_NS                        (200U * MCWDT_SIM_NS_PER_MS)
+#define TEST_TAIL_NS                        (60U * MCWDT_SIM_NS_PER_S)
+
+/* Resets are kept this far from the presses around them, so that the
+ * application has booted before the next press */
+#define TEST_RESET_MARGIN_S                 (60U)
+
+/* The press is latched by its interrupt a few hundred nanoseconds after the
+ * edge, which may fall after the next LFCLK tick */
+#define TEST_MAX_ERROR_TICKS                (1U)
+
+#define TEST_REPORT_TEXT                    "The time between two presses of user button = "
+#define TEST_BOOT_TEXT                      "MCWDT initialization is complete"
+
+/* Counter values between which Counter1 of the 32-bit count wraps */
+#define TEST_WRAP_TICKS                     (1ULL << 32)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    uint32_t run_hours;
+    uint32_t gap_min_s;         /* Time between presses                     */
+    uint32_t gap_max_s;
+    uint32_t long_every;        /* One gap in this many is long, 0 for none  */
+    uint32_t long_min_s;
+    uint32_t long_max_s;
+    uint32_t drift_every_s;     /* LFCLK error changes this often, 0: never  */
+    uint32_t drift_max_ppm;     /* ... to a value within +/- this            */
+    uint32_t reset_every;       /* One gap in this many has a reset, 0: none */
+
+    /* Scheduled */
+    uint32_t presses;
+    uint32_t resets;
+    uint64_t press_ns[TEST_MAX_PRESSES];
+    uint64_t run_ns;
+
+    /* Observed */
+    uint32_t latched;           /* Presses whose interval has been recorded */
+    uint32_t long_gaps;         /* Intervals longer than the counter wrap   */
+    uint64_t anchor_tick;       /* LFCLK tick of the last press or boot     */
+    uint64_t expected[TEST_MAX_PRESSES];    /* LFCLK ticks of each interval */
+    uint32_t reports;
+    uint32_t boots;
+    uint32_t bad;
+    uint64_t max_error_us;
+    uint64_t wall_ns;
+    size_t   captured;
+} test_scenario_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static char capture[TEST_CAPTURE_SIZE];
+static char first_capture[TEST_CAPTURE_SIZE];
+static test_scenario_t *current;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+extern int app_main(void);
+
+
+/*******************************************************************************
+* Function Name: rng_between
+********************************************************************************
+* Summary:
+*  Returns a random time between min_s and max_s seconds, in nanoseconds with
+*  a random sub-second part so that events fall anywhere within an LFCLK tick.
+*******************************************************************************/
+static uint64_t rng_between(uint32_t min_s, uint32_t max_s)
+{
+    return ((uint64_t)(min_s + bench_util_rng_range(max_s - min_s + 1U)) * MCWDT_SIM_NS_PER_S) +
+           bench_util_rng_range((uint32_t)MCWDT_SIM_NS_PER_S);
+}
+
+
+/*******************************************************************************
+* Function Name: app
+********************************************************************************
+* Summary:
+*  Starts the application on power-up and after every reset, from which the
+*  first press after it is timed.
+*******************************************************************************/
+static void app(void)
+{
+    current->anchor_tick = mcwdt_sim_lfclk_ticks();
+    (void)app_main();
+}
+
+
+/*******************************************************************************
+* Function Name: on_irq
+********************************************************************************
+* Summary:
+*  Records the LFCLK ticks elapsed up to a press when its interrupt is taken,
+*  under the LFCLK error in force at the time.
+*******************************************************************************/
+static void on_irq(uint32_t irqn)
+{
+    test_scenario_t *s = current;
+    uint64_t tick;
+
+    if ((uint32_t)CYBSP_USER_BTN_IRQ != irqn)
+    {
+        return;
+    }
+    tick = mcwdt_sim_lfclk_ticks();
+    while ((s->latched < s->presses) && (s->press_ns[s->latched] <= mcwdt_sim_now_ns()))
+    {
+        s->expected[s->latched] = tick - s->anchor_tick;
+        if (s->expected[s->latched] >= TEST_WRAP_TICKS)
+        {
+            s->long_gaps++;
+        }
+        s->anchor_tick = tick;
+        s->latched++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: schedule
+********************************************************************************
+* Summary:
+*  Schedules the presses, drift changes and resets of a scenario.
+*******************************************************************************/
+static void schedule(test_scenario_t *s)
+{
+    uint64_t end_ns = (uint64_t)s->run_hours * TEST_HOUR_S * MCWDT_SIM_NS_PER_S;
+    uint64_t t_ns;
+    uint64_t gap_ns;
+    uint64_t reset_ns;
+    int64_t ppb;
+
+    bench_util_rng_seed(BENCH_UTIL_RNG_SEED);
+    mcwdt_sim_reset();
+    mcwdt_sim_set_irq_hook(on_irq);
+
+    if (0U != s->drift_every_s)
+    {
+        for (t_ns = rng_between(0U, s->drift_every_s); t_ns < end_ns;
+             t_ns += rng_between(s->drift_every_s / 2U, s->drift_every_s))
+        {
+            ppb = ((int64_t)bench_util_rng_range((2U * s->drift_max_ppm * 1000U) + 1U)) -
+                  ((int64_t)s->drift_max_ppm * 1000);
+            mcwdt_sim_schedule_drift(t_ns, ppb);
+        }
+    }
+
+    s->presses = 0U;
+    s->resets = 0U;
+    t_ns = 0U;
+    for (;;)
+    {
+        if ((0U != s->long_every) && (0U == bench_util_rng_range(s->long_every)))
+        {
+            gap_ns = rng_between(s->long_min_s, s->long_max_s);
+        }
+        else
+        {
+            gap_ns = rng_between(s->gap_min_s, s->gap_max_s);
+        }
+        if (((t_ns + gap_ns + TEST_TAIL_NS) > end_ns) || (s->presses == TEST_MAX_PRESSES))
+        {
+            break;
+        }
+
+        if ((0U != s->reset_every) && (0U == bench_util_rng_range(s->reset_every)) &&
+            (gap_ns >= (4U * TEST_RESET_MARGIN_S * MCWDT_SIM_NS_PER_S)))
+        {
+            reset_ns = t_ns + rng_between(TEST_RESET_MARGIN_S,
+                                          (uint32_t)(gap_ns / MCWDT_SIM_NS_PER_S) -
+                                          (2U * TEST_RESET_MARGIN_S));
+            mcwdt_sim_schedule_reset(reset_ns);
+            s->resets++;
+        }
+
+        t_ns += gap_ns;
+        mcwdt_sim_schedule_press(t_ns, TEST_HOLD_NS);
+        s->press_ns[s->presses] = t_ns;
+        s->presses++;
+    }
+    s->run_ns = t_ns + TEST_TAIL_NS;
+}
+
+
+/*******************************************************************************
+* Function Name: check
+********************************************************************************
+* Summary:
+*  Counts the boot banners in the captured UART output, and checks each
+*  interval printed against the one expected for that press.
+*******************************************************************************/
+static void check(test_scenario_t *s)
+{
+    char const *p;
+    unsigned long long sec;
+    unsigned long long usec;
+    uint64_t want_us;
+    uint64_t got_us;
+    uint64_t error_us;
+
+    s->boots = 0U;
+    for (p = capture; NULL != (p = strstr(p, TEST_BOOT_TEXT)); p++)
+    {
+        s->boots++;
+    }
+
+    s->reports = 0U;
+    s->bad = 0U;
+    s->max_error_us = 0U;
+    for (p = capture; NULL != (p = strstr(p, TEST_REPORT_TEXT)); p++)
+    {
+        if ((2 != sscanf(p + strlen(TEST_REPORT_TEXT), "%llu.%6llus", &sec, &usec)) ||
+            (s->reports == s->latched))
+        {
+            s->bad++;
+            continue;
+        }
+        got_us = (sec * 1000000ULL) + usec;
+        want_us = interval_ticks_to_us(s->expected[s->reports]);
+        error_us = (got_us > want_us) ? (got_us - want_us) : (want_us - got_us);
+        if (error_us > s->max_error_us)
+        {
+            s->max_error_us = error_us;
+        }
+        if (error_us > interval_ticks_to_us(TEST_MAX_ERROR_TICKS))
+        {
+            printf("  %s: press %u printed %llu.%06llus, expected %llu.%06llus\n", s->name,
+                   s->reports + 1U, sec, usec, (unsigned long long)(want_us / 1000000U),
+                   (unsigned long long)(want_us % 1000000U));
+            s->bad++;
+        }
+        s->reports++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(test_scenario_t *s)
+{
+    uint64_t t0;
+
+    current = s;
+    s->latched = 0U;
+    s->long_gaps = 0U;
+    schedule(s);
+    memset(capture, 0, sizeof(capture));
+    mcwdt_sim_set_uart_capture(capture, sizeof(capture) - 1U);
+
+    t0 = bench_util_wall_ns();
+    (void)mcwdt_sim_run(app, s->run_ns);
+    s->wall_ns = bench_util_wall_ns() - t0;
+    s->captured = mcwdt_sim_uart_captured();
+    check(s);
+
+    printf("%-8s | %5u | %7u | %6u | %9u | %7u | %6u | %11llu | %7.3f | %9.0f\n",
+           s->name, s->run_hours, s->presses, s->resets, s->long_gaps, s->reports, s->boots,
+           (unsigned long long)s->max_error_us, (double)s->wall_ns / 1e9,
+           (double)s->run_ns / (double)s->wall_ns);
+}
+
+
+/*******************************************************************************
+* Function Name: passed
+*******************************************************************************/
+static bool passed(test_scenario_t const *s)
+{
+    return (s->reports == s->presses) && (s->latched == s->presses) && (s->boots == (s->resets + 1U)) && (0U == s->bad);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    /* Presses hours apart with some days apart, across the 36.4 h wrap of the
+     * 32-bit count, while the LFCLK error wanders by up to 100 ppm */
+    static test_scenario_t weeks = {
+        .name = "weeks", .run_hours = 21U * 24U,
+        .gap_min_s = 5U * TEST_HOUR_S, .gap_max_s = 11U * TEST_HOUR_S,
+        .long_every = 5U, .long_min_s = 40U * TEST_HOUR_S, .long_max_s = 80U * TEST_HOUR_S,
+        .drift_every_s = TEST_DAY_S, .drift_max_ppm = 100U };
+    /* The same with device resets between presses */
+    static test_scenario_t resets = {
+        .name = "resets", .run_hours = 21U * 24U,
+        .gap_min_s = 5U * TEST_HOUR_S, .gap_max_s = 11U * TEST_HOUR_S,
+        .long_every = 5U, .long_min_s = 40U * TEST_HOUR_S, .long_max_s = 80U * TEST_HOUR_S,
+        .drift_every_s = TEST_DAY_S, .drift_max_ppm = 100U, .reset_every = 4U };
+    /* Presses days apart, each interval across at least one wrap */
+    static test_scenario_t sparse = {
+        .name = "sparse", .run_hours = 56U * 24U,
+        .gap_min_s = 2U * TEST_DAY_S, .gap_max_s = 5U * TEST_DAY_S,
+        .drift_every_s = 7U * TEST_DAY_S, .drift_max_ppm = 50U };
+    /* Presses seconds to minutes apart, as a user would make them */
+    static test_scenario_t burst = {
+        .name = "burst", .run_hours = 2U,
+        .gap_min_s = 1U, .gap_max_s = 600U,
+        .drift_every_s = 600U, .drift_max_ppm = 100U, .reset_every = 4U };
+    static test_scenario_t again;
+    bool same;
+    bool ok;
+
+    printf("Application runs with presses, LFCLK drift and resets at random virtual times;\n"
+           "errors are printed intervals against the LFCLK ticks between the presses\n\n");
+    printf("scenario | hours | presses | resets | long gaps | reports | boots  | max err(us) | wall(s) | speed-up\n");
+    printf("---------|-------|---------|--------|-----------|---------|--------|-------------|---------|---------\n");
+    run(&weeks);
+    run(&resets);
+    memcpy(first_capture, capture, sizeof(capture));
+    run(&sparse);
+    run(&burst);
+
+    /* The same scenario must produce the same output, character for character */
+    again = resets;
+    run(&again);
+    same = (again.captured == resets.captured) &&
+           (0 == memcmp(first_capture, capture, sizeof(capture)));
+    printf("\nsecond run of \"%s\": %s output\n", resets.name, same ? "same" : "different");
+
+    ok = passed(&weeks) && passed(&resets) && passed(&sparse) && passed(&burst) && same &&
+         (weeks.long_gaps > 0U) && (sparse.long_gaps == sparse.presses) &&
+         (resets.resets > 0U) && (burst.resets > 0U);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
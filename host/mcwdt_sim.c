@@ -0,0 +1,2204 @@
+/******************************************************************************
+* File Name:   mcwdt_sim.c
+*
+* Description: Host-side simulator of the PSoC 6 MCWDT block, GPIO inputs and the
+*              CM4 interrupt controller, driven by a virtual clock. Counter0 and
+*              Counter1 cascade the same way as on silicon and are clocked by an
+*              LFCLK from the WCO or a trimmable ILO, with optional ppb drift.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* This file implements the retarget-io printf() itself */
+#define MCWDT_SIM_NO_RETARGET_PRINTF
+
+#include "cybsp.h"
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include "mcwdt_sim.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Nominal LFCLK frequency scaled by 1e9 so that drift can be given in ppb */
+#define SIM_PPB_SCALE                       (1000000000LL)
+#define SIM_NS_X_SCALE                      ((unsigned __int128)SIM_PPB_SCALE * \
+                                             MCWDT_SIM_NS_PER_S)
+
+/* 16-bit counter range of Counter0 and Counter1 */
+#define SIM_C16_RANGE                       (65536ULL)
+
+/* Guard against an ISR that never clears its interrupt source */
+#define SIM_MAX_ISR_REENTRY                 (1000U)
+
+#define SIM_NEVER                           (UINT64_MAX)
+#define SIM_CACHE_STALE                     (0ULL)
+
+/* Default modeled register access costs */
+#define SIM_DEFAULT_MCWDT_READ_NS           (120U)
+#define SIM_DEFAULT_GPIO_READ_NS            (20U)
+#define SIM_DEFAULT_DEEPSLEEP_WAKEUP_NS     (20000U)
+
+/* Exception entry of the Cortex-M4: 12 cycles of stacking and vector fetch */
+#define SIM_DEFAULT_IRQ_ENTRY_NS            (120U)
+
+/* CPU clock, which also clocks SysTick */
+#define SIM_CORE_CLOCK_HZ                   (100000000UL)
+
+/* Value kept in SysTick VAL so that any write by the application, which can
+ * only be 24 bits wide, is noticed */
+#define SIM_SYSTICK_VAL_UNWRITTEN           (0xFFFFFFFFUL)
+
+/* Untrimmed ILO frequency unless set with mcwdt_sim_set_ilo_hz() */
+#define SIM_DEFAULT_ILO_HZ                  (CY_SYSCLK_ILO_FREQ)
+
+/* Cy_SysClk_IloTrim() aims at the WCO frequency in steps of 1.5% of it, over
+ * the range of the 6-bit trim field */
+#define SIM_ILO_TRIM_TARGET_HZ              (CY_SYSCLK_WCO_FREQ)
+#define SIM_ILO_TRIM_STEP_HZ                (((CY_SYSCLK_WCO_FREQ * 15UL) + 999UL) / 1000UL)
+#define SIM_ILO_TRIM_MIN                    (-32)
+#define SIM_ILO_TRIM_MAX                    (31)
+
+/* Largest count of the first clock measurement counter */
+#define SIM_MEAS_COUNT1_MAX                 (0xFFFFFFUL)
+
+/* UART frame: start bit, 8 data bits, stop bit */
+#define SIM_UART_BITS_PER_CHAR              (10U)
+
+/* Longest line printf() can send in one call */
+#define SIM_UART_PRINTF_MAX                 (1024U)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+struct mcwdt_sim_gpio_port
+{
+    uint32_t in;                /* Input levels                          */
+    uint32_t out;               /* Output latch                          */
+    uint32_t intr;              /* Edge-detect status                    */
+    uint32_t intr_mask;
+    uint32_t edge[32];          /* CY_GPIO_INTR_xxx per pin              */
+    IRQn_Type irqn;
+};
+
+struct mcwdt_sim_block
+{
+    uint32_t enabled;           /* CY_MCWDT_CTRx bits                    */
+    uint32_t cnt[3];
+    uint32_t match[2];
+    cy_en_mcwdtmode_t mode[3];
+    bool     clear[2];
+    bool     cascade01;
+    bool     cascade12;
+    uint32_t toggle_bit;
+    uint32_t intr;
+    uint32_t intr_mask;
+    uint32_t unhandled[3];      /* Matches since the interrupt was cleared */
+    uint64_t tick;              /* LFCLK tick the counter state reflects */
+    IRQn_Type irqn;
+};
+
+typedef enum
+{
+    SIM_EVENT_PIN,          /* A pin changes level                          */
+    SIM_EVENT_UART_RX,      /* A character arrives on the debug UART        */
+    SIM_EVENT_DRIFT,        /* The LFCLK frequency error changes            */
+    SIM_EVENT_RESET         /* The device resets, as from its reset pin     */
+} sim_event_kind_t;
+
+typedef struct
+{
+    uint64_t t_ns;
+    uint64_t seq;
+    sim_event_kind_t kind;
+    GPIO_PRT_Type *port;
+    uint32_t pin;
+    uint32_t level;         /* Pin level, or the received character */
+    int64_t  ppb;           /* New LFCLK frequency error */
+} sim_event_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+GPIO_PRT_Type mcwdt_sim_gpio_prt0, mcwdt_sim_gpio_prt1, mcwdt_sim_gpio_prt2,
+              mcwdt_sim_gpio_prt3, mcwdt_sim_gpio_prt4, mcwdt_sim_gpio_prt5,
+              mcwdt_sim_gpio_prt6, mcwdt_sim_gpio_prt7, mcwdt_sim_gpio_prt8,
+              mcwdt_sim_gpio_prt9, mcwdt_sim_gpio_prt10, mcwdt_sim_gpio_prt11,
+              mcwdt_sim_gpio_prt12, mcwdt_sim_gpio_prt13, mcwdt_sim_gpio_prt14;
+
+MCWDT_STRUCT_Type mcwdt_sim_mcwdt_struct0, mcwdt_sim_mcwdt_struct1;
+
+SysTick_Type mcwdt_sim_systick;
+
+CoreDebug_Type mcwdt_sim_coredebug;
+static DWT_Type sim_dwt;
+uint32_t SystemCoreClock = SIM_CORE_CLOCK_HZ;
+
+/* Applications without a SysTick handler link without one */
+void SysTick_Handler(void) __attribute__((weak));
+
+static GPIO_PRT_Type *const sim_ports[MCWDT_SIM_GPIO_PORTS] =
+{
+    GPIO_PRT0, GPIO_PRT1, GPIO_PRT2, GPIO_PRT3, GPIO_PRT4, GPIO_PRT5, GPIO_PRT6,
+    GPIO_PRT7, GPIO_PRT8, GPIO_PRT9, GPIO_PRT10, GPIO_PRT11, GPIO_PRT12,
+    GPIO_PRT13, GPIO_PRT14
+};
+
+static MCWDT_STRUCT_Type *const sim_blocks[MCWDT_SIM_MCWDT_BLOCKS] =
+{
+    MCWDT_STRUCT0, MCWDT_STRUCT1
+};
+
+/* Mirrors the MCWDT_0 settings of templates/TARGET_xxx/config/design.modus */
+const cy_stc_mcwdt_config_t MCWDT_0_config =
+{
+    .c0Match = 65535U,
+    .c1Match = 65535U,
+    .c0Mode = CY_MCWDT_MODE_NONE,
+    .c1Mode = CY_MCWDT_MODE_NONE,
+    .c2ToggleBit = 16U,
+    .c2Mode = CY_MCWDT_MODE_NONE,
+    .c0ClearOnMatch = false,
+    .c1ClearOnMatch = false,
+    .c0c1Cascade = true,
+    .c1c2Cascade = false,
+};
+
+static struct
+{
+    uint64_t now_ns;
+    uint64_t until_ns;
+
+    /* LFCLK phase anchor; the clock rate may change at any time */
+    uint64_t anchor_ns;
+    uint64_t anchor_tick;
+    unsigned __int128 lfclk_scaled;
+
+    /* LFCLK source. The drift applies to whichever source is selected; the
+     * ILO runs at ilo_hz plus ilo_trim trim steps. A WCO that is absent but
+     * selected is not modeled: it counts as if present. */
+    int64_t  lfclk_ppb;
+    cy_en_clklf_in_sources_t lfclk_source;
+    bool     wco_absent;
+    uint32_t ilo_hz;
+    int32_t  ilo_trim;
+    int64_t  imo_ppb;
+
+    /* Clock measurement counters: counting until meas_done_ns, with
+     * meas_count2 IMO cycles counted in the meantime */
+    bool     meas_active;
+    bool     meas_valid;
+    uint64_t meas_done_ns;
+    uint32_t meas_count1;
+    uint32_t meas_count2;
+    uint32_t meas_polls;
+
+    /* sim_ticks_at() returns cached_tick for times in [cached_lo_ns, cached_hi_ns) */
+    uint64_t cached_lo_ns;
+    uint64_t cached_hi_ns;
+    uint64_t cached_tick;
+
+    /* Cached result of sim_mcwdt_next_event_ns(), SIM_CACHE_STALE if unknown */
+    uint64_t wdt_next_ns;
+
+    mcwdt_sim_costs_t costs;
+    mcwdt_sim_stats_t stats;
+
+    sim_event_t *events;
+    size_t   event_count;
+    size_t   event_capacity;
+    uint64_t event_seq;
+
+    cy_israddress vector[SIM_IRQ_COUNT];
+    uint64_t nvic_enabled;      /* Bit n: IRQ n enabled                */
+    uint64_t nvic_pending;      /* Bit n: IRQ n pended by software     */
+    bool     primask;
+    bool     in_isr;
+    bool     deepsleep;
+    mcwdt_sim_irq_hook_t irq_hook;
+    cy_stc_syspm_callback_t *syspm_callbacks;
+    bool     exclusive_monitor;
+
+    /* Spin detection for polling loops */
+    GPIO_PRT_Type *spin_port;
+    uint32_t spin_pin;
+    uint32_t spin_value;
+    uint32_t spin_reads;
+
+    /* Debug UART. Characters leave the TX FIFO one every uart_char_ns; the
+     * last one queued so far has been sent at uart_idle_ns. */
+    uint64_t uart_char_ns;
+    uint64_t uart_idle_ns;
+    const char *uart_async_buf;             /* Buffer of the async write  */
+    size_t   uart_async_len;
+    uint64_t uart_async_done_ns;            /* SIM_NEVER when none        */
+    uint32_t uart_events;                   /* Enabled cyhal_uart_event_t */
+    bool     uart_intr;
+    cyhal_uart_event_callback_t uart_callback;
+    void    *uart_callback_arg;
+    uint8_t  uart_rx_fifo[MCWDT_SIM_UART_FIFO_DEPTH];
+    uint32_t uart_rx_head;                  /* Free-running FIFO indices  */
+    uint32_t uart_rx_tail;
+    char    *uart_capture;                  /* NULL: echo to stdout       */
+    size_t   uart_capture_size;
+    size_t   uart_capture_len;
+
+    /* SysTick as last seen, and the time of its next expiry */
+    uint32_t systick_ctrl;
+    uint64_t systick_next_ns;               /* SIM_NEVER when stopped     */
+    bool     systick_pending;
+
+    /* Busy time up to which DWT CYCCNT has been counted */
+    uint64_t dwt_busy_ns;
+
+    jmp_buf  run_env;
+    bool     running;
+} sim;
+
+cyhal_uart_t cy_retarget_io_uart_obj;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void sim_run_until(uint64_t t_end, bool sleeping);
+static void sim_uart_complete(void);
+static void sim_uart_receive(uint8_t c);
+static bool sim_uart_rx_intr(void);
+
+
+/*******************************************************************************
+* LFCLK time base
+*******************************************************************************/
+
+/* LFCLK tick count at virtual time t_ns */
+static uint64_t sim_ticks_from_anchor(uint64_t t_ns)
+{
+    unsigned __int128 elapsed = (unsigned __int128)(t_ns - sim.anchor_ns);
+
+    return sim.anchor_tick + (uint64_t)((elapsed * sim.lfclk_scaled) / SIM_NS_X_SCALE);
+}
+
+uint64_t mcwdt_sim_tick_time_ns(uint64_t tick);
+
+/* Time mostly moves in steps far shorter than an LFCLK cycle, so the tick
+ * period around the last lookup is cached */
+static uint64_t sim_ticks_at(uint64_t t_ns)
+{
+    if ((t_ns < sim.cached_lo_ns) || (t_ns >= sim.cached_hi_ns))
+    {
+        sim.cached_tick = sim_ticks_from_anchor(t_ns);
+        sim.cached_lo_ns = mcwdt_sim_tick_time_ns(sim.cached_tick);
+        sim.cached_hi_ns = mcwdt_sim_tick_time_ns(sim.cached_tick + 1U);
+        if (sim.cached_lo_ns > t_ns)
+        {
+            sim.cached_lo_ns = t_ns;
+        }
+    }
+    return sim.cached_tick;
+}
+
+/* Earliest virtual time at which the LFCLK tick count reaches tick */
+uint64_t mcwdt_sim_tick_time_ns(uint64_t tick)
+{
+    unsigned __int128 num;
+
+    if (tick <= sim.anchor_tick)
+    {
+        return sim.anchor_ns;
+    }
+
+    num = (unsigned __int128)(tick - sim.anchor_tick) * SIM_NS_X_SCALE;
+    return sim.anchor_ns + (uint64_t)((num + sim.lfclk_scaled - 1U) / sim.lfclk_scaled);
+}
+
+/* Frequency of the ILO in Hz, without drift */
+static uint32_t sim_ilo_hz(void)
+{
+    return (uint32_t)((int64_t)sim.ilo_hz + ((int64_t)sim.ilo_trim * (int64_t)SIM_ILO_TRIM_STEP_HZ));
+}
+
+/* Restarts the LFCLK from the current tick at the rate of the selected source */
+static void sim_lfclk_update(void)
+{
+    uint32_t hz = (CY_SYSCLK_CLKLF_IN_ILO == sim.lfclk_source) ? sim_ilo_hz() : CY_SYSCLK_WCO_FREQ;
+
+    sim.anchor_tick = (sim.lfclk_scaled != 0U) ? sim_ticks_from_anchor(sim.now_ns) : 0U;
+    sim.anchor_ns = sim.now_ns;
+    sim.lfclk_scaled = (unsigned __int128)hz * (unsigned __int128)(SIM_PPB_SCALE + sim.lfclk_ppb);
+    sim.wdt_next_ns = SIM_CACHE_STALE;
+    sim.cached_lo_ns = SIM_NEVER;
+    sim.cached_hi_ns = 0U;
+}
+
+void mcwdt_sim_set_lfclk_ppb(int64_t ppb)
+{
+    sim.lfclk_ppb = ppb;
+    sim_lfclk_update();
+}
+
+/* Without a WCO, LFCLK starts from the ILO, as when clock start-up falls back */
+void mcwdt_sim_set_wco_present(bool present)
+{
+    sim.wco_absent = !present;
+    sim.lfclk_source = present ? CY_SYSCLK_CLKLF_IN_WCO : CY_SYSCLK_CLKLF_IN_ILO;
+    sim_lfclk_update();
+}
+
+/* Frequency of the untrimmed ILO */
+void mcwdt_sim_set_ilo_hz(uint32_t hz)
+{
+    sim.ilo_hz = hz;
+    sim_lfclk_update();
+}
+
+/* Error of the IMO, which clocks the measurement counters */
+void mcwdt_sim_set_imo_ppb(int64_t ppb)
+{
+    sim.imo_ppb = ppb;
+}
+
+
+/*******************************************************************************
+* MCWDT counter model
+*
+* Counter0 counts LFCLK. Counter1 counts LFCLK, or when cascaded, increments on
+* the cycle after Counter0 equals its match value. Counter2 is 32 bits and
+* counts LFCLK or, when cascaded, the cycle after Counter1 equals its match.
+* A match event is raised when a 16-bit counter becomes equal to its match
+* value; Counter2 raises one whenever its toggle bit changes.
+*******************************************************************************/
+
+static uint64_t sim_c16_period(const MCWDT_STRUCT_Type *b, uint32_t i)
+{
+    return b->clear[i] ? ((uint64_t)b->match[i] + 1U) : SIM_C16_RANGE;
+}
+
+/* Increments from the current value until the counter equals its match value
+ * (0 if it equals it already) */
+static uint64_t sim_c16_to_match(const MCWDT_STRUCT_Type *b, uint32_t i)
+{
+    uint64_t v = b->cnt[i];
+    uint64_t m = b->match[i];
+
+    return (v <= m) ? (m - v) : (SIM_C16_RANGE - v + m);
+}
+
+/* Applies n increments to a 16-bit counter. Returns the number of carries into
+ * the next counter of the cascade; *hits receives the number of match events. */
+static uint64_t sim_c16_step(MCWDT_STRUCT_Type *b, uint32_t i, uint64_t n, uint64_t *hits)
+{
+    uint64_t p = sim_c16_period(b, i);
+    uint64_t h = sim_c16_to_match(b, i);
+    uint64_t first_hit = (h > 0U) ? h : p;
+    uint64_t carries = (n > h) ? (1U + ((n - 1U - h) / p)) : 0U;
+
+    *hits = (n >= first_hit) ? (1U + ((n - first_hit) / p)) : 0U;
+
+    if (n <= h)
+    {
+        b->cnt[i] = (uint32_t)((b->cnt[i] + n) % SIM_C16_RANGE);
+    }
+    else
+    {
+        b->cnt[i] = (uint32_t)(((uint64_t)b->match[i] + (n - h)) % p);
+    }
+
+    return carries;
+}
+
+/* Increments of Counter i needed before its carry number 'carries' (>= 1) */
+static uint64_t sim_c16_incs_for_carries(const MCWDT_STRUCT_Type *b, uint32_t i,
+                                         uint64_t carries)
+{
+    if (carries == SIM_NEVER)
+    {
+        return SIM_NEVER;
+    }
+    return sim_c16_to_match(b, i) + 1U + ((carries - 1U) * sim_c16_period(b, i));
+}
+
+/* LFCLK ticks needed to give Counter1 n increments */
+static uint64_t sim_c1_ticks_for_incs(const MCWDT_STRUCT_Type *b, uint64_t n)
+{
+    if ((n == SIM_NEVER) || (0U == (b->enabled & CY_MCWDT_CTR1)))
+    {
+        return SIM_NEVER;
+    }
+    if (!b->cascade01)
+    {
+        return n;
+    }
+    if (0U == (b->enabled & CY_MCWDT_CTR0))
+    {
+        return SIM_NEVER;
+    }
+    return sim_c16_incs_for_carries(b, 0U, n);
+}
+
+/* LFCLK ticks needed to give Counter2 n increments */
+static uint64_t sim_c2_ticks_for_incs(const MCWDT_STRUCT_Type *b, uint64_t n)
+{
+    if (0U == (b->enabled & CY_MCWDT_CTR2))
+    {
+        return SIM_NEVER;
+    }
+    if (!b->cascade12)
+    {
+        return n;
+    }
+    return sim_c1_ticks_for_incs(b, sim_c16_incs_for_carries(b, 1U, n));
+}
+
+/* True if a match event of counter i needs to be simulated at the exact tick:
+ * it resets the device or raises an unmasked interrupt. Other events only set
+ * a status bit, which sim_mcwdt_sync() does in bulk. */
+static bool sim_mcwdt_timed(const MCWDT_STRUCT_Type *b, uint32_t i)
+{
+    return (CY_MCWDT_MODE_RESET == b->mode[i]) || (CY_MCWDT_MODE_INT_RESET == b->mode[i]) ||
+           ((CY_MCWDT_MODE_INT == b->mode[i]) && (0U != (b->intr_mask & (1UL << i))));
+}
+
+/* LFCLK ticks until the block next raises an interrupt or reset event */
+static uint64_t sim_mcwdt_ticks_to_event(const MCWDT_STRUCT_Type *b)
+{
+    uint64_t next = SIM_NEVER;
+    uint64_t t;
+    uint64_t h;
+
+    if (sim_mcwdt_timed(b, 0U) && (0U != (b->enabled & CY_MCWDT_CTR0)))
+    {
+        h = sim_c16_to_match(b, 0U);
+        next = (h > 0U) ? h : sim_c16_period(b, 0U);
+    }
+
+    if (sim_mcwdt_timed(b, 1U))
+    {
+        h = sim_c16_to_match(b, 1U);
+        t = sim_c1_ticks_for_incs(b, (h > 0U) ? h : sim_c16_period(b, 1U));
+        next = (t < next) ? t : next;
+    }
+
+    if (sim_mcwdt_timed(b, 2U))
+    {
+        uint64_t span = 1ULL << b->toggle_bit;
+        t = sim_c2_ticks_for_incs(b, span - (b->cnt[2] & (span - 1U)));
+        next = (t < next) ? t : next;
+    }
+
+    return next;
+}
+
+static void sim_device_reset(const char *source);
+
+static void sim_mcwdt_raise(MCWDT_STRUCT_Type *b, uint32_t i, uint64_t hits)
+{
+    uint32_t bit = 1UL << i;
+
+    sim.wdt_next_ns = SIM_CACHE_STALE;
+
+    switch (b->mode[i])
+    {
+        case CY_MCWDT_MODE_INT:
+            b->intr |= bit;
+            break;
+        case CY_MCWDT_MODE_RESET:
+            sim_device_reset("MCWDT");
+            break;
+        case CY_MCWDT_MODE_INT_RESET:
+            /* The third interrupt not cleared in between resets */
+            b->unhandled[i] += (hits < 3U) ? (uint32_t)hits : 3U;
+            if (b->unhandled[i] >= 3U)
+            {
+                sim_device_reset("MCWDT");
+            }
+            b->intr |= bit;
+            break;
+        default:
+            break;
+    }
+}
+
+/* Brings a block's counters up to LFCLK tick 'tick' */
+static void sim_mcwdt_sync(MCWDT_STRUCT_Type *b, uint64_t tick)
+{
+    uint64_t n = tick - b->tick;
+    uint64_t carries0 = 0U;
+    uint64_t carries1 = 0U;
+    uint64_t hits[3] = {0U, 0U, 0U};
+    uint32_t i;
+
+    if (tick <= b->tick)
+    {
+        return;
+    }
+    b->tick = tick;
+
+    if (0U != (b->enabled & CY_MCWDT_CTR0))
+    {
+        carries0 = sim_c16_step(b, 0U, n, &hits[0]);
+    }
+    if (0U != (b->enabled & CY_MCWDT_CTR1))
+    {
+        carries1 = sim_c16_step(b, 1U, b->cascade01 ? carries0 : n, &hits[1]);
+    }
+    if (0U != (b->enabled & CY_MCWDT_CTR2))
+    {
+        uint64_t incs = b->cascade12 ? carries1 : n;
+        uint64_t v = b->cnt[2];
+
+        hits[2] = ((v + incs) >> b->toggle_bit) - (v >> b->toggle_bit);
+        b->cnt[2] = (uint32_t)(v + incs);
+    }
+
+    for (i = 0U; i < 3U; i++)
+    {
+        if (hits[i] > 0U)
+        {
+            sim_mcwdt_raise(b, i, hits[i]);
+        }
+    }
+}
+
+static void sim_mcwdt_sync_all(void)
+{
+    uint64_t tick = sim_ticks_at(sim.now_ns);
+    uint32_t i;
+
+    for (i = 0U; i < MCWDT_SIM_MCWDT_BLOCKS; i++)
+    {
+        sim_mcwdt_sync(sim_blocks[i], tick);
+    }
+}
+
+/* Register accesses land at the current virtual time */
+static MCWDT_STRUCT_Type *sim_mcwdt_at_now(MCWDT_STRUCT_Type const *base)
+{
+    MCWDT_STRUCT_Type *b = (MCWDT_STRUCT_Type *)base;
+
+    sim_mcwdt_sync(b, sim_ticks_at(sim.now_ns));
+    return b;
+}
+
+static MCWDT_STRUCT_Type *sim_mcwdt_write(MCWDT_STRUCT_Type *base)
+{
+    sim.wdt_next_ns = SIM_CACHE_STALE;
+    return sim_mcwdt_at_now(base);
+}
+
+/* Virtual time of the next MCWDT event over all blocks. Plain counting does
+ * not move it, so it is only recomputed after an event or a register write. */
+static uint64_t sim_mcwdt_next_event_ns(void)
+{
+    uint64_t next = SIM_NEVER;
+    uint32_t i;
+
+    if (sim.wdt_next_ns != SIM_CACHE_STALE)
+    {
+        return sim.wdt_next_ns;
+    }
+
+    for (i = 0U; i < MCWDT_SIM_MCWDT_BLOCKS; i++)
+    {
+        const MCWDT_STRUCT_Type *b = sim_blocks[i];
+        uint64_t k = sim_mcwdt_ticks_to_event(b);
+
+        if (k != SIM_NEVER)
+        {
+            uint64_t t = mcwdt_sim_tick_time_ns(b->tick + k);
+            next = (t < next) ? t : next;
+        }
+    }
+    sim.wdt_next_ns = next;
+    return next;
+}
+
+
+/*******************************************************************************
+* Scheduled stimuli (binary min-heap ordered by time, then insertion order)
+*******************************************************************************/
+
+static bool sim_event_before(const sim_event_t *a, const sim_event_t *b)
+{
+    return (a->t_ns < b->t_ns) || ((a->t_ns == b->t_ns) && (a->seq < b->seq));
+}
+
+static void sim_event_push(const sim_event_t *ev)
+{
+    size_t i;
+
+    if (sim.event_count == sim.event_capacity)
+    {
+        sim.event_capacity = (sim.event_capacity > 0U) ? (sim.event_capacity * 2U) : 64U;
+        sim.events = realloc(sim.events, sim.event_capacity * sizeof(sim_event_t));
+        CY_ASSERT(NULL != sim.events);
+    }
+
+    i = sim.event_count++;
+    sim.events[i] = *ev;
+    sim.events[i].seq = sim.event_seq++;
+
+    while (i > 0U)
+    {
+        size_t parent = (i - 1U) / 2U;
+        sim_event_t tmp;
+
+        if (!sim_event_before(&sim.events[i], &sim.events[parent]))
+        {
+            break;
+        }
+        tmp = sim.events[parent];
+        sim.events[parent] = sim.events[i];
+        sim.events[i] = tmp;
+        i = parent;
+    }
+}
+
+static void sim_event_pop(sim_event_t *ev)
+{
+    size_t i = 0U;
+
+    *ev = sim.events[0];
+    sim.events[0] = sim.events[--sim.event_count];
+
+    for (;;)
+    {
+        size_t l = (2U * i) + 1U;
+        size_t r = l + 1U;
+        size_t m = i;
+        sim_event_t tmp;
+
+        if ((l < sim.event_count) && sim_event_before(&sim.events[l], &sim.events[m]))
+        {
+            m = l;
+        }
+        if ((r < sim.event_count) && sim_event_before(&sim.events[r], &sim.events[m]))
+        {
+            m = r;
+        }
+        if (m == i)
+        {
+            break;
+        }
+        tmp = sim.events[m];
+        sim.events[m] = sim.events[i];
+        sim.events[i] = tmp;
+        i = m;
+    }
+}
+
+static uint64_t sim_next_event_ns(void)
+{
+    return (sim.event_count > 0U) ? sim.events[0].t_ns : SIM_NEVER;
+}
+
+static void sim_apply_pin(GPIO_PRT_Type *port, uint32_t pin, uint32_t level)
+{
+    uint32_t bit = 1UL << pin;
+    uint32_t old = (port->in & bit) ? 1U : 0U;
+    uint32_t edge = port->edge[pin];
+
+    if (old == level)
+    {
+        return;
+    }
+
+    port->in = (level != 0U) ? (port->in | bit) : (port->in & ~bit);
+
+    if (((level != 0U) && (0U != (edge & CY_GPIO_INTR_RISING))) ||
+        ((level == 0U) && (0U != (edge & CY_GPIO_INTR_FALLING))))
+    {
+        port->intr |= bit;
+    }
+}
+
+void mcwdt_sim_schedule_pin(GPIO_PRT_Type *port, uint32_t pin, uint64_t t_ns, uint32_t level)
+{
+    sim_event_t ev = { .t_ns = t_ns, .kind = SIM_EVENT_PIN, .port = port, .pin = pin,
+                       .level = level };
+
+    sim_event_push(&ev);
+}
+
+/* The drift changes at t_ns, for example with the crystal temperature */
+void mcwdt_sim_schedule_drift(uint64_t t_ns, int64_t ppb)
+{
+    sim_event_t ev = { .t_ns = t_ns, .kind = SIM_EVENT_DRIFT, .ppb = ppb };
+
+    sim_event_push(&ev);
+}
+
+/* The application restarts at t_ns with the peripherals reset; the input
+ * levels, the LFCLK and the events still to come are kept */
+void mcwdt_sim_schedule_reset(uint64_t t_ns)
+{
+    sim_event_t ev = { .t_ns = t_ns, .kind = SIM_EVENT_RESET };
+
+    sim_event_push(&ev);
+}
+
+/* The user button is active low */
+void mcwdt_sim_schedule_press(uint64_t t_ns, uint64_t hold_ns)
+{
+    mcwdt_sim_schedule_pin(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM, t_ns, 0U);
+    mcwdt_sim_schedule_pin(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM, t_ns + hold_ns, 1U);
+}
+
+
+/*******************************************************************************
+* SysTick
+*******************************************************************************/
+
+static uint64_t sim_systick_period_ns(void)
+{
+    return (((uint64_t)(mcwdt_sim_systick.LOAD & SysTick_LOAD_RELOAD_Msk) + 1U) *
+            MCWDT_SIM_NS_PER_S) / SystemCoreClock;
+}
+
+/* Picks up register writes made since the last simulated access, which all
+ * happened at the current virtual time. Enabling the counter or writing VAL
+ * restarts a full period. */
+static void sim_systick_sync(void)
+{
+    SysTick_Type *st = &mcwdt_sim_systick;
+    bool enabled = (0U != (st->CTRL & SysTick_CTRL_ENABLE_Msk));
+    bool was_enabled = (0U != (sim.systick_ctrl & SysTick_CTRL_ENABLE_Msk));
+
+    if (!enabled)
+    {
+        sim.systick_next_ns = SIM_NEVER;
+    }
+    else if (!was_enabled || (st->VAL != SIM_SYSTICK_VAL_UNWRITTEN))
+    {
+        sim.systick_next_ns = sim.now_ns + sim_systick_period_ns();
+    }
+    else
+    {
+        /* Running on */
+    }
+    sim.systick_ctrl = st->CTRL;
+    st->VAL = SIM_SYSTICK_VAL_UNWRITTEN;
+}
+
+/* The CPU clock stops in Deep Sleep, and SysTick with it */
+static uint64_t sim_systick_next_ns(void)
+{
+    return sim.deepsleep ? SIM_NEVER : sim.systick_next_ns;
+}
+
+/* Counts down every period that ended by now; each raises the exception if
+ * TICKINT is set. An expiry due during Deep Sleep is raised on wakeup. */
+static void sim_systick_expire(void)
+{
+    while (sim.systick_next_ns <= sim.now_ns)
+    {
+        sim.systick_pending = sim.systick_pending ||
+                              (0U != (sim.systick_ctrl & SysTick_CTRL_TICKINT_Msk));
+        sim.systick_next_ns += sim_systick_period_ns();
+    }
+}
+
+uint32_t SysTick_Config(uint32_t ticks)
+{
+    if ((ticks - 1U) > SysTick_LOAD_RELOAD_Msk)
+    {
+        return 1U;
+    }
+    mcwdt_sim_systick.LOAD = ticks - 1U;
+    mcwdt_sim_systick.VAL = 0U;
+    mcwdt_sim_systick.CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk |
+                             SysTick_CTRL_ENABLE_Msk;
+    sim_systick_sync();
+    return 0U;
+}
+
+
+/*******************************************************************************
+* DWT
+*
+* CYCCNT counts the CPU clock over busy time only: the clock is gated in
+* Sleep and stopped in Deep Sleep. The CPU itself runs in no time, so the
+* count is that of the modeled register accesses and interrupt entries.
+*******************************************************************************/
+DWT_Type *mcwdt_sim_dwt(void)
+{
+    uint64_t busy_ns = sim.stats.busy_ns;
+    uint64_t cycles;
+
+    if ((0U != (sim_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk)) &&
+        (0U != (mcwdt_sim_coredebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk)))
+    {
+        cycles = (uint64_t)(((unsigned __int128)busy_ns * SystemCoreClock) / MCWDT_SIM_NS_PER_S) -
+                 (uint64_t)(((unsigned __int128)sim.dwt_busy_ns * SystemCoreClock) / MCWDT_SIM_NS_PER_S);
+        sim_dwt.CYCCNT += (uint32_t)cycles;
+    }
+    sim.dwt_busy_ns = busy_ns;
+    return &sim_dwt;
+}
+
+
+/*******************************************************************************
+* Interrupt controller
+*******************************************************************************/
+
+/* Bit n set when IRQ line n is asserted */
+static uint64_t sim_irq_lines(void)
+{
+    uint64_t lines = sim.nvic_pending;
+    uint32_t i;
+
+    for (i = 0U; i < MCWDT_SIM_GPIO_PORTS; i++)
+    {
+        const GPIO_PRT_Type *p = sim_ports[i];
+        lines |= (0U != (p->intr & p->intr_mask)) ? (1ULL << p->irqn) : 0U;
+    }
+    for (i = 0U; i < MCWDT_SIM_MCWDT_BLOCKS; i++)
+    {
+        const MCWDT_STRUCT_Type *b = sim_blocks[i];
+        lines |= (0U != (b->intr & b->intr_mask)) ? (1ULL << b->irqn) : 0U;
+    }
+    lines |= (sim.uart_intr || sim_uart_rx_intr()) ? (1ULL << scb_5_interrupt_IRQn) : 0U;
+    return lines;
+}
+
+static bool sim_irq_ready(void)
+{
+    sim_systick_sync();
+    return sim.systick_pending || (0U != (sim_irq_lines() & sim.nvic_enabled));
+}
+
+/* Takes the exception entry time, with handlers already marked as running so
+ * that none is dispatched meanwhile */
+static void sim_irq_entry(void)
+{
+    if (0U != sim.costs.irq_entry_ns)
+    {
+        sim_run_until(sim.now_ns + sim.costs.irq_entry_ns, false);
+    }
+}
+
+/* Runs every ready handler, lowest IRQ number first. Handlers do not nest. */
+static void sim_dispatch(void)
+{
+    uint32_t reentry = 0U;
+    uint64_t ready;
+    uint32_t irqn;
+
+    if (sim.primask || sim.in_isr)
+    {
+        return;
+    }
+
+    /* SysTick is an exception and runs ahead of the device interrupts */
+    sim_systick_sync();
+    if (sim.systick_pending)
+    {
+        if (NULL == SysTick_Handler)
+        {
+            fprintf(stderr, "[sim] SysTick interrupt enabled without a handler\n");
+            CY_ASSERT(0);
+        }
+        sim.systick_pending = false;
+        sim.in_isr = true;
+        sim.exclusive_monitor = false;
+        sim.stats.irq_count++;
+        sim_irq_entry();
+        SysTick_Handler();
+        sim.in_isr = false;
+    }
+
+    /* Rescan after every handler: it may have raised other sources */
+    while (0U != (ready = sim_irq_lines() & sim.nvic_enabled))
+    {
+        irqn = (uint32_t)__builtin_ctzll(ready);
+        if (NULL == sim.vector[irqn])
+        {
+            fprintf(stderr, "[sim] IRQ %u enabled without a handler\n", (unsigned int)irqn);
+            CY_ASSERT(0);
+        }
+
+        sim.nvic_pending &= ~(1ULL << irqn);
+        sim.in_isr = true;
+        sim.exclusive_monitor = false;
+        sim.stats.irq_count++;
+        if (NULL != sim.irq_hook)
+        {
+            sim.irq_hook(irqn);
+        }
+        sim_irq_entry();
+        sim.vector[irqn]();
+        sim.in_isr = false;
+
+        if (++reentry > SIM_MAX_ISR_REENTRY)
+        {
+            fprintf(stderr, "[sim] IRQ %u never deasserts\n", (unsigned int)irqn);
+            CY_ASSERT(0);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Virtual time
+*******************************************************************************/
+
+static void sim_account(uint64_t t, bool sleeping)
+{
+    if (sleeping)
+    {
+        sim.stats.sleep_ns += t - sim.now_ns;
+        sim.stats.deepsleep_ns += sim.deepsleep ? (t - sim.now_ns) : 0U;
+    }
+    else
+    {
+        sim.stats.busy_ns += t - sim.now_ns;
+    }
+    sim.now_ns = t;
+}
+
+/* Moves virtual time to t_end, applying every stimulus and MCWDT event on the
+ * way in order. When sleeping, returns as soon as an enabled interrupt is
+ * ready (which is also how WFI behaves with PRIMASK set). */
+static void sim_run_until(uint64_t t_end, bool sleeping)
+{
+    for (;;)
+    {
+        uint64_t t = t_end;
+        uint64_t t_ev;
+        uint64_t t_wdt;
+        sim_event_t ev;
+
+        uint64_t t_tick;
+
+        /* A handler run by a nested call may already have moved time on */
+        sim_systick_sync();
+        if (sim.now_ns >= t_end)
+        {
+            return;
+        }
+
+        t_ev = sim_next_event_ns();
+        t_wdt = sim_mcwdt_next_event_ns();
+        t_tick = sim_systick_next_ns();
+        t = (t_ev < t) ? t_ev : t;
+        t = (t_wdt < t) ? t_wdt : t;
+        t = (t_tick < t) ? t_tick : t;
+        t = (sim.uart_async_done_ns < t) ? sim.uart_async_done_ns : t;
+
+        if (t > sim.until_ns)
+        {
+            sim_account(sim.until_ns, sleeping);
+            sim_mcwdt_sync_all();
+            longjmp(sim.run_env, 1 + MCWDT_SIM_RUN_UNTIL);
+        }
+        if (t == SIM_NEVER)
+        {
+            longjmp(sim.run_env, 1 + MCWDT_SIM_RUN_IDLE);
+        }
+
+        sim_account(t, sleeping);
+        sim_mcwdt_sync_all();
+
+        while ((sim.event_count > 0U) && (sim.events[0].t_ns <= sim.now_ns))
+        {
+            sim_event_pop(&ev);
+            switch (ev.kind)
+            {
+                case SIM_EVENT_PIN:
+                    sim_apply_pin(ev.port, ev.pin, ev.level);
+                    break;
+                case SIM_EVENT_UART_RX:
+                    sim_uart_receive((uint8_t)ev.level);
+                    break;
+                case SIM_EVENT_DRIFT:
+                    mcwdt_sim_set_lfclk_ppb(ev.ppb);
+                    break;
+                default:
+                    sim_device_reset("external");
+                    break;
+            }
+        }
+        if (sim.uart_async_done_ns <= sim.now_ns)
+        {
+            sim_uart_complete();
+        }
+        if (!sim.deepsleep)
+        {
+            sim_systick_expire();
+        }
+
+        if (sleeping && sim_irq_ready())
+        {
+            return;
+        }
+
+        sim_dispatch();
+
+        if (sim.now_ns >= t_end)
+        {
+            return;
+        }
+    }
+}
+
+void mcwdt_sim_advance_ns(uint64_t ns)
+{
+    sim.spin_reads = 0U;
+    sim_run_until(sim.now_ns + ns, false);
+}
+
+/* Enters WFI: sleeps until an enabled interrupt is ready, then services it */
+void mcwdt_sim_sleep(void)
+{
+    sim.spin_reads = 0U;
+    if (!sim_irq_ready())
+    {
+        sim_run_until(SIM_NEVER, true);
+    }
+    sim.stats.wakeups++;
+    sim_dispatch();
+}
+
+/* Busy-waits until the next scheduled event, as a spinning CPU would */
+static void sim_spin_to_next_event(void)
+{
+    uint64_t t = sim_next_event_ns();
+    uint64_t t_wdt = sim_mcwdt_next_event_ns();
+    uint64_t t_tick;
+
+    sim_systick_sync();
+    t_tick = sim_systick_next_ns();
+    t = (t_wdt < t) ? t_wdt : t;
+    t = (t_tick < t) ? t_tick : t;
+    t = (sim.uart_async_done_ns < t) ? sim.uart_async_done_ns : t;
+    if (t == SIM_NEVER)
+    {
+        longjmp(sim.run_env, 1 + MCWDT_SIM_RUN_IDLE);
+    }
+    sim_run_until(t, false);
+}
+
+uint64_t mcwdt_sim_now_ns(void)
+{
+    return sim.now_ns;
+}
+
+uint64_t mcwdt_sim_lfclk_ticks(void)
+{
+    return sim_ticks_at(sim.now_ns);
+}
+
+/* Only valid for times after the last LFCLK rate change */
+uint64_t mcwdt_sim_ticks_at_ns(uint64_t t_ns)
+{
+    return sim_ticks_at(t_ns);
+}
+
+const mcwdt_sim_stats_t *mcwdt_sim_stats(void)
+{
+    return &sim.stats;
+}
+
+void mcwdt_sim_set_costs(const mcwdt_sim_costs_t *costs)
+{
+    sim.costs = *costs;
+}
+
+void mcwdt_sim_set_irq_hook(mcwdt_sim_irq_hook_t hook)
+{
+    sim.irq_hook = hook;
+}
+
+
+/*******************************************************************************
+* Scenario control
+*******************************************************************************/
+
+static void sim_reset_peripherals(void)
+{
+    uint32_t i;
+
+    for (i = 0U; i < MCWDT_SIM_MCWDT_BLOCKS; i++)
+    {
+        MCWDT_STRUCT_Type *b = sim_blocks[i];
+        memset(b, 0, sizeof(*b));
+        b->match[0] = 0xFFFFU;
+        b->match[1] = 0xFFFFU;
+        b->irqn = (IRQn_Type)(srss_interrupt_mcwdt_0_IRQn + i);
+        b->tick = sim_ticks_at(sim.now_ns);
+    }
+    sim.wdt_next_ns = SIM_CACHE_STALE;
+
+    for (i = 0U; i < MCWDT_SIM_GPIO_PORTS; i++)
+    {
+        GPIO_PRT_Type *p = sim_ports[i];
+        uint32_t in = p->in;
+        memset(p, 0, sizeof(*p));
+        p->in = in;
+        p->irqn = (IRQn_Type)(ioss_interrupts_gpio_0_IRQn + i);
+    }
+
+    memset(sim.vector, 0, sizeof(sim.vector));
+    sim.nvic_enabled = 0U;
+    sim.nvic_pending = 0U;
+    sim.primask = false;
+    sim.in_isr = false;
+    sim.deepsleep = false;
+    sim.syspm_callbacks = NULL;
+    sim.spin_reads = 0U;
+
+    sim.uart_idle_ns = sim.now_ns;
+    sim.uart_async_buf = NULL;
+    sim.uart_async_done_ns = SIM_NEVER;
+    sim.uart_events = 0U;
+    sim.uart_intr = false;
+    sim.uart_callback = NULL;
+    sim.uart_rx_head = 0U;
+    sim.uart_rx_tail = 0U;
+
+    /* Clock start-up runs again, and the ILO trim is lost */
+    sim.lfclk_source = sim.wco_absent ? CY_SYSCLK_CLKLF_IN_ILO : CY_SYSCLK_CLKLF_IN_WCO;
+    sim.ilo_trim = 0;
+    sim.meas_active = false;
+    sim_lfclk_update();
+
+    memset(&mcwdt_sim_systick, 0, sizeof(mcwdt_sim_systick));
+    memset(&mcwdt_sim_coredebug, 0, sizeof(mcwdt_sim_coredebug));
+    memset(&sim_dwt, 0, sizeof(sim_dwt));
+    mcwdt_sim_systick.VAL = SIM_SYSTICK_VAL_UNWRITTEN;
+    sim.systick_ctrl = 0U;
+    sim.systick_next_ns = SIM_NEVER;
+    sim.systick_pending = false;
+}
+
+static void sim_device_reset(const char *source)
+{
+    sim.stats.resets++;
+    fprintf(stderr, "[sim] %s reset at %.6f s\n", source, (double)sim.now_ns / 1e9);
+    longjmp(sim.run_env, -1);
+}
+
+void mcwdt_sim_reset(void)
+{
+    uint32_t i;
+
+    free(sim.events);
+    memset(&sim, 0, sizeof(sim));
+    sim.costs.mcwdt_read_ns = SIM_DEFAULT_MCWDT_READ_NS;
+    sim.costs.gpio_read_ns = SIM_DEFAULT_GPIO_READ_NS;
+    sim.costs.deepsleep_wakeup_ns = SIM_DEFAULT_DEEPSLEEP_WAKEUP_NS;
+    sim.costs.irq_entry_ns = SIM_DEFAULT_IRQ_ENTRY_NS;
+    sim.uart_char_ns = (SIM_UART_BITS_PER_CHAR * MCWDT_SIM_NS_PER_S) / CY_RETARGET_IO_BAUDRATE;
+    sim.lfclk_source = CY_SYSCLK_CLKLF_IN_WCO;
+    sim.ilo_hz = SIM_DEFAULT_ILO_HZ;
+    mcwdt_sim_set_lfclk_ppb(0);
+
+    /* Inputs idle high: the user button has a pull-up */
+    for (i = 0U; i < MCWDT_SIM_GPIO_PORTS; i++)
+    {
+        sim_ports[i]->in = 0xFFFFFFFFUL;
+    }
+    sim_reset_peripherals();
+}
+
+void mcwdt_sim_preset_count(MCWDT_STRUCT_Type *base, cy_en_mcwdtcounter_t counter, uint32_t value)
+{
+    sim_mcwdt_write(base);
+    base->cnt[counter] = (counter == CY_MCWDT_COUNTER2) ? value : (value & 0xFFFFU);
+}
+
+/* Runs the application until it goes idle with nothing left scheduled, the
+ * virtual time limit is reached, or it returns. Device resets restart it. */
+int mcwdt_sim_run(mcwdt_sim_app_t app, uint64_t until_ns)
+{
+    volatile int status;
+
+    sim.until_ns = (until_ns > 0U) ? until_ns : SIM_NEVER;
+    sim.running = true;
+
+    for (;;)
+    {
+        status = setjmp(sim.run_env);
+        if (status == 0)
+        {
+            app();
+            status = 1 + MCWDT_SIM_RUN_RETURNED;
+        }
+        if (status > 0)
+        {
+            break;
+        }
+        sim_reset_peripherals();
+    }
+
+    sim.running = false;
+    sim.in_isr = false;
+    fflush(stdout);
+    return status - 1;
+}
+
+void mcwdt_sim_finish(void)
+{
+    longjmp(sim.run_env, 1 + MCWDT_SIM_RUN_IDLE);
+}
+
+void mcwdt_sim_assert_failed(const char *file, int line)
+{
+    fflush(stdout);
+    fprintf(stderr, "[sim] CY_ASSERT failed at %s:%d (t=%.6f s)\n",
+            file, line, (double)sim.now_ns / 1e9);
+    if (!sim.running)
+    {
+        abort();
+    }
+    longjmp(sim.run_env, 1 + MCWDT_SIM_RUN_ASSERT);
+}
+
+
+/*******************************************************************************
+* CMSIS core
+*******************************************************************************/
+void __enable_irq(void)
+{
+    sim.primask = false;
+    sim_dispatch();
+}
+
+void __disable_irq(void)
+{
+    sim.primask = true;
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return sim.primask ? 1U : 0U;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    sim.primask = (priMask != 0U);
+    sim_dispatch();
+}
+
+void __WFI(void)
+{
+    mcwdt_sim_sleep();
+}
+
+void __DMB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void __DSB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void __ISB(void)
+{
+}
+
+uint32_t __LDREXW(volatile uint32_t *addr)
+{
+    sim.exclusive_monitor = true;
+    return *addr;
+}
+
+/* Exception entry clears the monitor, so the store fails if an ISR ran */
+uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+    if (!sim.exclusive_monitor)
+    {
+        return 1U;
+    }
+    *addr = value;
+    sim.exclusive_monitor = false;
+    return 0U;
+}
+
+void __CLREX(void)
+{
+    sim.exclusive_monitor = false;
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    sim.nvic_enabled |= (1ULL << IRQn);
+    sim_dispatch();
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    sim.nvic_enabled &= ~(1ULL << IRQn);
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    sim.nvic_pending &= ~(1ULL << IRQn);
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    sim.nvic_pending |= (1ULL << IRQn);
+    sim_dispatch();
+}
+
+void NVIC_SystemReset(void)
+{
+    sim_device_reset("software");
+}
+
+
+/*******************************************************************************
+* SysLib, SysInt, HAL, BSP and retarget-io
+*******************************************************************************/
+void Cy_SysLib_Delay(uint32_t milliseconds)
+{
+    mcwdt_sim_advance_ns((uint64_t)milliseconds * MCWDT_SIM_NS_PER_MS);
+}
+
+void Cy_SysLib_DelayUs(uint16_t microseconds)
+{
+    mcwdt_sim_advance_ns((uint64_t)microseconds * MCWDT_SIM_NS_PER_US);
+}
+
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    uint32_t saved = __get_PRIMASK();
+
+    sim.primask = true;
+    return saved;
+}
+
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    __set_PRIMASK(savedIntrStatus);
+}
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr)
+{
+    if ((NULL == config) || ((uint32_t)config->intrSrc >= SIM_IRQ_COUNT))
+    {
+        return CY_SYSINT_BAD_PARAM;
+    }
+    sim.vector[config->intrSrc] = userIsr;
+    return CY_SYSINT_SUCCESS;
+}
+
+cy_rslt_t cyhal_system_delay_ms(uint32_t milliseconds)
+{
+    Cy_SysLib_Delay(milliseconds);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cybsp_init(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_retarget_io_init(uint32_t tx, uint32_t rx, uint32_t baudrate)
+{
+    CY_UNUSED_PARAMETER(tx);
+    CY_UNUSED_PARAMETER(rx);
+    sim.uart_char_ns = (SIM_UART_BITS_PER_CHAR * MCWDT_SIM_NS_PER_S) / baudrate;
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Debug UART
+*
+* The TX FIFO is modeled by the time its last character will have been sent.
+* printf() queues one character at a time and busy-waits while the FIFO is
+* full. An asynchronous write (DMA or FIFO interrupt in the HAL) queues the
+* whole buffer at once and raises CYHAL_UART_IRQ_TX_DONE when the last
+* character has been sent. The buffer is only read at that point, so a buffer
+* changed during the transfer shows up in the output. Received characters
+* wait in the RX FIFO, which asserts CYHAL_UART_IRQ_RX_NOT_EMPTY until it is
+* read empty; characters arriving in Deep Sleep are lost.
+*******************************************************************************/
+static void sim_uart_emit(const char *data, size_t len)
+{
+    size_t room;
+
+    sim.stats.uart_bytes += len;
+    if (NULL == sim.uart_capture)
+    {
+        fwrite(data, 1U, len, stdout);
+        return;
+    }
+    room = sim.uart_capture_size - sim.uart_capture_len;
+    len = (len < room) ? len : room;
+    memcpy(&sim.uart_capture[sim.uart_capture_len], data, len);
+    sim.uart_capture_len += len;
+}
+
+static void sim_uart_complete(void)
+{
+    sim_uart_emit(sim.uart_async_buf, sim.uart_async_len);
+    sim.uart_async_buf = NULL;
+    sim.uart_async_done_ns = SIM_NEVER;
+    if (0U != (sim.uart_events & (uint32_t)CYHAL_UART_IRQ_TX_DONE))
+    {
+        sim.uart_intr = true;
+    }
+}
+
+static void sim_uart_receive(uint8_t c)
+{
+    if (sim.deepsleep || ((sim.uart_rx_head - sim.uart_rx_tail) >= MCWDT_SIM_UART_FIFO_DEPTH))
+    {
+        sim.stats.uart_rx_lost++;
+        return;
+    }
+    sim.uart_rx_fifo[sim.uart_rx_head % MCWDT_SIM_UART_FIFO_DEPTH] = c;
+    sim.uart_rx_head++;
+}
+
+static bool sim_uart_rx_intr(void)
+{
+    return (0U != (sim.uart_events & (uint32_t)CYHAL_UART_IRQ_RX_NOT_EMPTY)) &&
+           (sim.uart_rx_head != sim.uart_rx_tail);
+}
+
+/* The HAL UART interrupt handler */
+static void sim_uart_isr(void)
+{
+    uint32_t events = sim.uart_intr ? (uint32_t)CYHAL_UART_IRQ_TX_DONE : 0U;
+
+    events |= sim_uart_rx_intr() ? (uint32_t)CYHAL_UART_IRQ_RX_NOT_EMPTY : 0U;
+    sim.uart_intr = false;
+    if (NULL != sim.uart_callback)
+    {
+        sim.uart_callback(sim.uart_callback_arg, (cyhal_uart_event_t)events);
+    }
+}
+
+static bool sim_uart_tx_active(void)
+{
+    return (NULL != sim.uart_async_buf) || (sim.uart_idle_ns > sim.now_ns);
+}
+
+int mcwdt_sim_uart_printf(const char *format, ...)
+{
+    char line[SIM_UART_PRINTF_MAX];
+    va_list args;
+    int len;
+    int i;
+
+    va_start(args, format);
+    len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    len = (len < (int)sizeof(line)) ? len : ((int)sizeof(line) - 1);
+
+    for (i = 0; i < len; i++)
+    {
+        uint64_t full_until = sim.uart_idle_ns - (MCWDT_SIM_UART_FIFO_DEPTH * sim.uart_char_ns);
+
+        if ((sim.uart_idle_ns > (MCWDT_SIM_UART_FIFO_DEPTH * sim.uart_char_ns)) &&
+            (full_until > sim.now_ns))
+        {
+            sim.stats.uart_wait_ns += full_until - sim.now_ns;
+            mcwdt_sim_advance_ns(full_until - sim.now_ns);
+        }
+        sim.uart_idle_ns = ((sim.uart_idle_ns > sim.now_ns) ? sim.uart_idle_ns : sim.now_ns) +
+                           sim.uart_char_ns;
+    }
+    sim_uart_emit(line, (size_t)len);
+
+    return len;
+}
+
+cy_rslt_t cyhal_uart_set_async_mode(cyhal_uart_t *obj, cyhal_async_mode_t mode, uint8_t dma_priority)
+{
+    CY_UNUSED_PARAMETER(obj);
+    CY_UNUSED_PARAMETER(mode);
+    CY_UNUSED_PARAMETER(dma_priority);
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_uart_register_callback(cyhal_uart_t *obj, cyhal_uart_event_callback_t callback,
+                                  void *callback_arg)
+{
+    CY_UNUSED_PARAMETER(obj);
+    sim.uart_callback = callback;
+    sim.uart_callback_arg = callback_arg;
+}
+
+void cyhal_uart_enable_event(cyhal_uart_t *obj, cyhal_uart_event_t event,
+                             uint8_t intr_priority, bool enable)
+{
+    CY_UNUSED_PARAMETER(obj);
+    CY_UNUSED_PARAMETER(intr_priority);
+    sim.uart_events = enable ? (sim.uart_events | (uint32_t)event) : (sim.uart_events & ~(uint32_t)event);
+    sim.vector[scb_5_interrupt_IRQn] = sim_uart_isr;
+    NVIC_EnableIRQ(scb_5_interrupt_IRQn);
+}
+
+cy_rslt_t cyhal_uart_write_async(cyhal_uart_t *obj, void *tx, size_t length)
+{
+    uint64_t start = (sim.uart_idle_ns > sim.now_ns) ? sim.uart_idle_ns : sim.now_ns;
+
+    CY_UNUSED_PARAMETER(obj);
+    if (NULL != sim.uart_async_buf)
+    {
+        return CYHAL_UART_RSLT_ERR_TX_BUSY;
+    }
+    sim.uart_async_buf = tx;
+    sim.uart_async_len = length;
+    sim.uart_idle_ns = start + (length * sim.uart_char_ns);
+    sim.uart_async_done_ns = sim.uart_idle_ns;
+    return CY_RSLT_SUCCESS;
+}
+
+bool cyhal_uart_is_tx_active(cyhal_uart_t *obj)
+{
+    CY_UNUSED_PARAMETER(obj);
+    return (NULL != sim.uart_async_buf);
+}
+
+uint32_t cyhal_uart_readable(cyhal_uart_t *obj)
+{
+    CY_UNUSED_PARAMETER(obj);
+    return sim.uart_rx_head - sim.uart_rx_tail;
+}
+
+/* Only returns what has already arrived, whatever the timeout */
+cy_rslt_t cyhal_uart_getc(cyhal_uart_t *obj, uint8_t *value, uint32_t timeout)
+{
+    CY_UNUSED_PARAMETER(obj);
+    CY_UNUSED_PARAMETER(timeout);
+    if (sim.uart_rx_head == sim.uart_rx_tail)
+    {
+        return CYHAL_UART_RSLT_ERR_TIMEOUT;
+    }
+    *value = sim.uart_rx_fifo[sim.uart_rx_tail % MCWDT_SIM_UART_FIFO_DEPTH];
+    sim.uart_rx_tail++;
+    return CY_RSLT_SUCCESS;
+}
+
+/* Characters arrive back to back at the retarget-io baud rate */
+void mcwdt_sim_schedule_uart_rx(uint64_t t_ns, const char *text)
+{
+    sim_event_t ev = { .t_ns = t_ns, .kind = SIM_EVENT_UART_RX };
+
+    for (; '\0' != *text; text++)
+    {
+        ev.level = (uint8_t)*text;
+        sim_event_push(&ev);
+        ev.t_ns += sim.uart_char_ns;
+    }
+}
+
+void mcwdt_sim_set_uart_capture(char *buf, size_t size)
+{
+    sim.uart_capture = buf;
+    sim.uart_capture_size = size;
+    sim.uart_capture_len = 0U;
+}
+
+size_t mcwdt_sim_uart_captured(void)
+{
+    return sim.uart_capture_len;
+}
+
+
+/*******************************************************************************
+* SysClk and WDT
+*
+* The clock measurement counters count count1 cycles of the first clock and
+* the IMO cycles in the meantime. Both are fixed when counting starts, so a
+* drift change during a measurement only applies to the next one. Polling
+* for the end is fast-forwarded like a polling loop.
+*******************************************************************************/
+cy_en_clklf_in_sources_t Cy_SysClk_ClkLfGetSource(void)
+{
+    return sim.lfclk_source;
+}
+
+void Cy_SysClk_ClkLfSetSource(cy_en_clklf_in_sources_t source)
+{
+    sim.lfclk_source = source;
+    sim_lfclk_update();
+}
+
+bool Cy_SysClk_WcoOkay(void)
+{
+    return !sim.wco_absent;
+}
+
+/* The ILO always runs: it also clocks the WDT */
+void Cy_SysClk_IloEnable(void)
+{
+}
+
+bool Cy_SysClk_IloIsEnabled(void)
+{
+    return true;
+}
+
+/* Moves the ILO by whole trim steps towards the target, unless it is already
+ * within one step */
+int32_t Cy_SysClk_IloTrim(uint32_t iloFreq)
+{
+    int32_t change = 0;
+    int32_t trim;
+
+    if (iloFreq > (SIM_ILO_TRIM_TARGET_HZ + SIM_ILO_TRIM_STEP_HZ))
+    {
+        change = -(int32_t)(((iloFreq - SIM_ILO_TRIM_TARGET_HZ) + (SIM_ILO_TRIM_STEP_HZ / 2U)) /
+                            SIM_ILO_TRIM_STEP_HZ);
+    }
+    else if (iloFreq < (SIM_ILO_TRIM_TARGET_HZ - SIM_ILO_TRIM_STEP_HZ))
+    {
+        change = (int32_t)(((SIM_ILO_TRIM_TARGET_HZ - iloFreq) + (SIM_ILO_TRIM_STEP_HZ / 2U)) /
+                           SIM_ILO_TRIM_STEP_HZ);
+    }
+
+    trim = sim.ilo_trim + change;
+    trim = (trim < SIM_ILO_TRIM_MIN) ? SIM_ILO_TRIM_MIN : trim;
+    trim = (trim > SIM_ILO_TRIM_MAX) ? SIM_ILO_TRIM_MAX : trim;
+    change = trim - sim.ilo_trim;
+    if (0 != change)
+    {
+        sim.ilo_trim = trim;
+        sim_lfclk_update();
+    }
+    return change;
+}
+
+cy_en_sysclk_status_t Cy_SysClk_StartClkMeasurementCounters(cy_en_meas_clks_t clock1,
+                                                            uint32_t count1,
+                                                            cy_en_meas_clks_t clock2)
+{
+    long double hz;
+    long double seconds;
+
+    if (sim.meas_active)
+    {
+        return CY_SYSCLK_INVALID_STATE;
+    }
+    if ((0U == count1) || (count1 > SIM_MEAS_COUNT1_MAX) || (CY_SYSCLK_MEAS_CLK_IMO != clock2))
+    {
+        return CY_SYSCLK_BAD_PARAM;
+    }
+
+    switch (clock1)
+    {
+        case CY_SYSCLK_MEAS_CLK_ILO:
+            hz = sim_ilo_hz();
+            break;
+        case CY_SYSCLK_MEAS_CLK_WCO:
+            hz = CY_SYSCLK_WCO_FREQ;
+            break;
+        case CY_SYSCLK_MEAS_CLK_LFCLK:
+            hz = (CY_SYSCLK_CLKLF_IN_ILO == sim.lfclk_source) ? sim_ilo_hz() : CY_SYSCLK_WCO_FREQ;
+            break;
+        default:
+            return CY_SYSCLK_BAD_PARAM;
+    }
+    /* The drift is that of the LFCLK, so it applies to its source only */
+    if ((CY_SYSCLK_MEAS_CLK_LFCLK == clock1) ||
+        ((CY_SYSCLK_MEAS_CLK_ILO == clock1) && (CY_SYSCLK_CLKLF_IN_ILO == sim.lfclk_source)) ||
+        ((CY_SYSCLK_MEAS_CLK_WCO == clock1) && (CY_SYSCLK_CLKLF_IN_WCO == sim.lfclk_source)))
+    {
+        hz = hz * (long double)(SIM_PPB_SCALE + sim.lfclk_ppb) / (long double)SIM_PPB_SCALE;
+    }
+
+    seconds = (long double)count1 / hz;
+    sim.meas_active = true;
+    sim.meas_valid = true;
+    sim.meas_polls = 0U;
+    sim.meas_count1 = count1;
+    sim.meas_count2 = (uint32_t)(seconds * (long double)CY_SYSCLK_IMO_FREQ *
+                                 (long double)(SIM_PPB_SCALE + sim.imo_ppb) /
+                                 (long double)SIM_PPB_SCALE);
+    sim.meas_done_ns = sim.now_ns + (uint64_t)(seconds * (long double)MCWDT_SIM_NS_PER_S);
+    return CY_SYSCLK_SUCCESS;
+}
+
+bool Cy_SysClk_ClkMeasurementCountersDone(void)
+{
+    if (sim.meas_active && (sim.now_ns < sim.meas_done_ns))
+    {
+        sim.meas_polls++;
+        if (sim.meas_polls >= MCWDT_SIM_SPIN_READS)
+        {
+            mcwdt_sim_advance_ns(sim.meas_done_ns - sim.now_ns);
+        }
+    }
+    return !sim.meas_active || (sim.now_ns >= sim.meas_done_ns);
+}
+
+/* Returns 0 for a measurement that is not complete, or was spoiled by Deep
+ * Sleep */
+uint32_t Cy_SysClk_ClkMeasurementCountersGetFreq(bool measuredClock, uint32_t refClkFreq)
+{
+    uint64_t num;
+    uint64_t den;
+
+    if (!sim.meas_active || !sim.meas_valid || (sim.now_ns < sim.meas_done_ns) ||
+        (0U == sim.meas_count2))
+    {
+        sim.meas_active = false;
+        return 0U;
+    }
+    sim.meas_active = false;
+
+    num = (measuredClock ? sim.meas_count2 : sim.meas_count1) * (uint64_t)refClkFreq;
+    den = measuredClock ? sim.meas_count1 : sim.meas_count2;
+    return (uint32_t)((num + (den / 2U)) / den);
+}
+
+void Cy_SysClk_ClkMeasurementCountersEnd(void)
+{
+    sim.meas_active = false;
+}
+
+void Cy_WDT_Lock(void)
+{
+}
+
+void Cy_WDT_Unlock(void)
+{
+}
+
+
+/*******************************************************************************
+* SysPm
+*
+* Callbacks run in registration order for CHECK_READY and BEFORE_TRANSITION and
+* in reverse order for AFTER_TRANSITION and CHECK_FAIL, as in the PDL. The
+* 'order' field is not modeled.
+*******************************************************************************/
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler)
+{
+    cy_stc_syspm_callback_t **link = &sim.syspm_callbacks;
+    cy_stc_syspm_callback_t *prev = NULL;
+
+    if ((NULL == handler) || (NULL == handler->callback))
+    {
+        return false;
+    }
+    while (NULL != *link)
+    {
+        if (*link == handler)
+        {
+            return false;
+        }
+        prev = *link;
+        link = &(*link)->nextItm;
+    }
+    handler->prevItm = prev;
+    handler->nextItm = NULL;
+    *link = handler;
+    return true;
+}
+
+bool Cy_SysPm_UnregisterCallback(cy_stc_syspm_callback_t const *handler)
+{
+    cy_stc_syspm_callback_t **link = &sim.syspm_callbacks;
+
+    while (NULL != *link)
+    {
+        if (*link == handler)
+        {
+            *link = handler->nextItm;
+            if (NULL != handler->nextItm)
+            {
+                handler->nextItm->prevItm = handler->prevItm;
+            }
+            return true;
+        }
+        link = &(*link)->nextItm;
+    }
+    return false;
+}
+
+static cy_stc_syspm_callback_t *sim_syspm_last(void)
+{
+    cy_stc_syspm_callback_t *cb = sim.syspm_callbacks;
+
+    while ((NULL != cb) && (NULL != cb->nextItm))
+    {
+        cb = cb->nextItm;
+    }
+    return cb;
+}
+
+/* Calls the callbacks of 'type' from 'first' onwards (or backwards). Returns
+ * the callback that failed CY_SYSPM_CHECK_READY, or NULL. */
+static cy_stc_syspm_callback_t *sim_syspm_call(cy_en_syspm_callback_type_t type,
+                                               cy_en_syspm_callback_mode_t mode,
+                                               cy_stc_syspm_callback_t *first, bool forward)
+{
+    cy_stc_syspm_callback_t *cb;
+
+    for (cb = first; NULL != cb; cb = forward ? cb->nextItm : cb->prevItm)
+    {
+        if ((cb->type != type) || (0U != (cb->skipMode & (uint32_t)mode)))
+        {
+            continue;
+        }
+        if ((CY_SYSPM_SUCCESS != cb->callback(cb->callbackParams, mode)) &&
+            (CY_SYSPM_CHECK_READY == mode))
+        {
+            return cb;
+        }
+    }
+    return NULL;
+}
+
+static cy_en_syspm_status_t sim_syspm_enter(cy_en_syspm_callback_type_t type, bool deep)
+{
+    cy_stc_syspm_callback_t *failed;
+    uint32_t intr_status;
+
+    /* The HAL UART refuses Deep Sleep until its transmission is complete */
+    if (deep && sim_uart_tx_active())
+    {
+        return CY_SYSPM_FAIL;
+    }
+
+    failed = sim_syspm_call(type, CY_SYSPM_CHECK_READY, sim.syspm_callbacks, true);
+    if (NULL != failed)
+    {
+        sim_syspm_call(type, CY_SYSPM_CHECK_FAIL, failed->prevItm, false);
+        return CY_SYSPM_FAIL;
+    }
+    sim_syspm_call(type, CY_SYSPM_BEFORE_TRANSITION, sim.syspm_callbacks, true);
+
+    intr_status = Cy_SysLib_EnterCriticalSection();
+    sim.deepsleep = deep;
+    if (deep)
+    {
+        /* The IMO stops, which spoils a clock measurement in progress */
+        sim.meas_valid = false;
+    }
+    mcwdt_sim_sleep();
+    sim.deepsleep = false;
+    if (deep)
+    {
+        mcwdt_sim_advance_ns(sim.costs.deepsleep_wakeup_ns);
+    }
+
+    sim_syspm_call(type, CY_SYSPM_AFTER_TRANSITION, sim_syspm_last(), false);
+    Cy_SysLib_ExitCriticalSection(intr_status);
+
+    return CY_SYSPM_SUCCESS;
+}
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterSleep(cy_en_syspm_waitfor_t waitFor)
+{
+    CY_UNUSED_PARAMETER(waitFor);
+    return sim_syspm_enter(CY_SYSPM_SLEEP, false);
+}
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(cy_en_syspm_waitfor_t waitFor)
+{
+    CY_UNUSED_PARAMETER(waitFor);
+    return sim_syspm_enter(CY_SYSPM_DEEPSLEEP, true);
+}
+
+
+/*******************************************************************************
+* GPIO
+*******************************************************************************/
+uint32_t Cy_GPIO_Read(GPIO_PRT_Type *base, uint32_t pinNum)
+{
+    uint32_t value;
+
+    sim_run_until(sim.now_ns + sim.costs.gpio_read_ns, false);
+    sim.stats.gpio_reads++;
+    value = (base->in >> pinNum) & 1U;
+
+    /* Same pin, same value, nothing else happened: the caller is polling */
+    if ((base == sim.spin_port) && (pinNum == sim.spin_pin) && (value == sim.spin_value))
+    {
+        if (++sim.spin_reads >= MCWDT_SIM_SPIN_READS)
+        {
+            sim.spin_reads = 0U;
+            sim_spin_to_next_event();
+        }
+    }
+    else
+    {
+        sim.spin_port = base;
+        sim.spin_pin = pinNum;
+        sim.spin_value = value;
+        sim.spin_reads = 1U;
+    }
+
+    return value;
+}
+
+void Cy_GPIO_Write(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value)
+{
+    base->out = (value != 0U) ? (base->out | (1UL << pinNum)) : (base->out & ~(1UL << pinNum));
+}
+
+void Cy_GPIO_SetInterruptEdge(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value)
+{
+    base->edge[pinNum] = value & CY_GPIO_INTR_BOTH;
+}
+
+void Cy_GPIO_SetInterruptMask(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value)
+{
+    uint32_t bit = 1UL << pinNum;
+
+    base->intr_mask = (value != 0U) ? (base->intr_mask | bit) : (base->intr_mask & ~bit);
+    sim_dispatch();
+}
+
+uint32_t Cy_GPIO_GetInterruptStatus(GPIO_PRT_Type *base, uint32_t pinNum)
+{
+    return (base->intr >> pinNum) & 1U;
+}
+
+uint32_t Cy_GPIO_GetInterruptStatusMasked(GPIO_PRT_Type *base, uint32_t pinNum)
+{
+    return ((base->intr & base->intr_mask) >> pinNum) & 1U;
+}
+
+void Cy_GPIO_ClearInterrupt(GPIO_PRT_Type *base, uint32_t pinNum)
+{
+    base->intr &= ~(1UL << pinNum);
+}
+
+uint32_t mcwdt_sim_gpio_port_in(GPIO_PRT_Type *base)
+{
+    sim_run_until(sim.now_ns + sim.costs.gpio_read_ns, false);
+    sim.stats.gpio_reads++;
+    return base->in;
+}
+
+uint32_t mcwdt_sim_gpio_port_intr_masked(GPIO_PRT_Type *base)
+{
+    return base->intr & base->intr_mask;
+}
+
+void mcwdt_sim_gpio_port_intr_clear(GPIO_PRT_Type *base, uint32_t mask)
+{
+    base->intr &= ~mask;
+}
+
+
+/*******************************************************************************
+* MCWDT
+*******************************************************************************/
+
+cy_en_mcwdt_status_t Cy_MCWDT_Init(MCWDT_STRUCT_Type *base, cy_stc_mcwdt_config_t const *config)
+{
+    MCWDT_STRUCT_Type *b;
+
+    if ((NULL == base) || (NULL == config) || (config->c2ToggleBit > 31U))
+    {
+        return CY_MCWDT_BAD_PARAM;
+    }
+
+    b = sim_mcwdt_write(base);
+    b->match[0] = config->c0Match;
+    b->match[1] = config->c1Match;
+    b->mode[0] = (cy_en_mcwdtmode_t)config->c0Mode;
+    b->mode[1] = (cy_en_mcwdtmode_t)config->c1Mode;
+    b->mode[2] = (config->c2Mode == CY_MCWDT_MODE_NONE) ? CY_MCWDT_MODE_NONE : CY_MCWDT_MODE_INT;
+    b->toggle_bit = config->c2ToggleBit;
+    b->clear[0] = config->c0ClearOnMatch;
+    b->clear[1] = config->c1ClearOnMatch;
+    b->cascade01 = config->c0c1Cascade;
+    b->cascade12 = config->c1c2Cascade;
+    return CY_MCWDT_SUCCESS;
+}
+
+void Cy_MCWDT_DeInit(MCWDT_STRUCT_Type *base)
+{
+    MCWDT_STRUCT_Type *b = sim_mcwdt_write(base);
+    uint64_t tick = b->tick;
+    IRQn_Type irqn = b->irqn;
+
+    memset(b, 0, sizeof(*b));
+    b->match[0] = 0xFFFFU;
+    b->match[1] = 0xFFFFU;
+    b->tick = tick;
+    b->irqn = irqn;
+}
+
+void Cy_MCWDT_Enable(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs)
+{
+    sim_mcwdt_write(base)->enabled |= (counters & CY_MCWDT_CTR_Msk);
+    Cy_SysLib_DelayUs(waitUs);
+}
+
+void Cy_MCWDT_Disable(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs)
+{
+    sim_mcwdt_write(base)->enabled &= ~(counters & CY_MCWDT_CTR_Msk);
+    Cy_SysLib_DelayUs(waitUs);
+}
+
+uint32_t Cy_MCWDT_GetEnabledStatus(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter)
+{
+    return (base->enabled >> counter) & 1U;
+}
+
+uint32_t Cy_MCWDT_GetCount(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter)
+{
+    sim_run_until(sim.now_ns + sim.costs.mcwdt_read_ns, false);
+    sim.stats.mcwdt_reads++;
+    return sim_mcwdt_at_now(base)->cnt[counter];
+}
+
+void Cy_MCWDT_ResetCounters(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs)
+{
+    MCWDT_STRUCT_Type *b = sim_mcwdt_write(base);
+    uint32_t i;
+
+    for (i = 0U; i < 3U; i++)
+    {
+        if (0U != (counters & (1UL << i)))
+        {
+            b->cnt[i] = 0U;
+        }
+    }
+    Cy_SysLib_DelayUs(waitUs);
+}
+
+void Cy_MCWDT_SetMatch(MCWDT_STRUCT_Type *base, cy_en_mcwdtcounter_t counter, uint32_t match,
+                       uint16_t waitUs)
+{
+    if (counter != CY_MCWDT_COUNTER2)
+    {
+        sim_mcwdt_write(base)->match[counter] = match & 0xFFFFU;
+    }
+    Cy_SysLib_DelayUs(waitUs);
+}
+
+uint32_t Cy_MCWDT_GetMatch(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter)
+{
+    return (counter != CY_MCWDT_COUNTER2) ? base->match[counter] : 0U;
+}
+
+void Cy_MCWDT_SetMode(MCWDT_STRUCT_Type *base, cy_en_mcwdtcounter_t counter, cy_en_mcwdtmode_t mode)
+{
+    sim_mcwdt_write(base)->mode[counter] = mode;
+}
+
+cy_en_mcwdtmode_t Cy_MCWDT_GetMode(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter)
+{
+    return base->mode[counter];
+}
+
+void Cy_MCWDT_SetClearOnMatch(MCWDT_STRUCT_Type *base, cy_en_mcwdtcounter_t counter, uint32_t enable)
+{
+    if (counter != CY_MCWDT_COUNTER2)
+    {
+        sim_mcwdt_write(base)->clear[counter] = (enable != 0U);
+    }
+}
+
+void Cy_MCWDT_SetCascade(MCWDT_STRUCT_Type *base, cy_en_mcwdtcascade_t cascade)
+{
+    MCWDT_STRUCT_Type *b = sim_mcwdt_write(base);
+
+    b->cascade01 = (0U != ((uint32_t)cascade & (uint32_t)CY_MCWDT_CASCADE_C0C1));
+    b->cascade12 = (0U != ((uint32_t)cascade & (uint32_t)CY_MCWDT_CASCADE_C1C2));
+}
+
+void Cy_MCWDT_SetToggleBit(MCWDT_STRUCT_Type *base, uint32_t bit)
+{
+    sim_mcwdt_write(base)->toggle_bit = bit & 31U;
+}
+
+uint32_t Cy_MCWDT_GetToggleBit(MCWDT_STRUCT_Type const *base)
+{
+    return base->toggle_bit;
+}
+
+uint32_t Cy_MCWDT_GetInterruptStatus(MCWDT_STRUCT_Type const *base)
+{
+    return sim_mcwdt_at_now(base)->intr;
+}
+
+void Cy_MCWDT_ClearInterrupt(MCWDT_STRUCT_Type *base, uint32_t counters)
+{
+    MCWDT_STRUCT_Type *b = sim_mcwdt_at_now(base);
+    uint32_t i;
+
+    b->intr &= ~(counters & CY_MCWDT_CTR_Msk);
+    for (i = 0U; i < 3U; i++)
+    {
+        if (0U != (counters & (1UL << i)))
+        {
+            b->unhandled[i] = 0U;
+        }
+    }
+}
+
+void Cy_MCWDT_SetInterrupt(MCWDT_STRUCT_Type *base, uint32_t counters)
+{
+    sim_mcwdt_at_now(base)->intr |= (counters & CY_MCWDT_CTR_Msk);
+    sim_dispatch();
+}
+
+uint32_t Cy_MCWDT_GetInterruptMask(MCWDT_STRUCT_Type const *base)
+{
+    return base->intr_mask;
+}
+
+void Cy_MCWDT_SetInterruptMask(MCWDT_STRUCT_Type *base, uint32_t counters)
+{
+    sim_mcwdt_write(base)->intr_mask = counters & CY_MCWDT_CTR_Msk;
+    sim_dispatch();
+}
+
+uint32_t Cy_MCWDT_GetInterruptStatusMasked(MCWDT_STRUCT_Type const *base)
+{
+    MCWDT_STRUCT_Type *b = sim_mcwdt_at_now(base);
+
+    return b->intr & b->intr_mask;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,162 @@
+/******************************************************************************
+* File Name:   mcwdt_sim.h
+*
+* Description: Interface of the host-side MCWDT register simulator. The simulator
+*              runs the application against a virtual clock: time advances only
+*              through modeled register accesses, delays and sleep, and idle
+*              polling loops are fast-forwarded to the next scheduled event.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MCWDT_SIM_H
+#define MCWDT_SIM_H
+
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Nanoseconds per unit of virtual time */
+#define MCWDT_SIM_NS_PER_US                 (1000ULL)
+#define MCWDT_SIM_NS_PER_MS                 (1000000ULL)
+#define MCWDT_SIM_NS_PER_S                  (1000000000ULL)
+
+/* Number of simulated GPIO ports and MCWDT blocks */
+#define MCWDT_SIM_GPIO_PORTS                (15U)
+#define MCWDT_SIM_MCWDT_BLOCKS              (2U)
+
+/* Number of times the same pin may be read back unchanged, with no other
+ * simulated activity in between, before the simulator treats the caller as
+ * spinning and fast-forwards to the next scheduled event */
+#define MCWDT_SIM_SPIN_READS                (3U)
+
+/* Depth of each of the simulated debug UART TX and RX FIFOs, in characters */
+#define MCWDT_SIM_UART_FIFO_DEPTH           (128U)
+
+/* Return codes of mcwdt_sim_run() */
+#define MCWDT_SIM_RUN_IDLE                  (0)   /* No events left to run     */
+#define MCWDT_SIM_RUN_UNTIL                 (1)   /* Reached the time limit    */
+#define MCWDT_SIM_RUN_RETURNED              (2)   /* Application returned      */
+#define MCWDT_SIM_RUN_ASSERT                (3)   /* CY_ASSERT() failed        */
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/* Modeled cost of register accesses, in nanoseconds of virtual time */
+typedef struct
+{
+    uint32_t mcwdt_read_ns;     /* One MCWDT counter register read       */
+    uint32_t gpio_read_ns;      /* One GPIO input register read           */
+    uint32_t deepsleep_wakeup_ns; /* Deep Sleep exit until code runs      */
+    uint32_t irq_entry_ns;      /* Interrupt pending until handler runs   */
+} mcwdt_sim_costs_t;
+
+/* Counters accumulated over a run */
+typedef struct
+{
+    uint64_t busy_ns;           /* Virtual time with the CPU running      */
+    uint64_t sleep_ns;          /* Virtual time with the CPU in WFI       */
+    uint64_t deepsleep_ns;      /* Part of sleep_ns spent in Deep Sleep   */
+    uint64_t mcwdt_reads;       /* Cy_MCWDT_GetCount() calls              */
+    uint64_t gpio_reads;        /* Cy_GPIO_Read() and port register reads */
+    uint64_t irq_count;         /* Interrupt handlers invoked             */
+    uint64_t wakeups;           /* Exits from WFI                         */
+    uint64_t resets;            /* Device resets: MCWDT or NVIC_SystemReset() */
+    uint64_t uart_bytes;        /* Characters sent on the debug UART      */
+    uint64_t uart_wait_ns;      /* Busy time spent waiting for TX FIFO space */
+    uint64_t uart_rx_lost;      /* Characters lost: RX FIFO full or Deep Sleep */
+} mcwdt_sim_stats_t;
+
+typedef void (*mcwdt_sim_app_t)(void);
+
+/* Called on entry to every simulated interrupt handler */
+typedef void (*mcwdt_sim_irq_hook_t)(uint32_t irqn);
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+
+/* Scenario set-up */
+void     mcwdt_sim_reset(void);
+void     mcwdt_sim_set_costs(const mcwdt_sim_costs_t *costs);
+void     mcwdt_sim_set_lfclk_ppb(int64_t ppb);
+void     mcwdt_sim_set_wco_present(bool present);
+void     mcwdt_sim_set_ilo_hz(uint32_t hz);
+void     mcwdt_sim_set_imo_ppb(int64_t ppb);
+void     mcwdt_sim_set_irq_hook(mcwdt_sim_irq_hook_t hook);
+void     mcwdt_sim_schedule_pin(GPIO_PRT_Type *port, uint32_t pin,
+                                uint64_t t_ns, uint32_t level);
+void     mcwdt_sim_schedule_press(uint64_t t_ns, uint64_t hold_ns);
+void     mcwdt_sim_schedule_drift(uint64_t t_ns, int64_t ppb);
+void     mcwdt_sim_schedule_reset(uint64_t t_ns);
+void     mcwdt_sim_preset_count(MCWDT_STRUCT_Type *base, cy_en_mcwdtcounter_t counter,
+                                uint32_t value);
+void     mcwdt_sim_set_uart_capture(char *buf, size_t size);
+void     mcwdt_sim_schedule_uart_rx(uint64_t t_ns, const char *text);
+
+/* Execution */
+int      mcwdt_sim_run(mcwdt_sim_app_t app, uint64_t until_ns);
+void     mcwdt_sim_finish(void);
+void     mcwdt_sim_advance_ns(uint64_t ns);
+void     mcwdt_sim_sleep(void);
+
+/* Observation */
+uint64_t mcwdt_sim_now_ns(void);
+uint64_t mcwdt_sim_lfclk_ticks(void);
+uint64_t mcwdt_sim_ticks_at_ns(uint64_t t_ns);
+uint64_t mcwdt_sim_tick_time_ns(uint64_t tick);
+const mcwdt_sim_stats_t *mcwdt_sim_stats(void);
+size_t   mcwdt_sim_uart_captured(void);
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MCWDT_SIM_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,363 @@
+/******************************************************************************
+* File Name:   multi_capture_bench.c
+*
+* Description: Compares timestamping 16 GPIO inputs in one interrupt pass with
+*              one interrupt entry per pin.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "bench_util.h"
+#include "mcwdt_timebase.h"
+#include "multi_capture.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define BENCH_ROUNDS                        (4000U)
+#define BENCH_CHANNELS                      (MULTI_CAPTURE_MAX_CHANNELS)
+
+/* Gap between rounds of edges */
+#define BENCH_MIN_GAP_US                    (200U)
+#define BENCH_MAX_GAP_US                    (5000U)
+
+#define BENCH_TAIL_MS                       (10U)
+
+#define BENCH_TICK_US                       (1e6 / (double)CY_SYSCLK_WCO_FREQ)
+
+/* Generator seed of the scenario */
+#define BENCH_RNG_SEED                      (0x94D049BB133111EBULL)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint64_t tick;
+    uint32_t level;
+} bench_edge_t;
+
+typedef struct
+{
+    const char *name;
+    unsigned edges;
+    unsigned captured;
+    unsigned wrong;             /* Out of order, wrong level or early      */
+    double err_sum_us;
+    double err_max_us;
+    unsigned isr_count;
+    uint64_t reads;             /* MCWDT and GPIO register reads           */
+    timestamp_ring_stats_t ring;
+} bench_result_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Eight channels on each of two ports */
+static const multi_capture_channel_t bench_channels[BENCH_CHANNELS] =
+{
+    { GPIO_PRT5, 0U, ioss_interrupts_gpio_5_IRQn }, { GPIO_PRT5, 1U, ioss_interrupts_gpio_5_IRQn },
+    { GPIO_PRT5, 2U, ioss_interrupts_gpio_5_IRQn }, { GPIO_PRT5, 3U, ioss_interrupts_gpio_5_IRQn },
+    { GPIO_PRT5, 4U, ioss_interrupts_gpio_5_IRQn }, { GPIO_PRT5, 5U, ioss_interrupts_gpio_5_IRQn },
+    { GPIO_PRT5, 6U, ioss_interrupts_gpio_5_IRQn }, { GPIO_PRT5, 7U, ioss_interrupts_gpio_5_IRQn },
+    { GPIO_PRT9, 0U, ioss_interrupts_gpio_9_IRQn }, { GPIO_PRT9, 1U, ioss_interrupts_gpio_9_IRQn },
+    { GPIO_PRT9, 2U, ioss_interrupts_gpio_9_IRQn }, { GPIO_PRT9, 3U, ioss_interrupts_gpio_9_IRQn },
+    { GPIO_PRT9, 4U, ioss_interrupts_gpio_9_IRQn }, { GPIO_PRT9, 5U, ioss_interrupts_gpio_9_IRQn },
+    { GPIO_PRT9, 6U, ioss_interrupts_gpio_9_IRQn }, { GPIO_PRT9, 7U, ioss_interrupts_gpio_9_IRQn }
+};
+
+/* Edges scheduled on each channel, and how many have been matched */
+static bench_edge_t expected[BENCH_CHANNELS][BENCH_ROUNDS];
+static unsigned expected_count[BENCH_CHANNELS];
+static unsigned matched[BENCH_CHANNELS];
+
+static bench_result_t *current;
+
+/* Per-pin baseline: its own event ring */
+static timestamp_ring_t pin_ring;
+
+
+/*******************************************************************************
+* Function Name: schedule_scenario
+********************************************************************************
+* Summary:
+*  Schedules rounds of edges: half of them one channel, the other half 2 to 16
+*  channels switching at the same instant, as on a parallel bus or a shared
+*  trigger. Returns the time at which the run should stop.
+*******************************************************************************/
+static uint64_t schedule_scenario(void)
+{
+    uint32_t level[BENCH_CHANNELS];
+    uint64_t t = MCWDT_SIM_NS_PER_S;
+    uint32_t r;
+    uint32_t c;
+
+    bench_util_rng_seed(BENCH_RNG_SEED);
+    memset(expected_count, 0, sizeof(expected_count));
+    memset(matched, 0, sizeof(matched));
+    for (c = 0U; c < BENCH_CHANNELS; c++)
+    {
+        level[c] = 1U;
+    }
+
+    for (r = 0U; r < BENCH_ROUNDS; r++)
+    {
+        uint32_t mask = (0U == bench_util_rng_range(2U)) ?
+                        (1UL << bench_util_rng_range(BENCH_CHANNELS)) :
+                        (uint32_t)bench_util_rng_range(1UL << BENCH_CHANNELS);
+
+        t += (BENCH_MIN_GAP_US + bench_util_rng_range(BENCH_MAX_GAP_US - BENCH_MIN_GAP_US)) *
+             MCWDT_SIM_NS_PER_US;
+        mask = (0U == (mask & (mask - 1U))) ? (mask | 1U) : mask;
+        for (c = 0U; c < BENCH_CHANNELS; c++)
+        {
+            if (0U != (mask & (1UL << c)))
+            {
+                level[c] ^= 1U;
+                mcwdt_sim_schedule_pin(bench_channels[c].port, bench_channels[c].pin, t, level[c]);
+                expected[c][expected_count[c]].tick = mcwdt_sim_ticks_at_ns(t);
+                expected[c][expected_count[c]].level = level[c];
+                expected_count[c]++;
+                current->edges++;
+            }
+        }
+    }
+
+    return t + (BENCH_TAIL_MS * MCWDT_SIM_NS_PER_MS);
+}
+
+
+/*******************************************************************************
+* Function Name: record_event
+*******************************************************************************/
+static void record_event(uint32_t channel, uint64_t timestamp, uint32_t level)
+{
+    bench_edge_t const *edge;
+    double err;
+
+    if ((channel >= BENCH_CHANNELS) || (matched[channel] >= expected_count[channel]))
+    {
+        current->wrong++;
+        return;
+    }
+
+    edge = &expected[channel][matched[channel]++];
+    if ((edge->level != level) || (timestamp < edge->tick))
+    {
+        current->wrong++;
+        return;
+    }
+
+    err = (double)(timestamp - edge->tick) * BENCH_TICK_US;
+    current->err_sum_us += err;
+    current->err_max_us = (err > current->err_max_us) ? err : current->err_max_us;
+    current->captured++;
+}
+
+
+/*******************************************************************************
+* Function Name: irq_hook
+*******************************************************************************/
+static void irq_hook(uint32_t irqn)
+{
+    if ((irqn == (uint32_t)ioss_interrupts_gpio_5_IRQn) ||
+        (irqn == (uint32_t)ioss_interrupts_gpio_9_IRQn))
+    {
+        current->isr_count++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: multi_capture_app
+*******************************************************************************/
+static void multi_capture_app(void)
+{
+    multi_capture_event_t event;
+    uint32_t intr_status;
+    bool got;
+
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == multi_capture_init(bench_channels, BENCH_CHANNELS));
+
+    for (;;)
+    {
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        got = multi_capture_get_event(&event);
+        if (!got)
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+
+        if (got)
+        {
+            record_event(event.channel, event.timestamp, event.level);
+            multi_capture_get_ring_stats(&current->ring);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: per_pin_isr
+********************************************************************************
+* Summary:
+*  The button_capture.c pattern applied to many pins: each entry timestamps and
+*  serves the lowest pending pin of the port, and the interrupt stays asserted
+*  until every pin has had its own entry.
+*******************************************************************************/
+static void per_pin_isr(void)
+{
+    uint64_t now = mcwdt_timebase_read64();
+    uint32_t c;
+
+    for (c = 0U; c < BENCH_CHANNELS; c++)
+    {
+        GPIO_PRT_Type *port = bench_channels[c].port;
+        uint32_t pin = bench_channels[c].pin;
+
+        if (0U != Cy_GPIO_GetInterruptStatusMasked(port, pin))
+        {
+            Cy_GPIO_ClearInterrupt(port, pin);
+            (void)timestamp_ring_push(&pin_ring, now, c | (Cy_GPIO_Read(port, pin) << 8));
+            return;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: per_pin_app
+*******************************************************************************/
+static void per_pin_app(void)
+{
+    static const cy_stc_sysint_t intr5 = { ioss_interrupts_gpio_5_IRQn, 3U };
+    static const cy_stc_sysint_t intr9 = { ioss_interrupts_gpio_9_IRQn, 3U };
+    timestamp_record_t record;
+    uint32_t intr_status;
+    uint32_t c;
+    bool got;
+
+    bench_util_start_mcwdt();
+    timestamp_ring_init(&pin_ring);
+    CY_ASSERT(CY_SYSINT_SUCCESS == Cy_SysInt_Init(&intr5, per_pin_isr));
+    CY_ASSERT(CY_SYSINT_SUCCESS == Cy_SysInt_Init(&intr9, per_pin_isr));
+    for (c = 0U; c < BENCH_CHANNELS; c++)
+    {
+        Cy_GPIO_SetInterruptEdge(bench_channels[c].port, bench_channels[c].pin, CY_GPIO_INTR_BOTH);
+        Cy_GPIO_SetInterruptMask(bench_channels[c].port, bench_channels[c].pin, 1U);
+    }
+    NVIC_EnableIRQ(ioss_interrupts_gpio_5_IRQn);
+    NVIC_EnableIRQ(ioss_interrupts_gpio_9_IRQn);
+
+    for (;;)
+    {
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        got = (0U != timestamp_ring_count(&pin_ring));
+        if (got)
+        {
+            record = *timestamp_ring_at(&pin_ring, 0U);
+            timestamp_ring_release(&pin_ring, 1U);
+        }
+        else
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+
+        if (got)
+        {
+            record_event(record.event & 0xFFU, timestamp_record_time(&record), record.event >> 8);
+            timestamp_ring_get_stats(&pin_ring, &current->ring);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(bench_result_t *res, mcwdt_sim_app_t app)
+{
+    const mcwdt_sim_stats_t *stats;
+
+    current = res;
+    mcwdt_sim_reset();
+    mcwdt_sim_set_irq_hook(irq_hook);
+    mcwdt_sim_run(app, schedule_scenario());
+    stats = mcwdt_sim_stats();
+    res->reads = stats->mcwdt_reads + stats->gpio_reads;
+
+    printf("%-18s | %6u | %8u | %5u | %9.2f / %6.2f | %9.3f | %11.2f | %3u / %u\n",
+           res->name, res->edges, res->captured, res->wrong,
+           res->err_sum_us / res->captured, res->err_max_us,
+           (double)res->isr_count / res->edges, (double)res->reads / res->edges,
+           (unsigned int)res->ring.high_water, (unsigned int)TIMESTAMP_RING_SIZE);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    bench_result_t single_pass = { .name = "single pass" };
+    bench_result_t per_pin = { .name = "one pin per entry" };
+
+    printf("%u rounds on %u channels over 2 ports; half of the rounds switch 2 to 16\n"
+           "channels at the same instant\n\n",
+           (unsigned int)BENCH_ROUNDS, (unsigned int)BENCH_CHANNELS);
+    printf("ISR dispatch       |  edges | captured | wrong | error mean/max(us) | ISRs/edge | reads/edge  | ring peak\n");
+    printf("-------------------|--------|----------|-------|--------------------|-----------|-------------|----------\n");
+
+    run(&single_pass, multi_capture_app);
+    run(&per_pin, per_pin_app);
+
+    return ((single_pass.captured == single_pass.edges) && (0U == single_pass.wrong))
+           ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
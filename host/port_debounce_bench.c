@@ -0,0 +1,355 @@
+/******************************************************************************
+* File Name:   port_debounce_bench.c
+*
+* Description: Checks the vertical-counter port debouncer against per-pin counters
+*              on recorded bounce traces and compares their cost.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "bench_util.h"
+#include "port_debounce.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Port samples in the trace, one every BENCH_TICK_MS: about 5.8 hours */
+#define BENCH_SAMPLES                       (1U << 21)
+#define BENCH_TICK_MS                       (10U)
+#define BENCH_PINS                          (32U)
+#define BENCH_ROUNDS                        (5U)
+
+/* Switches bounce for up to this long after each edge, in pulses of 0.05 to
+ * 4 ms, and a few spikes of up to 2 ticks hit idle pins */
+#define BENCH_MAX_BOUNCE_US                 (25000U)
+#define BENCH_MAX_PULSE_US                  (4000U)
+#define BENCH_SPIKE_INTERVAL                (7U)
+
+/* Press lengths and gaps between presses, kept longer than the debounce
+ * window plus the bounce */
+#define BENCH_MIN_HOLD_MS                   (150U)
+#define BENCH_MAX_HOLD_MS                   (2000U)
+#define BENCH_MIN_GAP_MS                    (150U)
+#define BENCH_MAX_GAP_MS                    (30000U)
+
+#define BENCH_US_PER_TICK                   (BENCH_TICK_MS * 1000ULL)
+
+/* Generator seed of the traces */
+#define BENCH_RNG_SEED                      (0xBF58476D1CE4E5B9ULL)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* The trace: bit n of each sample is the raw level of pin n */
+static uint32_t trace[BENCH_SAMPLES];
+static unsigned presses[BENCH_PINS];
+
+/* Trace recording: samples filled so far and the level since, per pin */
+static uint64_t pin_filled[BENCH_PINS];
+static uint32_t pin_level[BENCH_PINS];
+
+/* Keeps the compiler from discarding the results */
+static volatile uint32_t sink;
+
+
+/*******************************************************************************
+* Function Name: set_level
+********************************************************************************
+* Summary:
+*  Sets the level of a pin from t_us on. Calls for a pin must come in time
+*  order: the samples up to t_us are filled with the previous level.
+*******************************************************************************/
+static void set_level(uint32_t pin, uint64_t t_us, uint32_t level)
+{
+    uint64_t end = (t_us + BENCH_US_PER_TICK - 1U) / BENCH_US_PER_TICK;
+    uint32_t bit = 1UL << pin;
+
+    end = (end < BENCH_SAMPLES) ? end : BENCH_SAMPLES;
+    for (; pin_filled[pin] < end; pin_filled[pin]++)
+    {
+        trace[pin_filled[pin]] = (0U != pin_level[pin]) ? (trace[pin_filled[pin]] | bit)
+                                                        : (trace[pin_filled[pin]] & ~bit);
+    }
+    pin_level[pin] = level;
+}
+
+
+/*******************************************************************************
+* Function Name: bouncy_edge
+********************************************************************************
+* Summary:
+*  Switches a pin to 'level' at t_us, with a train of bounces that settles on
+*  'level'. Returns the time the pin settles.
+*******************************************************************************/
+static uint64_t bouncy_edge(uint32_t pin, uint64_t t_us, uint32_t level)
+{
+    uint64_t end = t_us + bench_util_rng_range(BENCH_MAX_BOUNCE_US);
+    uint64_t t = t_us;
+
+    set_level(pin, t, level);
+    while (t < end)
+    {
+        t += 50U + bench_util_rng_range(BENCH_MAX_PULSE_US);
+        set_level(pin, t, level ^ 1U);
+        t += 50U + bench_util_rng_range(BENCH_MAX_PULSE_US);
+        set_level(pin, t, level);
+    }
+
+    return t;
+}
+
+
+/*******************************************************************************
+* Function Name: build_trace
+********************************************************************************
+* Summary:
+*  Records presses of an active-low switch on every pin, each edge with its
+*  own bounce train, and some short spikes between presses that must not be
+*  reported.
+*******************************************************************************/
+static void build_trace(void)
+{
+    uint64_t trace_us = (uint64_t)BENCH_SAMPLES * BENCH_US_PER_TICK;
+    uint32_t pin;
+
+    bench_util_rng_seed(BENCH_RNG_SEED);
+    for (pin = 0U; pin < BENCH_PINS; pin++)
+    {
+        uint64_t t = (BENCH_MIN_GAP_MS + bench_util_rng_range(BENCH_MAX_GAP_MS)) * 1000ULL;
+
+        pin_filled[pin] = 0U;
+        pin_level[pin] = 1U;
+
+        for (;;)
+        {
+            uint64_t hold = (BENCH_MIN_HOLD_MS + bench_util_rng_range(BENCH_MAX_HOLD_MS)) * 1000ULL;
+            uint64_t gap = (BENCH_MIN_GAP_MS + bench_util_rng_range(BENCH_MAX_GAP_MS)) * 1000ULL;
+
+            if ((t + hold + gap) >= trace_us)
+            {
+                break;
+            }
+            (void)bouncy_edge(pin, t, 0U);
+            t = bouncy_edge(pin, t + hold, 1U);
+            presses[pin]++;
+
+            if (0U == bench_util_rng_range(BENCH_SPIKE_INTERVAL))
+            {
+                uint64_t spike = t + (gap / 2U);
+
+                set_level(pin, spike, 0U);
+                set_level(pin, spike + 1000U + bench_util_rng_range(2U * BENCH_US_PER_TICK), 1U);
+            }
+            t += gap;
+        }
+        set_level(pin, trace_us, 1U);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: scalar_update
+********************************************************************************
+* Summary:
+*  The counting rule of read_switch_status(), run for each pin in turn: a
+*  counter per pin counts consecutive samples away from the debounced level
+*  and the level changes when it reaches the window.
+*******************************************************************************/
+static uint32_t scalar_update(uint32_t *state, uint8_t *count, uint32_t pins, uint32_t sample)
+{
+    uint32_t changed = 0U;
+    uint32_t pin;
+
+    for (pin = 0U; pin < pins; pin++)
+    {
+        uint32_t bit = 1UL << pin;
+
+        if (((sample ^ *state) & bit) != 0U)
+        {
+            if (++count[pin] >= PORT_DEBOUNCE_SAMPLES)
+            {
+                count[pin] = 0U;
+                *state ^= bit;
+                changed |= bit;
+            }
+        }
+        else
+        {
+            count[pin] = 0U;
+        }
+    }
+
+    return changed;
+}
+
+
+/*******************************************************************************
+* Function Name: check
+********************************************************************************
+* Summary:
+*  Runs both debouncers over the trace. Returns the number of samples where
+*  they disagree, and counts the debounced changes of each pin.
+*******************************************************************************/
+static unsigned check(unsigned changes[BENCH_PINS])
+{
+    port_debounce_t vertical;
+    uint8_t count[BENCH_PINS] = { 0U };
+    uint32_t state = trace[0];
+    unsigned errors = 0U;
+    uint32_t i;
+    uint32_t pin;
+
+    port_debounce_init(&vertical, trace[0]);
+    for (i = 0U; i < BENCH_SAMPLES; i++)
+    {
+        uint32_t v = port_debounce_update(&vertical, trace[i]);
+        uint32_t s = scalar_update(&state, count, BENCH_PINS, trace[i]);
+
+        errors += ((v != s) || (port_debounce_state(&vertical) != state)) ? 1U : 0U;
+        for (pin = 0U; pin < BENCH_PINS; pin++)
+        {
+            changes[pin] += (v >> pin) & 1U;
+        }
+    }
+
+    return errors;
+}
+
+
+/*******************************************************************************
+* Function Name: time_scalar
+********************************************************************************
+* Summary:
+*  Returns the mean wall time in nanoseconds per sample for the scalar rule.
+*******************************************************************************/
+static double time_scalar(uint32_t pins)
+{
+    uint64_t best = UINT64_MAX;
+    uint32_t r;
+
+    for (r = 0U; r < BENCH_ROUNDS; r++)
+    {
+        uint8_t count[BENCH_PINS] = { 0U };
+        uint32_t state = trace[0];
+        uint32_t acc = 0U;
+        uint64_t t0 = bench_util_wall_ns();
+        uint32_t i;
+
+        for (i = 0U; i < BENCH_SAMPLES; i++)
+        {
+            acc ^= scalar_update(&state, count, pins, trace[i]);
+        }
+        t0 = bench_util_wall_ns() - t0;
+        best = (t0 < best) ? t0 : best;
+        sink = acc;
+    }
+
+    return (double)best / BENCH_SAMPLES;
+}
+
+
+/*******************************************************************************
+* Function Name: time_vertical
+*******************************************************************************/
+static double time_vertical(void)
+{
+    uint64_t best = UINT64_MAX;
+    uint32_t r;
+
+    for (r = 0U; r < BENCH_ROUNDS; r++)
+    {
+        port_debounce_t vertical;
+        uint32_t acc = 0U;
+        uint64_t t0 = bench_util_wall_ns();
+        uint32_t i;
+
+        port_debounce_init(&vertical, trace[0]);
+        for (i = 0U; i < BENCH_SAMPLES; i++)
+        {
+            acc ^= port_debounce_update(&vertical, trace[i]);
+        }
+        t0 = bench_util_wall_ns() - t0;
+        best = (t0 < best) ? t0 : best;
+        sink = acc;
+    }
+
+    return (double)best / BENCH_SAMPLES;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    unsigned changes[BENCH_PINS] = { 0U };
+    unsigned wrong_pins = 0U;
+    unsigned total = 0U;
+    unsigned errors;
+    uint32_t pin;
+
+    build_trace();
+    errors = check(changes);
+    for (pin = 0U; pin < BENCH_PINS; pin++)
+    {
+        wrong_pins += (changes[pin] != (2U * presses[pin])) ? 1U : 0U;
+        total += presses[pin];
+    }
+
+    printf("%u samples of %u pins, %u ms apart; %u presses with bounce trains of up\n"
+           "to %u ms and spikes between them; debounce window %u samples\n\n",
+           (unsigned int)BENCH_SAMPLES, (unsigned int)BENCH_PINS, (unsigned int)BENCH_TICK_MS,
+           total, (unsigned int)(BENCH_MAX_BOUNCE_US / 1000U), (unsigned int)PORT_DEBOUNCE_SAMPLES);
+    printf("vertical counters against per-pin counters: %u samples differ\n", errors);
+    printf("pins with other than one press and one release per press: %u\n\n", wrong_pins);
+
+    printf("debouncer                | pins | ns/sample\n");
+    printf("-------------------------|------|----------\n");
+    printf("per-pin counters         |    1 | %9.2f\n", time_scalar(1U));
+    printf("per-pin counters         |    8 | %9.2f\n", time_scalar(8U));
+    printf("per-pin counters         |   32 | %9.2f\n", time_scalar(32U));
+    printf("vertical counters        |   32 | %9.2f\n", time_vertical());
+
+    return ((0U == errors) && (0U == wrong_pins)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
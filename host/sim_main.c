@@ -0,0 +1,230 @@
+/******************************************************************************
+* File Name:   sim_main.c
+*
+* Description: Host entry point: schedules user button presses from the command
+*              line and runs the unmodified application main() on the simulator.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <getopt.h>
+#include <string.h>
+#include <time.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Default time the simulated user button is held down */
+#define SIM_DEFAULT_HOLD_MS                 (150.0)
+
+/* Without --until, the run stops this long after the last button release or
+ * received character */
+#define SIM_DEFAULT_TAIL_MS                 (1000.0)
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+
+/* main() of ../main.c, renamed by the host Makefile */
+void app_main(void);
+
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -p, --press T[:HOLD]   press the user button at T s for HOLD ms (default %.0f)\n"
+            "  -r, --receive T:TEXT   send TEXT to the debug UART at T s\n"
+            "  -s, --start COUNT      preset the cascaded Counter1:Counter0 value\n"
+            "  -d, --drift [T:]PPM    LFCLK frequency error in ppm, from T s if given\n"
+            "  -R, --reset T          reset the device at T s\n"
+            "  -i, --ilo HZ           no WCO: LFCLK from an ILO at HZ before trimming\n"
+            "  -u, --until T          stop after T s of virtual time (default %.0f ms\n"
+            "                         after the last input)\n"
+            "  -v, --verbose          print simulator statistics on exit\n",
+            prog, SIM_DEFAULT_HOLD_MS, SIM_DEFAULT_TAIL_MS);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Builds a scenario from the command line and runs the application on the
+*  simulated MCWDT until shortly after the last scheduled input. The time
+*  base interrupts periodically, so the run would otherwise never go idle.
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static const struct option options[] =
+    {
+        { "press",   required_argument, NULL, 'p' },
+        { "receive", required_argument, NULL, 'r' },
+        { "start",   required_argument, NULL, 's' },
+        { "drift",   required_argument, NULL, 'd' },
+        { "ilo",     required_argument, NULL, 'i' },
+        { "reset",   required_argument, NULL, 'R' },
+        { "until",   required_argument, NULL, 'u' },
+        { "verbose", no_argument,       NULL, 'v' },
+        { NULL,      0,                 NULL, 0   }
+    };
+    uint64_t until_ns = 0U;
+    uint64_t last_input_ns = 0U;
+    bool verbose = false;
+    struct timespec wall0;
+    struct timespec wall1;
+    const mcwdt_sim_stats_t *stats;
+    int status;
+    int opt;
+
+    mcwdt_sim_reset();
+
+    while ((opt = getopt_long(argc, argv, "p:r:s:d:i:R:u:v", options, NULL)) != -1)
+    {
+        switch (opt)
+        {
+            case 'p':
+            {
+                char *end;
+                double t = strtod(optarg, &end);
+                double hold = (*end == ':') ? strtod(end + 1, NULL) : SIM_DEFAULT_HOLD_MS;
+                mcwdt_sim_schedule_press((uint64_t)(t * 1e9), (uint64_t)(hold * 1e6));
+                if ((uint64_t)((t * 1e9) + (hold * 1e6)) > last_input_ns)
+                {
+                    last_input_ns = (uint64_t)((t * 1e9) + (hold * 1e6));
+                }
+                break;
+            }
+            case 'r':
+            {
+                char *end;
+                double t = strtod(optarg, &end);
+                mcwdt_sim_schedule_uart_rx((uint64_t)(t * 1e9), (*end == ':') ? (end + 1) : "");
+                if ((uint64_t)(t * 1e9) > last_input_ns)
+                {
+                    last_input_ns = (uint64_t)(t * 1e9);
+                }
+                break;
+            }
+            case 's':
+            {
+                uint32_t count = (uint32_t)strtoul(optarg, NULL, 0);
+                mcwdt_sim_preset_count(MCWDT_0_HW, CY_MCWDT_COUNTER0, count & 0xFFFFU);
+                mcwdt_sim_preset_count(MCWDT_0_HW, CY_MCWDT_COUNTER1, count >> 16);
+                break;
+            }
+            case 'd':
+            {
+                char *end;
+                double value = strtod(optarg, &end);
+                if (*end == ':')
+                {
+                    mcwdt_sim_schedule_drift((uint64_t)(value * 1e9),
+                                             (int64_t)(strtod(end + 1, NULL) * 1000.0));
+                }
+                else
+                {
+                    mcwdt_sim_set_lfclk_ppb((int64_t)(value * 1000.0));
+                }
+                break;
+            }
+            case 'R':
+            {
+                double t = strtod(optarg, NULL);
+                mcwdt_sim_schedule_reset((uint64_t)(t * 1e9));
+                if ((uint64_t)(t * 1e9) > last_input_ns)
+                {
+                    last_input_ns = (uint64_t)(t * 1e9);
+                }
+                break;
+            }
+            case 'i':
+                mcwdt_sim_set_wco_present(false);
+                mcwdt_sim_set_ilo_hz((uint32_t)strtoul(optarg, NULL, 0));
+                break;
+            case 'u':
+                until_ns = (uint64_t)(strtod(optarg, NULL) * 1e9);
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (0U == until_ns)
+    {
+        until_ns = last_input_ns + (uint64_t)(SIM_DEFAULT_TAIL_MS * 1e6);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &wall0);
+    status = mcwdt_sim_run(app_main, until_ns);
+    clock_gettime(CLOCK_MONOTONIC, &wall1);
+
+    if (verbose)
+    {
+        stats = mcwdt_sim_stats();
+        fprintf(stderr,
+                "[sim] virtual %.3f s in %.3f ms wall, busy %.3f s, sleep %.3f s\n"
+                "[sim] %llu MCWDT reads, %llu GPIO reads, %llu IRQs, %llu wakeups, %llu resets\n"
+                "[sim] %llu UART characters sent, %llu received characters lost\n",
+                (double)mcwdt_sim_now_ns() / 1e9,
+                ((double)(wall1.tv_sec - wall0.tv_sec) * 1e3) +
+                ((double)(wall1.tv_nsec - wall0.tv_nsec) / 1e6),
+                (double)stats->busy_ns / 1e9, (double)stats->sleep_ns / 1e9,
+                (unsigned long long)stats->mcwdt_reads, (unsigned long long)stats->gpio_reads,
+                (unsigned long long)stats->irq_count, (unsigned long long)stats->wakeups,
+                (unsigned long long)stats->resets,
+                (unsigned long long)stats->uart_bytes, (unsigned long long)stats->uart_rx_lost);
+    }
+
+    return (status == MCWDT_SIM_RUN_ASSERT) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,352 @@
+/******************************************************************************
+* File Name:   task_watchdog_test.c
+*
+* Description: Runs tasks under the per-task software watchdog, stalls one at a time,
+*              and checks that the supervisor reports exactly the stalled task before
+*              the reset, and that a healthy run is never reset.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "task_watchdog.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Virtual time of the healthy run */
+#define TEST_HEALTHY_S                      (600U)
+
+/* When a task stalls in the faulty runs, and how long they may run */
+#define TEST_STALL_AT_NS                    (60U * MCWDT_SIM_NS_PER_S + 123U * MCWDT_SIM_NS_PER_MS)
+
+/* When the 250 ms task runs again in the runs where it comes back. Its
+ * warning is at 61.875 s; it is back in time before the window opens at
+ * 62.25 s, and too late after that */
+#define TEST_RESUME_AT_NS                   (61U * MCWDT_SIM_NS_PER_S + 923U * MCWDT_SIM_NS_PER_MS)
+#define TEST_RESUME_LATE_AT_NS              (62U * MCWDT_SIM_NS_PER_S + 323U * MCWDT_SIM_NS_PER_MS)
+#define TEST_STALL_RUN_S                    (80U)
+
+/* From a warning to the MCWDT reset: the rest of the period, and the next
+ * one, whose match is the third without a feed */
+#define TEST_RESET_DELAY_NS                 (((2ULL * WATCHDOG_SUPERVISOR_PERIOD_CYCLES - WATCHDOG_SUPERVISOR_WARN_CYCLES) * \
+                                              MCWDT_SIM_NS_PER_S) / CY_SYSCLK_WCO_FREQ)
+
+/* Work done by a task each time it runs */
+#define TEST_WORK_NS                        (10U * MCWDT_SIM_NS_PER_US)
+
+/* Tasks run by the loop; one more checks in from the 1 kHz SysTick */
+#define TEST_TASKS                          (6U)
+#define TEST_TICK_TASK                      (TEST_TASKS)
+#define TEST_NO_STALL                       (0xFFU)
+
+/* Check-ins timed for their cost */
+#define TEST_CHECKINS                       (100000000U)
+
+#define TEST_NS_PER_CYCLE                   (1e9 / (double)CY_SYSCLK_WCO_FREQ)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t period_ms;
+    uint32_t windows;           /* Watchdog periods it may miss in a row */
+    uint32_t id;
+    uint64_t next_ns;
+} test_task_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t stall;             /* Task that stops, or TEST_NO_STALL */
+    uint64_t resume_ns;         /* When it runs again, or 0 for never */
+    uint64_t run_ns;
+    bool faulted;
+    watchdog_supervisor_fault_t fault;
+    uint32_t warnings;
+    uint64_t warning_ns;
+    uint64_t restart_ns;
+    uint64_t checkins;
+    mcwdt_sim_stats_t stats;
+} test_run_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static test_task_t tasks[TEST_TASKS] =
+{
+    { .period_ms = 2U,    .windows = 1U },
+    { .period_ms = 10U,   .windows = 1U },
+    { .period_ms = 50U,   .windows = 1U },
+    { .period_ms = 250U,  .windows = 1U },
+    { .period_ms = 700U,  .windows = 2U },
+    { .period_ms = 3000U, .windows = 4U },
+};
+static uint32_t tick_id;
+static test_run_t *current;
+
+
+/*******************************************************************************
+* Function Name: SysTick_Handler
+********************************************************************************
+* Summary:
+*  Checks in from interrupt context, 1000 times a second.
+*******************************************************************************/
+void SysTick_Handler(void)
+{
+    task_watchdog_checkin(tick_id);
+    current->checkins++;
+}
+
+
+/*******************************************************************************
+* Function Name: on_warning
+*******************************************************************************/
+static void on_warning(watchdog_supervisor_fault_t const *fault)
+{
+    current->warnings++;
+    current->warning_ns = mcwdt_sim_now_ns();
+}
+
+
+/*******************************************************************************
+* Function Name: task_app
+********************************************************************************
+* Summary:
+*  A cooperative scheduler that runs each task on its period. Every run
+*  checks in; a stalled task stops running from the stall time on.
+*******************************************************************************/
+static void task_app(void)
+{
+    uint64_t now;
+    uint64_t next;
+    uint32_t i;
+
+    bench_util_start_mcwdt();
+
+    if (watchdog_supervisor_get_fault(&current->fault))
+    {
+        current->faulted = true;
+        current->restart_ns = mcwdt_sim_now_ns();
+        mcwdt_sim_finish();
+    }
+
+    CY_ASSERT(CY_RSLT_SUCCESS == task_watchdog_init(on_warning));
+    for (i = 0U; i < TEST_TASKS; i++)
+    {
+        CY_ASSERT(task_watchdog_register(tasks[i].windows, &tasks[i].id));
+        tasks[i].next_ns = mcwdt_sim_now_ns();
+    }
+    CY_ASSERT(task_watchdog_register(1U, &tick_id));
+    CY_ASSERT(0U == SysTick_Config(SystemCoreClock / 1000U));
+
+    for (;;)
+    {
+        now = mcwdt_sim_now_ns();
+        next = UINT64_MAX;
+        for (i = 0U; i < TEST_TASKS; i++)
+        {
+            if ((i == current->stall) && (now >= TEST_STALL_AT_NS) &&
+                ((0U == current->resume_ns) || (now < current->resume_ns)))
+            {
+                continue;
+            }
+            if (now >= tasks[i].next_ns)
+            {
+                task_watchdog_checkin(tasks[i].id);
+                current->checkins++;
+                mcwdt_sim_advance_ns(TEST_WORK_NS);
+                tasks[i].next_ns += (uint64_t)tasks[i].period_ms * MCWDT_SIM_NS_PER_MS;
+            }
+            next = (tasks[i].next_ns < next) ? tasks[i].next_ns : next;
+        }
+
+        if ((TEST_TICK_TASK == current->stall) && (now >= TEST_STALL_AT_NS))
+        {
+            SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+        }
+
+        now = mcwdt_sim_now_ns();
+        if (next > now)
+        {
+            mcwdt_sim_advance_ns(next - now);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(test_run_t *r)
+{
+    watchdog_supervisor_fault_t stale;
+    double stall_s = (double)TEST_STALL_AT_NS / 1e9;
+
+    current = r;
+    (void)watchdog_supervisor_get_fault(&stale);
+    mcwdt_sim_reset();
+    (void)mcwdt_sim_run(task_app, r->run_ns);
+    r->stats = *mcwdt_sim_stats();
+
+    printf("%-16s | %10.0f | %6llu | ", r->name, (double)r->checkins * MCWDT_SIM_NS_PER_S / (double)r->run_ns,
+           (unsigned long long)r->stats.resets);
+    if (r->faulted)
+    {
+        printf("%9.3f | %9.3f | %-8s | 0x%02x\n", (double)r->warning_ns / 1e9 - stall_s,
+               (double)r->restart_ns / 1e9 - stall_s,
+               (WATCHDOG_SUPERVISOR_FAULT_STARVED == r->fault.cause) ? "not fed" : "other",
+               (unsigned int)r->fault.detail);
+    }
+    else
+    {
+        printf("%9s | %9s | %-8s | -\n", "-", "-", "-");
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: reset_in_time
+********************************************************************************
+* Summary:
+*  True if the run restarted with a fault record, within a millisecond after
+*  the end of the period that follows its warning.
+*
+*******************************************************************************/
+static bool reset_in_time(test_run_t const *r)
+{
+    uint64_t delay = r->restart_ns - r->warning_ns;
+
+    return r->faulted && (delay >= TEST_RESET_DELAY_NS) &&
+           (delay < (TEST_RESET_DELAY_NS + MCWDT_SIM_NS_PER_MS));
+}
+
+
+/*******************************************************************************
+* Function Name: checkin_ns
+********************************************************************************
+* Summary:
+*  Wall time of a check-in on the host with the bit already set, which is
+*  the case for all but the first check-in of a task in each window.
+*******************************************************************************/
+static double checkin_ns(void)
+{
+    uint64_t t0;
+    uint32_t i;
+
+    task_watchdog_checkins = 0xFFFFFFFFUL;
+    t0 = bench_util_wall_ns();
+    for (i = 0U; i < TEST_CHECKINS; i++)
+    {
+        task_watchdog_checkin(i & 31U);
+    }
+    return (double)(bench_util_wall_ns() - t0) / (double)TEST_CHECKINS;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    test_run_t healthy = { .name = "healthy", .stall = TEST_NO_STALL,
+                           .run_ns = TEST_HEALTHY_S * MCWDT_SIM_NS_PER_S };
+    test_run_t fast = { .name = "250 ms task", .stall = 3U,
+                        .run_ns = TEST_STALL_RUN_S * MCWDT_SIM_NS_PER_S };
+    test_run_t slow = { .name = "3 s task", .stall = 5U,
+                        .run_ns = TEST_STALL_RUN_S * MCWDT_SIM_NS_PER_S };
+    test_run_t tick = { .name = "SysTick", .stall = TEST_TICK_TASK,
+                        .run_ns = TEST_STALL_RUN_S * MCWDT_SIM_NS_PER_S };
+    test_run_t back = { .name = "250 ms, back", .stall = 3U, .resume_ns = TEST_RESUME_AT_NS,
+                        .run_ns = TEST_STALL_RUN_S * MCWDT_SIM_NS_PER_S };
+    test_run_t late = { .name = "250 ms, too late", .stall = 3U, .resume_ns = TEST_RESUME_LATE_AT_NS,
+                        .run_ns = TEST_STALL_RUN_S * MCWDT_SIM_NS_PER_S };
+    uint64_t record_ns;
+    double best = 1e9;
+    double t;
+    uint32_t i;
+    bool ok;
+
+    printf("%u tasks every 2, 10, 50, 250, 700 (2 windows) and 3000 ms (4 windows), one\n"
+           "more from SysTick at 1 kHz; watchdog period %.0f ms. A task stalls at %.3f s;\n"
+           "times below are seconds after the stall\n\n",
+           TEST_TASKS + 1U, WATCHDOG_SUPERVISOR_PERIOD_CYCLES * TEST_NS_PER_CYCLE / 1e6,
+           (double)TEST_STALL_AT_NS / 1e9);
+    printf("stalled          | check-in/s | resets | warning   | restart   | cause    | tasks\n");
+    printf("-----------------|------------|--------|-----------|-----------|----------|------\n");
+    run(&healthy);
+    run(&fast);
+    run(&slow);
+    run(&tick);
+    run(&back);
+    run(&late);
+
+    for (i = 0U; i < 3U; i++)
+    {
+        t = checkin_ns();
+        best = (t < best) ? t : best;
+    }
+    printf("\ncheck-in with the bit already set: %.3f ns on the host\n", best);
+
+    ok = (0U == healthy.stats.resets) && (0U == healthy.warnings) &&
+         reset_in_time(&fast) && (1U == fast.warnings) && ((1UL << 3) == fast.fault.detail) &&
+         reset_in_time(&slow) && (1U == slow.warnings) && ((1UL << 5) == slow.fault.detail) &&
+         reset_in_time(&tick) && (1U == tick.warnings) && ((1UL << TEST_TICK_TASK) == tick.fault.detail) &&
+         (1U == fast.stats.resets) && (1U == slow.stats.resets) && (1U == tick.stats.resets);
+
+    /* Back in time: the feed at the next window drops the warning. Too late:
+     * the record made at the warning survives the window opening after it,
+     * where the task is still missing, and the reset a period later */
+    record_ns = (late.fault.timestamp * MCWDT_SIM_NS_PER_S) / CY_SYSCLK_WCO_FREQ;
+    ok = ok && !back.faulted && (1U == back.warnings) && (0U == back.stats.resets) &&
+         reset_in_time(&late) && (1U == late.warnings) && (1U == late.stats.resets) &&
+         (WATCHDOG_SUPERVISOR_FAULT_STARVED == late.fault.cause) && ((1UL << 3) == late.fault.detail) &&
+         (record_ns <= late.warning_ns) && ((late.warning_ns - record_ns) < MCWDT_SIM_NS_PER_MS);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
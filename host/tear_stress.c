@@ -0,0 +1,284 @@
+/******************************************************************************
+* File Name:   tear_stress.c
+*
+* Description: Stress test of mcwdt_timebase_read32() on the simulator. Samples are
+*              concentrated around Counter0 wraps and compared with the LFCLK count
+*              before and after each read; the two-read method of the original
+*              main() is measured alongside for reference. mcwdt_timebase_read64()
+*              is checked the same way around the 32-bit wraps.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "mcwdt_timebase.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Default number of sample pairs */
+#define STRESS_DEFAULT_SAMPLES              (2000000UL)
+
+/* Samples are placed within this many LFCLK cycles of a Counter0 wrap */
+#define STRESS_WRAP_WINDOW_TICKS            (4U)
+
+/* Number of 32-bit half-range crossings sampled by mcwdt_timebase_read64() */
+#define STRESS_EPOCH_CROSSINGS              (20000UL)
+
+/* Nanoseconds per LFCLK cycle, for reporting */
+#define STRESS_LFCLK_PERIOD_NS              (1e9 / (double)CY_SYSCLK_WCO_FREQ)
+
+/* Generator seed of the sample phases */
+#define STRESS_RNG_SEED                     (0x9E3779B97F4A7C15ULL)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static unsigned long stress_samples = STRESS_DEFAULT_SAMPLES;
+
+static struct
+{
+    unsigned long naive_torn;
+    unsigned long safe_torn;
+    uint64_t naive_reads;
+    uint64_t safe_reads;
+    uint64_t naive_ns;
+    uint64_t safe_ns;
+} result;
+
+static unsigned long epoch_torn;
+
+
+/*******************************************************************************
+* Function Name: read_naive
+********************************************************************************
+* Summary:
+*  The two independent reads previously done in main().
+*******************************************************************************/
+static uint32_t read_naive(void)
+{
+    uint32_t counter0_value = Cy_MCWDT_GetCount(MCWDT_0_HW, CY_MCWDT_COUNTER0);
+    uint32_t counter1_value = Cy_MCWDT_GetCount(MCWDT_0_HW, CY_MCWDT_COUNTER1);
+
+    return ((counter1_value << 16) | counter0_value);
+}
+
+
+/*******************************************************************************
+* Function Name: read_timebase
+*******************************************************************************/
+static uint32_t read_timebase(void)
+{
+    return mcwdt_timebase_read32(MCWDT_0_HW);
+}
+
+
+/*******************************************************************************
+* Function Name: sample
+********************************************************************************
+* Summary:
+*  Takes one reading and checks it against the LFCLK count seen just before
+*  and just after it. Returns true if the value lies outside that range.
+*******************************************************************************/
+static bool sample(uint32_t (*read)(void), uint64_t *reads, uint64_t *ns)
+{
+    uint64_t reads0 = mcwdt_sim_stats()->mcwdt_reads;
+    uint64_t t0 = mcwdt_sim_now_ns();
+    uint32_t before = (uint32_t)mcwdt_sim_lfclk_ticks();
+    uint32_t value = read();
+    uint32_t after = (uint32_t)mcwdt_sim_lfclk_ticks();
+
+    *reads += mcwdt_sim_stats()->mcwdt_reads - reads0;
+    *ns += mcwdt_sim_now_ns() - t0;
+
+    return ((uint32_t)(value - before) > (uint32_t)(after - before));
+}
+
+
+/*******************************************************************************
+* Function Name: stress_app
+********************************************************************************
+* Summary:
+*  Starts MCWDT_0 as main() does and then repeatedly moves virtual time to a
+*  random phase close to a Counter0 wrap before taking a sample with each
+*  read method.
+*******************************************************************************/
+static void stress_app(void)
+{
+    unsigned long i;
+
+    CY_ASSERT(CY_MCWDT_SUCCESS == Cy_MCWDT_Init(MCWDT_0_HW, &MCWDT_0_config));
+    Cy_MCWDT_Enable(MCWDT_0_HW, CY_MCWDT_CTR0 | CY_MCWDT_CTR1, 93U);
+
+    for (i = 0U; i < stress_samples; i++)
+    {
+        uint64_t now = mcwdt_sim_lfclk_ticks();
+        uint64_t wrap = (now | 0xFFFFULL) + 1U;
+        uint64_t target = wrap - STRESS_WRAP_WINDOW_TICKS +
+                          (bench_util_rng_next() % (2U * STRESS_WRAP_WINDOW_TICKS));
+        uint64_t t = mcwdt_sim_tick_time_ns(target) + (bench_util_rng_next() % 30518U);
+
+        if (t > mcwdt_sim_now_ns())
+        {
+            mcwdt_sim_advance_ns(t - mcwdt_sim_now_ns());
+        }
+
+        if ((i & 1U) == 0U)
+        {
+            result.naive_torn += sample(read_naive, &result.naive_reads, &result.naive_ns) ? 1U : 0U;
+        }
+        else
+        {
+            result.safe_torn += sample(read_timebase, &result.safe_reads, &result.safe_ns) ? 1U : 0U;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: epoch_app
+********************************************************************************
+* Summary:
+*  Starts the 64-bit time base as main() does and samples it around each
+*  crossing of half the 32-bit range. Every other sample is taken with
+*  interrupts disabled, so that the Counter 1 interrupt of a crossing that has
+*  just happened is still pending.
+*******************************************************************************/
+static void epoch_app(void)
+{
+    unsigned long i;
+
+    bench_util_start_mcwdt();
+
+    for (i = 0U; i < STRESS_EPOCH_CROSSINGS; i++)
+    {
+        uint64_t crossing = (mcwdt_sim_lfclk_ticks() | 0x7FFFFFFFULL) + 1U;
+        uint64_t target = crossing - STRESS_WRAP_WINDOW_TICKS +
+                          (bench_util_rng_next() % (2U * STRESS_WRAP_WINDOW_TICKS));
+        uint64_t t = mcwdt_sim_tick_time_ns(target) + (bench_util_rng_next() % 30518U);
+        uint32_t intr_status = 0U;
+        uint64_t before;
+        uint64_t value;
+        uint64_t after;
+
+        if ((i & 1U) != 0U)
+        {
+            intr_status = Cy_SysLib_EnterCriticalSection();
+        }
+        if (t > mcwdt_sim_now_ns())
+        {
+            mcwdt_sim_advance_ns(t - mcwdt_sim_now_ns());
+        }
+
+        before = mcwdt_sim_lfclk_ticks();
+        value = mcwdt_timebase_read64();
+        after = mcwdt_sim_lfclk_ticks();
+        epoch_torn += ((value < before) || (value > after)) ? 1U : 0U;
+
+        if ((i & 1U) != 0U)
+        {
+            Cy_SysLib_ExitCriticalSection(intr_status);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static const uint32_t read_costs_ns[] = { 120U, 1000U, 15259U, 30518U };
+    uint32_t k;
+
+    if (argc > 1)
+    {
+        stress_samples = strtoul(argv[1], NULL, 0);
+    }
+
+    bench_util_rng_seed(STRESS_RNG_SEED);
+
+    printf("Cascaded MCWDT read stress: %lu samples within +/-%u LFCLK cycles of a wrap\n\n",
+           stress_samples, STRESS_WRAP_WINDOW_TICKS);
+    printf("read cost  | method       | torn      | reads/sample | cost/sample (LFCLK cycles)\n");
+    printf("-----------|--------------|-----------|--------------|---------------------------\n");
+
+    for (k = 0U; k < (sizeof(read_costs_ns) / sizeof(read_costs_ns[0])); k++)
+    {
+        mcwdt_sim_costs_t costs = { .mcwdt_read_ns = read_costs_ns[k], .gpio_read_ns = 20U };
+        unsigned long half = stress_samples / 2U;
+
+        memset(&result, 0, sizeof(result));
+        mcwdt_sim_reset();
+        mcwdt_sim_set_costs(&costs);
+        if (MCWDT_SIM_RUN_RETURNED != mcwdt_sim_run(stress_app, 0U))
+        {
+            return EXIT_FAILURE;
+        }
+
+        printf("%7u ns | two reads    | %9lu | %12.3f | %.5f\n", read_costs_ns[k],
+               result.naive_torn, (double)result.naive_reads / half,
+               (double)result.naive_ns / half / STRESS_LFCLK_PERIOD_NS);
+        printf("%7u ns | hi-lo-hi     | %9lu | %12.3f | %.5f\n", read_costs_ns[k],
+               result.safe_torn, (double)result.safe_reads / half,
+               (double)result.safe_ns / half / STRESS_LFCLK_PERIOD_NS);
+
+        if (result.safe_torn != 0U)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+
+    mcwdt_sim_reset();
+    if (MCWDT_SIM_RUN_RETURNED != mcwdt_sim_run(epoch_app, 0U))
+    {
+        return EXIT_FAILURE;
+    }
+    printf("\n64-bit read: %lu of %lu samples around 32-bit wraps and half-wraps wrong\n",
+           epoch_torn, STRESS_EPOCH_CROSSINGS);
+
+    return (epoch_torn == 0U) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,530 @@
+/******************************************************************************
+* File Name:   telemetry_decode.c
+*
+* Description: Decodes binary telemetry captures from the application, and
+*              benchmarks the decoder on a multi-megabyte synthetic capture.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cy_pdl.h"
+#include "interval_format.h"
+#include "telemetry.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Default size of the synthetic capture decoded by -b, in megabytes */
+#define BENCH_CAPTURE_MB                    (16U)
+#define BENCH_ROUNDS                        (5U)
+
+/* One frame in this many is followed by a stray text line, and one in this
+ * many has a byte corrupted on the wire */
+#define BENCH_NOISE_INTERVAL                (997U)
+#define BENCH_CORRUPT_INTERVAL              (4999U)
+
+/* Length of the text line main() prints per press, for comparison */
+#define TEXT_LINE_BYTES                     (sizeof("\r\nThe time between two presses of user button = 2.500000s\r\n") - 1U)
+
+#define OUTPUT_BUF_SIZE                     (1U << 20)
+
+/* Generator seed of the synthetic capture */
+#define BENCH_RNG_SEED                      (0x9E3779B97F4A7C15ULL)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint8_t  seq;
+    uint8_t  event;
+    uint64_t ticks;         /* Absolute time base value                     */
+    uint64_t delta;         /* Ticks since the previous decoded record      */
+} record_t;
+
+typedef struct
+{
+    uint8_t const *buf;
+    size_t   len;
+    size_t   pos;
+    uint64_t last_ticks;
+    bool     anchored;      /* last_ticks is known                          */
+    bool     seq_valid;
+    uint8_t  next_seq;
+
+    uint64_t frames;        /* Frames with a good CRC                       */
+    uint64_t lost;          /* Frames missing from the sequence             */
+    uint64_t unanchored;    /* Delta frames received before an absolute one */
+    uint64_t skipped;       /* Bytes not part of any good frame             */
+} decoder_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint16_t crc_table[256];
+
+
+/*******************************************************************************
+* Function Name: crc_table_init
+********************************************************************************
+* Summary:
+*  Byte-wise table for the CRC-16/CCITT-FALSE of telemetry_crc16().
+*******************************************************************************/
+static void crc_table_init(void)
+{
+    uint32_t i;
+    uint32_t bit;
+
+    for (i = 0U; i < 256U; i++)
+    {
+        uint16_t crc = (uint16_t)(i << 8);
+
+        for (bit = 0U; bit < 8U; bit++)
+        {
+            crc = (uint16_t)((0U != (crc & 0x8000U)) ? (((uint32_t)crc << 1) ^ 0x1021U) : ((uint32_t)crc << 1));
+        }
+        crc_table[i] = crc;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: decoder_init
+*******************************************************************************/
+static void decoder_init(decoder_t *dec, uint8_t const *buf, size_t len)
+{
+    memset(dec, 0, sizeof(*dec));
+    dec->buf = buf;
+    dec->len = len;
+}
+
+
+/*******************************************************************************
+* Function Name: decoder_next
+********************************************************************************
+* Summary:
+*  Returns the next record whose time is known. Scans for the sync byte and
+*  accepts a frame only if its CRC matches, so text and line noise between
+*  frames are skipped. After a gap in the sequence numbers, delta frames are
+*  dropped until the next absolute frame.
+*
+* Return:
+*  bool: false at the end of the buffer
+*******************************************************************************/
+static bool decoder_next(decoder_t *dec, record_t *rec)
+{
+    uint8_t const *buf = dec->buf;
+    size_t len = dec->len;
+    size_t pos = dec->pos;
+
+    for (;;)
+    {
+        uint8_t const *sync;
+        uint64_t value = 0U;
+        uint16_t crc = TELEMETRY_CRC_INIT;
+        size_t end;
+        size_t i;
+        uint8_t seq;
+        uint8_t type;
+        bool ok = false;
+
+        /* Shortest frame: sync, seq, type, one byte of ticks and the CRC */
+        if ((len - pos) < 6U)
+        {
+            dec->skipped += len - pos;
+            dec->pos = len;
+            return false;
+        }
+
+        if (TELEMETRY_SYNC != buf[pos])
+        {
+            sync = memchr(&buf[pos], TELEMETRY_SYNC, len - pos);
+            end = (NULL != sync) ? (size_t)(sync - buf) : len;
+            dec->skipped += end - pos;
+            pos = end;
+            continue;
+        }
+
+        end = pos + 3U;
+        for (i = 0U; (i < 10U) && (end < len); i++)
+        {
+            uint8_t b = buf[end++];
+
+            value |= (uint64_t)(b & 0x7FU) << (7U * i);
+            if (0U == (b & 0x80U))
+            {
+                ok = ((end + 2U) <= len);
+                break;
+            }
+        }
+
+        if (ok)
+        {
+            for (i = pos + 1U; i < end; i++)
+            {
+                crc = (uint16_t)((crc << 8) ^ crc_table[(crc >> 8) ^ buf[i]]);
+            }
+            ok = (crc == (uint16_t)(buf[end] | ((uint16_t)buf[end + 1U] << 8)));
+        }
+
+        if (!ok)
+        {
+            dec->skipped++;
+            pos++;
+            continue;
+        }
+
+        seq = buf[pos + 1U];
+        type = buf[pos + 2U];
+        pos = end + 2U;
+        dec->frames++;
+
+        if (dec->seq_valid && (seq != dec->next_seq))
+        {
+            dec->lost += (uint8_t)(seq - dec->next_seq);
+            dec->anchored = false;
+        }
+        dec->seq_valid = true;
+        dec->next_seq = (uint8_t)(seq + 1U);
+
+        if (0U != (type & TELEMETRY_FLAG_ABSOLUTE))
+        {
+            rec->delta = dec->anchored ? (value - dec->last_ticks) : 0U;
+            dec->last_ticks = value;
+            dec->anchored = true;
+        }
+        else if (dec->anchored)
+        {
+            rec->delta = value;
+            dec->last_ticks += value;
+        }
+        else
+        {
+            dec->unanchored++;
+            continue;
+        }
+
+        rec->seq = seq;
+        rec->event = (uint8_t)(type & TELEMETRY_EVENT_MASK);
+        rec->ticks = dec->last_ticks;
+        dec->pos = pos;
+        return true;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bench_interval
+********************************************************************************
+* Summary:
+*  Mostly press intervals of a fraction of a second to a minute, with some
+*  bounces of a few ticks and some gaps of days.
+*******************************************************************************/
+static uint64_t bench_interval(void)
+{
+    uint64_t r = bench_util_rng_next();
+
+    switch (r & 7U)
+    {
+        case 0U:
+            return 1U + ((r >> 8) & 0xFFU);
+        case 1U:
+            return 1U + ((r >> 8) & 0x3FFFFFFFFULL);
+        default:
+            return 1U + ((r >> 8) & 0x1FFFFFU);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run_bench
+********************************************************************************
+* Summary:
+*  Encodes a synthetic capture of about 'megabytes' with telemetry_encode(),
+*  with stray text and corrupted bytes mixed in, then checks and times the
+*  decoder. Returns the number of records decoded with the wrong time or
+*  event.
+*******************************************************************************/
+static unsigned run_bench(uint32_t megabytes)
+{
+    static const char noise[] = "\r\nstray text \xA5\xA5 between frames\r\n";
+    size_t capacity = (size_t)megabytes << 20;
+    size_t max_records = capacity / 6U;
+    uint8_t *capture = malloc(capacity + TELEMETRY_FRAME_MAX + sizeof(noise));
+    uint64_t *truth_ticks = malloc(max_records * sizeof(uint64_t));
+    uint8_t *truth_event = malloc(max_records);
+    telemetry_encoder_t encoder;
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    uint64_t ticks;
+    uint64_t frame_bytes = 0U;
+    uint64_t crc_errors = 0U;
+    uint64_t best_ns = UINT64_MAX;
+    size_t len = 0U;
+    size_t count = 0U;
+    size_t cursor;
+    size_t i;
+    unsigned mismatches = 0U;
+    uint32_t round;
+    decoder_t dec;
+    record_t rec;
+
+    if ((NULL == capture) || (NULL == truth_ticks) || (NULL == truth_event))
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    bench_util_rng_seed(BENCH_RNG_SEED);
+    ticks = bench_util_rng_next() >> 24;
+
+    /* The CRC the decoder uses is the one the target computes */
+    for (i = 0U; i < 4096U; i++)
+    {
+        uint8_t data[8];
+        uint16_t crc = TELEMETRY_CRC_INIT;
+        size_t n = 1U + (i % sizeof(data));
+        size_t j;
+
+        for (j = 0U; j < n; j++)
+        {
+            data[j] = (uint8_t)bench_util_rng_next();
+            crc = (uint16_t)((crc << 8) ^ crc_table[(crc >> 8) ^ data[j]]);
+        }
+        crc_errors += (crc != telemetry_crc16(TELEMETRY_CRC_INIT, data, n)) ? 1U : 0U;
+    }
+
+    telemetry_encoder_init(&encoder);
+    while ((len < capacity) && (count < max_records))
+    {
+        telemetry_event_t event = (0U == count) ? TELEMETRY_EVENT_BOOT : TELEMETRY_EVENT_PRESS;
+        size_t n;
+
+        ticks += (0U == count) ? 0U : bench_interval();
+        n = telemetry_encode(&encoder, frame, event, ticks);
+        memcpy(&capture[len], frame, n);
+        if ((0U != count) && (0U == (count % BENCH_CORRUPT_INTERVAL)))
+        {
+            capture[len + 1U + (bench_util_rng_next() % (n - 1U))] ^=
+                (uint8_t)(1U + (bench_util_rng_next() % 255U));
+        }
+        len += n;
+        frame_bytes += n;
+        truth_ticks[count] = ticks;
+        truth_event[count] = (uint8_t)event;
+        count++;
+
+        if (0U == (count % BENCH_NOISE_INTERVAL))
+        {
+            memcpy(&capture[len], noise, sizeof(noise) - 1U);
+            len += sizeof(noise) - 1U;
+        }
+    }
+
+    for (round = 0U; round < BENCH_ROUNDS; round++)
+    {
+        uint64_t t0 = bench_util_wall_ns();
+        uint64_t t;
+
+        decoder_init(&dec, capture, len);
+        cursor = 0U;
+        mismatches = 0U;
+        while (decoder_next(&dec, &rec))
+        {
+            while ((cursor < count) && (truth_ticks[cursor] < rec.ticks))
+            {
+                cursor++;
+            }
+            if ((cursor >= count) || (truth_ticks[cursor] != rec.ticks) ||
+                (truth_event[cursor] != rec.event))
+            {
+                mismatches++;
+            }
+        }
+
+        t = bench_util_wall_ns() - t0;
+        best_ns = (t < best_ns) ? t : best_ns;
+    }
+
+    printf("telemetry_decode: %u records with the wrong time or event, "
+           "%llu CRC table mismatches\n\n",
+           mismatches, (unsigned long long)crc_errors);
+    printf("capture            %10.2f MB, %zu frames, %.2f bytes/frame "
+           "(text line: %zu bytes)\n",
+           (double)len / 1048576.0, count, (double)frame_bytes / (double)count,
+           (size_t)TEXT_LINE_BYTES);
+    printf("frames decoded     %10llu\n", (unsigned long long)dec.frames);
+    printf("frames lost        %10llu (%zu corrupted on purpose)\n",
+           (unsigned long long)dec.lost, (count - 1U) / BENCH_CORRUPT_INTERVAL);
+    printf("awaiting absolute  %10llu\n", (unsigned long long)dec.unanchored);
+    printf("bytes skipped      %10llu\n", (unsigned long long)dec.skipped);
+    printf("decode rate        %10.1f MB/s, %.1f Mframes/s\n",
+           ((double)len / 1048576.0) / ((double)best_ns / 1e9),
+           ((double)dec.frames / 1e6) / ((double)best_ns / 1e9));
+
+    free(capture);
+    free(truth_ticks);
+    free(truth_event);
+
+    return mismatches + (unsigned)crc_errors;
+}
+
+
+/*******************************************************************************
+* Function Name: decode_file
+********************************************************************************
+* Summary:
+*  Decodes a capture and prints one CSV line per record, or only the totals.
+*******************************************************************************/
+static int decode_file(FILE *in, bool csv)
+{
+    static char out_buf[OUTPUT_BUF_SIZE];
+    char interval[INTERVAL_FORMAT_BUF_SIZE];
+    uint8_t *capture = NULL;
+    size_t capacity = 0U;
+    size_t len = 0U;
+    size_t n;
+    uint64_t records = 0U;
+    decoder_t dec;
+    record_t rec;
+
+    do
+    {
+        if (len == capacity)
+        {
+            capacity = (0U == capacity) ? (1U << 20) : (capacity * 2U);
+            capture = realloc(capture, capacity);
+            if (NULL == capture)
+            {
+                fprintf(stderr, "out of memory\n");
+                return EXIT_FAILURE;
+            }
+        }
+        n = fread(&capture[len], 1U, capacity - len, in);
+        len += n;
+    } while (0U != n);
+
+    setvbuf(stdout, out_buf, _IOFBF, sizeof(out_buf));
+    if (csv)
+    {
+        printf("seq,event,ticks,interval_s\n");
+    }
+
+    decoder_init(&dec, capture, len);
+    while (decoder_next(&dec, &rec))
+    {
+        records++;
+        if (csv)
+        {
+            (void)interval_format_ticks(interval, rec.delta);
+            printf("%u,%u,%llu,%s\n", (unsigned int)rec.seq, (unsigned int)rec.event,
+                   (unsigned long long)rec.ticks, interval);
+        }
+    }
+
+    fprintf(stderr, "%zu bytes: %llu frames, %llu records, %llu lost, "
+            "%llu awaiting absolute, %llu bytes skipped\n",
+            len, (unsigned long long)dec.frames, (unsigned long long)records,
+            (unsigned long long)dec.lost, (unsigned long long)dec.unanchored,
+            (unsigned long long)dec.skipped);
+
+    free(capture);
+
+    return EXIT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    bool csv = true;
+    FILE *in = stdin;
+    int opt;
+    int status;
+
+    crc_table_init();
+
+    while (-1 != (opt = getopt(argc, argv, "b::s")))
+    {
+        switch (opt)
+        {
+            case 'b':
+                return (0U == run_bench((NULL != optarg) ? (uint32_t)strtoul(optarg, NULL, 0)
+                                                         : BENCH_CAPTURE_MB))
+                       ? EXIT_SUCCESS : EXIT_FAILURE;
+            case 's':
+                csv = false;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-s] [capture]   decode, CSV to stdout\n"
+                                "       %s -b[MB]            benchmark on a synthetic capture\n",
+                        argv[0], argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind < argc)
+    {
+        in = fopen(argv[optind], "rb");
+        if (NULL == in)
+        {
+            perror(argv[optind]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    status = decode_file(in, csv);
+
+    if (stdin != in)
+    {
+        fclose(in);
+    }
+
+    return status;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,287 @@
+/******************************************************************************
+* File Name:   tickless_test.c
+*
+* Description: Runs a minimal RTOS for hours of virtual time with a SysTick tick and with
+*              tickless idle, and checks that tickless idle wakes the CPU far less often
+*              without the RTOS tick count losing time against the MCWDT_0 time base.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "mcwdt_timebase.h"
+#include "tickless_idle.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Virtual time of each run */
+#define TEST_RUN_S                          (2U * 3600U)
+
+/* CPU time each task release takes */
+#define TEST_WORK_NS                        (100U * MCWDT_SIM_NS_PER_US)
+
+/* WCO error against the CPU clock in the drift runs */
+#define TEST_DRIFT_PPM                      (100)
+
+#define TEST_TASKS                          (4U)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/* A periodic task of the modeled RTOS */
+typedef struct
+{
+    uint32_t period;            /* Ticks */
+    uint32_t next;              /* Tick of the next release */
+    uint32_t runs;
+} test_task_t;
+
+typedef struct
+{
+    const char *name;
+    bool tickless;
+    int32_t ppm;
+    int64_t max_error;          /* Ticks the RTOS was off the time base */
+    int64_t final_error;
+    double max_late_us;         /* Release to task start */
+    uint32_t missed;            /* Releases not run, or run twice */
+    mcwdt_sim_stats_t stats;
+    tickless_idle_stats_t idle;
+} test_result_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static volatile uint32_t tick_count;
+static test_task_t tasks[TEST_TASKS];
+static test_result_t *current;
+static cy_rslt_t ilo_result;
+
+
+/*******************************************************************************
+* Function Name: SysTick_Handler
+********************************************************************************
+* Summary:
+*  The RTOS tick.
+*******************************************************************************/
+void SysTick_Handler(void)
+{
+    tick_count++;
+}
+
+
+/*******************************************************************************
+* Function Name: check_time
+********************************************************************************
+* Summary:
+*  Compares the RTOS tick count with the time base when a task is released.
+*******************************************************************************/
+static void check_time(uint32_t release)
+{
+    int64_t error = (int64_t)tick_count - (int64_t)tickless_idle_ticks_due();
+    uint64_t start = (((uint64_t)release * CY_SYSCLK_WCO_FREQ) + TICKLESS_IDLE_TICK_RATE_HZ - 1U) /
+                     TICKLESS_IDLE_TICK_RATE_HZ;
+    double late = ((double)mcwdt_timebase_read64() - (double)start) * 1e6 / CY_SYSCLK_WCO_FREQ;
+
+    error = (error < 0) ? -error : error;
+    current->max_error = (error > current->max_error) ? error : current->max_error;
+    current->max_late_us = (late > current->max_late_us) ? late : current->max_late_us;
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_app
+********************************************************************************
+* Summary:
+*  A minimal RTOS: SysTick counts ticks, tasks are released on their ticks,
+*  and the idle loop either waits for the next tick or sleeps tickless until
+*  the next release.
+*******************************************************************************/
+static void rtos_app(void)
+{
+    static const uint32_t periods[TEST_TASKS] = { 50U, 200U, 1000U, 10000U };
+    uint32_t intr_status;
+    uint32_t expected;
+    uint32_t next;
+    uint32_t i;
+
+    bench_util_start_mcwdt();
+
+    tick_count = 0U;
+    for (i = 0U; i < TEST_TASKS; i++)
+    {
+        tasks[i].period = periods[i];
+        tasks[i].next = periods[i];
+        tasks[i].runs = 0U;
+    }
+    CY_ASSERT(CY_RSLT_SUCCESS == tickless_idle_init(tick_count));
+    CY_ASSERT(0U == SysTick_Config(SystemCoreClock / TICKLESS_IDLE_TICK_RATE_HZ));
+
+    for (;;)
+    {
+        for (i = 0U; i < TEST_TASKS; i++)
+        {
+            if ((int32_t)(tick_count - tasks[i].next) >= 0)
+            {
+                check_time(tasks[i].next);
+                mcwdt_sim_advance_ns(TEST_WORK_NS);
+                tasks[i].runs++;
+                tasks[i].next += tasks[i].period;
+            }
+        }
+
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        next = tasks[0].next;
+        for (i = 1U; i < TEST_TASKS; i++)
+        {
+            next = ((int32_t)(tasks[i].next - next) < 0) ? tasks[i].next : next;
+        }
+        expected = next - tick_count;
+
+        if ((int32_t)expected <= 0)
+        {
+            /* A task is due */
+        }
+        else if (current->tickless && (expected >= TICKLESS_IDLE_MIN_TICKS))
+        {
+            tick_count += tickless_idle_sleep(tick_count, expected);
+        }
+        else
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(test_result_t *res)
+{
+    double seconds = (double)TEST_RUN_S;
+    uint32_t i;
+
+    current = res;
+    mcwdt_sim_reset();
+    mcwdt_sim_set_lfclk_ppb((int64_t)res->ppm * 1000);
+    CY_ASSERT(MCWDT_SIM_RUN_UNTIL == mcwdt_sim_run(rtos_app, TEST_RUN_S * MCWDT_SIM_NS_PER_S));
+    res->stats = *mcwdt_sim_stats();
+    tickless_idle_get_stats(&res->idle);
+
+    /* Every release up to the RTOS's own idea of now has run exactly once */
+    for (i = 0U; i < TEST_TASKS; i++)
+    {
+        uint32_t due = tick_count / tasks[i].period;
+        res->missed += (uint32_t)abs((int32_t)(due - tasks[i].runs));
+    }
+    res->final_error = (int64_t)tick_count - (int64_t)tickless_idle_ticks_due();
+
+    printf("%-22s | %10.1f | %9.4f %% | %9lld | %11lld | %11.1f | %u\n", res->name,
+           (double)res->stats.wakeups / seconds,
+           100.0 * (double)res->stats.busy_ns / (double)(res->stats.busy_ns + res->stats.sleep_ns),
+           (long long)res->max_error, (long long)res->final_error, res->max_late_us, res->missed);
+}
+
+
+/*******************************************************************************
+* Function Name: ilo_app
+********************************************************************************
+* Summary:
+*  Starts tickless idle with LFCLK on the ILO, which it must refuse.
+*******************************************************************************/
+static void ilo_app(void)
+{
+    bench_util_start_mcwdt();
+
+    Cy_SysClk_ClkLfSetSource(CY_SYSCLK_CLKLF_IN_ILO);
+    ilo_result = tickless_idle_init(0U);
+    mcwdt_sim_finish();
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    test_result_t systick = { .name = "SysTick" };
+    test_result_t tickless = { .name = "tickless", .tickless = true };
+    test_result_t systick_drift = { .name = "SysTick, WCO +100ppm", .ppm = TEST_DRIFT_PPM };
+    test_result_t tickless_drift = { .name = "tickless, WCO +100ppm", .tickless = true,
+                                     .ppm = TEST_DRIFT_PPM };
+    bool ok;
+
+    printf("%u h of an RTOS with a %u Hz tick and tasks every 50, 200, 1000 and 10000 ms;\n"
+           "errors are RTOS ticks against the MCWDT_0 time base\n\n",
+           TEST_RUN_S / 3600U, TICKLESS_IDLE_TICK_RATE_HZ);
+    printf("idle                   | wakeups/s  | CPU active  | max error | final error | max late(us) | missed\n");
+    printf("-----------------------|------------|-------------|-----------|-------------|-------------|-------\n");
+    run(&systick);
+    run(&tickless);
+    run(&systick_drift);
+    run(&tickless_drift);
+
+    printf("\ntickless: %u sleeps, %u ended early, %u ticks stepped of which %u made up for SysTick\n",
+           tickless_drift.idle.sleeps, tickless_drift.idle.early_wakeups,
+           tickless_drift.idle.ticks_stepped, tickless_drift.idle.ticks_corrected);
+
+    mcwdt_sim_reset();
+    (void)mcwdt_sim_run(ilo_app, MCWDT_SIM_NS_PER_S);
+    printf("LFCLK from the ILO: tickless idle %s\n",
+           ((cy_rslt_t)CY_SYSCLK_INVALID_STATE == ilo_result) ? "refused" : "started");
+
+    ok = ((cy_rslt_t)CY_SYSCLK_INVALID_STATE == ilo_result) &&
+         (tickless.max_error <= 1) && (tickless_drift.max_error <= 1) &&
+         (0U == tickless.missed) && (0U == tickless_drift.missed) &&
+         (tickless.stats.wakeups < (systick.stats.wakeups / 10U));
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,442 @@
+/******************************************************************************
+* File Name:   timer_wheel_bench.c
+*
+* Description: Measures the expiry lateness of the timer wheel under load, checks timers
+*              longer than the wheel covers, and shows that the cost of each operation does
+*              not grow with the number of armed timers.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "bench_util.h"
+#include "mcwdt_timebase.h"
+#include "timer_wheel.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Jitter run: one-shot timers re-armed from their callbacks with a new random
+ * delay, some cancelled and re-armed from the callbacks of others, and
+ * periodic timers with whole-tick periods */
+#define BENCH_ONE_SHOTS                     (3000U)
+#define BENCH_PERIODIC                      (1000U)
+#define BENCH_MAX_DELAY_S                   (20U)
+#define BENCH_MAX_PERIOD_TICKS              (2000U)
+#define BENCH_CANCEL_EVERY                  (8U)
+#define BENCH_RUN_S                         (60U)
+#define BENCH_MAX_SAMPLES                   (200000U)
+
+/* Cost run: timers armed at once with delays of 1 s up to this long, so that
+ * none expires before all have been armed */
+#define BENCH_COST_DELAY_S                  (10U)
+#define BENCH_COST_MAX_TIMERS               (100000U)
+#define BENCH_COST_ROUNDS                   (3U)
+
+/* Carry run: delays past the 2^24 ticks the levels cover */
+#define BENCH_CARRY_TIMERS                  (4U)
+
+#define BENCH_US_PER_CYCLE                  (1e6 / (double)CY_SYSCLK_WCO_FREQ)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/* A timer with the time base value at which it is due */
+typedef struct
+{
+    timer_wheel_timer_t timer;          /* Must be first */
+    uint64_t target;
+    uint32_t period;                    /* LFCLK cycles; 0 for one-shot */
+} bench_timer_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static bench_timer_t timers[BENCH_COST_MAX_TIMERS + 1U];
+static int64_t lateness[BENCH_MAX_SAMPLES];
+static uint32_t samples;
+static uint32_t expiries;
+static uint32_t cancels;
+static uint32_t cost_timers;
+static uint64_t start_wall_ns;
+static uint64_t cancel_wall_ns;
+
+
+/*******************************************************************************
+* Function Name: start_wheel
+*******************************************************************************/
+static void start_wheel(void)
+{
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == timer_wheel_init());
+}
+
+
+/*******************************************************************************
+* Function Name: bench_start
+********************************************************************************
+* Summary:
+*  Arms a bench timer and notes when it is due.
+*******************************************************************************/
+static void bench_start(bench_timer_t *t, uint32_t delay, uint32_t period,
+                        timer_wheel_callback_t callback)
+{
+    t->target = mcwdt_timebase_read64() + delay;
+    t->period = period;
+    timer_wheel_start(&t->timer, delay, period, callback, NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: record
+********************************************************************************
+* Summary:
+*  Records how late a timer expired and when it is due next.
+*******************************************************************************/
+static void record(bench_timer_t *t)
+{
+    int64_t late = (int64_t)(mcwdt_timebase_read64() - t->target);
+
+    if (samples < BENCH_MAX_SAMPLES)
+    {
+        lateness[samples++] = late;
+    }
+    expiries++;
+    t->target += t->period;
+}
+
+
+/*******************************************************************************
+* Function Name: one_shot_expired
+********************************************************************************
+* Summary:
+*  Re-arms the timer with a new delay, and now and then cancels another
+*  one-shot timer and re-arms it too.
+*******************************************************************************/
+static void one_shot_expired(timer_wheel_timer_t *timer, void *context)
+{
+    bench_timer_t *t = (bench_timer_t *)timer;
+    bench_timer_t *other;
+
+    record(t);
+    bench_start(t, 1U + bench_util_rng_range(BENCH_MAX_DELAY_S * CY_SYSCLK_WCO_FREQ), 0U,
+                one_shot_expired);
+
+    if (0U == (expiries % BENCH_CANCEL_EVERY))
+    {
+        other = &timers[bench_util_rng_range(BENCH_ONE_SHOTS)];
+        if (timer_wheel_active(&other->timer))
+        {
+            timer_wheel_cancel(&other->timer);
+            cancels++;
+            bench_start(other, 1U + bench_util_rng_range(BENCH_MAX_DELAY_S * CY_SYSCLK_WCO_FREQ),
+                        0U, one_shot_expired);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: periodic_expired
+*******************************************************************************/
+static void periodic_expired(timer_wheel_timer_t *timer, void *context)
+{
+    record((bench_timer_t *)timer);
+}
+
+
+/*******************************************************************************
+* Function Name: counted_expired
+*******************************************************************************/
+static void counted_expired(timer_wheel_timer_t *timer, void *context)
+{
+    record((bench_timer_t *)timer);
+}
+
+
+/*******************************************************************************
+* Function Name: keeper_expired
+*******************************************************************************/
+static void keeper_expired(timer_wheel_timer_t *timer, void *context)
+{
+}
+
+
+/*******************************************************************************
+* Function Name: jitter_app
+*******************************************************************************/
+static void jitter_app(void)
+{
+    uint32_t period;
+    uint32_t i;
+
+    start_wheel();
+
+    for (i = 0U; i < BENCH_ONE_SHOTS; i++)
+    {
+        bench_start(&timers[i], 1U + bench_util_rng_range(BENCH_MAX_DELAY_S * CY_SYSCLK_WCO_FREQ),
+                    0U, one_shot_expired);
+    }
+    for (i = BENCH_ONE_SHOTS; i < (BENCH_ONE_SHOTS + BENCH_PERIODIC); i++)
+    {
+        period = (1U + bench_util_rng_range(BENCH_MAX_PERIOD_TICKS)) * TIMER_WHEEL_TICK_CYCLES;
+        bench_start(&timers[i], period, period, periodic_expired);
+    }
+
+    for (;;)
+    {
+        __WFI();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cost_app
+********************************************************************************
+* Summary:
+*  Arms cost_timers one-shot timers, cancels and re-arms half of them, then
+*  sleeps while they expire. A timer of one tick keeps the wheel turning for
+*  the whole run whatever the number of timers.
+*******************************************************************************/
+static void cost_app(void)
+{
+    uint32_t delay[2];
+    uint64_t t0;
+    uint32_t i;
+
+    start_wheel();
+    timer_wheel_start(&timers[cost_timers].timer, TIMER_WHEEL_TICK_CYCLES, TIMER_WHEEL_TICK_CYCLES,
+                      keeper_expired, NULL);
+
+    for (i = 0U; i < cost_timers; i++)
+    {
+        delay[0] = CY_SYSCLK_WCO_FREQ +
+                   bench_util_rng_range((BENCH_COST_DELAY_S - 1U) * CY_SYSCLK_WCO_FREQ);
+        t0 = bench_util_wall_ns();
+        bench_start(&timers[i], delay[0], 0U, counted_expired);
+        start_wall_ns += bench_util_wall_ns() - t0;
+    }
+    for (i = 0U; i < cost_timers; i += 2U)
+    {
+        delay[1] = CY_SYSCLK_WCO_FREQ +
+                   bench_util_rng_range((BENCH_COST_DELAY_S - 1U) * CY_SYSCLK_WCO_FREQ);
+        t0 = bench_util_wall_ns();
+        timer_wheel_cancel(&timers[i].timer);
+        cancel_wall_ns += bench_util_wall_ns() - t0;
+        bench_start(&timers[i], delay[1], 0U, counted_expired);
+    }
+
+    for (;;)
+    {
+        __WFI();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: carry_app
+*******************************************************************************/
+static void carry_app(void)
+{
+    static const uint32_t hours[BENCH_CARRY_TIMERS] = { 1U, 5U, 9U, 14U };
+    uint32_t i;
+
+    start_wheel();
+
+    for (i = 0U; i < BENCH_CARRY_TIMERS; i++)
+    {
+        bench_start(&timers[i],
+                    (hours[i] * 3600U * CY_SYSCLK_WCO_FREQ) + bench_util_rng_range(CY_SYSCLK_WCO_FREQ),
+                    0U, counted_expired);
+    }
+
+    while (0U != timer_wheel_count())
+    {
+        __WFI();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: compare_lateness
+*******************************************************************************/
+static int compare_lateness(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+
+/*******************************************************************************
+* Function Name: reset_counts
+*******************************************************************************/
+static void reset_counts(void)
+{
+    samples = 0U;
+    expiries = 0U;
+    cancels = 0U;
+    start_wall_ns = 0U;
+    cancel_wall_ns = 0U;
+    bench_util_rng_seed(BENCH_UTIL_RNG_SEED);
+    memset(timers, 0, sizeof(timers));
+    mcwdt_sim_reset();
+}
+
+
+/*******************************************************************************
+* Function Name: run_cost
+********************************************************************************
+* Summary:
+*  Returns the shortest wall time in nanoseconds of a few cost runs with n
+*  timers, and prints the cost of each operation.
+*******************************************************************************/
+static uint64_t run_cost(uint32_t n, uint64_t base_ns)
+{
+    uint64_t best = UINT64_MAX;
+    uint64_t best_start = UINT64_MAX;
+    uint64_t best_cancel = UINT64_MAX;
+    uint64_t t0;
+    uint32_t round;
+
+    for (round = 0U; round < BENCH_COST_ROUNDS; round++)
+    {
+        reset_counts();
+        cost_timers = n;
+        t0 = bench_util_wall_ns();
+        CY_ASSERT(MCWDT_SIM_RUN_UNTIL == mcwdt_sim_run(cost_app, (BENCH_COST_DELAY_S + 1U) *
+                                                                 MCWDT_SIM_NS_PER_S));
+        t0 = bench_util_wall_ns() - t0;
+        CY_ASSERT(expiries == n);
+
+        best = (t0 < best) ? t0 : best;
+        best_start = (start_wall_ns < best_start) ? start_wall_ns : best_start;
+        best_cancel = (cancel_wall_ns < best_cancel) ? cancel_wall_ns : best_cancel;
+    }
+
+    if (0U != base_ns)
+    {
+        printf("%7u | %10.1f | %11.1f | %26.1f\n", n,
+               (double)best_start / (n + (n / 2U)), (double)best_cancel / (n / 2U),
+               (double)(best - base_ns) / n);
+    }
+
+    return best;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    static const uint32_t sizes[] = { 1000U, 10000U, 100000U };
+    const mcwdt_sim_stats_t *stats;
+    uint64_t ticks;
+    uint64_t base_ns;
+    double sum = 0.0;
+    uint32_t early = 0U;
+    uint32_t worst = 0U;
+    uint32_t i;
+    bool ok;
+
+    /* Jitter */
+    reset_counts();
+    CY_ASSERT(MCWDT_SIM_RUN_UNTIL == mcwdt_sim_run(jitter_app, BENCH_RUN_S * MCWDT_SIM_NS_PER_S));
+    stats = mcwdt_sim_stats();
+    ticks = mcwdt_sim_lfclk_ticks() >> TIMER_WHEEL_TOGGLE_BIT;
+
+    qsort(lateness, samples, sizeof(lateness[0]), compare_lateness);
+    for (i = 0U; i < samples; i++)
+    {
+        sum += (double)lateness[i];
+        early += (lateness[i] < 0) ? 1U : 0U;
+    }
+
+    printf("%u one-shot and %u periodic timers for %u s, %.3f ms wheel tick; %u expiries, "
+           "%u cancelled and re-armed\n", BENCH_ONE_SHOTS, BENCH_PERIODIC, BENCH_RUN_S,
+           TIMER_WHEEL_TICK_CYCLES * BENCH_US_PER_CYCLE / 1e3, expiries, cancels);
+    printf("expiry lateness (us): min %.1f, median %.1f, mean %.1f, p99 %.1f, max %.1f; "
+           "%u early\n",
+           (double)lateness[0] * BENCH_US_PER_CYCLE,
+           (double)lateness[samples / 2U] * BENCH_US_PER_CYCLE,
+           sum / samples * BENCH_US_PER_CYCLE,
+           (double)lateness[(samples * 99U) / 100U] * BENCH_US_PER_CYCLE,
+           (double)lateness[samples - 1U] * BENCH_US_PER_CYCLE, early);
+    printf("MCWDT interrupts per wheel tick: %.3f; CPU active %.3f %%\n",
+           (double)stats->irq_count / (double)ticks,
+           100.0 * (double)stats->busy_ns / (double)(stats->busy_ns + stats->sleep_ns));
+    ok = (0U == early) && (lateness[samples - 1U] < (int64_t)(2U * TIMER_WHEEL_TICK_CYCLES));
+
+    /* Carry past the top level */
+    reset_counts();
+    CY_ASSERT(MCWDT_SIM_RUN_RETURNED == mcwdt_sim_run(carry_app, 0U));
+    for (i = 0U; i < samples; i++)
+    {
+        early += (lateness[i] < 0) ? 1U : 0U;
+        worst = ((uint32_t)lateness[i] > worst) ? (uint32_t)lateness[i] : worst;
+    }
+    printf("\n%u timers of 1 to 14 hours: %u expired, max lateness %.1f us\n",
+           BENCH_CARRY_TIMERS, expiries, (double)worst * BENCH_US_PER_CYCLE);
+    ok = ok && (BENCH_CARRY_TIMERS == expiries) && (0U == early) &&
+         (worst < (2U * TIMER_WHEEL_TICK_CYCLES));
+
+    /* Cost against the number of armed timers */
+    printf("\narmed   | start (ns) | cancel (ns) | expire incl. cascades (ns)\n");
+    printf("--------|------------|-------------|---------------------------\n");
+    base_ns = run_cost(1U, 0U);
+    for (i = 0U; i < (sizeof(sizes) / sizeof(sizes[0])); i++)
+    {
+        (void)run_cost(sizes[i], base_ns);
+    }
+    printf("Host wall time, including the simulated register reads; expire is the run\n"
+           "time beyond that of a run with one timer, per timer\n");
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
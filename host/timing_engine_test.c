@@ -0,0 +1,696 @@
+/******************************************************************************
+* File Name:   timing_engine_test.c
+*
+* Description: Unit test of the timing engine built against mock counters and a
+*              mock button instead of the simulator: torn-free reads at every
+*              Counter 0 wrap phase, 64-bit extension with the crossing interrupt
+*              handled or pending, press capture against a reference debouncer on
+*              random bounce traces, adaptive debounce against the same
+*              reference, and intervals across counter wraps.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cy_pdl.h"
+#include "timing_engine.h"
+#include "timing_hw.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* read32: counter values around each wrap, and the most LFCLK ticks that
+ * pass between two register reads */
+#define TEST_WRAP_SPAN                      (24U)
+#define TEST_MAX_STEP                       (3U)
+
+/* extend: random 64-bit times besides those next to each crossing */
+#define TEST_EXTEND_RANDOM                  (100000U)
+
+/* Capture: random traces, and edges and polls in each */
+#define TEST_TRACES                         (20000U)
+#define TEST_TRACE_EDGES                    (64U)
+#define TEST_TRACE_POLLS                    (16U)
+#define TEST_WINDOW                         (2622U)     /* 80 ms of ticks */
+
+/* Adaptive debounce: random switches, each with its longest bounce gap, and
+ * the least window. Holds and pauses are longer than the window, and one burst
+ * in TEST_ADAPT_ODD_EVERY has a gap of up to the window. */
+#define TEST_ADAPT_TRACES                   (5000U)
+#define TEST_ADAPT_BURSTS                   (48U)
+#define TEST_ADAPT_MAX_PULSES               (12U)
+#define TEST_ADAPT_MARGIN                   (66U)       /* 2 ms of ticks */
+#define TEST_ADAPT_ODD_EVERY                (16U)
+
+/* Intervals: random press sequences across the 32-bit wrap */
+#define TEST_INTERVAL_RUNS                  (1000U)
+#define TEST_INTERVAL_PRESSES               (50U)
+
+#define TEST_HALF_RANGE                     (1ULL << 31)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint64_t t;
+    uint32_t level;
+    bool     poll;          /* A main-loop poll instead of an edge */
+} test_step_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t cases;
+    uint32_t failures;
+} test_result_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Mock cascade: its 32-bit value, and the ticks that pass after each read */
+static uint32_t mock_cascade;
+static uint32_t mock_steps[4];
+static uint32_t mock_reads;
+
+/* Mock button level */
+static uint32_t mock_button;
+
+static test_step_t trace[(TEST_ADAPT_BURSTS * 2U * (TEST_ADAPT_MAX_PULSES + 1U)) + 1U];
+static uint64_t engine_presses[TEST_ADAPT_BURSTS * 2U * (TEST_ADAPT_MAX_PULSES + 1U)];
+static uint64_t model_presses[TEST_ADAPT_BURSTS * 2U * (TEST_ADAPT_MAX_PULSES + 1U)];
+static uint64_t engine_releases[TEST_TRACE_EDGES];
+static uint64_t model_releases[TEST_TRACE_EDGES];
+static uint32_t model_release_count;
+
+
+/*******************************************************************************
+* Function Name: timing_hw_mock_get_count
+********************************************************************************
+* Summary:
+*  Counter 0 or Counter 1 of the mock cascade. The cascade then moves on by
+*  the ticks set for this read.
+*******************************************************************************/
+uint32_t timing_hw_mock_get_count(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter)
+{
+    uint32_t value = (CY_MCWDT_COUNTER0 == counter) ? (mock_cascade & 0xFFFFU) :
+                                                     (mock_cascade >> 16);
+
+    mock_cascade += mock_steps[mock_reads % 4U];
+    mock_reads++;
+    return value;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_hw_mock_read_button
+*******************************************************************************/
+uint32_t timing_hw_mock_read_button(void)
+{
+    return mock_button;
+}
+
+
+/*******************************************************************************
+* Function Name: test_read32
+********************************************************************************
+* Summary:
+*  Reads the cascade at every phase around Counter 0 and Counter 1 wraps with
+*  every pattern of 0 to TEST_MAX_STEP ticks between the reads. The value must
+*  be one the cascade held while it was being read.
+*******************************************************************************/
+static void test_read32(test_result_t *r)
+{
+    static const uint32_t highs[] = { 0x0000U, 0x0001U, 0x7FFFU, 0x8000U, 0xFFFEU, 0xFFFFU };
+    uint32_t patterns = (TEST_MAX_STEP + 1U) * (TEST_MAX_STEP + 1U) *
+                        (TEST_MAX_STEP + 1U) * (TEST_MAX_STEP + 1U);
+    uint32_t start;
+    uint32_t value;
+    uint32_t h;
+    uint32_t k;
+    uint32_t p;
+    uint32_t i;
+
+    for (h = 0U; h < (sizeof(highs) / sizeof(highs[0])); h++)
+    {
+        for (k = 0U; k < (2U * TEST_WRAP_SPAN); k++)
+        {
+            for (p = 0U; p < patterns; p++)
+            {
+                start = (highs[h] << 16) + (0x10000U - TEST_WRAP_SPAN) + k;
+                for (i = 0U; i < 4U; i++)
+                {
+                    mock_steps[i] = (p >> (2U * i)) & 3U;
+                }
+                mock_cascade = start;
+                mock_reads = 0U;
+
+                value = timing_engine_read32(NULL);
+
+                r->cases++;
+                if ((value - start) > (mock_cascade - start))
+                {
+                    if (r->failures < 5U)
+                    {
+                        printf("  read32: started at 0x%08x, steps %u %u %u %u: 0x%08x\n",
+                               (unsigned)start, (unsigned)mock_steps[0],
+                               (unsigned)mock_steps[1], (unsigned)mock_steps[2],
+                               (unsigned)mock_steps[3], (unsigned)value);
+                    }
+                    r->failures++;
+                }
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: check_extend
+********************************************************************************
+* Summary:
+*  Extends the time 't' with its last half-range crossing counted, and with
+*  the interrupt of that crossing still pending.
+*******************************************************************************/
+static void check_extend(test_result_t *r, uint64_t t)
+{
+    uint32_t crossings = (uint32_t)(t / TEST_HALF_RANGE);
+    uint32_t lag;
+
+    for (lag = 0U; (lag <= 1U) && (lag <= crossings); lag++)
+    {
+        r->cases++;
+        if (timing_engine_extend(crossings - lag, (uint32_t)t) != t)
+        {
+            if (r->failures < 5U)
+            {
+                printf("  extend: 0x%016llx with %u crossings counted\n",
+                       (unsigned long long)t, (unsigned)(crossings - lag));
+            }
+            r->failures++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_extend
+********************************************************************************
+* Summary:
+*  Checks the 64-bit extension next to every half-range crossing of the first
+*  thousand, and at random times up to 2^48 ticks (272 years). Also checks that
+*  the crossing count to start from and the next match value agree with a
+*  time base first read at any point of its range.
+*******************************************************************************/
+static void test_extend(test_result_t *r)
+{
+    uint64_t crossing;
+    uint32_t count;
+    uint32_t halves;
+    uint32_t next;
+    int32_t d;
+    uint32_t i;
+
+    for (crossing = 0U; crossing < (1000U * TEST_HALF_RANGE); crossing += TEST_HALF_RANGE)
+    {
+        for (d = -3; d <= 3; d++)
+        {
+            if ((crossing > 0U) || (d >= 0))
+            {
+                check_extend(r, crossing + (uint64_t)(int64_t)d);
+            }
+        }
+    }
+    for (i = 0U; i < TEST_EXTEND_RANDOM; i++)
+    {
+        check_extend(r, bench_util_rng_next() >> 16);
+    }
+
+    for (i = 0U; i < TEST_EXTEND_RANDOM; i++)
+    {
+        count = (uint32_t)bench_util_rng_next();
+        halves = timing_engine_initial_halves(count);
+        next = (uint32_t)timing_engine_half_match(halves) << 16;
+
+        r->cases++;
+        if ((timing_engine_extend(halves, count) != count) ||
+            ((next - count) > (uint32_t)TEST_HALF_RANGE) || (next == count))
+        {
+            r->failures++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: model_presses_of
+********************************************************************************
+* Summary:
+*  Reference debouncer over a whole trace. Edges closer together than the
+*  window form one burst, after which the switch is stable at the level of
+*  its last edge. A burst that leaves the switch pressed after it was stable
+*  released is a press, timed from the first edge of the burst, and one that
+*  leaves it released after a press is its release. A burst that has not
+*  been followed by a full window by the end of the trace is undecided.
+*******************************************************************************/
+static uint32_t model_presses_of(uint32_t steps, uint64_t end)
+{
+    bool held = false;
+    uint32_t presses = 0U;
+    uint64_t burst_start = 0U;
+    bool in_burst = false;
+    uint64_t last_t = 0U;
+    uint32_t last_level = 1U;
+    uint32_t i;
+
+    model_release_count = 0U;
+    for (i = 0U; i <= steps; i++)
+    {
+        bool closes = (i == steps) ? ((end - last_t) >= TEST_WINDOW) :
+                                     (!trace[i].poll && ((trace[i].t - last_t) >= TEST_WINDOW));
+
+        if (in_burst && closes)
+        {
+            if (!held && (0U == last_level))
+            {
+                model_presses[presses++] = burst_start;
+                held = true;
+            }
+            else if (held && (0U != last_level))
+            {
+                if (model_release_count < TEST_TRACE_EDGES)
+                {
+                    model_releases[model_release_count] = burst_start;
+                }
+                model_release_count++;
+                held = false;
+            }
+            in_burst = false;
+        }
+        if ((i < steps) && !trace[i].poll)
+        {
+            if (!in_burst)
+            {
+                burst_start = trace[i].t;
+                in_burst = true;
+            }
+            last_t = trace[i].t;
+            last_level = trace[i].level;
+        }
+    }
+
+    return presses;
+}
+
+
+/*******************************************************************************
+* Function Name: make_trace
+********************************************************************************
+* Summary:
+*  Builds a random trace of bounce bursts and clean edges, with gaps around
+*  the window so that windows both run out and are restarted just in time,
+*  and main-loop polls at random times in between. Returns the number of steps.
+*******************************************************************************/
+static uint32_t make_trace(uint64_t start)
+{
+    uint64_t t = start;
+    uint32_t level = 1U;
+    uint32_t edges = 0U;
+    uint32_t steps = 0U;
+    uint32_t polls = 0U;
+    uint64_t gap;
+
+    while (edges < TEST_TRACE_EDGES)
+    {
+        switch (bench_util_rng_range(4U))
+        {
+            case 0U:    /* Bounce */
+                gap = 1U + bench_util_rng_range(TEST_WINDOW / 8U);
+                break;
+            case 1U:    /* Just inside or outside the window */
+                gap = TEST_WINDOW - 2U + bench_util_rng_range(5U);
+                break;
+            default:    /* Anything up to a few windows */
+                gap = 1U + bench_util_rng_range(4U * TEST_WINDOW);
+                break;
+        }
+
+        if ((polls < TEST_TRACE_POLLS) && (0U == bench_util_rng_range(4U)))
+        {
+            trace[steps].t = t + bench_util_rng_range((uint32_t)gap);
+            trace[steps].poll = true;
+            steps++;
+            polls++;
+        }
+
+        t += gap;
+        /* Mostly alternating levels, with the odd repeated level */
+        level = (0U == bench_util_rng_range(16U)) ? level : (level ^ 1U);
+        trace[steps].t = t;
+        trace[steps].level = level;
+        trace[steps].poll = false;
+        steps++;
+        edges++;
+    }
+
+    return steps;
+}
+
+
+/*******************************************************************************
+* Function Name: make_switch_trace
+********************************************************************************
+* Summary:
+*  Builds a trace of a switch that bounces with gaps of up to 'max_gap' ticks,
+*  or on odd bursts up to the window, and stays at each level for longer than
+*  the window in between. Bursts alternate between press and release, with
+*  the odd glitch away from the settled level. Returns the number of edges; 'longest'
+*  receives the longest burst.
+*******************************************************************************/
+static uint32_t make_switch_trace(uint64_t start, uint32_t max_gap, bool odd, uint64_t *longest)
+{
+    uint64_t t = start;
+    uint64_t burst_start;
+    uint32_t level = 1U;
+    uint32_t steps = 0U;
+    uint32_t pulses;
+    uint32_t gap;
+    uint32_t b;
+    uint32_t p;
+    bool glitch;
+
+    *longest = 0U;
+    for (b = 0U; b < TEST_ADAPT_BURSTS; b++)
+    {
+        t += TEST_WINDOW + 1U + bench_util_rng_range(4U * TEST_WINDOW);
+        burst_start = t;
+        pulses = bench_util_rng_range(TEST_ADAPT_MAX_PULSES + 1U);
+
+        /* A transition with bounces, or a glitch away from the current level.
+         * Only transitions get odd gaps: a glitch that long would be a press. */
+        glitch = (0U == bench_util_rng_range(8U));
+        gap = (odd && !glitch && (0U == bench_util_rng_range(TEST_ADAPT_ODD_EVERY))) ?
+              (TEST_WINDOW - 1U) : max_gap;
+        level = glitch ? level : (level ^ 1U);
+        trace[steps].t = t;
+        trace[steps].level = glitch ? (level ^ 1U) : level;
+        trace[steps].poll = false;
+        steps++;
+        for (p = 0U; p < pulses; p++)
+        {
+            t += 1U + bench_util_rng_range(gap);
+            trace[steps].t = t;
+            trace[steps].level = trace[steps - 1U].level ^ 1U;
+            trace[steps].poll = false;
+            steps++;
+        }
+        if (trace[steps - 1U].level != level)
+        {
+            t += 1U + bench_util_rng_range(gap);
+            trace[steps].t = t;
+            trace[steps].level = level;
+            trace[steps].poll = false;
+            steps++;
+        }
+        *longest = ((t - burst_start) > *longest) ? (t - burst_start) : *longest;
+    }
+
+    return steps;
+}
+
+
+/*******************************************************************************
+* Function Name: test_capture
+********************************************************************************
+* Summary:
+*  Feeds random traces to the capture engine, the way button_capture.c does:
+*  each edge first settles a window that ran out before it, and polls settle
+*  the switch at the level of the button, and compares the presses with the
+*  reference debouncer. Traces start anywhere, including next to the 32-bit
+*  wrap.
+*******************************************************************************/
+static void test_capture(test_result_t *r)
+{
+    timing_capture_t capture;
+    uint64_t start;
+    uint64_t end;
+    uint64_t ts;
+    timing_capture_event_t event;
+    uint32_t presses;
+    uint32_t releases;
+    uint32_t expected;
+    uint32_t steps;
+    uint32_t n;
+    uint32_t i;
+
+    for (n = 0U; n < TEST_TRACES; n++)
+    {
+        start = (0U == (n & 1U)) ? (bench_util_rng_next() >> 20) :
+                                   (0xFFFFFFFFULL - bench_util_rng_range(100000U));
+        steps = make_trace(start);
+        end = trace[steps - 1U].t + TEST_WINDOW + bench_util_rng_range(2U * TEST_WINDOW);
+
+        timing_capture_init(&capture, TEST_WINDOW);
+        mock_button = 1U;
+        presses = 0U;
+        releases = 0U;
+        for (i = 0U; i <= steps; i++)
+        {
+            if ((i == steps) || trace[i].poll)
+            {
+                event = timing_capture_poll_event(&capture, (i == steps) ? end : trace[i].t, &ts);
+            }
+            else
+            {
+                event = timing_capture_expired(&capture, trace[i].t) ?
+                            timing_capture_settle_event(&capture, capture.last_edge_level, &ts) :
+                            TIMING_CAPTURE_EVENT_NONE;
+            }
+            if (TIMING_CAPTURE_EVENT_PRESS == event)
+            {
+                engine_presses[presses++] = ts;
+            }
+            else if (TIMING_CAPTURE_EVENT_RELEASE == event)
+            {
+                engine_releases[releases++] = ts;
+            }
+            if ((i < steps) && !trace[i].poll)
+            {
+                timing_capture_edge(&capture, trace[i].t, trace[i].level);
+                mock_button = trace[i].level;
+            }
+        }
+
+        expected = model_presses_of(steps, end);
+        r->cases++;
+        if ((presses != expected) || (releases != model_release_count) ||
+            (0 != memcmp(engine_presses, model_presses, presses * sizeof(engine_presses[0]))) ||
+            (0 != memcmp(engine_releases, model_releases, releases * sizeof(engine_releases[0]))) ||
+            timing_capture_busy(&capture))
+        {
+            if (r->failures < 5U)
+            {
+                printf("  capture: trace %u, %u presses against %u\n",
+                       (unsigned)n, (unsigned)presses, (unsigned)expected);
+            }
+            r->failures++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_adapt
+********************************************************************************
+* Summary:
+*  Feeds switch traces to the capture with adaptive debounce and checks that
+*  it reports the presses of the reference debouncer at the conservative
+*  window. A press whose burst was cut short by a learned window that turned
+*  out too short may be timed from a later edge of its burst, but never
+*  outside it. On switches with no odd bursts the window must end up within
+*  the learned gap, its half and the margin.
+*******************************************************************************/
+static void test_adapt(test_result_t *r)
+{
+    timing_capture_t capture;
+    uint64_t longest;
+    uint64_t end;
+    uint64_t ts;
+    uint32_t max_gap;
+    uint32_t presses;
+    uint32_t expected;
+    uint32_t steps;
+    uint32_t n;
+    uint32_t i;
+    bool odd;
+    bool ok;
+
+    for (n = 0U; n < TEST_ADAPT_TRACES; n++)
+    {
+        odd = (0U != (n & 1U));
+        max_gap = (0U == (n & 2U)) ? (1U + bench_util_rng_range(TEST_WINDOW / 8U)) :
+                                     (1U + bench_util_rng_range((2U * TEST_WINDOW) / 3U));
+        steps = make_switch_trace(0xFFFFFFFFULL - bench_util_rng_range(1000000U), max_gap, odd,
+                                  &longest);
+        end = trace[steps - 1U].t + TEST_WINDOW;
+
+        timing_capture_init(&capture, TEST_WINDOW);
+        timing_capture_adapt(&capture, TEST_ADAPT_MARGIN);
+        mock_button = 1U;
+        presses = 0U;
+        for (i = 0U; i < steps; i++)
+        {
+            if (timing_capture_expired(&capture, trace[i].t) &&
+                timing_capture_settle(&capture, capture.last_edge_level, &ts))
+            {
+                engine_presses[presses++] = ts;
+            }
+            timing_capture_edge(&capture, trace[i].t, trace[i].level);
+            mock_button = trace[i].level;
+        }
+        if (timing_capture_poll(&capture, end, &ts))
+        {
+            engine_presses[presses++] = ts;
+        }
+
+        expected = model_presses_of(steps, end);
+        ok = (presses == expected) && !timing_capture_busy(&capture);
+        for (i = 0U; ok && (i < presses); i++)
+        {
+            ok = (engine_presses[i] >= model_presses[i]) &&
+                 ((engine_presses[i] - model_presses[i]) <= longest);
+        }
+        if (!odd)
+        {
+            ok = ok && (capture.window <= (max_gap + (max_gap / 2U) + TEST_ADAPT_MARGIN));
+        }
+
+        r->cases++;
+        if (!ok)
+        {
+            if (r->failures < 5U)
+            {
+                printf("  adapt: trace %u, %u presses against %u, window %u\n", (unsigned)n,
+                       (unsigned)presses, (unsigned)expected, (unsigned)capture.window);
+            }
+            r->failures++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_interval
+********************************************************************************
+* Summary:
+*  Times random press sequences, from start-up at any point of the time base,
+*  with gaps from one tick to several 32-bit wraps.
+*******************************************************************************/
+static void test_interval(test_result_t *r)
+{
+    timing_interval_t intervals;
+    uint64_t previous;
+    uint64_t press;
+    uint64_t ticks;
+    bool had_previous;
+    uint32_t n;
+    uint32_t i;
+
+    for (n = 0U; n < TEST_INTERVAL_RUNS; n++)
+    {
+        previous = (0U == (n & 1U)) ? 0U : (bench_util_rng_next() >> 24);
+        timing_interval_init(&intervals, previous);
+        press = previous;
+        for (i = 0U; i < TEST_INTERVAL_PRESSES; i++)
+        {
+            press += (0U == bench_util_rng_range(8U)) ? (bench_util_rng_next() >> 28) :
+                                                        (1U + bench_util_rng_range(1000000U));
+            had_previous = timing_interval_press(&intervals, press, &ticks);
+
+            r->cases++;
+            if ((ticks != (press - previous)) || (had_previous != (i > 0U)))
+            {
+                r->failures++;
+            }
+            previous = press;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    test_result_t results[] = {
+        { .name = "read32 at wraps" },
+        { .name = "64-bit extension" },
+        { .name = "press capture" },
+        { .name = "adaptive debounce" },
+        { .name = "intervals" },
+    };
+    uint32_t failures = 0U;
+    uint32_t i;
+
+    test_read32(&results[0]);
+    test_extend(&results[1]);
+    test_capture(&results[2]);
+    test_adapt(&results[3]);
+    test_interval(&results[4]);
+
+    printf("\ntest               | cases   | failures\n");
+    printf("-------------------|---------|---------\n");
+    for (i = 0U; i < (sizeof(results) / sizeof(results[0])); i++)
+    {
+        printf("%-18s | %7u | %8u\n", results[i].name, (unsigned)results[i].cases,
+               (unsigned)results[i].failures);
+        failures += results[i].failures;
+    }
+
+    return (0U == failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,322 @@
+/******************************************************************************
+* File Name:   watchdog_test.c
+*
+* Description: Runs a main loop under the windowed watchdog supervisor: healthy, hung,
+*              feeding on every pass, and feeding late once. Checks which runs are reset,
+*              with which cause, and the cost of the service call on the main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+
+#include "cybsp.h"
+#include "mcwdt_sim.h"
+#include "watchdog_supervisor.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Virtual time of the healthy run */
+#define TEST_HEALTHY_S                      (3600U)
+
+/* When the faulty runs go wrong, and how long they may run after that */
+#define TEST_FAULT_AT_NS                    (30U * MCWDT_SIM_NS_PER_S + 123U * MCWDT_SIM_NS_PER_MS)
+#define TEST_FAULT_RUN_S                    (40U)
+
+/* From a warning to the MCWDT reset: the rest of the period, and the next
+ * one, whose match is the third without a feed */
+#define TEST_RESET_DELAY_NS                 (((2ULL * WATCHDOG_SUPERVISOR_PERIOD_CYCLES - WATCHDOG_SUPERVISOR_WARN_CYCLES) * \
+                                              MCWDT_SIM_NS_PER_S) / CY_SYSCLK_WCO_FREQ)
+
+/* Work done by the main loop on each pass */
+#define TEST_WORK_NS                        (20U * MCWDT_SIM_NS_PER_US)
+
+/* Delay of the feed in the late run: past the warning, inside the period */
+#define TEST_LATE_NS                        (700U * MCWDT_SIM_NS_PER_MS)
+
+/* Main-loop passes timed for the cost of watchdog_supervisor_service() */
+#define TEST_PASSES                         (100000000U)
+
+#define TEST_NS_PER_CYCLE                   (1e9 / (double)CY_SYSCLK_WCO_FREQ)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    TEST_HEALTHY,       /* Feeds in every window                         */
+    TEST_HANG,          /* Main loop stops; interrupts still run          */
+    TEST_RUNAWAY,       /* Main loop feeds on every pass                  */
+    TEST_LATE           /* One feed late, but before the end of the period */
+} test_kind_t;
+
+typedef struct
+{
+    const char *name;
+    test_kind_t kind;
+    uint64_t run_ns;
+    bool faulted;       /* Restarted with a fault record */
+    watchdog_supervisor_fault_t fault;
+    uint32_t warnings;
+    uint64_t warning_ns;
+    uint64_t restart_ns;
+    bool late_done;
+    mcwdt_sim_stats_t stats;
+} test_run_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static test_run_t *current;
+
+
+/*******************************************************************************
+* Function Name: on_warning
+*******************************************************************************/
+static void on_warning(watchdog_supervisor_fault_t const *fault)
+{
+    current->warnings++;
+    current->warning_ns = mcwdt_sim_now_ns();
+}
+
+
+/*******************************************************************************
+* Function Name: supervised_app
+********************************************************************************
+* Summary:
+*  A main loop that sleeps between the supervisor interrupts and feeds the
+*  watchdog when its window opens, until it goes wrong as the run asks.
+*******************************************************************************/
+static void supervised_app(void)
+{
+    uint32_t intr_status;
+
+    bench_util_start_mcwdt();
+
+    /* After a reset by the supervisor the run is over */
+    if (watchdog_supervisor_get_fault(&current->fault))
+    {
+        current->faulted = true;
+        current->restart_ns = mcwdt_sim_now_ns();
+        mcwdt_sim_finish();
+    }
+    CY_ASSERT(CY_RSLT_SUCCESS == watchdog_supervisor_init(on_warning));
+
+    for (;;)
+    {
+        bool faulty = (mcwdt_sim_now_ns() >= TEST_FAULT_AT_NS);
+
+        if (faulty && (TEST_HANG == current->kind))
+        {
+            for (;;)
+            {
+                mcwdt_sim_advance_ns(MCWDT_SIM_NS_PER_MS);
+            }
+        }
+        if (faulty && (TEST_RUNAWAY == current->kind))
+        {
+            for (;;)
+            {
+                watchdog_supervisor_feed();
+                mcwdt_sim_advance_ns(TEST_WORK_NS);
+            }
+        }
+        if (faulty && (TEST_LATE == current->kind) && !current->late_done &&
+            watchdog_supervisor_window_open)
+        {
+            current->late_done = true;
+            mcwdt_sim_advance_ns(TEST_LATE_NS);
+        }
+
+        watchdog_supervisor_service();
+        mcwdt_sim_advance_ns(TEST_WORK_NS);
+
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        if (!watchdog_supervisor_window_open)
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(test_run_t *r)
+{
+    watchdog_supervisor_fault_t stale;
+    double fault_s = (double)TEST_FAULT_AT_NS / 1e9;
+
+    current = r;
+    (void)watchdog_supervisor_get_fault(&stale);
+    mcwdt_sim_reset();
+    (void)mcwdt_sim_run(supervised_app, r->run_ns);
+    r->stats = *mcwdt_sim_stats();
+
+    printf("%-8s | %6llu | %8u | ", r->name, (unsigned long long)r->stats.resets, r->warnings);
+    if (r->warnings > 0U)
+    {
+        printf("%9.3f | ", (double)r->warning_ns / 1e9 - fault_s);
+    }
+    else
+    {
+        printf("%9s | ", "-");
+    }
+    if (r->faulted)
+    {
+        printf("%9.3f | %-10s | %9.3f\n", (double)r->restart_ns / 1e9 - fault_s,
+               (WATCHDOG_SUPERVISOR_FAULT_EARLY_FEED == r->fault.cause) ? "early feed" : "not fed",
+               (double)r->fault.timestamp * TEST_NS_PER_CYCLE / 1e9 - fault_s);
+    }
+    else
+    {
+        printf("%9s | %-10s | %9s\n", "-", "-", "-");
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: reset_in_time
+********************************************************************************
+* Summary:
+*  True if the run restarted with a fault record, within a millisecond after
+*  the end of the period that follows its warning.
+*
+*******************************************************************************/
+static bool reset_in_time(test_run_t const *r)
+{
+    uint64_t delay = r->restart_ns - r->warning_ns;
+
+    return r->faulted && (delay >= TEST_RESET_DELAY_NS) &&
+           (delay < (TEST_RESET_DELAY_NS + MCWDT_SIM_NS_PER_MS));
+}
+
+
+/*******************************************************************************
+* Function Name: pass_ns
+********************************************************************************
+* Summary:
+*  Wall time of one main-loop pass with a little work, with or without the
+*  service call, while the window is closed as it is on almost every pass.
+*******************************************************************************/
+static double pass_ns(bool service)
+{
+    static volatile uint32_t work;
+    uint64_t t0;
+    uint32_t i;
+
+    watchdog_supervisor_window_open = false;
+    t0 = bench_util_wall_ns();
+    for (i = 0U; i < TEST_PASSES; i++)
+    {
+        if (service)
+        {
+            watchdog_supervisor_service();
+        }
+        work = work + i;
+    }
+    return (double)(bench_util_wall_ns() - t0) / (double)TEST_PASSES;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    test_run_t healthy = { .name = "healthy", .kind = TEST_HEALTHY,
+                            .run_ns = TEST_HEALTHY_S * MCWDT_SIM_NS_PER_S };
+    test_run_t hang = { .name = "hang", .kind = TEST_HANG,
+                        .run_ns = TEST_FAULT_RUN_S * MCWDT_SIM_NS_PER_S };
+    test_run_t runaway = { .name = "runaway", .kind = TEST_RUNAWAY,
+                           .run_ns = TEST_FAULT_RUN_S * MCWDT_SIM_NS_PER_S };
+    test_run_t late = { .name = "late", .kind = TEST_LATE,
+                        .run_ns = TEST_FAULT_RUN_S * MCWDT_SIM_NS_PER_S };
+    double with_service = 1e9;
+    double without = 1e9;
+    double t;
+    uint32_t i;
+    bool ok;
+
+    printf("Period %.0f ms, window open from %.0f ms, warning at %.0f ms; faults start at %.3f s\n"
+           "times below are seconds after the fault\n\n",
+           WATCHDOG_SUPERVISOR_PERIOD_CYCLES * TEST_NS_PER_CYCLE / 1e6,
+           WATCHDOG_SUPERVISOR_OPEN_CYCLES * TEST_NS_PER_CYCLE / 1e6,
+           WATCHDOG_SUPERVISOR_WARN_CYCLES * TEST_NS_PER_CYCLE / 1e6,
+           (double)TEST_FAULT_AT_NS / 1e9);
+    printf("run      | resets | warnings | warning   | restart   | cause      | timestamp\n");
+    printf("---------|--------|----------|-----------|-----------|------------|----------\n");
+    run(&healthy);
+    run(&hang);
+    run(&runaway);
+    run(&late);
+
+    printf("\nhealthy: %.2f interrupts/s, CPU active %.4f %% for %u s\n",
+           (double)healthy.stats.irq_count / TEST_HEALTHY_S,
+           100.0 * (double)healthy.stats.busy_ns /
+           (double)(healthy.stats.busy_ns + healthy.stats.sleep_ns), TEST_HEALTHY_S);
+
+    /* Best of three against scheduling noise */
+    for (i = 0U; i < 3U; i++)
+    {
+        t = pass_ns(false);
+        without = (t < without) ? t : without;
+        t = pass_ns(true);
+        with_service = (t < with_service) ? t : with_service;
+    }
+    printf("main-loop pass: %.3f ns without the service call, %.3f ns with it\n",
+           without, with_service);
+
+    ok = (0U == healthy.stats.resets) && (0U == healthy.warnings) &&
+         hang.faulted && (WATCHDOG_SUPERVISOR_FAULT_STARVED == hang.fault.cause) &&
+         (1U == hang.warnings) && (1U == hang.stats.resets) && reset_in_time(&hang) &&
+         runaway.faulted && (WATCHDOG_SUPERVISOR_FAULT_EARLY_FEED == runaway.fault.cause) &&
+         (1U == runaway.warnings) && (1U == runaway.stats.resets) &&
+         !late.faulted && (1U == late.warnings) && (0U == late.stats.resets);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
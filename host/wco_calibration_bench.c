@@ -0,0 +1,275 @@
+/******************************************************************************
+* File Name:   wco_calibration_bench.c
+*
+* Description: Measures the intervals between button presses on a simulated WCO
+*              with a constant frequency error and along a temperature ramp, with
+*              and without the correction from wco_calibration.c against reference
+*              time lines from the host over the debug UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "mcwdt_sim.h"
+#include "button_capture.h"
+#include "log_sink.h"
+#include "wco_calibration.h"
+#include "bench_util.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Virtual time of each run */
+#define BENCH_RUN_S                         (2U * 3600U)
+
+/* The host sends its time once a minute, from an origin of its own */
+#define BENCH_REFERENCE_PERIOD_S            (60U)
+#define BENCH_REFERENCE_ORIGIN_US           (1700000000000000ULL)
+
+/* Presses every 10 minutes from shortly after start-up */
+#define BENCH_FIRST_PRESS_S                 (5U)
+#define BENCH_PRESS_PERIOD_S                (600U)
+#define BENCH_HOLD_MS                       (150U)
+
+/* Temperature ramp: a tuning-fork crystal loses 0.034 ppm per degree squared
+ * away from its turnover at 25 degrees C; the run heats it from 25 to 65 */
+#define BENCH_RAMP_PPB_PER_C2               (34)
+#define BENCH_RAMP_TURNOVER_C               (25.0)
+#define BENCH_RAMP_END_C                    (65.0)
+#define BENCH_RAMP_STEP_S                   (60U)
+
+/* Corrected intervals must be within this of the true interval */
+#define BENCH_CORRECTED_MAX_PPM             (1.0)
+#define BENCH_RAMP_MAX_PPM                  (4.0)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    int32_t ppm;                /* Constant WCO error */
+    bool ramp;                  /* WCO error follows the temperature ramp */
+    uint32_t intervals;
+    double raw_max_ppm;         /* Largest error of the uncorrected intervals */
+    double corrected_max_ppm;   /* Largest error of the corrected intervals   */
+    double raw_max_us;
+    double corrected_max_us;
+    wco_calibration_stats_t cal;
+} bench_result_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static bench_result_t *current;
+
+
+/*******************************************************************************
+* Function Name: ramp_ppb
+********************************************************************************
+* Summary:
+*  WCO error at a virtual time of the temperature ramp.
+*******************************************************************************/
+static int64_t ramp_ppb(uint64_t t_ns)
+{
+    double c = BENCH_RAMP_TURNOVER_C + ((BENCH_RAMP_END_C - BENCH_RAMP_TURNOVER_C) *
+                                        (double)t_ns / ((double)BENCH_RUN_S * MCWDT_SIM_NS_PER_S));
+
+    return -(int64_t)(BENCH_RAMP_PPB_PER_C2 * (c - BENCH_RAMP_TURNOVER_C) *
+                      (c - BENCH_RAMP_TURNOVER_C));
+}
+
+
+/*******************************************************************************
+* Function Name: record_interval
+********************************************************************************
+* Summary:
+*  Compares the raw and corrected interval between two presses with the time
+*  between the press edges.
+*******************************************************************************/
+static void record_interval(uint64_t raw, uint64_t true_ns)
+{
+    double truth = (double)true_ns * CY_SYSCLK_WCO_FREQ / (double)MCWDT_SIM_NS_PER_S;
+    double raw_err = (double)raw - truth;
+    double cor_err = (double)wco_calibration_correct(raw) - truth;
+
+    raw_err = (raw_err < 0.0) ? -raw_err : raw_err;
+    cor_err = (cor_err < 0.0) ? -cor_err : cor_err;
+    if ((raw_err * 1e6 / truth) > current->raw_max_ppm)
+    {
+        current->raw_max_ppm = raw_err * 1e6 / truth;
+        current->raw_max_us = raw_err * 1e6 / CY_SYSCLK_WCO_FREQ;
+    }
+    if ((cor_err * 1e6 / truth) > current->corrected_max_ppm)
+    {
+        current->corrected_max_ppm = cor_err * 1e6 / truth;
+        current->corrected_max_us = cor_err * 1e6 / CY_SYSCLK_WCO_FREQ;
+    }
+    current->intervals++;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_app
+********************************************************************************
+* Summary:
+*  The main loop of main() with interrupt capture and the background log
+*  sink, feeding received characters to the calibration.
+*******************************************************************************/
+static void bench_app(void)
+{
+    uint64_t timestamp;
+    uint64_t previous = 0U;
+    uint64_t ramp_next = 0U;
+    uint32_t press = 0U;
+    uint32_t intr_status;
+    char c;
+
+    CY_ASSERT(CY_RSLT_SUCCESS == cy_retarget_io_init(0U, 0U, CY_RETARGET_IO_BAUDRATE));
+    CY_ASSERT(CY_RSLT_SUCCESS == log_sink_init());
+    bench_util_start_mcwdt();
+    CY_ASSERT(CY_RSLT_SUCCESS == button_capture_init());
+    wco_calibration_init();
+
+    for (;;)
+    {
+        /* The crystal warms up; its frequency is stepped once a minute */
+        if (current->ramp && (mcwdt_sim_now_ns() >= ramp_next))
+        {
+            mcwdt_sim_set_lfclk_ppb(ramp_ppb(mcwdt_sim_now_ns()));
+            ramp_next += (uint64_t)BENCH_RAMP_STEP_S * MCWDT_SIM_NS_PER_S;
+        }
+
+        while (button_capture_get_press(&timestamp))
+        {
+            if (press > 0U)
+            {
+                record_interval(timestamp - previous,
+                                (uint64_t)BENCH_PRESS_PERIOD_S * MCWDT_SIM_NS_PER_S);
+            }
+            previous = timestamp;
+            press++;
+        }
+
+        while (log_sink_getc(&c))
+        {
+            (void)wco_calibration_parse(c);
+        }
+
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        if (!button_capture_busy())
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: run
+*******************************************************************************/
+static void run(bench_result_t *res)
+{
+    char line[32];
+    uint64_t t;
+
+    current = res;
+    mcwdt_sim_reset();
+    mcwdt_sim_set_lfclk_ppb(res->ramp ? ramp_ppb(0U) : ((int64_t)res->ppm * 1000));
+
+    for (t = BENCH_REFERENCE_PERIOD_S; t < BENCH_RUN_S; t += BENCH_REFERENCE_PERIOD_S)
+    {
+        (void)snprintf(line, sizeof(line), "T%llu\r\n",
+                       (unsigned long long)(BENCH_REFERENCE_ORIGIN_US + (t * 1000000ULL)));
+        mcwdt_sim_schedule_uart_rx(t * MCWDT_SIM_NS_PER_S, line);
+    }
+    for (t = BENCH_FIRST_PRESS_S; t < BENCH_RUN_S; t += BENCH_PRESS_PERIOD_S)
+    {
+        mcwdt_sim_schedule_press(t * MCWDT_SIM_NS_PER_S, BENCH_HOLD_MS * MCWDT_SIM_NS_PER_MS);
+    }
+
+    CY_ASSERT(MCWDT_SIM_RUN_UNTIL == mcwdt_sim_run(bench_app, BENCH_RUN_S * MCWDT_SIM_NS_PER_S));
+    wco_calibration_get_stats(&res->cal);
+
+    printf("%-16s | %9u | %12.3f | %12.1f | %12.3f | %12.1f | %9.3f\n", res->name,
+           res->intervals, res->raw_max_ppm, res->raw_max_us, res->corrected_max_ppm,
+           res->corrected_max_us, (double)res->cal.error_ppb / 1000.0);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    bench_result_t runs[] =
+    {
+        { .name = "WCO -100 ppm", .ppm = -100 },
+        { .name = "WCO -20 ppm", .ppm = -20 },
+        { .name = "WCO exact", .ppm = 0 },
+        { .name = "WCO +20 ppm", .ppm = 20 },
+        { .name = "WCO +50 ppm", .ppm = 50 },
+        { .name = "WCO +100 ppm", .ppm = 100 },
+        { .name = "25 to 65 C ramp", .ramp = true },
+    };
+    bool ok = true;
+    uint32_t i;
+
+    printf("%u h, reference time from the host every %u s, presses every %u s;\n"
+           "errors are the largest of any interval against the true time\n\n",
+           BENCH_RUN_S / 3600U, BENCH_REFERENCE_PERIOD_S, BENCH_PRESS_PERIOD_S);
+    printf("drift            | intervals | raw max(ppm) | raw max(us)  | corr max(ppm)| corr max(us) | estimate(ppm)\n");
+    printf("-----------------|-----------|--------------|--------------|--------------|--------------|--------------\n");
+    for (i = 0U; i < (sizeof(runs) / sizeof(runs[0])); i++)
+    {
+        run(&runs[i]);
+        ok = ok && (runs[i].corrected_max_ppm <=
+                    (runs[i].ramp ? BENCH_RAMP_MAX_PPM : BENCH_CORRECTED_MAX_PPM));
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,203 @@
+/******************************************************************************
+* File Name:   interval_format.c
+*
+* Description: Formats LFCLK tick intervals as seconds with microsecond
+*              resolution using shifts and multiplies only.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "interval_format.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* 10^6 / 2^15 = 15625 / 2^9: converts a tick fraction to microseconds */
+#define INTERVAL_US_PER_TICK_NUM            (15625u)
+#define INTERVAL_US_PER_TICK_SHIFT          (9u)
+
+#if (CY_SYSCLK_WCO_FREQ != (1uL << INTERVAL_TICK_SHIFT))
+#error "Interval formatting assumes a 32768 Hz LFCLK"
+#endif
+
+
+/*******************************************************************************
+* Function Name: interval_div10
+********************************************************************************
+* Summary:
+*  Divides by 10 with a multiply and a shift, exact for any 32-bit value.
+*
+* Parameters:
+*  value: dividend
+*
+* Return:
+*  uint32_t: value / 10
+*
+*******************************************************************************/
+static inline uint32_t interval_div10(uint32_t value)
+{
+    return (uint32_t)(((uint64_t)value * 0xCCCCCCCDuLL) >> 35);
+}
+
+
+/*******************************************************************************
+* Function Name: interval_format_ticks
+********************************************************************************
+* Summary:
+*  Writes an interval of LFCLK ticks as "<seconds>.<microseconds>", for example
+*  "2.500000". The whole seconds are the ticks shifted right by 15; the
+*  15-bit fraction is scaled to microseconds and rounded to nearest, which
+*  never carries into the seconds. Intervals of 2^32 s or more saturate.
+*
+* Parameters:
+*  buf: receives the string, at least INTERVAL_FORMAT_BUF_SIZE bytes
+*  ticks: interval in LFCLK ticks
+*
+* Return:
+*  size_t: length of the string, excluding the terminating NUL
+*
+*******************************************************************************/
+size_t interval_format_ticks(char *buf, uint64_t ticks)
+{
+    uint64_t whole = ticks >> INTERVAL_TICK_SHIFT;
+    uint32_t seconds = (whole > UINT32_MAX) ? UINT32_MAX : (uint32_t)whole;
+    uint32_t micros = ((((uint32_t)ticks & INTERVAL_TICK_FRACTION_MASK) * INTERVAL_US_PER_TICK_NUM) +
+                       (1uL << (INTERVAL_US_PER_TICK_SHIFT - 1u))) >> INTERVAL_US_PER_TICK_SHIFT;
+    char digits[10];
+    size_t len = 0u;
+    size_t n = 0u;
+    uint32_t q;
+    uint32_t i;
+
+    /* Seconds, least significant digit first */
+    do
+    {
+        q = interval_div10(seconds);
+        digits[n++] = (char)('0' + (seconds - (q * 10u)));
+        seconds = q;
+    } while (0u != seconds);
+
+    while (n > 0u)
+    {
+        buf[len++] = digits[--n];
+    }
+
+    buf[len++] = '.';
+
+    /* Exactly six fraction digits, written from the right */
+    for (i = 6u; i > 0u; i--)
+    {
+        q = interval_div10(micros);
+        buf[len + i - 1u] = (char)('0' + (micros - (q * 10u)));
+        micros = q;
+    }
+    len += 6u;
+    buf[len] = '\0';
+
+    return len;
+}
+
+
+/*******************************************************************************
+* Function Name: interval_format32
+********************************************************************************
+* Summary:
+*  Formats the time from start to end of the 32-bit time base. The difference
+*  is taken modulo 2^32, so an interval that spans the counter wrap is still
+*  correct as long as it is shorter than the wrap period.
+*
+* Parameters:
+*  buf: receives the string, at least INTERVAL_FORMAT_BUF_SIZE bytes
+*  start: time base value at the start of the interval
+*  end: time base value at the end of the interval
+*
+* Return:
+*  size_t: length of the string, excluding the terminating NUL
+*
+*******************************************************************************/
+size_t interval_format32(char *buf, uint32_t start, uint32_t end)
+{
+    return interval_format_ticks(buf, (uint64_t)(uint32_t)(end - start));
+}
+
+
+/*******************************************************************************
+* Function Name: interval_format64
+********************************************************************************
+* Summary:
+*  Formats the time from start to end of the 64-bit time base, with the
+*  difference taken modulo 2^64.
+*
+* Parameters:
+*  buf: receives the string, at least INTERVAL_FORMAT_BUF_SIZE bytes
+*  start: time base value at the start of the interval
+*  end: time base value at the end of the interval
+*
+* Return:
+*  size_t: length of the string, excluding the terminating NUL
+*
+*******************************************************************************/
+size_t interval_format64(char *buf, uint64_t start, uint64_t end)
+{
+    return interval_format_ticks(buf, end - start);
+}
+
+
+/*******************************************************************************
+* Function Name: interval_ticks_to_us
+********************************************************************************
+* Summary:
+*  Converts LFCLK ticks to microseconds, rounded to nearest.
+*
+* Parameters:
+*  ticks: interval in LFCLK ticks
+*
+* Return:
+*  uint64_t: interval in microseconds
+*
+*******************************************************************************/
+uint64_t interval_ticks_to_us(uint64_t ticks)
+{
+    return ((ticks >> INTERVAL_TICK_SHIFT) * 1000000u) +
+           (((((uint32_t)ticks & INTERVAL_TICK_FRACTION_MASK) * INTERVAL_US_PER_TICK_NUM) +
+             (1uL << (INTERVAL_US_PER_TICK_SHIFT - 1u))) >> INTERVAL_US_PER_TICK_SHIFT);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,75 @@
+/******************************************************************************
+* File Name:   interval_format.h
+*
+* Description: Formats LFCLK tick intervals as seconds with microsecond
+*              resolution using shifts and multiplies only.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef INTERVAL_FORMAT_H
+#define INTERVAL_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* The LFCLK is 2^15 Hz: the low 15 bits of a tick count are the fraction of a
+ * second */
+#define INTERVAL_TICK_SHIFT                 (15u)
+#define INTERVAL_TICK_FRACTION_MASK         ((1uL << INTERVAL_TICK_SHIFT) - 1u)
+
+/* Longest string produced, "4294967295.999969" plus the terminating NUL */
+#define INTERVAL_FORMAT_BUF_SIZE            (18u)
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+size_t   interval_format_ticks(char *buf, uint64_t ticks);
+size_t   interval_format32(char *buf, uint32_t start, uint32_t end);
+size_t   interval_format64(char *buf, uint64_t start, uint64_t end);
+uint64_t interval_ticks_to_us(uint64_t ticks);
+
+
+#endif /* INTERVAL_FORMAT_H */
+
+
+/* [] END OF FILE */
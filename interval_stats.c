@@ -0,0 +1,287 @@
+/******************************************************************************
+* File Name:   interval_stats.c
+*
+* Description: Constant-memory running statistics of measured intervals: count,
+*              min/max, Welford mean/variance and a log2 histogram.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "interval_stats.h"
+
+
+/*******************************************************************************
+* Function Name: interval_stats_init
+********************************************************************************
+* Summary:
+*  Clears the statistics.
+*
+* Parameters:
+*  stats: statistics to clear
+*
+*******************************************************************************/
+void interval_stats_init(interval_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->min = UINT64_MAX;
+}
+
+
+/*******************************************************************************
+* Function Name: interval_stats_bucket
+********************************************************************************
+* Summary:
+*  Returns the histogram bucket of an interval: the number of significant bits
+*  of the tick count, limited to the last bucket.
+*
+* Parameters:
+*  ticks: interval in ticks
+*
+* Return:
+*  uint32_t: bucket index
+*
+*******************************************************************************/
+uint32_t interval_stats_bucket(uint64_t ticks)
+{
+    uint32_t bits = (0u == ticks) ? 0u : (64u - (uint32_t)__builtin_clzll(ticks));
+
+    return (bits < INTERVAL_STATS_BUCKETS) ? bits : (INTERVAL_STATS_BUCKETS - 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: interval_stats_bucket_floor
+********************************************************************************
+* Summary:
+*  Returns the shortest interval counted in a histogram bucket.
+*
+* Parameters:
+*  bucket: bucket index
+*
+* Return:
+*  uint64_t: interval in ticks
+*
+*******************************************************************************/
+uint64_t interval_stats_bucket_floor(uint32_t bucket)
+{
+    return (0u == bucket) ? 0u : (1ull << (bucket - 1u));
+}
+
+
+/*******************************************************************************
+* Function Name: interval_stats_mul
+********************************************************************************
+* Summary:
+*  Multiplies two 64-bit values into a 128-bit product, in 32-bit halves so
+*  that only the Cortex-M4 UMULL and UMLAL are needed.
+*
+* Parameters:
+*  a, b: factors
+*  hi:   returns the upper 64 bits of the product
+*  lo:   returns the lower 64 bits of the product
+*
+*******************************************************************************/
+static void interval_stats_mul(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo)
+{
+    uint64_t ll = (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu);
+    uint64_t lh = (a & 0xFFFFFFFFu) * (b >> 32);
+    uint64_t hl = (a >> 32) * (b & 0xFFFFFFFFu);
+    uint64_t hh = (a >> 32) * (b >> 32);
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+
+    *lo = (mid << 32) | (ll & 0xFFFFFFFFu);
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+
+/*******************************************************************************
+* Function Name: interval_stats_add
+********************************************************************************
+* Summary:
+*  Adds one interval. Takes constant time, no heap and no floating point, so
+*  it may be called from an interrupt: a count-leading-zeros for the bucket
+*  and one Welford step in fixed point, which is one 64-by-32-bit division
+*  for the mean and one 64-by-64-bit multiply for the sum of squares.
+*
+* Parameters:
+*  stats: statistics to update
+*  ticks: interval in ticks
+*
+*******************************************************************************/
+void interval_stats_add(interval_stats_t *stats, uint64_t ticks)
+{
+    int64_t x = (int64_t)(ticks << INTERVAL_STATS_FRAC_BITS);
+    int64_t delta = x - stats->mean;
+    uint64_t half;
+    uint64_t step;
+    uint64_t hi;
+    uint64_t lo;
+
+    stats->count++;
+    stats->min = (ticks < stats->min) ? ticks : stats->min;
+    stats->max = (ticks > stats->max) ? ticks : stats->max;
+    stats->histogram[interval_stats_bucket(ticks)]++;
+
+    /* mean += delta / count, rounded to nearest. The step is never larger
+     * than delta, so x - mean keeps the sign of delta and the product below
+     * is never negative. */
+    half = stats->count / 2u;
+    if (delta >= 0)
+    {
+        step = ((uint64_t)delta + half) / stats->count;
+        stats->mean += (int64_t)step;
+        interval_stats_mul((uint64_t)delta, (uint64_t)(x - stats->mean), &hi, &lo);
+    }
+    else
+    {
+        step = ((uint64_t)(-delta) + half) / stats->count;
+        stats->mean -= (int64_t)step;
+        interval_stats_mul((uint64_t)(-delta), (uint64_t)(stats->mean - x), &hi, &lo);
+    }
+
+    /* m2 += delta * (x - mean), from 1/2^32 to 1/65536 square ticks */
+    lo = (lo >> INTERVAL_STATS_FRAC_BITS) | (hi << (64u - INTERVAL_STATS_FRAC_BITS));
+    hi >>= INTERVAL_STATS_FRAC_BITS;
+    stats->m2_lo += lo;
+    stats->m2_hi += hi + ((stats->m2_lo < lo) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: interval_stats_mean
+********************************************************************************
+* Summary:
+*  Returns the mean interval, rounded to the nearest tick.
+*
+* Parameters:
+*  stats: statistics to read
+*
+* Return:
+*  uint64_t: mean in ticks, 0 if there are no intervals
+*
+*******************************************************************************/
+uint64_t interval_stats_mean(interval_stats_t const *stats)
+{
+    return (stats->mean <= 0) ? 0u
+         : (((uint64_t)stats->mean + (1ull << (INTERVAL_STATS_FRAC_BITS - 1u))) >> INTERVAL_STATS_FRAC_BITS);
+}
+
+
+/*******************************************************************************
+* Function Name: interval_stats_stddev
+********************************************************************************
+* Summary:
+*  Returns the sample standard deviation, rounded down to a whole tick, or
+*  within a few ticks for a deviation over 2^32 ticks. The division and
+*  square root are taken in integers, so that neither libm nor the
+*  floating-point library is needed.
+*
+* Parameters:
+*  stats: statistics to read
+*
+* Return:
+*  uint64_t: standard deviation in ticks, 0 for fewer than two intervals
+*
+*******************************************************************************/
+uint64_t interval_stats_stddev(interval_stats_t const *stats)
+{
+    uint32_t words[4];
+    uint64_t rem = 0u;
+    uint64_t variance;
+    uint64_t root = 0u;
+    uint64_t bit = 1ull << 62;
+    uint32_t shift;
+    uint32_t i;
+
+    if (stats->count < 2u)
+    {
+        return 0u;
+    }
+
+    /* variance = m2 / (count - 1), by long division in 32-bit words */
+    words[0] = (uint32_t)(stats->m2_hi >> 32);
+    words[1] = (uint32_t)stats->m2_hi;
+    words[2] = (uint32_t)(stats->m2_lo >> 32);
+    words[3] = (uint32_t)stats->m2_lo;
+    for (i = 0u; i < 4u; i++)
+    {
+        uint64_t cur = (rem << 32) | words[i];
+
+        words[i] = (uint32_t)(cur / (stats->count - 1u));
+        rem = cur % (stats->count - 1u);
+    }
+
+    /* To whole square ticks. A spread over 2^32 ticks leaves more than 64
+     * bits; those are scaled down by powers of four and the root scaled back
+     * up, which loses only bits far below the root's leading one. */
+    variance = ((uint64_t)words[1] << (64u - INTERVAL_STATS_FRAC_BITS))
+             | ((uint64_t)words[2] << (32u - INTERVAL_STATS_FRAC_BITS))
+             | ((uint64_t)words[3] >> INTERVAL_STATS_FRAC_BITS);
+    rem = ((uint64_t)words[0] << (32u - INTERVAL_STATS_FRAC_BITS)) | ((uint64_t)words[1] >> INTERVAL_STATS_FRAC_BITS);
+    shift = 0u;
+    while (0u != rem)
+    {
+        variance = (variance >> 2) | (rem << 62);
+        rem >>= 2;
+        shift++;
+    }
+
+    /* Digit-by-digit square root */
+    while (bit > variance)
+    {
+        bit >>= 2;
+    }
+    while (0u != bit)
+    {
+        if (variance >= (root + bit))
+        {
+            variance -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root << shift;
+}
+
+
+/* [] END OF FILE */
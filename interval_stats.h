@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name:   interval_stats.h
+*
+* Description: Constant-memory running statistics of measured intervals: count,
+*              min/max, Welford mean/variance and a log2 histogram.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef INTERVAL_STATS_H
+#define INTERVAL_STATS_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Histogram buckets. Bucket 0 counts intervals of 0 ticks and bucket k counts
+ * intervals of 2^(k-1) to 2^k - 1 ticks; the last bucket also counts every
+ * longer interval. 40 buckets reach 2^38 ticks, about 97 days. */
+#ifndef INTERVAL_STATS_BUCKETS
+#define INTERVAL_STATS_BUCKETS              (40u)
+#endif
+
+#if ((INTERVAL_STATS_BUCKETS < 2u) || (INTERVAL_STATS_BUCKETS > 65u))
+#error "INTERVAL_STATS_BUCKETS must be between 2 and 65"
+#endif
+
+/* Fraction bits of the mean and of the sum of squares */
+#define INTERVAL_STATS_FRAC_BITS            (16u)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/* Running statistics of intervals in ticks, in constant memory. Mean and
+ * variance use Welford's update, so they stay accurate over any number of
+ * intervals without summing squares. The update is in integers: the mean in
+ * 1/65536 ticks, and the sum of squares in 1/65536 square ticks as a 128-bit
+ * hi:lo pair, which holds 2^32 intervals of 2^38 ticks. */
+typedef struct
+{
+    uint32_t count;
+    uint64_t min;
+    uint64_t max;
+    int64_t  mean;          /* Mean in 1/65536 ticks */
+    uint64_t m2_hi;         /* Sum of squared differences from the mean, */
+    uint64_t m2_lo;         /* in 1/65536 square ticks */
+    uint32_t histogram[INTERVAL_STATS_BUCKETS];
+} interval_stats_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void     interval_stats_init(interval_stats_t *stats);
+void     interval_stats_add(interval_stats_t *stats, uint64_t ticks);
+uint64_t interval_stats_mean(interval_stats_t const *stats);
+uint64_t interval_stats_stddev(interval_stats_t const *stats);
+uint32_t interval_stats_bucket(uint64_t ticks);
+uint64_t interval_stats_bucket_floor(uint32_t bucket);
+
+
+#endif /* INTERVAL_STATS_H */
+
+
+/* [] END OF FILE */
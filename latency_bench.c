@@ -0,0 +1,299 @@
+/******************************************************************************
+* File Name:   latency_bench.c
+*
+* Description: Measures with the DWT cycle counter what each step from a button
+*              interrupt to a reported interval costs: the MCWDT and GPIO register
+*              reads, the cascaded time base reads, interrupt entry, and the
+*              queueing and formatting of the result.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cybsp.h"
+#include "latency_bench.h"
+#include "mcwdt_timebase.h"
+#include "timestamp_ring.h"
+#include "interval_format.h"
+#include "log_sink.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Priority of the interrupt used to measure interrupt entry, the same as the
+ * button capture interrupt that it stands in for */
+#define LATENCY_BENCH_INTR_PRIORITY         (3u)
+
+/* Spreads the formatted intervals over many digits */
+#define LATENCY_BENCH_FORMAT_STEP           (0x9E3779B9uLL)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static char const *const step_names[LATENCY_BENCH_STEPS] =
+{
+    [LATENCY_BENCH_MCWDT_READ]    = "Cy_MCWDT_GetCount()",
+    [LATENCY_BENCH_GPIO_READ]     = "GPIO_PRT_IN()",
+    [LATENCY_BENCH_TWO_READS]     = "Counter1:Counter0, two reads",
+    [LATENCY_BENCH_READ32]        = "mcwdt_timebase_read32()",
+    [LATENCY_BENCH_READ64]        = "mcwdt_timebase_read64()",
+    [LATENCY_BENCH_IRQ_ENTRY]     = "interrupt entry",
+    [LATENCY_BENCH_IRQ_TIMESTAMP] = "interrupt to timestamp",
+    [LATENCY_BENCH_RING_PUSH]     = "timestamp_ring_push()",
+    [LATENCY_BENCH_FORMAT]        = "interval_format_ticks()",
+    [LATENCY_BENCH_LOG_PRINTF]    = "log_sink_printf() of a line"
+};
+
+/* Cycle counter values taken by the interrupt handler */
+static volatile bool irq_taken;
+static volatile uint32_t irq_entry_cycles;
+static volatile uint32_t irq_timestamp_cycles;
+
+/* Keeps reads from being optimized away */
+static volatile uint64_t bench_sink;
+
+static timestamp_ring_t bench_ring;
+
+
+/*******************************************************************************
+* Function Name: latency_bench_isr
+********************************************************************************
+* Summary:
+*  Takes the cycle counter on entry, and again once it has a timestamp, as the
+*  button capture interrupt would.
+*
+*******************************************************************************/
+static void latency_bench_isr(void)
+{
+    irq_entry_cycles = DWT->CYCCNT;
+    bench_sink = mcwdt_timebase_read64();
+    irq_timestamp_cycles = DWT->CYCCNT;
+
+    NVIC_ClearPendingIRQ(CYBSP_USER_BTN_IRQ);
+    irq_taken = true;
+}
+
+
+/*******************************************************************************
+* Function Name: latency_bench_add
+********************************************************************************
+* Summary:
+*  Adds a sample of a step, less the cost of reading the cycle counter.
+*
+*******************************************************************************/
+static void latency_bench_add(latency_bench_report_t *report, uint64_t *sums,
+                              latency_bench_step_t step, uint32_t start, uint32_t end)
+{
+    latency_bench_result_t *res = &report->steps[step];
+    uint32_t cycles = end - start;
+
+    cycles = (cycles > report->overhead) ? (cycles - report->overhead) : 0u;
+    res->min = ((0u == res->samples) || (cycles < res->min)) ? cycles : res->min;
+    res->max = (cycles > res->max) ? cycles : res->max;
+    res->samples++;
+    sums[step] += cycles;
+}
+
+
+/*******************************************************************************
+* Function Name: latency_bench_run
+********************************************************************************
+* Summary:
+*  Enables the DWT cycle counter and measures each step LATENCY_BENCH_SAMPLES
+*  times. Interrupt entry is measured on the user button interrupt, pended in
+*  software, so call before button_capture_init() with interrupts enabled.
+*  MCWDT_0 must be running with the time base of mcwdt_timebase_init().
+*
+*  The log sink step waits for the UART to go idle before each line, so the
+*  cost includes starting the transfer, as for a press after a quiet period.
+*
+* Parameters:
+*  report: receives the cycle counts
+*  log_sink: true to measure log_sink_printf(), which needs log_sink_init()
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the failing cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t latency_bench_run(latency_bench_report_t *report, bool log_sink)
+{
+    static const cy_stc_sysint_t bench_intr_config =
+    {
+        .intrSrc = CYBSP_USER_BTN_IRQ,
+        .intrPriority = LATENCY_BENCH_INTR_PRIORITY
+    };
+    uint64_t sums[LATENCY_BENCH_STEPS] = { 0u };
+    char buf[INTERVAL_FORMAT_BUF_SIZE];
+    cy_en_sysint_status_t status;
+    uint32_t start;
+    uint32_t end;
+    uint32_t low;
+    uint32_t high;
+    uint32_t i;
+
+    memset(report, 0, sizeof(*report));
+    report->core_clock_hz = SystemCoreClock;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* The cost of the cycle counter reads themselves */
+    report->overhead = UINT32_MAX;
+    for (i = 0u; i < LATENCY_BENCH_SAMPLES; i++)
+    {
+        start = DWT->CYCCNT;
+        end = DWT->CYCCNT;
+        report->overhead = ((end - start) < report->overhead) ? (end - start) : report->overhead;
+    }
+
+    timestamp_ring_init(&bench_ring);
+    for (i = 0u; i < LATENCY_BENCH_SAMPLES; i++)
+    {
+        start = DWT->CYCCNT;
+        bench_sink = Cy_MCWDT_GetCount(MCWDT_0_HW, CY_MCWDT_COUNTER0);
+        end = DWT->CYCCNT;
+        latency_bench_add(report, sums, LATENCY_BENCH_MCWDT_READ, start, end);
+
+        start = DWT->CYCCNT;
+        bench_sink = GPIO_PRT_IN(CYBSP_USER_BTN_PORT);
+        end = DWT->CYCCNT;
+        latency_bench_add(report, sums, LATENCY_BENCH_GPIO_READ, start, end);
+
+        /* The original read, which can tear at a Counter 0 wrap */
+        start = DWT->CYCCNT;
+        low = Cy_MCWDT_GetCount(MCWDT_0_HW, CY_MCWDT_COUNTER0);
+        high = Cy_MCWDT_GetCount(MCWDT_0_HW, CY_MCWDT_COUNTER1);
+        bench_sink = (high << 16u) | low;
+        end = DWT->CYCCNT;
+        latency_bench_add(report, sums, LATENCY_BENCH_TWO_READS, start, end);
+
+        start = DWT->CYCCNT;
+        bench_sink = mcwdt_timebase_read32(MCWDT_0_HW);
+        end = DWT->CYCCNT;
+        latency_bench_add(report, sums, LATENCY_BENCH_READ32, start, end);
+
+        start = DWT->CYCCNT;
+        bench_sink = mcwdt_timebase_read64();
+        end = DWT->CYCCNT;
+        latency_bench_add(report, sums, LATENCY_BENCH_READ64, start, end);
+
+        start = DWT->CYCCNT;
+        (void)timestamp_ring_push(&bench_ring, bench_sink, i);
+        end = DWT->CYCCNT;
+        latency_bench_add(report, sums, LATENCY_BENCH_RING_PUSH, start, end);
+        timestamp_ring_release(&bench_ring, 1u);
+
+        start = DWT->CYCCNT;
+        bench_sink = interval_format_ticks(buf, (uint64_t)i * LATENCY_BENCH_FORMAT_STEP);
+        end = DWT->CYCCNT;
+        latency_bench_add(report, sums, LATENCY_BENCH_FORMAT, start, end);
+    }
+
+    status = Cy_SysInt_Init(&bench_intr_config, latency_bench_isr);
+    if (CY_SYSINT_SUCCESS != status)
+    {
+        return (cy_rslt_t)status;
+    }
+    NVIC_ClearPendingIRQ(CYBSP_USER_BTN_IRQ);
+    NVIC_EnableIRQ(CYBSP_USER_BTN_IRQ);
+    for (i = 0u; i < LATENCY_BENCH_SAMPLES; i++)
+    {
+        irq_taken = false;
+        start = DWT->CYCCNT;
+        NVIC_SetPendingIRQ(CYBSP_USER_BTN_IRQ);
+        __DSB();
+        __ISB();
+
+        /* Not taken with interrupts disabled */
+        if (irq_taken)
+        {
+            latency_bench_add(report, sums, LATENCY_BENCH_IRQ_ENTRY, start, irq_entry_cycles);
+            latency_bench_add(report, sums, LATENCY_BENCH_IRQ_TIMESTAMP, start, irq_timestamp_cycles);
+        }
+    }
+    NVIC_DisableIRQ(CYBSP_USER_BTN_IRQ);
+    NVIC_ClearPendingIRQ(CYBSP_USER_BTN_IRQ);
+
+    for (i = 0u; log_sink && (i < LATENCY_BENCH_LOG_SAMPLES); i++)
+    {
+        log_sink_flush();
+        (void)interval_format_ticks(buf, (uint64_t)i * LATENCY_BENCH_FORMAT_STEP);
+        start = DWT->CYCCNT;
+        (void)log_sink_printf("Latency benchmark line %u: %ss\r\n", (unsigned int)i, buf);
+        end = DWT->CYCCNT;
+        latency_bench_add(report, sums, LATENCY_BENCH_LOG_PRINTF, start, end);
+    }
+    if (log_sink)
+    {
+        log_sink_flush();
+    }
+
+    for (i = 0u; i < (uint32_t)LATENCY_BENCH_STEPS; i++)
+    {
+        if (0u != report->steps[i].samples)
+        {
+            report->steps[i].mean = (uint32_t)(sums[i] / report->steps[i].samples);
+        }
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: latency_bench_step_name
+********************************************************************************
+* Summary:
+*  Returns the name of a step for the summary table.
+*
+* Parameters:
+*  step: the step
+*
+* Return:
+*  char const *: its name
+*
+*******************************************************************************/
+char const *latency_bench_step_name(latency_bench_step_t step)
+{
+    return step_names[step];
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,110 @@
+/******************************************************************************
+* File Name:   latency_bench.h
+*
+* Description: Cycle counts, from the DWT cycle counter, of the steps from a
+*              button interrupt to a reported interval.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LATENCY_BENCH_H
+#define LATENCY_BENCH_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Samples taken of each step */
+#ifndef LATENCY_BENCH_SAMPLES
+#define LATENCY_BENCH_SAMPLES               (64u)
+#endif
+
+/* Lines queued to the log sink, each after the previous one has been sent.
+ * They appear on the UART. */
+#ifndef LATENCY_BENCH_LOG_SAMPLES
+#define LATENCY_BENCH_LOG_SAMPLES           (4u)
+#endif
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    LATENCY_BENCH_MCWDT_READ,       /* Cy_MCWDT_GetCount() of Counter 0           */
+    LATENCY_BENCH_GPIO_READ,        /* GPIO_PRT_IN() of the user button port      */
+    LATENCY_BENCH_TWO_READS,        /* Counter1:Counter0 from two plain reads     */
+    LATENCY_BENCH_READ32,           /* mcwdt_timebase_read32()                    */
+    LATENCY_BENCH_READ64,           /* mcwdt_timebase_read64()                    */
+    LATENCY_BENCH_IRQ_ENTRY,        /* Interrupt pended until its handler runs    */
+    LATENCY_BENCH_IRQ_TIMESTAMP,    /* Interrupt pended until the handler has read64 */
+    LATENCY_BENCH_RING_PUSH,        /* timestamp_ring_push() of the timestamp     */
+    LATENCY_BENCH_FORMAT,           /* interval_format_ticks()                    */
+    LATENCY_BENCH_LOG_PRINTF,       /* log_sink_printf() of a report line         */
+    LATENCY_BENCH_STEPS
+} latency_bench_step_t;
+
+/* Cycles of one step, less the cost of reading the cycle counter */
+typedef struct
+{
+    uint32_t samples;
+    uint32_t min;
+    uint32_t max;
+    uint32_t mean;
+} latency_bench_result_t;
+
+typedef struct
+{
+    uint32_t core_clock_hz;     /* CPU clock, which the cycle counter counts  */
+    uint32_t overhead;          /* Cycles between two cycle counter reads     */
+    latency_bench_result_t steps[LATENCY_BENCH_STEPS];
+} latency_bench_report_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t   latency_bench_run(latency_bench_report_t *report, bool log_sink);
+char const *latency_bench_step_name(latency_bench_step_t step);
+
+
+#endif /* LATENCY_BENCH_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,468 @@
+/******************************************************************************
+* File Name:   lfclk_source.c
+*
+* Description: Finds whether LFCLK runs from the WCO or the ILO. The ILO is trimmed
+*              and measured against the IMO at start-up and periodically after, so
+*              that intervals can be converted to WCO ticks and given an error bound.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cybsp.h"
+#include "lfclk_source.h"
+#include "mcwdt_timebase.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define LFCLK_SOURCE_PPM                    (1000000u)
+
+/* Cy_SysClk_IloTrim() moves the ILO in steps of 1.5% towards CY_SYSCLK_WCO_FREQ
+ * and leaves it within one step of it */
+#define LFCLK_SOURCE_ILO_TRIM_STEP_PPM      (15000u)
+
+/* Measurements at start-up: trim, then measure the trimmed ILO */
+#define LFCLK_SOURCE_INIT_MEASUREMENTS      (3u)
+
+/* Low bits of a tick count multiplied separately by the conversion factor */
+#define LFCLK_SOURCE_SPLIT_BITS             (15u)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static lfclk_source_stats_t lfclk_stats;
+
+/* WCO ticks per LFCLK tick - 1, in 2^-LFCLK_SOURCE_FRAC_BITS units */
+static int32_t tick_factor;
+
+/* Time base value at the last trim, and at the trim before it; 0 until the
+ * ILO is trimmed after start-up */
+static uint64_t trim_tick;
+static uint64_t earlier_trim_tick;
+
+/* Factor and error bound in force just before the last trim, which hold for
+ * ticks counted before it */
+static int32_t pre_trim_factor;
+static uint32_t pre_trim_error_ppm;
+
+/* Frequency change of the last trim, and of all the trims before it, in ppm */
+static uint32_t trim_ppm;
+static uint32_t earlier_trim_ppm;
+
+/* An ILO measurement is running */
+static bool measuring;
+
+/* Time base value at which the next ILO measurement is due */
+static uint64_t next_measurement;
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_set_frequency
+********************************************************************************
+* Summary:
+*  Sets the LFCLK frequency that ticks are converted with, and the bound on
+*  its error.
+*
+*******************************************************************************/
+static void lfclk_source_set_frequency(uint32_t hz, uint32_t error_ppm)
+{
+    lfclk_stats.frequency = hz;
+    lfclk_stats.error_ppm = error_ppm;
+    tick_factor = (int32_t)((((uint64_t)CY_SYSCLK_WCO_FREQ << LFCLK_SOURCE_FRAC_BITS) +
+                             (hz / 2u)) / hz) - (int32_t)(1UL << LFCLK_SOURCE_FRAC_BITS);
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_clear_trims
+********************************************************************************
+* Summary:
+*  Forgets the trims made so far, so that all ticks are converted with the
+*  current factor.
+*
+*******************************************************************************/
+static void lfclk_source_clear_trims(void)
+{
+    trim_tick = 0u;
+    earlier_trim_tick = 0u;
+    trim_ppm = 0u;
+    earlier_trim_ppm = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_convert
+********************************************************************************
+* Summary:
+*  Converts LFCLK ticks to WCO ticks with a factor. Exact to the resolution of
+*  the factor for up to 2^48 ticks.
+*
+* Parameters:
+*  ticks: LFCLK ticks
+*  factor: WCO ticks per LFCLK tick - 1, in 2^-LFCLK_SOURCE_FRAC_BITS units
+*
+* Return:
+*  uint64_t: WCO ticks
+*
+*******************************************************************************/
+static uint64_t lfclk_source_convert(uint64_t ticks, int32_t factor)
+{
+    int64_t delta = ((int64_t)(ticks >> LFCLK_SOURCE_SPLIT_BITS) * factor) +
+                    (((int64_t)(ticks & ((1UL << LFCLK_SOURCE_SPLIT_BITS) - 1u)) * factor) >>
+                     LFCLK_SOURCE_SPLIT_BITS);
+
+    /* Round to nearest; the shift of a negative value is arithmetic */
+    delta = (delta + (1LL << (LFCLK_SOURCE_FRAC_BITS - LFCLK_SOURCE_SPLIT_BITS - 1u))) >>
+            (LFCLK_SOURCE_FRAC_BITS - LFCLK_SOURCE_SPLIT_BITS);
+
+    return (uint64_t)((int64_t)ticks + delta);
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_ppm_of
+********************************************************************************
+* Summary:
+*  Returns ppm parts per million of ticks, rounded up, without overflow.
+*
+*******************************************************************************/
+static uint64_t lfclk_source_ppm_of(uint64_t ticks, uint32_t ppm)
+{
+    return ((ticks / LFCLK_SOURCE_PPM) * ppm) +
+           ((((ticks % LFCLK_SOURCE_PPM) * ppm) + LFCLK_SOURCE_PPM - 1u) / LFCLK_SOURCE_PPM);
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_pre_trim
+********************************************************************************
+* Summary:
+*  Splits an interval at the last trim.
+*
+* Parameters:
+*  start: time base value at the start of the interval
+*  ticks: interval in LFCLK ticks
+*  earlier: receives the ticks counted before the trim ahead of the last one
+*
+* Return:
+*  uint64_t: ticks counted before the last trim, including *earlier
+*
+*******************************************************************************/
+static uint64_t lfclk_source_pre_trim(uint64_t start, uint64_t ticks, uint64_t *earlier)
+{
+    uint64_t end = start + ticks;
+
+    *earlier = 0u;
+    if (start >= trim_tick)
+    {
+        return 0u;
+    }
+    if (start < earlier_trim_tick)
+    {
+        *earlier = ((end < earlier_trim_tick) ? end : earlier_trim_tick) - start;
+    }
+    return ((end < trim_tick) ? end : trim_tick) - start;
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_measure
+********************************************************************************
+* Summary:
+*  Takes the result of an ILO measurement against the IMO. Trims the ILO if it
+*  is more than a trim step from CY_SYSCLK_WCO_FREQ; the frequency is then only
+*  known to within the step until it is measured again. The factor in force
+*  before a trim is kept for the ticks counted before it.
+*
+* Parameters:
+*  now: time base value at the trim
+*
+* Return:
+*  bool: true if the ILO frequency is known from this measurement, false if
+*  the measurement was lost or the ILO was trimmed
+*
+*******************************************************************************/
+static bool lfclk_source_measure(uint64_t now)
+{
+    uint32_t hz = Cy_SysClk_ClkMeasurementCountersGetFreq(false, CY_SYSCLK_IMO_FREQ);
+    uint32_t resolution_ppm;
+    int32_t change;
+
+    if (0u == hz)
+    {
+        lfclk_stats.failures++;
+        return false;
+    }
+    lfclk_stats.measurements++;
+
+    change = Cy_SysClk_IloTrim(hz);
+    if (0 != change)
+    {
+        lfclk_stats.trims++;
+        earlier_trim_tick = trim_tick;
+        earlier_trim_ppm += trim_ppm;
+        trim_tick = now;
+        trim_ppm = (uint32_t)((change < 0) ? -change : change) * LFCLK_SOURCE_ILO_TRIM_STEP_PPM;
+        pre_trim_factor = tick_factor;
+        pre_trim_error_ppm = lfclk_stats.error_ppm;
+        lfclk_source_set_frequency(CY_SYSCLK_WCO_FREQ, LFCLK_SOURCE_IMO_PPM +
+                                   LFCLK_SOURCE_ILO_TRIM_STEP_PPM + LFCLK_SOURCE_ILO_DRIFT_PPM);
+        return false;
+    }
+
+    /* The result is rounded to 1 Hz, and the IMO count to one cycle */
+    resolution_ppm = ((LFCLK_SOURCE_PPM + hz - 1u) / hz) +
+                     (uint32_t)((((uint64_t)hz * LFCLK_SOURCE_PPM) +
+                                 ((uint64_t)LFCLK_SOURCE_MEASURE_CYCLES * CY_SYSCLK_IMO_FREQ) - 1u) /
+                                ((uint64_t)LFCLK_SOURCE_MEASURE_CYCLES * CY_SYSCLK_IMO_FREQ));
+    lfclk_source_set_frequency(hz, LFCLK_SOURCE_IMO_PPM + resolution_ppm +
+                               LFCLK_SOURCE_ILO_DRIFT_PPM);
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_init
+********************************************************************************
+* Summary:
+*  Finds the LFCLK source. If the WCO is selected but has not started, which
+*  is the case on boards without the crystal, LFCLK is switched to the ILO.
+*  The ILO is then trimmed and measured against the IMO before returning,
+*  which takes about 100 ms. Call before the MCWDT is enabled.
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the failing cy_en_sysclk_status_t;
+*  CY_SYSCLK_UNSUPPORTED_STATE if LFCLK is neither the WCO nor the ILO
+*
+*******************************************************************************/
+cy_rslt_t lfclk_source_init(void)
+{
+    cy_en_sysclk_status_t status;
+    uint32_t i;
+
+    memset(&lfclk_stats, 0, sizeof(lfclk_stats));
+    measuring = false;
+    next_measurement = 0u;
+
+    lfclk_source_clear_trims();
+
+    lfclk_stats.source = Cy_SysClk_ClkLfGetSource();
+    if ((CY_SYSCLK_CLKLF_IN_WCO == lfclk_stats.source) && !Cy_SysClk_WcoOkay())
+    {
+        /* The WDT must be unlocked to change the LFCLK source */
+        Cy_SysClk_IloEnable();
+        Cy_WDT_Unlock();
+        Cy_SysClk_ClkLfSetSource(CY_SYSCLK_CLKLF_IN_ILO);
+        Cy_WDT_Lock();
+        lfclk_stats.source = CY_SYSCLK_CLKLF_IN_ILO;
+        lfclk_stats.fallback = true;
+    }
+
+    if (CY_SYSCLK_CLKLF_IN_WCO == lfclk_stats.source)
+    {
+        lfclk_source_set_frequency(CY_SYSCLK_WCO_FREQ, LFCLK_SOURCE_WCO_PPM);
+        return CY_RSLT_SUCCESS;
+    }
+    if (CY_SYSCLK_CLKLF_IN_ILO != lfclk_stats.source)
+    {
+        return (cy_rslt_t)CY_SYSCLK_UNSUPPORTED_STATE;
+    }
+
+    lfclk_source_set_frequency(CY_SYSCLK_ILO_FREQ, LFCLK_SOURCE_ILO_PPM);
+    for (i = 0u; i < LFCLK_SOURCE_INIT_MEASUREMENTS; i++)
+    {
+        status = Cy_SysClk_StartClkMeasurementCounters(CY_SYSCLK_MEAS_CLK_ILO,
+                                                       LFCLK_SOURCE_MEASURE_CYCLES,
+                                                       CY_SYSCLK_MEAS_CLK_IMO);
+        if (CY_SYSCLK_SUCCESS != status)
+        {
+            return (cy_rslt_t)status;
+        }
+        while (!Cy_SysClk_ClkMeasurementCountersDone())
+        {
+        }
+        if (lfclk_source_measure(0u))
+        {
+            break;
+        }
+    }
+
+    /* Intervals start after the time base, so after the trims made here */
+    lfclk_source_clear_trims();
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_service
+********************************************************************************
+* Summary:
+*  Measures the ILO against the IMO every LFCLK_SOURCE_MEASURE_PERIOD_S, and
+*  again at once after a trim. Call from the main loop, which is also where
+*  ticks are converted. The measurement runs in the background and is taken
+*  by a later call once it has ended. Does nothing with the WCO.
+*
+*******************************************************************************/
+void lfclk_source_service(void)
+{
+    uint64_t now;
+
+    if (CY_SYSCLK_CLKLF_IN_ILO != lfclk_stats.source)
+    {
+        return;
+    }
+
+    now = mcwdt_timebase_read64();
+    if (!measuring && (now >= next_measurement))
+    {
+        measuring = (CY_SYSCLK_SUCCESS ==
+                     Cy_SysClk_StartClkMeasurementCounters(CY_SYSCLK_MEAS_CLK_ILO,
+                                                           LFCLK_SOURCE_MEASURE_CYCLES,
+                                                           CY_SYSCLK_MEAS_CLK_IMO));
+        next_measurement = now + ((uint64_t)LFCLK_SOURCE_MEASURE_PERIOD_S * CY_SYSCLK_WCO_FREQ);
+    }
+
+    if (measuring && Cy_SysClk_ClkMeasurementCountersDone())
+    {
+        measuring = false;
+        if (!lfclk_source_measure(now))
+        {
+            /* Measure again at the next call */
+            next_measurement = now;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_busy
+********************************************************************************
+* Summary:
+*  Returns whether an ILO measurement is running. It is lost if the device
+*  enters Deep Sleep before it ends, so stay in Sleep, and wake to call
+*  lfclk_source_service() again, until this returns false.
+*
+* Return:
+*  bool: true while a measurement is running
+*
+*******************************************************************************/
+bool lfclk_source_busy(void)
+{
+    return measuring;
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_to_wco_ticks
+********************************************************************************
+* Summary:
+*  Converts a number of LFCLK ticks to the ticks of a CY_SYSCLK_WCO_FREQ Hz
+*  clock, with the last measured frequency. The ticks of an interval counted
+*  before the last trim are converted with the frequency measured before it.
+*  Returns the ticks unchanged when LFCLK is the WCO. Exact to the resolution
+*  of the factor for intervals of up to 2^48 ticks.
+*
+* Parameters:
+*  start: time base value at the start of the interval
+*  ticks: interval in LFCLK ticks
+*
+* Return:
+*  uint64_t: interval in WCO ticks
+*
+*******************************************************************************/
+uint64_t lfclk_source_to_wco_ticks(uint64_t start, uint64_t ticks)
+{
+    uint64_t earlier;
+    uint64_t pre = lfclk_source_pre_trim(start, ticks, &earlier);
+
+    return lfclk_source_convert(pre, pre_trim_factor) +
+           lfclk_source_convert(ticks - pre, tick_factor);
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_error_ticks
+********************************************************************************
+* Summary:
+*  Returns a bound on the error of an interval measured on LFCLK: the
+*  frequency error bound of the source over the interval, plus one tick for
+*  the count at each end falling anywhere within its tick. Ticks counted
+*  before the last trim take the bound measured before it, and those counted
+*  before an earlier trim also the frequency change of the trims since.
+*
+* Parameters:
+*  start: time base value at the start of the interval
+*  ticks: interval in LFCLK ticks
+*
+* Return:
+*  uint64_t: error bound in WCO ticks
+*
+*******************************************************************************/
+uint64_t lfclk_source_error_ticks(uint64_t start, uint64_t ticks)
+{
+    uint64_t earlier;
+    uint64_t pre = lfclk_source_pre_trim(start, ticks, &earlier);
+    uint64_t post = lfclk_source_convert(ticks - pre, tick_factor);
+
+    return lfclk_source_ppm_of(lfclk_source_convert(earlier, pre_trim_factor), earlier_trim_ppm) +
+           lfclk_source_ppm_of(lfclk_source_convert(pre, pre_trim_factor), pre_trim_error_ppm) +
+           lfclk_source_ppm_of(post, lfclk_stats.error_ppm) + 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: lfclk_source_get_stats
+********************************************************************************
+* Summary:
+*  Returns the LFCLK source, its frequency and error bound, and the counts of
+*  ILO measurements and trims.
+*
+* Parameters:
+*  stats: receives the statistics
+*
+*******************************************************************************/
+void lfclk_source_get_stats(lfclk_source_stats_t *stats)
+{
+    *stats = lfclk_stats;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name:   lfclk_source.h
+*
+* Description: Detects the LFCLK source, converts ticks of a trimmed ILO to WCO
+*              ticks, and bounds the error of measured intervals.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LFCLK_SOURCE_H
+#define LFCLK_SOURCE_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Fraction bits of the factor that converts ILO ticks to WCO ticks */
+#define LFCLK_SOURCE_FRAC_BITS              (24u)
+
+/* Frequency tolerance of the WCO crystal in ppm, including temperature and
+ * ageing over the operating range */
+#ifndef LFCLK_SOURCE_WCO_PPM
+#define LFCLK_SOURCE_WCO_PPM                (200u)
+#endif
+
+/* Frequency tolerance of the untrimmed ILO in ppm */
+#ifndef LFCLK_SOURCE_ILO_PPM
+#define LFCLK_SOURCE_ILO_PPM                (300000u)
+#endif
+
+/* Frequency tolerance of the IMO, which the ILO is measured against, in ppm.
+ * Lower it if the IMO is itself trimmed against a better clock. */
+#ifndef LFCLK_SOURCE_IMO_PPM
+#define LFCLK_SOURCE_IMO_PPM                (20000u)
+#endif
+
+/* Change of the ILO frequency allowed for between two measurements, in ppm */
+#ifndef LFCLK_SOURCE_ILO_DRIFT_PPM
+#define LFCLK_SOURCE_ILO_DRIFT_PPM          (2000u)
+#endif
+
+/* ILO cycles counted per measurement: 1024 cycles take about 31 ms and
+ * count about 250000 IMO cycles */
+#ifndef LFCLK_SOURCE_MEASURE_CYCLES
+#define LFCLK_SOURCE_MEASURE_CYCLES         (1024u)
+#endif
+
+/* Time between ILO measurements, in seconds of the time base */
+#ifndef LFCLK_SOURCE_MEASURE_PERIOD_S
+#define LFCLK_SOURCE_MEASURE_PERIOD_S       (10u)
+#endif
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    cy_en_clklf_in_sources_t source;    /* Active LFCLK source                */
+    uint32_t frequency;         /* LFCLK frequency in Hz, measured for the ILO */
+    uint32_t error_ppm;         /* Bound on the error of frequency            */
+    uint32_t measurements;      /* Completed ILO measurements                 */
+    uint32_t failures;          /* Measurements lost, e.g. to Deep Sleep      */
+    uint32_t trims;             /* ILO trim changes                           */
+    bool fallback;              /* Switched from a WCO that had not started   */
+} lfclk_source_stats_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t lfclk_source_init(void);
+void     lfclk_source_service(void);
+bool     lfclk_source_busy(void);
+uint64_t lfclk_source_to_wco_ticks(uint64_t start, uint64_t ticks);
+uint64_t lfclk_source_error_ticks(uint64_t start, uint64_t ticks);
+void     lfclk_source_get_stats(lfclk_source_stats_t *stats);
+
+
+#endif /* LFCLK_SOURCE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,451 @@
+/******************************************************************************
+* File Name:   log_sink.c
+*
+* Description: Non-blocking log output on the debug UART. Lines are formatted
+*              into one of two buffers while the other is sent in the background.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include "log_sink.h"
+#include "mcwdt_timebase.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static char log_buf[2][LOG_SINK_BUF_SIZE];
+
+/* Buffer being filled and the number of bytes committed to it. The other
+ * buffer is the one being sent while a transfer is active. */
+static volatile uint32_t fill_index;
+static volatile uint32_t fill_len;
+
+/* Incremented on every buffer swap */
+static volatile uint32_t swap_count;
+
+static volatile bool tx_active;
+
+static log_sink_stats_t log_stats;
+
+/* Received characters. The indices run freely; rx_head is written by the
+ * UART interrupt only and rx_tail by log_sink_getc() only. */
+static volatile uint8_t rx_buf[LOG_SINK_RX_BUF_SIZE];
+static volatile uint32_t rx_head;
+static volatile uint32_t rx_tail;
+
+/* Time base value when the last line end was received */
+static volatile uint64_t rx_line_time;
+
+
+/*******************************************************************************
+* Function Name: log_sink_start
+********************************************************************************
+* Summary:
+*  Starts sending the fill buffer if the UART is idle and there is something to
+*  send; the other buffer becomes the fill buffer. Called with interrupts
+*  disabled, or from the UART interrupt.
+*
+*******************************************************************************/
+static void log_sink_start(void)
+{
+    uint32_t send_index = fill_index;
+    uint32_t send_len = fill_len;
+
+    if (tx_active || (0u == send_len))
+    {
+        return;
+    }
+
+    if (CY_RSLT_SUCCESS == cyhal_uart_write_async(&cy_retarget_io_uart_obj,
+                                                  log_buf[send_index], send_len))
+    {
+        tx_active = true;
+        fill_index = send_index ^ 1u;
+        fill_len = 0u;
+        swap_count++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_commit
+********************************************************************************
+* Summary:
+*  Accounts for a line written beyond the committed bytes of the fill buffer
+*  and starts sending. Called with interrupts disabled.
+*
+* Parameters:
+*  len: length of the line
+*  fits: false if the line did not fit and is dropped
+*
+*******************************************************************************/
+static void log_sink_commit(uint32_t len, bool fits)
+{
+    if (!fits)
+    {
+        log_stats.dropped++;
+        return;
+    }
+
+    fill_len += len;
+    log_stats.lines++;
+    log_stats.bytes += len;
+    if (fill_len > log_stats.high_water)
+    {
+        log_stats.high_water = fill_len;
+    }
+    log_sink_start();
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_receive
+********************************************************************************
+* Summary:
+*  Moves received characters from the UART FIFO to the receive buffer. The
+*  FIFO is always emptied so that the interrupt deasserts; characters that do
+*  not fit are discarded. Line ends are timestamped on arrival.
+*
+*******************************************************************************/
+static void log_sink_receive(void)
+{
+    uint8_t c;
+
+    while ((cyhal_uart_readable(&cy_retarget_io_uart_obj) > 0u) &&
+           (CY_RSLT_SUCCESS == cyhal_uart_getc(&cy_retarget_io_uart_obj, &c, 0u)))
+    {
+        if ('\n' == c)
+        {
+            rx_line_time = mcwdt_timebase_read64();
+        }
+        if ((rx_head - rx_tail) < LOG_SINK_RX_BUF_SIZE)
+        {
+            rx_buf[rx_head & (LOG_SINK_RX_BUF_SIZE - 1u)] = c;
+            __DMB();
+            rx_head++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_uart_callback
+********************************************************************************
+* Summary:
+*  UART event handler. When a buffer has been sent, sends whatever was queued
+*  in the meantime, and keeps received characters.
+*
+* Parameters:
+*  callback_arg: unused
+*  event: UART events that occurred
+*
+*******************************************************************************/
+static void log_sink_uart_callback(void *callback_arg, cyhal_uart_event_t event)
+{
+    (void)callback_arg;
+
+    if (0u != ((uint32_t)event & (uint32_t)CYHAL_UART_IRQ_TX_DONE))
+    {
+        tx_active = false;
+        log_sink_start();
+    }
+
+    if (0u != ((uint32_t)event & (uint32_t)CYHAL_UART_IRQ_RX_NOT_EMPTY))
+    {
+        log_sink_receive();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_init
+********************************************************************************
+* Summary:
+*  Switches the debug UART to asynchronous transmission, using DMA where the
+*  HAL can allocate a channel and the UART FIFO interrupt otherwise, and
+*  buffers received characters for log_sink_getc(). Call after
+*  cy_retarget_io_init(); from then on output must go through
+*  log_sink_printf() rather than printf().
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the HAL error
+*
+*******************************************************************************/
+cy_rslt_t log_sink_init(void)
+{
+    cy_rslt_t result;
+
+    fill_index = 0u;
+    fill_len = 0u;
+    tx_active = false;
+    rx_head = 0u;
+    rx_tail = 0u;
+    rx_line_time = 0u;
+
+    result = cyhal_uart_set_async_mode(&cy_retarget_io_uart_obj, CYHAL_ASYNC_DMA,
+                                       CYHAL_DMA_PRIORITY_DEFAULT);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        result = cyhal_uart_set_async_mode(&cy_retarget_io_uart_obj, CYHAL_ASYNC_SW,
+                                           CYHAL_DMA_PRIORITY_DEFAULT);
+    }
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    cyhal_uart_register_callback(&cy_retarget_io_uart_obj, log_sink_uart_callback, NULL);
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_TX_DONE,
+                            LOG_SINK_INTR_PRIORITY, true);
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY,
+                            LOG_SINK_INTR_PRIORITY, true);
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_printf
+********************************************************************************
+* Summary:
+*  Formats a line into the fill buffer and starts sending it if the UART is
+*  idle. Never waits for the UART. The line is formatted with interrupts
+*  enabled, beyond the bytes already committed, and only committed with
+*  interrupts disabled; if the buffers were swapped in between, it is
+*  formatted again into the new fill buffer.
+*
+* Parameters:
+*  format: printf() format string
+*
+* Return:
+*  bool: true if the line was queued, false if it was dropped
+*
+*******************************************************************************/
+bool log_sink_printf(const char *format, ...)
+{
+    bool queued = false;
+    bool retry = true;
+    uint32_t intr_status;
+    uint32_t swaps;
+    uint32_t index;
+    uint32_t offset;
+    va_list args;
+    int len;
+
+    while (retry)
+    {
+        swaps = swap_count;
+        index = fill_index;
+        offset = fill_len;
+
+        va_start(args, format);
+        len = vsnprintf(&log_buf[index][offset], LOG_SINK_BUF_SIZE - offset, format, args);
+        va_end(args);
+
+        intr_status = Cy_SysLib_EnterCriticalSection();
+
+        retry = (swaps != swap_count);
+        if (!retry)
+        {
+            queued = ((len >= 0) && ((uint32_t)len < (LOG_SINK_BUF_SIZE - offset)));
+            log_sink_commit(queued ? (uint32_t)len : 0u, queued);
+        }
+
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+
+    return queued;
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_write
+********************************************************************************
+* Summary:
+*  Queues raw bytes, such as a binary telemetry frame, as one line. The bytes
+*  are copied with interrupts disabled, so keep the record short.
+*
+* Parameters:
+*  data: bytes to send
+*  len: number of bytes
+*
+* Return:
+*  bool: true if the bytes were queued, false if they were dropped
+*
+*******************************************************************************/
+bool log_sink_write(void const *data, size_t len)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    bool queued = (len <= (LOG_SINK_BUF_SIZE - fill_len));
+
+    if (queued)
+    {
+        memcpy(&log_buf[fill_index][fill_len], data, len);
+    }
+    log_sink_commit((uint32_t)len, queued);
+
+    Cy_SysLib_ExitCriticalSection(intr_status);
+
+    return queued;
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_getc
+********************************************************************************
+* Summary:
+*  Takes the oldest received character, if any. Never waits. The UART does not
+*  receive in Deep Sleep.
+*
+* Parameters:
+*  c: receives the character
+*
+* Return:
+*  bool: true if a character was returned
+*
+*******************************************************************************/
+bool log_sink_getc(char *c)
+{
+    uint32_t tail = rx_tail;
+
+    if (rx_head == tail)
+    {
+        return false;
+    }
+
+    __DMB();
+    *c = (char)rx_buf[tail & (LOG_SINK_RX_BUF_SIZE - 1u)];
+    rx_tail = tail + 1u;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_rx_line_time
+********************************************************************************
+* Summary:
+*  Returns the time base value latched by the receive interrupt when the last
+*  line end ('\n') arrived, so that the time of a line does not depend on
+*  when the main loop reads it.
+*
+* Return:
+*  uint64_t: time base value, or 0 if no line end has been received
+*
+*******************************************************************************/
+uint64_t log_sink_rx_line_time(void)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    uint64_t timestamp = rx_line_time;
+
+    Cy_SysLib_ExitCriticalSection(intr_status);
+
+    return timestamp;
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_busy
+********************************************************************************
+* Summary:
+*  Reports whether output is still being sent. The UART does not run in Deep
+*  Sleep, so the CPU should only enter Sleep while this is true.
+*
+* Return:
+*  bool: true while a transfer is active or a line is waiting
+*
+*******************************************************************************/
+bool log_sink_busy(void)
+{
+    return (tx_active || (0u != fill_len));
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_flush
+********************************************************************************
+* Summary:
+*  Sleeps until everything queued has been sent. For output longer than a log
+*  buffer, such as a table printed at start-up. Interrupts are disabled around
+*  the check so that the end of the transfer still wakes the CPU.
+*
+*******************************************************************************/
+void log_sink_flush(void)
+{
+    uint32_t intr_status;
+    bool busy = true;
+
+    while (busy)
+    {
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        busy = log_sink_busy();
+        if (busy)
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: log_sink_get_stats
+********************************************************************************
+* Summary:
+*  Returns the number of lines queued and dropped, and the most bytes that have
+*  waited in a buffer.
+*
+* Parameters:
+*  stats: receives the statistics
+*
+*******************************************************************************/
+void log_sink_get_stats(log_sink_stats_t *stats)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+
+    *stats = log_stats;
+
+    Cy_SysLib_ExitCriticalSection(intr_status);
+}
+
+
+/* [] END OF FILE */
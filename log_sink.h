@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name:   log_sink.h
+*
+* Description: Non-blocking log output on the debug UART. Lines are formatted
+*              into one of two buffers while the other is sent in the background.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Size of each of the two log buffers. A line that does not fit in the
+ * buffer being filled is dropped. */
+#ifndef LOG_SINK_BUF_SIZE
+#define LOG_SINK_BUF_SIZE                   (512u)
+#endif
+
+/* Characters received and not yet read by log_sink_getc(), enough for a
+ * reference time line of wco_calibration.c. Must be a power of two. */
+#ifndef LOG_SINK_RX_BUF_SIZE
+#define LOG_SINK_RX_BUF_SIZE                (32u)
+#endif
+
+#if ((LOG_SINK_RX_BUF_SIZE == 0u) || ((LOG_SINK_RX_BUF_SIZE & (LOG_SINK_RX_BUF_SIZE - 1u)) != 0u))
+#error "LOG_SINK_RX_BUF_SIZE must be a power of two"
+#endif
+
+/* Priority of the UART transmit-done and receive interrupts, below the timestamping
+ * interrupts */
+#define LOG_SINK_INTR_PRIORITY              (7u)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t lines;         /* Lines queued                                 */
+    uint32_t dropped;       /* Lines dropped because the buffer was full    */
+    uint32_t bytes;         /* Bytes queued                                 */
+    uint32_t high_water;    /* Most bytes ever waiting in the fill buffer   */
+} log_sink_stats_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t log_sink_init(void);
+bool      log_sink_printf(const char *format, ...) __attribute__((format(__printf__, 1, 2)));
+bool      log_sink_write(void const *data, size_t len);
+bool      log_sink_getc(char *c);
+uint64_t  log_sink_rx_line_time(void);
+bool      log_sink_busy(void);
+void      log_sink_flush(void);
+void      log_sink_get_stats(log_sink_stats_t *stats);
+
+
+#endif /* LOG_SINK_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,286 @@
+/******************************************************************************
+* File Name:   low_power.c
+*
+* Description: Sleep or Deep Sleep between events. The CM4 wakes on the user button
+*              GPIO interrupt or, while a debounce window or a button event deadline
+*              is pending, on a periodic MCWDT_0 Counter 2 interrupt. MCWDT_0 keeps
+*              counting in Deep Sleep.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "low_power.h"
+#include "mcwdt_timebase.h"
+#include "mcwdt_irq.h"
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void low_power_set_wake_tick(bool wake_tick);
+static cy_en_syspm_status_t low_power_syspm_callback(cy_stc_syspm_callback_params_t *callback_params,
+                                                     cy_en_syspm_callback_mode_t mode);
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static low_power_stats_t power_stats;
+
+/* Time base value when the CPU last woke up and when it last went to sleep */
+static uint32_t wake_count;
+static uint32_t sleep_count;
+
+static cy_stc_syspm_callback_params_t syspm_callback_params =
+{
+    .base = NULL,
+    .context = NULL
+};
+
+static cy_stc_syspm_callback_t syspm_callback =
+{
+    .callback = low_power_syspm_callback,
+    .type = CY_SYSPM_DEEPSLEEP,
+    .skipMode = 0u,
+    .callbackParams = &syspm_callback_params,
+    .prevItm = NULL,
+    .nextItm = NULL,
+    .order = 0u
+};
+
+
+/*******************************************************************************
+* Function Name: low_power_wake_isr
+********************************************************************************
+* Summary:
+*  MCWDT_0 Counter 2 handler. The interrupt only wakes the CPU; the main loop
+*  does the work.
+*
+*******************************************************************************/
+static void low_power_wake_isr(void)
+{
+}
+
+
+/*******************************************************************************
+* Function Name: low_power_set_wake_tick
+********************************************************************************
+* Summary:
+*  Unmasks or masks the Counter 2 interrupt, so that the next sleep ends at
+*  the next Counter 2 toggle or not.
+*
+* Parameters:
+*  wake_tick: true to wake on the next Counter 2 toggle
+*
+*******************************************************************************/
+static void low_power_set_wake_tick(bool wake_tick)
+{
+    if (wake_tick)
+    {
+        mcwdt_irq_enable(CY_MCWDT_CTR2);
+    }
+    else
+    {
+        mcwdt_irq_disable(CY_MCWDT_CTR2);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: low_power_syspm_callback
+********************************************************************************
+* Summary:
+*  Deep Sleep callback. Refuses Deep Sleep if the time base is not running,
+*  since timestamps taken after wakeup would then not follow on from those
+*  taken before. Around the transition it splits time into awake and asleep
+*  using the time base itself, and checks that the time base moved forward
+*  while the CPU was asleep.
+*
+* Parameters:
+*  callback_params: unused
+*  mode: SysPm callback mode
+*
+* Return:
+*  cy_en_syspm_status_t: CY_SYSPM_SUCCESS, or CY_SYSPM_FAIL to stay awake
+*
+*******************************************************************************/
+static cy_en_syspm_status_t low_power_syspm_callback(cy_stc_syspm_callback_params_t *callback_params,
+                                                     cy_en_syspm_callback_mode_t mode)
+{
+    cy_en_syspm_status_t status = CY_SYSPM_SUCCESS;
+    uint32_t now;
+
+    (void)callback_params;
+
+    switch (mode)
+    {
+        case CY_SYSPM_CHECK_READY:
+            if ((0u == Cy_MCWDT_GetEnabledStatus(MCWDT_0_HW, CY_MCWDT_COUNTER0)) ||
+                (0u == Cy_MCWDT_GetEnabledStatus(MCWDT_0_HW, CY_MCWDT_COUNTER1)))
+            {
+                status = CY_SYSPM_FAIL;
+            }
+            break;
+
+        case CY_SYSPM_BEFORE_TRANSITION:
+            sleep_count = mcwdt_timebase_read32(MCWDT_0_HW);
+            power_stats.active_ticks += sleep_count - wake_count;
+            break;
+
+        case CY_SYSPM_AFTER_TRANSITION:
+            now = mcwdt_timebase_read32(MCWDT_0_HW);
+
+            /* A disabled counter, or one that was restarted, shows up as
+             * a jump back of up to half the counter range */
+            if (((now - sleep_count) >= 0x80000000u) ||
+                (0u == Cy_MCWDT_GetEnabledStatus(MCWDT_0_HW, CY_MCWDT_COUNTER1)))
+            {
+                power_stats.continuity_errors++;
+            }
+            power_stats.sleep_ticks += now - sleep_count;
+            power_stats.wakeups++;
+            wake_count = now;
+            break;
+
+        default:
+            break;
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: low_power_init
+********************************************************************************
+* Summary:
+*  Starts MCWDT_0 Counter 2 as the wake tick, with its interrupt masked until a
+*  debounce window needs it, and registers the Deep Sleep callback. Counter 0
+*  and Counter 1 must already be running.
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the failing cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t low_power_init(void)
+{
+    cy_rslt_t result;
+
+    result = mcwdt_irq_register(CY_MCWDT_CTR2, low_power_wake_isr);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    Cy_MCWDT_SetToggleBit(MCWDT_0_HW, LOW_POWER_WAKE_TOGGLE_BIT);
+    Cy_MCWDT_SetMode(MCWDT_0_HW, CY_MCWDT_COUNTER2, CY_MCWDT_MODE_INT);
+    Cy_MCWDT_Enable(MCWDT_0_HW, CY_MCWDT_CTR2, LOW_POWER_MCWDT_ENABLE_DELAY);
+    mcwdt_irq_disable(CY_MCWDT_CTR2);
+
+    wake_count = mcwdt_timebase_read32(MCWDT_0_HW);
+
+    if (!Cy_SysPm_RegisterCallback(&syspm_callback))
+    {
+        return (cy_rslt_t)CY_SYSPM_FAIL;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: low_power_deep_sleep
+********************************************************************************
+* Summary:
+*  Enters Deep Sleep. Call with interrupts disabled: an interrupt that became
+*  pending after the caller decided to sleep still wakes the CPU at once.
+*
+* Parameters:
+*  wake_tick: true to also wake on every Counter 2 toggle, for example while
+*             a debounce window is open
+*
+*******************************************************************************/
+void low_power_deep_sleep(bool wake_tick)
+{
+    low_power_set_wake_tick(wake_tick);
+    (void)Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+}
+
+
+/*******************************************************************************
+* Function Name: low_power_sleep
+********************************************************************************
+* Summary:
+*  Enters CPU Sleep, with the same wake tick and the same calling convention
+*  as low_power_deep_sleep(). Used when Deep Sleep is not enabled, so that
+*  the main loop does not run flat out while it waits for a point in time.
+*
+* Parameters:
+*  wake_tick: true to also wake on every Counter 2 toggle, for example while
+*             a debounce window is open
+*
+*******************************************************************************/
+void low_power_sleep(bool wake_tick)
+{
+    low_power_set_wake_tick(wake_tick);
+    __WFI();
+}
+
+
+/*******************************************************************************
+* Function Name: low_power_get_stats
+********************************************************************************
+* Summary:
+*  Returns the time spent awake and in Deep Sleep since low_power_init(). The
+*  awake time includes the current wake period.
+*
+* Parameters:
+*  stats: receives the statistics
+*
+*******************************************************************************/
+void low_power_get_stats(low_power_stats_t *stats)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+
+    *stats = power_stats;
+    stats->active_ticks += mcwdt_timebase_read32(MCWDT_0_HW) - wake_count;
+
+    Cy_SysLib_ExitCriticalSection(intr_status);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,90 @@
+/******************************************************************************
+* File Name:   low_power.h
+*
+* Description: Deep Sleep between events. The CM4 wakes on the user button GPIO
+*              interrupt or, while a debounce window is open, on a periodic MCWDT_0
+*              Counter 2 interrupt. MCWDT_0 keeps counting in Deep Sleep.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LOW_POWER_H
+#define LOW_POWER_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Counter 2 bit whose toggle wakes the CPU while a debounce window is open
+ * or a button event deadline is pending. Bit 9 toggles every 512 LFCLK
+ * cycles (15.6 ms at 32768 Hz). */
+#define LOW_POWER_WAKE_TOGGLE_BIT           (9u)
+
+/* The function Cy_MCWDT_Enable() waits for some delay in microseconds before
+ * returning */
+#define LOW_POWER_MCWDT_ENABLE_DELAY        (93u)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/* Time spent awake and in Deep Sleep, in LFCLK cycles */
+typedef struct
+{
+    uint32_t active_ticks;
+    uint32_t sleep_ticks;
+    uint32_t wakeups;
+    uint32_t continuity_errors; /* Time base found stopped or moving back */
+} low_power_stats_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t low_power_init(void);
+void      low_power_deep_sleep(bool wake_tick);
+void      low_power_sleep(bool wake_tick);
+void      low_power_get_stats(low_power_stats_t *stats);
+
+
+#endif /* LOW_POWER_H */
+
+
+/* [] END OF FILE */
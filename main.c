@@ -44,18 +44,127 @@
 #include "cyhal.h"
 #include "cybsp.h"
 #include "cy_retarget_io.h"
+#include "mcwdt_timebase.h"
+#include "timing_engine.h"
+#include "button_capture.h"
+#include "switch_debounce.h"
+#include "timer_debounce.h"
+#include "low_power.h"
+#include "interval_format.h"
+#include "log_sink.h"
+#include "telemetry.h"
+#include "interval_stats.h"
+#include "watchdog_supervisor.h"
+#include "wco_calibration.h"
+#include "lfclk_source.h"
+#include "latency_bench.h"
 
 
 /*******************************************************************************
 * Macros
 ********************************************************************************/
 
-/* Switch press/release check interval in milliseconds for debouncing */
-#define SWITCH_DEBOUNCE_CHECK_UNIT          (1u)
+/* Set to 1 to timestamp the user button from its GPIO interrupt and debounce
+ * in the background, or 0 to use the blocking read_switch_status() */
+#ifndef ENABLE_BUTTON_INTERRUPT_CAPTURE
+#define ENABLE_BUTTON_INTERRUPT_CAPTURE     (1u)
+#endif
+
+/* Set to 1 to enter Deep Sleep between events instead of CPU Sleep. Needs
+ * ENABLE_BUTTON_INTERRUPT_CAPTURE. */
+#ifndef ENABLE_DEEP_SLEEP_MODE
+#define ENABLE_DEEP_SLEEP_MODE              (0u)
+#endif
+
+#if (ENABLE_DEEP_SLEEP_MODE) && !(ENABLE_BUTTON_INTERRUPT_CAPTURE)
+#error "ENABLE_DEEP_SLEEP_MODE requires ENABLE_BUTTON_INTERRUPT_CAPTURE"
+#endif
+
+/* Without ENABLE_BUTTON_INTERRUPT_CAPTURE: set to 1 to sample the user button
+ * on MCWDT_0 Counter 2 interrupts and sleep between samples, or 0 to use the
+ * blocking read_switch_status() */
+#ifndef ENABLE_TIMER_DEBOUNCE
+#define ENABLE_TIMER_DEBOUNCE               (1u)
+#endif
+
+/* Button path taken by the main loop */
+#define USE_TIMER_DEBOUNCE                  (!(ENABLE_BUTTON_INTERRUPT_CAPTURE) && \
+                                             (ENABLE_TIMER_DEBOUNCE))
+
+/* Set to 1 to send UART output in the background through log_sink.c, or 0
+ * to use printf(), which waits for the UART */
+#ifndef ENABLE_ASYNC_LOG
+#define ENABLE_ASYNC_LOG                    (1u)
+#endif
+
+/* Set to 1 to send each event as a compact binary frame from telemetry.c
+ * instead of a text line. Decode the capture with host/telemetry_decode.
+ * Needs ENABLE_ASYNC_LOG. */
+#ifndef ENABLE_BINARY_TELEMETRY
+#define ENABLE_BINARY_TELEMETRY             (0u)
+#endif
+
+#if (ENABLE_BINARY_TELEMETRY) && !(ENABLE_ASYNC_LOG)
+#error "ENABLE_BINARY_TELEMETRY requires ENABLE_ASYNC_LOG"
+#endif
+
+/* Clicks, long presses and hold repeats (BUTTON_CAPTURE_EVENTS in
+ * button_capture.h) are printed as text lines */
+#if (BUTTON_CAPTURE_EVENTS) && (!(ENABLE_BUTTON_INTERRUPT_CAPTURE) || (ENABLE_BINARY_TELEMETRY))
+#error "BUTTON_CAPTURE_EVENTS requires ENABLE_BUTTON_INTERRUPT_CAPTURE and no ENABLE_BINARY_TELEMETRY"
+#endif
+
+/* Set to 1 to supervise the main loop with the windowed watchdog of
+ * watchdog_supervisor.c on MCWDT_1. Needs a button path that does not block
+ * the main loop while the button is held. */
+#ifndef ENABLE_WATCHDOG_SUPERVISOR
+#define ENABLE_WATCHDOG_SUPERVISOR          (0u)
+#endif
+
+#if (ENABLE_WATCHDOG_SUPERVISOR) && !(ENABLE_BUTTON_INTERRUPT_CAPTURE) && !(USE_TIMER_DEBOUNCE)
+#error "ENABLE_WATCHDOG_SUPERVISOR requires ENABLE_BUTTON_INTERRUPT_CAPTURE or ENABLE_TIMER_DEBOUNCE"
+#endif
+
+/* Set to 1 to correct reported intervals for the WCO frequency error measured
+ * by wco_calibration.c against "T<microseconds>" reference time lines sent by
+ * the host. Takes effect only with ENABLE_ASYNC_LOG, which receives them. */
+#ifndef ENABLE_WCO_CALIBRATION
+#define ENABLE_WCO_CALIBRATION              (1u)
+#endif
+
+#define USE_WCO_CALIBRATION                 ((ENABLE_ASYNC_LOG) && (ENABLE_WCO_CALIBRATION))
+
+/* Set to 1 to find the LFCLK source at start-up with lfclk_source.c. Without
+ * a WCO, LFCLK runs from the ILO, which is trimmed and measured against the
+ * IMO; intervals are converted with the measured frequency, and reported
+ * with an error bound. Set to 0 to assume the WCO. */
+#ifndef ENABLE_LFCLK_SOURCE_DETECTION
+#define ENABLE_LFCLK_SOURCE_DETECTION       (1u)
+#endif
+
+/* Set to 1 to measure at start-up, with the DWT cycle counter, what each step
+ * from a button interrupt to a reported interval costs, and print the cycle
+ * counts after the banner */
+#ifndef ENABLE_LATENCY_BENCHMARK
+#define ENABLE_LATENCY_BENCHMARK            (0u)
+#endif
 
-/* Number of debounce check units to count before considering that switch is pressed
- * or released */
-#define SWITCH_DEBOUNCE_MAX_PERIOD_UNITS    (80u)
+#if (ENABLE_LATENCY_BENCHMARK) && (ENABLE_BINARY_TELEMETRY)
+#error "ENABLE_LATENCY_BENCHMARK prints text and cannot be used with ENABLE_BINARY_TELEMETRY"
+#endif
+
+#if (ENABLE_ASYNC_LOG)
+#define LOG_PRINTF                          log_sink_printf
+#else
+#define LOG_PRINTF                          printf
+#endif
+
+/* Characters that query and clear the interval statistics over the UART */
+#define STATS_QUERY_CHAR                    ('s')
+#define STATS_CLEAR_CHAR                    ('c')
+
+/* Scale for printing the CPU active time in hundredths of a percent */
+#define DUTY_CYCLE_SCALE                    (10000u)
 
 /* The function Cy_MCWDT_Enable() waits for some delay in microseconds before 
  * returning */
@@ -69,7 +178,9 @@
 * Function Prototypes
 ********************************************************************************/
 void handle_error(void);
-static uint32_t read_switch_status(void);
+void print_interval_stats(interval_stats_t const *stats);
+void print_lfclk_source(lfclk_source_stats_t const *stats);
+void print_latency_bench(latency_bench_report_t const *report);
 
 
 /*******************************************************************************
@@ -102,11 +213,55 @@ int main(void)
 #endif
 
     /* Switch press event count value */
-    uint32_t event1_cnt, event2_cnt;
-    uint32_t counter1_value, counter0_value;
+    timing_interval_t intervals;
+    uint64_t press_cnt;
+    uint64_t interval;
+    bool first_press;
+
+    /* Distribution of the times between presses */
+    interval_stats_t interval_stats;
+#if (ENABLE_ASYNC_LOG)
+    char command;
+#endif
+#if (USE_WCO_CALIBRATION)
+    wco_calibration_stats_t cal_stats;
+#endif
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+    lfclk_source_stats_t lfclk_stats;
+    uint64_t interval_start;
+#endif
+#if (ENABLE_LATENCY_BENCHMARK)
+    latency_bench_report_t latency_report;
+#endif
+#if (ENABLE_BUTTON_INTERRUPT_CAPTURE) || (USE_TIMER_DEBOUNCE)
+    uint32_t intr_status;
+#endif
+#if (ENABLE_WATCHDOG_SUPERVISOR)
+    watchdog_supervisor_fault_t watchdog_fault;
+    bool watchdog_reset;
+#endif
 
+#if (ENABLE_BINARY_TELEMETRY)
+    telemetry_encoder_t telemetry;
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+#else
     /* The time between two presses of switch */
-    volatile uint32_t timegap;
+    char timegap[INTERVAL_FORMAT_BUF_SIZE];
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+    char error_bound[INTERVAL_FORMAT_BUF_SIZE];
+#endif
+#if (ENABLE_BUTTON_INTERRUPT_CAPTURE)
+    timestamp_ring_stats_t ring_stats;
+    uint32_t edges_lost = 0u;
+#endif
+#if (BUTTON_CAPTURE_EVENTS)
+    button_event_t button_event;
+#endif
+#if (ENABLE_DEEP_SLEEP_MODE)
+    low_power_stats_t power_stats;
+    uint32_t duty;
+#endif
+#endif
 
     /* Initialize the device and board peripherals */
     result = cybsp_init() ;
@@ -130,6 +285,27 @@ int main(void)
         handle_error();
     }
 
+#if (ENABLE_ASYNC_LOG)
+    /* Send UART output in the background from now on */
+    result = log_sink_init();
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        handle_error();
+    }
+#endif
+
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+    /* Find the LFCLK source that the MCWDT will count, and trim and measure
+     * the ILO if there is no WCO */
+    result = lfclk_source_init();
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        handle_error();
+    }
+#endif
+
     /* Initialize the MCWDT_0 */
     mcwdt_init_status = Cy_MCWDT_Init(MCWDT_0_HW, &MCWDT_0_config);
     
@@ -138,122 +314,385 @@ int main(void)
         handle_error();
     }
 
+    /* Extend the Counter1:Counter0 cascade to 64 bits using the Counter1
+     * match interrupt, so that the time base does not overflow
+     */
+    result = mcwdt_timebase_init();
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        handle_error();
+    }
+
     /* Enable the MCWDT_0 counters */
     Cy_MCWDT_Enable(MCWDT_0_HW, CY_MCWDT_CTR0|CY_MCWDT_CTR1,
                     MCWDT_0_ENABLE_DELAY);
 
-    /* Initialize event count value */
-    event1_cnt = 0;
-    event2_cnt = 0;
+#if (ENABLE_LATENCY_BENCHMARK)
+    /* Measure before the button interrupt is taken over by button capture */
+    result = latency_bench_run(&latency_report, (0u != ENABLE_ASYNC_LOG));
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        handle_error();
+    }
+#endif
+
+#if (ENABLE_BUTTON_INTERRUPT_CAPTURE)
+    /* Timestamp the user button from its GPIO interrupt */
+    result = button_capture_init();
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        handle_error();
+    }
+#endif
+
+#if (USE_TIMER_DEBOUNCE)
+    /* Sample the user button on MCWDT_0 Counter 2 interrupts */
+    result = timer_debounce_init();
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        handle_error();
+    }
+#endif
+
+#if (ENABLE_WATCHDOG_SUPERVISOR)
+    /* Take the record of a reset caused by the supervisor, then supervise
+     * the main loop from now on */
+    watchdog_reset = watchdog_supervisor_get_fault(&watchdog_fault);
+    result = watchdog_supervisor_init(NULL);
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        handle_error();
+    }
+#endif
+
+#if (ENABLE_BUTTON_INTERRUPT_CAPTURE)
+    /* Wake from Sleep or Deep Sleep on MCWDT_0 Counter 2 while debouncing */
+    result = low_power_init();
 
+    if (result != CY_RSLT_SUCCESS)
+    {
+        handle_error();
+    }
+#endif
+
+    /* Time the first press from the time base start at zero */
+    timing_interval_init(&intervals, 0u);
+    interval_stats_init(&interval_stats);
+#if (USE_WCO_CALIBRATION)
+    wco_calibration_init();
+#endif
+
+#if (ENABLE_BINARY_TELEMETRY)
+    /* Start the stream with the time base value at start-up */
+    telemetry_encoder_init(&telemetry);
+#if (ENABLE_WATCHDOG_SUPERVISOR)
+    (void)watchdog_reset;
+#endif
+    (void)log_sink_write(frame, telemetry_encode(&telemetry, frame, TELEMETRY_EVENT_BOOT,
+                                                 mcwdt_timebase_read64()));
+#else
     /* Print a message on UART */
     /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
-    printf("\x1b[2J\x1b[;H");
+    LOG_PRINTF("\x1b[2J\x1b[;H");
 
-    printf("*************** "
-            "PSoC 6 MCU: Multi-Counter Watchdog Timer Example "
-            "*************** \r\n\n");
+    LOG_PRINTF("*************** "
+                "PSoC 6 MCU: Multi-Counter Watchdog Timer Example "
+                "*************** \r\n\n");
+
+    LOG_PRINTF("\r\nMCWDT initialization is complete. Press the user button to "
+               "display the time between two presses of the user button. \r\n");
+
+#if (ENABLE_WATCHDOG_SUPERVISOR)
+    if (watchdog_reset)
+    {
+        (void)interval_format64(timegap, 0u, watchdog_fault.timestamp);
+        LOG_PRINTF("\r\nReset by the watchdog supervisor: %s at %ss, PC 0x%08x LR 0x%08x\r\n",
+                   (WATCHDOG_SUPERVISOR_FAULT_EARLY_FEED == watchdog_fault.cause) ?
+                   "fed before the window" : "not fed",
+                   timegap, (unsigned int)watchdog_fault.pc, (unsigned int)watchdog_fault.lr);
+    }
+#endif
+
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+    lfclk_source_get_stats(&lfclk_stats);
+    print_lfclk_source(&lfclk_stats);
+#endif
+
+#if (ENABLE_LATENCY_BENCHMARK)
+    print_latency_bench(&latency_report);
+#endif
+#endif
 
-    printf("\r\nMCWDT initialization is complete. Press the user button to "
-           "display the time between two presses of the user button. \r\n");
-    
 
     for(;;)
     {
+#if (ENABLE_WATCHDOG_SUPERVISOR)
+        /* Feed the watchdog once its window has opened */
+        watchdog_supervisor_service();
+#endif
+
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+        /* Keep measuring the ILO. A measurement that has not ended is taken
+         * by a later pass, after the main loop has slept. */
+        lfclk_source_service();
+#endif
+
+#if (ENABLE_BUTTON_INTERRUPT_CAPTURE)
+        /* Report every debounced press that has been captured. The counter
+         * value was latched by the button interrupt on the press edge and
+         * queued, so this returns immediately whether or not the switch is
+         * pressed, and presses made while the UART was busy are not lost.
+         */
+        while (button_capture_get_press(&press_cnt))
+#elif (USE_TIMER_DEBOUNCE)
+        /* Report every press debounced by the Counter 2 interrupt, with the
+         * counter value latched on its first pressed sample */
+        while (timer_debounce_get_press(&press_cnt))
+#else
         /* Check if the switch is pressed.
          * Note that if the switch is pressed, the CPU will not return from
          * read_switch_status() function until the switch is released.
          */
         if (0UL != read_switch_status())
+#endif
         {
-            /* Consider previous key press as 1st key press event */
-            event1_cnt = event2_cnt;
-
-            /* Consider current key press as 2nd key press event and get live
-             * counter value from MCWDT_0.
-             * Note that MCWDT_0 Counter1 is cascaded from MCWDT_0 Counter0 
+#if !(ENABLE_BUTTON_INTERRUPT_CAPTURE) && !(USE_TIMER_DEBOUNCE)
+            /* Get live counter value from MCWDT_0.
+             * Note that MCWDT_0 Counter1 is cascaded from MCWDT_0 Counter0.
+             * The two halves are read so that a Counter0 wrap between them
+             * cannot produce a value that is off by 65536 counts, and the
+             * count of Counter1 wraps extends the value to 64 bits.
              */
-            counter0_value = Cy_MCWDT_GetCount(MCWDT_0_HW, CY_MCWDT_COUNTER0);
-            counter1_value = Cy_MCWDT_GetCount(MCWDT_0_HW, CY_MCWDT_COUNTER1);
-            event2_cnt = ((counter1_value<<16) | (counter0_value<<0));
+            press_cnt = mcwdt_timebase_read64();
+#endif
+            /* Ticks since the previous press. The first press has no
+             * previous press to be timed from, and is not counted in the
+             * statistics.
+             */
+            first_press = !timing_interval_press(&intervals, press_cnt, &interval);
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+            /* Convert ILO ticks to WCO ticks with the measured frequency,
+             * or on each side of a trim with the frequency of that side */
+            lfclk_source_get_stats(&lfclk_stats);
+            interval_start = press_cnt - interval;
+            interval = lfclk_source_to_wco_ticks(interval_start, interval);
+#endif
+#if (USE_WCO_CALIBRATION)
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+            if (CY_SYSCLK_CLKLF_IN_WCO == lfclk_stats.source)
+#endif
+            {
+                /* Scale to true LFCLK ticks with the measured WCO error */
+                interval = wco_calibration_correct(interval);
+            }
+#endif
 
+            if (!first_press)
+            {
+                interval_stats_add(&interval_stats, interval);
+            }
+
+#if (ENABLE_BINARY_TELEMETRY)
+            /* Send the press time; the receiver takes the differences */
+            (void)log_sink_write(frame, telemetry_encode(&telemetry, frame, TELEMETRY_EVENT_PRESS,
+                                                         press_cnt));
+#else
             /* Calculate the time between two presses of switch and print on the 
              * terminal. MCWDT Counter0 and Counter1 are clocked by LFClk sourced 
-             * from WCO of frequency 32768 Hz
+             * from WCO of frequency 32768 Hz, so the low 15 bits of the
+             * difference are the fraction of a second and no division is
+             * needed.
              */
-            if(event2_cnt > event1_cnt)
+            (void)interval_format_ticks(timegap, interval);
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+            /* Print the timegap value with the bound on its error */
+            (void)interval_format_ticks(error_bound,
+                                        lfclk_source_error_ticks(interval_start,
+                                                                 press_cnt - interval_start));
+            LOG_PRINTF("\r\nThe time between two presses of user button = %ss +/- %ss\r\n",
+                       timegap, error_bound);
+#else
+            /* Print the timegap value */
+            LOG_PRINTF("\r\nThe time between two presses of user button = %ss\r\n", 
+                       timegap);
+#endif
+
+#if (ENABLE_DEEP_SLEEP_MODE)
+            /* Print the share of time the CPU has been awake */
+            low_power_get_stats(&power_stats);
+            duty = (uint32_t)(((uint64_t)power_stats.active_ticks * DUTY_CYCLE_SCALE) /
+                              ((uint64_t)power_stats.active_ticks + power_stats.sleep_ticks));
+            LOG_PRINTF("CPU active time = %u.%02u%% over %u wakeups\r\n",
+                       (unsigned int)(duty / 100u), (unsigned int)(duty % 100u),
+                       (unsigned int)power_stats.wakeups);
+#endif
+
+#if (ENABLE_BUTTON_INTERRUPT_CAPTURE)
+            /* Report button edges that arrived while the queue was full */
+            button_capture_get_ring_stats(&ring_stats);
+            if (ring_stats.dropped != edges_lost)
+            {
+                edges_lost = ring_stats.dropped;
+                LOG_PRINTF("%u button edges lost, queue high-water mark %u of %u\r\n",
+                           (unsigned int)edges_lost, (unsigned int)ring_stats.high_water,
+                           (unsigned int)TIMESTAMP_RING_SIZE);
+            }
+#endif
+#endif /* ENABLE_BINARY_TELEMETRY */
+        }
+
+#if (BUTTON_CAPTURE_EVENTS)
+        /* Report the clicks, long presses and hold repeats classified from
+         * the presses and releases taken above, with how long the button was
+         * held, or for clicks from the first press to the last release */
+        while (button_capture_get_event(&button_event))
+        {
+            (void)interval_format_ticks(timegap, button_event.duration);
+            LOG_PRINTF("%s (%u), %ss\r\n", button_events_name(button_event.type),
+                       (unsigned int)button_event.count, timegap);
+        }
+#endif
+
+#if (ENABLE_ASYNC_LOG)
+        /* Answer queries from the terminal */
+        while (log_sink_getc(&command))
+        {
+#if (USE_WCO_CALIBRATION)
+            /* Reference time lines from the host calibrate the WCO */
+            if (wco_calibration_parse(command))
             {
-                timegap = (event2_cnt - event1_cnt)/CY_SYSCLK_WCO_FREQ;
-                /* Print the timegap value */
-                printf("\r\nThe time between two presses of user button = %ds\r\n", 
-                       (unsigned int)timegap);
+                continue;
+            }
+#endif
+
+            if (STATS_QUERY_CHAR == command)
+            {
+                print_interval_stats(&interval_stats);
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+                lfclk_source_get_stats(&lfclk_stats);
+                print_lfclk_source(&lfclk_stats);
+#endif
+#if (USE_WCO_CALIBRATION)
+                wco_calibration_get_stats(&cal_stats);
+                LOG_PRINTF("WCO error %d ppb over %u s, %u reference points\r\n",
+                           (int)cal_stats.error_ppb, (unsigned int)cal_stats.span_s,
+                           (unsigned int)cal_stats.references);
+#endif
+#if (ENABLE_BUTTON_INTERRUPT_CAPTURE) && (BUTTON_CAPTURE_ADAPTIVE_DEBOUNCE)
+                LOG_PRINTF("Debounce window %u us\r\n",
+                           (unsigned int)((button_capture_window() * 1000000u) / CY_SYSCLK_WCO_FREQ));
+#endif
             }
-            else /* counter overflow */
+            else if (STATS_CLEAR_CHAR == command)
             {
-                timegap = 0;
-                /* Print a message on overflow of counter */
-                printf("\r\n\r\nCounter overflow detected\r\n");
+                interval_stats_init(&interval_stats);
+                LOG_PRINTF("\r\nInterval statistics cleared\r\n");
             }
+        }
+#endif
 
+#if (ENABLE_DEEP_SLEEP_MODE)
+        /* Deep Sleep until the next button edge, or until the next MCWDT_0
+         * Counter 2 tick while a debounce window is open. Interrupts are
+         * disabled so that an edge arriving after the check still wakes
+         * the CPU.
+         */
+        intr_status = Cy_SysLib_EnterCriticalSection();
+#if (ENABLE_ASYNC_LOG)
+        /* The UART stops in Deep Sleep, so only Sleep while output is still
+         * being sent; the end of the transfer wakes the CPU */
+        if (log_sink_busy())
+        {
+            __WFI();
+        }
+        else
+#endif
+#if (ENABLE_LFCLK_SOURCE_DETECTION)
+        /* An ILO measurement is lost in Deep Sleep, so only Sleep until it
+         * ends, waking on the Counter 2 tick to take it */
+        if (lfclk_source_busy())
+        {
+            low_power_sleep(true);
+        }
+        else
+#endif
+        {
+            low_power_deep_sleep(button_capture_busy());
+        }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+#elif (ENABLE_BUTTON_INTERRUPT_CAPTURE)
+        /* Sleep until the next button edge, or until the next MCWDT_0 Counter
+         * 2 tick while a debounce window is open or a button event deadline
+         * is pending. WFI wakes on a pending interrupt even with interrupts
+         * masked, so an edge arriving after the check is not missed.
+         */
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        low_power_sleep(button_capture_busy());
+        Cy_SysLib_ExitCriticalSection(intr_status);
+#elif (USE_TIMER_DEBOUNCE)
+        /* Sleep until the next sample unless a press is waiting to be
+         * reported */
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        if (!timer_debounce_pending())
+        {
+            __WFI();
         }
+        Cy_SysLib_ExitCriticalSection(intr_status);
+#endif
     }
 }
 
 
 /*******************************************************************************
-* Function Name: read_switch_status
+* Function Name: print_interval_stats
 ********************************************************************************
 * Summary:
-*  Reads and returns the current status of the switch.
+* This function prints the number of intervals measured between presses of the
+* user button, their mean, standard deviation, minimum and maximum, and one
+* line for each non-empty histogram bucket.
 *
 * Parameters:
-*  None
+*  stats: interval statistics
 *
 * Return:
-*  Returns non-zero value if switch is pressed and zero otherwise.
+*  None
 *
 *******************************************************************************/
-uint32_t read_switch_status(void)
+void print_interval_stats(interval_stats_t const *stats)
 {
-    uint32_t delayCounter = 0;
-    uint32_t sw_status = 0;
+    char mean[INTERVAL_FORMAT_BUF_SIZE];
+    char stddev[INTERVAL_FORMAT_BUF_SIZE];
+    char min[INTERVAL_FORMAT_BUF_SIZE];
+    char max[INTERVAL_FORMAT_BUF_SIZE];
+    uint32_t bucket;
 
-    /* Check if the switch is pressed */
-    while(0UL == Cy_GPIO_Read(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM))
+    if (0u == stats->count)
     {
-        /* Switch is pressed. Proceed for debouncing. */
-        Cy_SysLib_Delay(SWITCH_DEBOUNCE_CHECK_UNIT);
-        ++delayCounter;
-
-        /* Keep checking the switch status till the switch is pressed for a minimum
-         * period of SWITCH_DEBOUNCE_CHECK_UNIT x SWITCH_DEBOUNCE_MAX_PERIOD_UNITS
-         */
-        if (delayCounter > SWITCH_DEBOUNCE_MAX_PERIOD_UNITS)
-        {
-            /* Wait till the switch is released */
-            while(0UL == Cy_GPIO_Read(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM))
-            {
-            }
-
-            /* Debounce when the switch is being released */
-            do
-            {
-                delayCounter = 0;
-
-                while(delayCounter < SWITCH_DEBOUNCE_MAX_PERIOD_UNITS)
-                {
-                    cyhal_system_delay_ms(SWITCH_DEBOUNCE_CHECK_UNIT);
-                    ++delayCounter;
-                }
+        LOG_PRINTF("\r\nNo intervals measured yet\r\n");
+        return;
+    }
 
-            }while(0UL == Cy_GPIO_Read(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM));
+    (void)interval_format_ticks(mean, interval_stats_mean(stats));
+    (void)interval_format_ticks(stddev, interval_stats_stddev(stats));
+    (void)interval_format_ticks(min, stats->min);
+    (void)interval_format_ticks(max, stats->max);
+    LOG_PRINTF("\r\n%u intervals: mean %ss, standard deviation %ss, "
+               "min %ss, max %ss\r\n",
+               (unsigned int)stats->count, mean, stddev, min, max);
 
-            /* Switch is pressed and released*/
-            sw_status = 1u;
+    for (bucket = 0u; bucket < INTERVAL_STATS_BUCKETS; bucket++)
+    {
+        if (0u != stats->histogram[bucket])
+        {
+            (void)interval_format_ticks(min, interval_stats_bucket_floor(bucket));
+            LOG_PRINTF("  from %ss: %u\r\n", min, (unsigned int)stats->histogram[bucket]);
         }
     }
-
-    return (sw_status);
 }
 
 
@@ -286,4 +725,76 @@ void handle_error(void)
 }
 
 
+/*******************************************************************************
+* Function Name: print_lfclk_source
+********************************************************************************
+* Summary:
+* This function prints the LFCLK source with its frequency and error bound, and
+* for the ILO, the measurements and trims made so far.
+*
+* Parameters:
+*  stats: LFCLK source statistics
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void print_lfclk_source(lfclk_source_stats_t const *stats)
+{
+    if (CY_SYSCLK_CLKLF_IN_ILO != stats->source)
+    {
+        LOG_PRINTF("LFCLK from the WCO, within %u ppm\r\n", (unsigned int)stats->error_ppm);
+        return;
+    }
+
+    LOG_PRINTF("LFCLK from the ILO%s at %u Hz, within %u ppm: %u measurements, "
+               "%u lost, %u trims\r\n",
+               stats->fallback ? " (no WCO)" : "", (unsigned int)stats->frequency,
+               (unsigned int)stats->error_ppm, (unsigned int)stats->measurements,
+               (unsigned int)stats->failures, (unsigned int)stats->trims);
+}
+
+
+/*******************************************************************************
+* Function Name: print_latency_bench
+********************************************************************************
+* Summary:
+* This function prints the cycle counts of each step measured by the latency
+* benchmark, as a table with the mean also in nanoseconds. The table is longer
+* than a log buffer, so each line is sent before the next is queued.
+*
+* Parameters:
+*  report: cycle counts from latency_bench_run()
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void print_latency_bench(latency_bench_report_t const *report)
+{
+    latency_bench_result_t const *res;
+    uint32_t step;
+
+    LOG_PRINTF("\r\nCPU cycles at %u Hz, less %u for reading the counter\r\n",
+               (unsigned int)report->core_clock_hz, (unsigned int)report->overhead);
+    LOG_PRINTF("%-28s %6s %6s %6s %8s\r\n", "step", "min", "mean", "max", "mean ns");
+
+    for (step = 0u; step < (uint32_t)LATENCY_BENCH_STEPS; step++)
+    {
+#if (ENABLE_ASYNC_LOG)
+        log_sink_flush();
+#endif
+        res = &report->steps[step];
+        if (0u == res->samples)
+        {
+            LOG_PRINTF("%-28s %6s\r\n", latency_bench_step_name((latency_bench_step_t)step), "n/a");
+            continue;
+        }
+        LOG_PRINTF("%-28s %6u %6u %6u %8u\r\n", latency_bench_step_name((latency_bench_step_t)step),
+                   (unsigned int)res->min, (unsigned int)res->mean, (unsigned int)res->max,
+                   (unsigned int)(((uint64_t)res->mean * 1000000000u) / report->core_clock_hz));
+    }
+}
+
+
 /* [] END OF FILE */
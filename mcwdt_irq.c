@@ -0,0 +1,185 @@
+/******************************************************************************
+* File Name:   mcwdt_irq.c
+*
+* Description: Shared MCWDT_0 interrupt. Each counter's interrupt is handed to the
+*              handler registered for that counter.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "mcwdt_irq.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MCWDT_IRQ_COUNTERS                  (3u)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static mcwdt_irq_handler_t counter_handler[MCWDT_IRQ_COUNTERS];
+
+
+/*******************************************************************************
+* Function Name: mcwdt_irq_isr
+********************************************************************************
+* Summary:
+*  MCWDT_0 interrupt handler. Clears and dispatches every pending unmasked
+*  counter interrupt, Counter 0 first.
+*
+*******************************************************************************/
+static void mcwdt_irq_isr(void)
+{
+    uint32_t status = Cy_MCWDT_GetInterruptStatusMasked(MCWDT_0_HW);
+    uint32_t i;
+
+    Cy_MCWDT_ClearInterrupt(MCWDT_0_HW, status);
+    NVIC_ClearPendingIRQ(MCWDT_0_IRQ);
+
+    for (i = 0u; i < MCWDT_IRQ_COUNTERS; i++)
+    {
+        if ((0u != (status & (1uL << i))) && (NULL != counter_handler[i]))
+        {
+            counter_handler[i]();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mcwdt_irq_register
+********************************************************************************
+* Summary:
+*  Sets the handler for one counter's interrupt and installs the MCWDT_0
+*  interrupt, which may already be installed. The counter interrupt stays
+*  masked until mcwdt_irq_enable() is called.
+*
+* Parameters:
+*  counter: CY_MCWDT_CTR0, CY_MCWDT_CTR1 or CY_MCWDT_CTR2
+*  handler: function called from the interrupt
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the failing cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t mcwdt_irq_register(uint32_t counter, mcwdt_irq_handler_t handler)
+{
+    static const cy_stc_sysint_t mcwdt_intr_config =
+    {
+        .intrSrc = MCWDT_0_IRQ,
+        .intrPriority = MCWDT_IRQ_INTR_PRIORITY
+    };
+    cy_en_sysint_status_t status;
+    uint32_t i;
+
+    for (i = 0u; i < MCWDT_IRQ_COUNTERS; i++)
+    {
+        if (counter == (1uL << i))
+        {
+            break;
+        }
+    }
+    if (i == MCWDT_IRQ_COUNTERS)
+    {
+        return (cy_rslt_t)CY_SYSINT_BAD_PARAM;
+    }
+
+    counter_handler[i] = handler;
+
+    status = Cy_SysInt_Init(&mcwdt_intr_config, mcwdt_irq_isr);
+    if (CY_SYSINT_SUCCESS != status)
+    {
+        return (cy_rslt_t)status;
+    }
+    NVIC_EnableIRQ(MCWDT_0_IRQ);
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: mcwdt_irq_enable
+********************************************************************************
+* Summary:
+*  Clears any stale interrupt of the counter and unmasks it.
+*
+* Parameters:
+*  counter: CY_MCWDT_CTR0, CY_MCWDT_CTR1 or CY_MCWDT_CTR2
+*
+*******************************************************************************/
+void mcwdt_irq_enable(uint32_t counter)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    uint32_t mask = Cy_MCWDT_GetInterruptMask(MCWDT_0_HW);
+
+    if (0u == (mask & counter))
+    {
+        Cy_MCWDT_ClearInterrupt(MCWDT_0_HW, counter);
+        Cy_MCWDT_SetInterruptMask(MCWDT_0_HW, mask | counter);
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_status);
+}
+
+
+/*******************************************************************************
+* Function Name: mcwdt_irq_disable
+********************************************************************************
+* Summary:
+*  Masks the counter interrupt.
+*
+* Parameters:
+*  counter: CY_MCWDT_CTR0, CY_MCWDT_CTR1 or CY_MCWDT_CTR2
+*
+*******************************************************************************/
+void mcwdt_irq_disable(uint32_t counter)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    uint32_t mask = Cy_MCWDT_GetInterruptMask(MCWDT_0_HW);
+
+    if (0u != (mask & counter))
+    {
+        Cy_MCWDT_SetInterruptMask(MCWDT_0_HW, mask & ~counter);
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_status);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,154 @@
+/******************************************************************************
+* File Name:   mcwdt_timebase.c
+*
+* Description: Consistent reads of the free-running time base formed by cascading
+*              Counter 0 and Counter 1 of an MCWDT block.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "mcwdt_timebase.h"
+#include "mcwdt_irq.h"
+#include "timing_engine.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Number of times the 32-bit time base has crossed half of its range. Even
+ * while the time base is in its lower half, odd while in its upper half, until
+ * the Counter 1 interrupt of a crossing has been handled. */
+static volatile uint32_t half_periods;
+
+
+/*******************************************************************************
+* Function Name: mcwdt_timebase_read32
+********************************************************************************
+* Summary:
+*  Returns the 32-bit value of the Counter 1:Counter 0 cascade without tearing,
+*  with timing_engine_read32().
+*
+* Parameters:
+*  base: MCWDT block with Counter 0 cascaded into Counter 1
+*
+* Return:
+*  uint32_t: (Counter 1 << 16) | Counter 0
+*
+*******************************************************************************/
+uint32_t mcwdt_timebase_read32(MCWDT_STRUCT_Type const *base)
+{
+    return timing_engine_read32(base);
+}
+
+
+/*******************************************************************************
+* Function Name: mcwdt_timebase_half_isr
+********************************************************************************
+* Summary:
+*  Counter 1 match handler. Counts the half-range crossing and moves the match
+*  to the next one, half a range (about 18 hours at 32.768 kHz) away.
+*
+*******************************************************************************/
+static void mcwdt_timebase_half_isr(void)
+{
+    uint32_t halves = half_periods + 1u;
+
+    half_periods = halves;
+    Cy_MCWDT_SetMatch(MCWDT_0_HW, CY_MCWDT_COUNTER1, timing_engine_half_match(halves), 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: mcwdt_timebase_init
+********************************************************************************
+* Summary:
+*  Extends the MCWDT_0 time base to 64 bits. Counter 1 interrupts each time the
+*  32-bit value crosses half of its range, and the crossings are counted in
+*  software. Call after Cy_MCWDT_Init() and before Counter 1 is enabled; the
+*  Counter 1 match value is taken over for this.
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the failing cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t mcwdt_timebase_init(void)
+{
+    cy_rslt_t result;
+    uint32_t halves = timing_engine_initial_halves(timing_engine_read32(MCWDT_0_HW));
+
+    half_periods = halves;
+
+    Cy_MCWDT_SetMatch(MCWDT_0_HW, CY_MCWDT_COUNTER1, timing_engine_half_match(halves), 0u);
+    Cy_MCWDT_SetMode(MCWDT_0_HW, CY_MCWDT_COUNTER1, CY_MCWDT_MODE_INT);
+
+    result = mcwdt_irq_register(CY_MCWDT_CTR1, mcwdt_timebase_half_isr);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        mcwdt_irq_enable(CY_MCWDT_CTR1);
+    }
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: mcwdt_timebase_read64
+********************************************************************************
+* Summary:
+*  Returns the 64-bit MCWDT_0 time base, which does not wrap in practice. Takes
+*  no lock and may be called from any context, including interrupts that
+*  preempt the Counter 1 handler.
+*
+*  The crossing count is read before the counters. A wrap whose interrupt is
+*  pending, or was handled after the count was read, is made up for by
+*  timing_engine_extend(). This holds as long as the Counter 1 interrupt is
+*  handled within half a range of its crossing.
+*
+* Return:
+*  uint64_t: LFCLK cycles since the time base started at zero
+*
+*******************************************************************************/
+uint64_t mcwdt_timebase_read64(void)
+{
+    uint32_t halves = half_periods;
+
+    return timing_engine_extend(halves, timing_engine_read32(MCWDT_0_HW));
+}
+
+
+/* [] END OF FILE */
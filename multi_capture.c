@@ -0,0 +1,348 @@
+/******************************************************************************
+* File Name:   multi_capture.c
+*
+* Description: Timestamps edges on up to 16 GPIO inputs against the 64-bit MCWDT
+*              time base, serving every pending channel in one interrupt pass.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "multi_capture.h"
+#include "mcwdt_timebase.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Ring event: channel in the low byte, pin level after the edge above it */
+#define MULTI_CAPTURE_EVENT_LEVEL_SHIFT     (8u)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Ports with at least one channel, in the order of first use, with the pins
+ * captured on each and the channel of every pin. The interrupt walks these
+ * rather than the channels. */
+static GPIO_PRT_Type *port_base[MULTI_CAPTURE_MAX_CHANNELS];
+static IRQn_Type port_irqn[MULTI_CAPTURE_MAX_CHANNELS];
+static uint8_t port_pins[MULTI_CAPTURE_MAX_CHANNELS];
+static uint8_t port_channel[MULTI_CAPTURE_MAX_CHANNELS][MULTI_CAPTURE_PORT_PINS];
+static uint32_t port_count;
+
+/* Per-channel state, one array per field, written by the interrupt only */
+static uint64_t channel_last_edge[MULTI_CAPTURE_MAX_CHANNELS];
+static uint32_t channel_edges[MULTI_CAPTURE_MAX_CHANNELS];
+
+/* Bit n: level of channel n after its last edge */
+static volatile uint32_t channel_levels;
+
+static uint32_t channel_count;
+
+/* Edges for the main loop */
+static timestamp_ring_t event_ring;
+
+
+/*******************************************************************************
+* Function Name: multi_capture_isr
+********************************************************************************
+* Summary:
+*  Interrupt handler of every captured port. Reads the time base once, then
+*  takes the pending pins of all captured ports, not only the port that
+*  interrupted, and records one event per pin. Edges that arrive together
+*  share a timestamp and one interrupt entry.
+*
+*******************************************************************************/
+static void multi_capture_isr(void)
+{
+    uint64_t now = mcwdt_timebase_read64();
+    uint32_t levels = channel_levels;
+    uint32_t p;
+
+    for (p = 0u; p < port_count; p++)
+    {
+        GPIO_PRT_Type *base = port_base[p];
+        uint32_t pending = GPIO_PRT_INTR_MASKED(base) & port_pins[p];
+        uint32_t in;
+
+        if (0u == pending)
+        {
+            continue;
+        }
+
+        /* Clear before reading the pins, so that a later edge interrupts
+         * again rather than being lost */
+        for (in = pending; 0u != in; in &= in - 1u)
+        {
+            Cy_GPIO_ClearInterrupt(base, (uint32_t)__builtin_ctz(in));
+        }
+        NVIC_ClearPendingIRQ(port_irqn[p]);
+        in = GPIO_PRT_IN(base);
+
+        for (; 0u != pending; pending &= pending - 1u)
+        {
+            uint32_t pin = (uint32_t)__builtin_ctz(pending);
+            uint32_t channel = port_channel[p][pin];
+            uint32_t level = (in >> pin) & 1u;
+
+            channel_last_edge[channel] = now;
+            channel_edges[channel]++;
+            levels = (levels & ~(1ul << channel)) | (level << channel);
+
+            (void)timestamp_ring_push(&event_ring, now,
+                                      channel | (level << MULTI_CAPTURE_EVENT_LEVEL_SHIFT));
+        }
+    }
+
+    channel_levels = levels;
+}
+
+
+/*******************************************************************************
+* Function Name: multi_capture_init
+********************************************************************************
+* Summary:
+*  Enables interrupts on both edges of every channel. Channels are numbered in
+*  the order given. MCWDT_0 must already be running and extended to 64 bits by
+*  mcwdt_timebase_init(). Pins of a captured port that are not channels must
+*  not have their interrupt enabled by other code.
+*
+* Parameters:
+*  channels: port, pin and port interrupt of each channel
+*  count: number of channels, at most MULTI_CAPTURE_MAX_CHANNELS
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, CY_SYSINT_BAD_PARAM for an invalid or
+*  duplicated channel, or the failing cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t multi_capture_init(multi_capture_channel_t const *channels, uint32_t count)
+{
+    cy_stc_sysint_t intr_config = { .intrPriority = MULTI_CAPTURE_INTR_PRIORITY };
+    cy_en_sysint_status_t status;
+    uint32_t levels = 0u;
+    uint32_t c;
+    uint32_t p;
+
+    if ((NULL == channels) || (0u == count) || (count > MULTI_CAPTURE_MAX_CHANNELS))
+    {
+        return (cy_rslt_t)CY_SYSINT_BAD_PARAM;
+    }
+
+    port_count = 0u;
+    channel_count = 0u;
+    timestamp_ring_init(&event_ring);
+
+    for (c = 0u; c < count; c++)
+    {
+        if (channels[c].pin >= MULTI_CAPTURE_PORT_PINS)
+        {
+            return (cy_rslt_t)CY_SYSINT_BAD_PARAM;
+        }
+
+        for (p = 0u; (p < port_count) && (port_base[p] != channels[c].port); p++)
+        {
+        }
+        if (p == port_count)
+        {
+            port_base[p] = channels[c].port;
+            port_irqn[p] = channels[c].irqn;
+            port_pins[p] = 0u;
+            memset(port_channel[p], MULTI_CAPTURE_NO_CHANNEL, sizeof(port_channel[p]));
+            port_count++;
+        }
+        if (0u != (port_pins[p] & (1u << channels[c].pin)))
+        {
+            return (cy_rslt_t)CY_SYSINT_BAD_PARAM;
+        }
+
+        port_pins[p] |= (uint8_t)(1u << channels[c].pin);
+        port_channel[p][channels[c].pin] = (uint8_t)c;
+        channel_last_edge[c] = 0u;
+        channel_edges[c] = 0u;
+        levels |= Cy_GPIO_Read(channels[c].port, channels[c].pin) << c;
+    }
+    channel_levels = levels;
+    channel_count = count;
+
+    for (p = 0u; p < port_count; p++)
+    {
+        intr_config.intrSrc = port_irqn[p];
+        status = Cy_SysInt_Init(&intr_config, multi_capture_isr);
+        if (CY_SYSINT_SUCCESS != status)
+        {
+            return (cy_rslt_t)status;
+        }
+    }
+
+    for (c = 0u; c < count; c++)
+    {
+        Cy_GPIO_SetInterruptEdge(channels[c].port, channels[c].pin, CY_GPIO_INTR_BOTH);
+        Cy_GPIO_ClearInterrupt(channels[c].port, channels[c].pin);
+        Cy_GPIO_SetInterruptMask(channels[c].port, channels[c].pin, 1u);
+    }
+
+    for (p = 0u; p < port_count; p++)
+    {
+        NVIC_ClearPendingIRQ(port_irqn[p]);
+        NVIC_EnableIRQ(port_irqn[p]);
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: multi_capture_get_event
+********************************************************************************
+* Summary:
+*  Takes the oldest captured edge. Call from the main loop only.
+*
+* Parameters:
+*  event: receives the edge
+*
+* Return:
+*  bool: true if an edge was returned
+*
+*******************************************************************************/
+bool multi_capture_get_event(multi_capture_event_t *event)
+{
+    timestamp_record_t const *record;
+
+    if (0u == timestamp_ring_count(&event_ring))
+    {
+        return false;
+    }
+
+    record = timestamp_ring_at(&event_ring, 0u);
+    event->timestamp = timestamp_record_time(record);
+    event->channel = record->event & 0xFFu;
+    event->level = record->event >> MULTI_CAPTURE_EVENT_LEVEL_SHIFT;
+    timestamp_ring_release(&event_ring, 1u);
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: multi_capture_last_edge
+********************************************************************************
+* Summary:
+*  Returns the time base value of the most recent edge of a channel, even if
+*  its event was dropped because the ring was full.
+*
+* Parameters:
+*  channel: channel number
+*
+* Return:
+*  uint64_t: time base value, 0 before the first edge
+*
+*******************************************************************************/
+uint64_t multi_capture_last_edge(uint32_t channel)
+{
+    uint32_t intr_status;
+    uint64_t timestamp;
+
+    if (channel >= channel_count)
+    {
+        return 0u;
+    }
+
+    intr_status = Cy_SysLib_EnterCriticalSection();
+    timestamp = channel_last_edge[channel];
+    Cy_SysLib_ExitCriticalSection(intr_status);
+
+    return timestamp;
+}
+
+
+/*******************************************************************************
+* Function Name: multi_capture_edge_count
+********************************************************************************
+* Summary:
+*  Returns the number of edges captured on a channel.
+*
+* Parameters:
+*  channel: channel number
+*
+* Return:
+*  uint32_t: number of edges
+*
+*******************************************************************************/
+uint32_t multi_capture_edge_count(uint32_t channel)
+{
+    return (channel < channel_count) ? channel_edges[channel] : 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: multi_capture_levels
+********************************************************************************
+* Summary:
+*  Returns the level of every channel after its last captured edge.
+*
+* Return:
+*  uint32_t: bit n is the level of channel n
+*
+*******************************************************************************/
+uint32_t multi_capture_levels(void)
+{
+    return channel_levels;
+}
+
+
+/*******************************************************************************
+* Function Name: multi_capture_get_ring_stats
+********************************************************************************
+* Summary:
+*  Returns the event ring statistics: events queued, events dropped because
+*  the main loop fell behind, and the high-water mark.
+*
+* Parameters:
+*  stats: receives the statistics
+*
+*******************************************************************************/
+void multi_capture_get_ring_stats(timestamp_ring_stats_t *stats)
+{
+    timestamp_ring_get_stats(&event_ring, stats);
+}
+
+
+/* [] END OF FILE */
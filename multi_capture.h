@@ -0,0 +1,99 @@
+/******************************************************************************
+* File Name:   multi_capture.h
+*
+* Description: Timestamps edges on up to 16 GPIO inputs against the 64-bit MCWDT
+*              time base, serving every pending channel in one interrupt pass.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MULTI_CAPTURE_H
+#define MULTI_CAPTURE_H
+
+#include "cy_pdl.h"
+#include "timestamp_ring.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MULTI_CAPTURE_MAX_CHANNELS          (16u)
+
+/* Pins per GPIO port */
+#define MULTI_CAPTURE_PORT_PINS             (8u)
+
+/* Same priority as the user button interrupt. All port interrupts of the
+ * channels must share one priority, so that they do not preempt each other
+ * and the event ring keeps a single producer. */
+#define MULTI_CAPTURE_INTR_PRIORITY         (3u)
+
+/* Marks a pin of a captured port that is not a channel */
+#define MULTI_CAPTURE_NO_CHANNEL            (0xFFu)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    GPIO_PRT_Type *port;
+    uint32_t       pin;
+    IRQn_Type      irqn;        /* Interrupt of the port */
+} multi_capture_channel_t;
+
+typedef struct
+{
+    uint64_t timestamp;         /* 64-bit time base value of the edge  */
+    uint32_t channel;
+    uint32_t level;             /* Pin level after the edge             */
+} multi_capture_event_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t multi_capture_init(multi_capture_channel_t const *channels, uint32_t count);
+bool      multi_capture_get_event(multi_capture_event_t *event);
+uint64_t  multi_capture_last_edge(uint32_t channel);
+uint32_t  multi_capture_edge_count(uint32_t channel);
+uint32_t  multi_capture_levels(void);
+void      multi_capture_get_ring_stats(timestamp_ring_stats_t *stats);
+
+
+#endif /* MULTI_CAPTURE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,124 @@
+/******************************************************************************
+* File Name:   port_debounce.c
+*
+* Description: Debounces all pins of a GPIO port together with vertical counters,
+*              from one read of the port register per sample.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "port_debounce.h"
+
+
+/*******************************************************************************
+* Function Name: port_debounce_init
+********************************************************************************
+* Summary:
+*  Starts debouncing with the given levels taken as stable.
+*
+* Parameters:
+*  debounce: debounce state
+*  levels: initial debounced levels, normally a read of the port
+*
+*******************************************************************************/
+void port_debounce_init(port_debounce_t *debounce, uint32_t levels)
+{
+    memset(debounce->count, 0, sizeof(debounce->count));
+    debounce->state = levels;
+}
+
+
+/*******************************************************************************
+* Function Name: port_debounce_update
+********************************************************************************
+* Summary:
+*  Takes one sample of the port. The counter of each pin whose sample differs
+*  from its debounced level is incremented and every other counter is
+*  cleared; a pin changes level when its counter wraps. This is a ripple
+*  increment across the counter bits, three operations per bit whatever the
+*  number of pins. Call at a fixed rate.
+*
+* Parameters:
+*  debounce: debounce state
+*  sample: port input register
+*
+* Return:
+*  uint32_t: bit n set if pin n changed its debounced level
+*
+*******************************************************************************/
+uint32_t port_debounce_update(port_debounce_t *debounce, uint32_t sample)
+{
+    uint32_t differ = sample ^ debounce->state;
+    uint32_t carry = differ;
+    uint32_t k;
+
+    for (k = 0u; k < PORT_DEBOUNCE_COUNTER_BITS; k++)
+    {
+        uint32_t bit = debounce->count[k];
+
+        debounce->count[k] = (bit ^ carry) & differ;
+        carry &= bit;
+    }
+
+    /* The carry out of the top bit marks the counters that wrapped to 0 */
+    debounce->state ^= carry;
+
+    return carry;
+}
+
+
+/*******************************************************************************
+* Function Name: port_debounce_state
+********************************************************************************
+* Summary:
+*  Returns the debounced levels.
+*
+* Parameters:
+*  debounce: debounce state
+*
+* Return:
+*  uint32_t: bit n is the debounced level of pin n
+*
+*******************************************************************************/
+uint32_t port_debounce_state(port_debounce_t const *debounce)
+{
+    return debounce->state;
+}
+
+
+/* [] END OF FILE */
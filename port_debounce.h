@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name:   port_debounce.h
+*
+* Description: Debounces all pins of a GPIO port together with vertical counters,
+*              from one read of the port register per sample.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PORT_DEBOUNCE_H
+#define PORT_DEBOUNCE_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Bits of each pin's vertical counter. A pin changes its debounced level
+ * after 2^PORT_DEBOUNCE_COUNTER_BITS consecutive samples at the other level:
+ * 8 samples 10 ms apart give the 80 ms of switch_debounce.h. */
+#ifndef PORT_DEBOUNCE_COUNTER_BITS
+#define PORT_DEBOUNCE_COUNTER_BITS          (3u)
+#endif
+
+#define PORT_DEBOUNCE_SAMPLES               (1u << PORT_DEBOUNCE_COUNTER_BITS)
+
+#if ((PORT_DEBOUNCE_COUNTER_BITS < 1u) || (PORT_DEBOUNCE_COUNTER_BITS > 8u))
+#error "PORT_DEBOUNCE_COUNTER_BITS must be between 1 and 8"
+#endif
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/* Debounce state of up to 32 pins. Bit n of count[k] is bit k of the counter
+ * of pin n, so one bitwise operation updates every pin. */
+typedef struct
+{
+    uint32_t state;                             /* Debounced levels */
+    uint32_t count[PORT_DEBOUNCE_COUNTER_BITS];
+} port_debounce_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void     port_debounce_init(port_debounce_t *debounce, uint32_t levels);
+uint32_t port_debounce_update(port_debounce_t *debounce, uint32_t sample);
+uint32_t port_debounce_state(port_debounce_t const *debounce);
+
+
+#endif /* PORT_DEBOUNCE_H */
+
+
+/* [] END OF FILE */
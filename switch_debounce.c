@@ -0,0 +1,106 @@
+/******************************************************************************
+* File Name:   switch_debounce.c
+*
+* Description: Polled debounce of the user button switch. The CPU stays in this
+*              function, sampling the pin once per SWITCH_DEBOUNCE_CHECK_UNIT ms,
+*              until the switch has been pressed and released.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cyhal.h"
+#include "cybsp.h"
+#include "switch_debounce.h"
+
+
+/*******************************************************************************
+* Function Name: read_switch_status
+********************************************************************************
+* Summary:
+*  Reads and returns the current status of the switch.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Returns non-zero value if switch is pressed and zero otherwise.
+*
+*******************************************************************************/
+uint32_t read_switch_status(void)
+{
+    uint32_t delayCounter = 0;
+    uint32_t sw_status = 0;
+
+    /* Check if the switch is pressed */
+    while(0UL == Cy_GPIO_Read(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM))
+    {
+        /* Switch is pressed. Proceed for debouncing. */
+        Cy_SysLib_Delay(SWITCH_DEBOUNCE_CHECK_UNIT);
+        ++delayCounter;
+
+        /* Keep checking the switch status till the switch is pressed for a minimum
+         * period of SWITCH_DEBOUNCE_CHECK_UNIT x SWITCH_DEBOUNCE_MAX_PERIOD_UNITS
+         */
+        if (delayCounter > SWITCH_DEBOUNCE_MAX_PERIOD_UNITS)
+        {
+            /* Wait till the switch is released */
+            while(0UL == Cy_GPIO_Read(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM))
+            {
+            }
+
+            /* Debounce when the switch is being released */
+            do
+            {
+                delayCounter = 0;
+
+                while(delayCounter < SWITCH_DEBOUNCE_MAX_PERIOD_UNITS)
+                {
+                    cyhal_system_delay_ms(SWITCH_DEBOUNCE_CHECK_UNIT);
+                    ++delayCounter;
+                }
+
+            }while(0UL == Cy_GPIO_Read(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM));
+
+            /* Switch is pressed and released*/
+            sw_status = 1u;
+        }
+    }
+
+    return (sw_status);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,31 @@
+
+#ifndef SWITCH_DEBOUNCE_H
+#define SWITCH_DEBOUNCE_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Switch press/release check interval in milliseconds for debouncing */
+#define SWITCH_DEBOUNCE_CHECK_UNIT          (1u)
+
+/* Number of debounce check units to count before considering that switch is pressed
+ * or released */
+#ifndef SWITCH_DEBOUNCE_MAX_PERIOD_UNITS
+#define SWITCH_DEBOUNCE_MAX_PERIOD_UNITS    (80u)
+#endif
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t read_switch_status(void);
+
+
+#endif /* SWITCH_DEBOUNCE_H */
+
+
+/* [] END OF FILE */
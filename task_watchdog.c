@@ -0,0 +1,174 @@
+/******************************************************************************
+* File Name:   task_watchdog.c
+*
+* Description: Software watchdog for many tasks on the one MCWDT watchdog of
+*              watchdog_supervisor.c. Tasks set their bit in a check-in word without a
+*              lock; the supervisor interrupt feeds the watchdog only if every task has
+*              checked in within its allowed number of windows.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "task_watchdog.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+volatile uint32_t task_watchdog_checkins;
+
+/* Registered tasks, the windows each may miss in a row, and the windows each
+ * has missed */
+static uint32_t task_count;
+static uint32_t task_windows[TASK_WATCHDOG_MAX_TASKS];
+static uint32_t task_missed[TASK_WATCHDOG_MAX_TASKS];
+
+
+/*******************************************************************************
+* Function Name: task_watchdog_window
+********************************************************************************
+* Summary:
+*  Window callback of the supervisor. Takes and clears the check-ins of the
+*  period, and feeds the watchdog unless a task has gone without a check-in
+*  for as many windows as it was registered with.
+*
+* Return:
+*  uint32_t: 0 to feed, or one bit for each task that stalled
+*
+*******************************************************************************/
+static uint32_t task_watchdog_window(void)
+{
+    uint32_t seen;
+    uint32_t stalled = 0u;
+    uint32_t i;
+
+    /* A higher priority interrupt may check in between the two */
+    do
+    {
+        seen = __LDREXW(&task_watchdog_checkins);
+    } while (0u != __STREXW(0u, &task_watchdog_checkins));
+
+    for (i = 0u; i < task_count; i++)
+    {
+        if (0u != (seen & (1UL << i)))
+        {
+            task_missed[i] = 0u;
+        }
+        else if (++task_missed[i] >= task_windows[i])
+        {
+            stalled |= (1UL << i);
+        }
+    }
+
+    return stalled;
+}
+
+
+/*******************************************************************************
+* Function Name: task_watchdog_init
+********************************************************************************
+* Summary:
+*  Starts the watchdog supervisor, fed from its interrupt once every
+*  registered task has checked in. The MCWDT_0 time base must already be
+*  running. A stall leads to a STARVED fault with the stalled tasks in its
+*  detail, and to a reset at the end of the next period. A task that only
+*  checks in again after that period's window has opened is too late.
+*
+* Parameters:
+*  warning: called from the supervisor interrupt on a fault, or NULL
+*
+* Return:
+*  cy_rslt_t: result of watchdog_supervisor_init()
+*
+*******************************************************************************/
+cy_rslt_t task_watchdog_init(watchdog_supervisor_warning_t warning)
+{
+    cy_rslt_t result;
+
+    task_count = 0u;
+    task_watchdog_checkins = 0u;
+
+    result = watchdog_supervisor_init(warning);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        watchdog_supervisor_set_window(task_watchdog_window);
+    }
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: task_watchdog_register
+********************************************************************************
+* Summary:
+*  Adds a task. It must check in at least once in every 'windows' watchdog
+*  periods; a task that runs less often than the period needs more than one.
+*  The task counts as checked in for the current window.
+*
+* Parameters:
+*  windows: periods the task may go without a check-in, at least 1
+*  id: receives the id to check in with
+*
+* Return:
+*  bool: false if TASK_WATCHDOG_MAX_TASKS tasks are registered already
+*
+*******************************************************************************/
+bool task_watchdog_register(uint32_t windows, uint32_t *id)
+{
+    uint32_t intr_status;
+
+    intr_status = Cy_SysLib_EnterCriticalSection();
+    if (task_count >= TASK_WATCHDOG_MAX_TASKS)
+    {
+        Cy_SysLib_ExitCriticalSection(intr_status);
+        return false;
+    }
+
+    *id = task_count;
+    task_windows[task_count] = (windows > 0u) ? windows : 1u;
+    task_missed[task_count] = 0u;
+    task_count++;
+    Cy_SysLib_ExitCriticalSection(intr_status);
+
+    task_watchdog_checkin(*id);
+
+    return true;
+}
+
+
+/* [] END OF FILE */
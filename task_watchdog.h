@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name:   task_watchdog.h
+*
+* Description: Interface of the per-task software watchdog on the watchdog supervisor.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TASK_WATCHDOG_H
+#define TASK_WATCHDOG_H
+
+#include "cy_pdl.h"
+#include "watchdog_supervisor.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* One bit of the check-in word per task */
+#define TASK_WATCHDOG_MAX_TASKS             (32u)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Tasks that have checked in since the last window opened, one bit each */
+extern volatile uint32_t task_watchdog_checkins;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t task_watchdog_init(watchdog_supervisor_warning_t warning);
+bool      task_watchdog_register(uint32_t windows, uint32_t *id);
+
+
+/*******************************************************************************
+* Function Name: task_watchdog_checkin
+********************************************************************************
+* Summary:
+*  Reports that a task is alive. Sets its bit with an exclusive load and
+*  store, so a check-in from any task or interrupt is never lost, and no
+*  lock is taken. Once the bit is set, further check-ins until the next
+*  window are a load and a test.
+*
+* Parameters:
+*  id: task from task_watchdog_register()
+*
+*******************************************************************************/
+static inline void task_watchdog_checkin(uint32_t id)
+{
+    uint32_t bit = 1UL << id;
+    uint32_t value;
+
+    if (0u == (task_watchdog_checkins & bit))
+    {
+        do
+        {
+            value = __LDREXW(&task_watchdog_checkins);
+        } while (0u != __STREXW(value | bit, &task_watchdog_checkins));
+    }
+}
+
+
+#endif /* TASK_WATCHDOG_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,154 @@
+/******************************************************************************
+* File Name:   telemetry.c
+*
+* Description: Compact binary telemetry frames: sequence number, delta-encoded
+*              time base value, event type and CRC.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include "telemetry.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* CRC-16/CCITT-FALSE (polynomial 0x1021) of each 4-bit value */
+static const uint16_t crc16_nibble[16] =
+{
+    0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+    0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu
+};
+
+
+/*******************************************************************************
+* Function Name: telemetry_crc16
+********************************************************************************
+* Summary:
+*  Updates a CRC-16/CCITT-FALSE with the given bytes, four bits at a time.
+*
+* Parameters:
+*  crc: TELEMETRY_CRC_INIT, or the result of the previous call
+*  data: bytes to add
+*  len: number of bytes
+*
+* Return:
+*  uint16_t: updated CRC
+*
+*******************************************************************************/
+uint16_t telemetry_crc16(uint16_t crc, uint8_t const *data, size_t len)
+{
+    size_t i;
+
+    for (i = 0u; i < len; i++)
+    {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (data[i] & 0x0Fu)]);
+    }
+
+    return crc;
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_encoder_init
+********************************************************************************
+* Summary:
+*  Starts a new stream. The first frame carries absolute ticks.
+*
+* Parameters:
+*  encoder: encoder state
+*
+*******************************************************************************/
+void telemetry_encoder_init(telemetry_encoder_t *encoder)
+{
+    encoder->last_ticks = 0u;
+    encoder->seq = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_encode
+********************************************************************************
+* Summary:
+*  Builds the next frame of the stream. Press intervals of up to 4 s take
+*  three bytes of ticks, so a typical frame is 8 bytes.
+*
+* Parameters:
+*  encoder: encoder state
+*  frame: receives the frame, at least TELEMETRY_FRAME_MAX bytes
+*  event: event type
+*  ticks: 64-bit time base value of the event
+*
+* Return:
+*  size_t: frame length in bytes
+*
+*******************************************************************************/
+size_t telemetry_encode(telemetry_encoder_t *encoder, uint8_t *frame,
+                        telemetry_event_t event, uint64_t ticks)
+{
+    bool absolute = ((encoder->seq % TELEMETRY_ABSOLUTE_INTERVAL) == 0u);
+    uint64_t value = absolute ? ticks : (ticks - encoder->last_ticks);
+    uint16_t crc;
+    size_t len = 0u;
+
+    frame[len++] = TELEMETRY_SYNC;
+    frame[len++] = encoder->seq;
+    frame[len++] = (uint8_t)(((uint32_t)event & TELEMETRY_EVENT_MASK) |
+                             (absolute ? TELEMETRY_FLAG_ABSOLUTE : 0u));
+
+    /* LEB128: seven bits per byte, bit 7 set on all but the last */
+    while (value >= 0x80u)
+    {
+        frame[len++] = (uint8_t)(value | 0x80u);
+        value >>= 7;
+    }
+    frame[len++] = (uint8_t)value;
+
+    crc = telemetry_crc16(TELEMETRY_CRC_INIT, &frame[1], len - 1u);
+    frame[len++] = (uint8_t)crc;
+    frame[len++] = (uint8_t)(crc >> 8);
+
+    encoder->last_ticks = ticks;
+    encoder->seq++;
+
+    return len;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name:   telemetry.h
+*
+* Description: Compact binary telemetry frames: sequence number, delta-encoded
+*              time base value, event type and CRC.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Frame layout, all fields little-endian:
+ *
+ *   0xA5 | seq | type | ticks (LEB128, 1-10 bytes) | CRC-16 (2 bytes)
+ *
+ * 'seq' counts frames modulo 256. The low 7 bits of 'type' are the event and
+ * bit 7 marks a frame whose 'ticks' is the absolute 64-bit time base value;
+ * otherwise 'ticks' is the difference from the previous frame, modulo 2^64.
+ * The CRC is CRC-16/CCITT-FALSE over 'seq' to the end of 'ticks'. */
+#define TELEMETRY_SYNC                      (0xA5u)
+#define TELEMETRY_FLAG_ABSOLUTE             (0x80u)
+#define TELEMETRY_EVENT_MASK                (0x7Fu)
+
+/* Longest frame: sync, seq, type, 10 bytes of ticks and the CRC */
+#define TELEMETRY_FRAME_MAX                 (15u)
+
+/* Every frame whose sequence number is a multiple of this carries absolute
+ * ticks, so that a receiver that lost frames resynchronizes */
+#define TELEMETRY_ABSOLUTE_INTERVAL         (16u)
+
+#define TELEMETRY_CRC_INIT                  (0xFFFFu)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    TELEMETRY_EVENT_BOOT    = 0u,   /* Time base value at start-up     */
+    TELEMETRY_EVENT_PRESS   = 1u    /* User button press edge          */
+} telemetry_event_t;
+
+typedef struct
+{
+    uint64_t last_ticks;
+    uint8_t  seq;
+} telemetry_encoder_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void     telemetry_encoder_init(telemetry_encoder_t *encoder);
+size_t   telemetry_encode(telemetry_encoder_t *encoder, uint8_t *frame,
+                          telemetry_event_t event, uint64_t ticks);
+uint16_t telemetry_crc16(uint16_t crc, uint8_t const *data, size_t len);
+
+
+#endif /* TELEMETRY_H */
+
+
+/* [] END OF FILE */
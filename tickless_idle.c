@@ -0,0 +1,301 @@
+/******************************************************************************
+* File Name:   tickless_idle.c
+*
+* Description: Tickless idle for an RTOS. While the RTOS is idle its tick is stopped
+*              and an MCWDT match wakes the CPU at the next deadline; on wakeup the
+*              ticks that passed are measured on the MCWDT_0 time base.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cybsp.h"
+#include "tickless_idle.h"
+#include "mcwdt_timebase.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Counter 0 of MCWDT_1 counts freely; its match value is moved to each
+ * wakeup time */
+static const cy_stc_mcwdt_config_t tickless_mcwdt_config =
+{
+    .c0Match = 0xFFFFu,
+    .c1Match = 0xFFFFu,
+    .c0Mode = CY_MCWDT_MODE_INT,
+    .c1Mode = CY_MCWDT_MODE_NONE,
+    .c2ToggleBit = 0u,
+    .c2Mode = CY_MCWDT_MODE_NONE,
+    .c0ClearOnMatch = false,
+    .c1ClearOnMatch = false,
+    .c0c1Cascade = false,
+    .c1c2Cascade = false,
+};
+
+/* Time base value and RTOS tick count at tickless_idle_init(). Tick n after
+ * that starts at the first LFCLK cycle at or after n / TICKLESS_IDLE_TICK_RATE_HZ
+ * seconds, so tick boundaries do not drift whatever the ratio of the clocks. */
+static uint64_t anchor_count;
+static uint32_t anchor_tick;
+
+static tickless_idle_stats_t idle_stats;
+
+
+/*******************************************************************************
+* Function Name: tickless_idle_isr
+********************************************************************************
+* Summary:
+*  MCWDT_1 handler. The match only has to wake the CPU, and is normally
+*  cleared by tickless_idle_sleep() before interrupts are enabled again.
+*
+*******************************************************************************/
+static void tickless_idle_isr(void)
+{
+    Cy_MCWDT_ClearInterrupt(TICKLESS_IDLE_MCWDT_HW, CY_MCWDT_CTR0);
+    NVIC_ClearPendingIRQ(TICKLESS_IDLE_MCWDT_IRQ);
+}
+
+
+/*******************************************************************************
+* Function Name: tickless_idle_ticks_at
+********************************************************************************
+* Summary:
+*  Returns the number of whole ticks since the anchor at a time base value.
+*
+*******************************************************************************/
+static uint64_t tickless_idle_ticks_at(uint64_t count)
+{
+    return ((count - anchor_count) * TICKLESS_IDLE_TICK_RATE_HZ) / CY_SYSCLK_WCO_FREQ;
+}
+
+
+/*******************************************************************************
+* Function Name: tickless_idle_init
+********************************************************************************
+* Summary:
+*  Starts MCWDT_1 Counter 0 with its interrupt masked, and ties the RTOS tick
+*  count to the current time base value. The MCWDT_0 time base must already
+*  be running. Call once before the scheduler starts.
+*
+*  Ticks are converted at CY_SYSCLK_WCO_FREQ, so LFCLK must be the WCO. When
+*  it is not, for example after lfclk_source.c has fallen back to the ILO,
+*  which is only within 30% of that frequency, the port refuses to start and
+*  the RTOS has to keep its SysTick tick.
+*
+* Parameters:
+*  tick_count: current RTOS tick count
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, CY_SYSCLK_INVALID_STATE if LFCLK is not the
+*             WCO, or the failing cy_en_mcwdt_status_t or
+*             cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t tickless_idle_init(uint32_t tick_count)
+{
+    static const cy_stc_sysint_t tickless_intr_config =
+    {
+        .intrSrc = TICKLESS_IDLE_MCWDT_IRQ,
+        .intrPriority = TICKLESS_IDLE_INTR_PRIORITY
+    };
+    cy_en_mcwdt_status_t mcwdt_status;
+    cy_en_sysint_status_t status;
+
+    if (CY_SYSCLK_CLKLF_IN_WCO != Cy_SysClk_ClkLfGetSource())
+    {
+        return (cy_rslt_t)CY_SYSCLK_INVALID_STATE;
+    }
+
+    mcwdt_status = Cy_MCWDT_Init(TICKLESS_IDLE_MCWDT_HW, &tickless_mcwdt_config);
+    if (CY_MCWDT_SUCCESS != mcwdt_status)
+    {
+        return (cy_rslt_t)mcwdt_status;
+    }
+    Cy_MCWDT_SetInterruptMask(TICKLESS_IDLE_MCWDT_HW, 0u);
+
+    status = Cy_SysInt_Init(&tickless_intr_config, tickless_idle_isr);
+    if (CY_SYSINT_SUCCESS != status)
+    {
+        return (cy_rslt_t)status;
+    }
+    NVIC_ClearPendingIRQ(TICKLESS_IDLE_MCWDT_IRQ);
+    NVIC_EnableIRQ(TICKLESS_IDLE_MCWDT_IRQ);
+
+    Cy_MCWDT_Enable(TICKLESS_IDLE_MCWDT_HW, CY_MCWDT_CTR0, TICKLESS_IDLE_MCWDT_ENABLE_DELAY);
+
+    anchor_count = mcwdt_timebase_read64();
+    anchor_tick = tick_count;
+    memset(&idle_stats, 0, sizeof(idle_stats));
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: tickless_idle_sleep
+********************************************************************************
+* Summary:
+*  Stops SysTick and sleeps until the RTOS tick expected_idle_ticks after
+*  tick_count, or until another interrupt, then restarts SysTick. Returns the
+*  number of ticks to step the RTOS tick count by, measured on the MCWDT_0
+*  time base: this also makes up any ticks SysTick lost or gained against the
+*  time base since the last sleep, up to expected_idle_ticks.
+*
+*  Call from the RTOS idle task with interrupts disabled, after checking that
+*  the RTOS still wants to sleep. With FreeRTOS and configUSE_TICKLESS_IDLE 2:
+*    vTaskStepTick(tickless_idle_sleep(xTaskGetTickCount(), xExpectedIdleTime));
+*
+*  Idle periods are cut to TICKLESS_IDLE_MAX_CYCLES, and periods shorter than
+*  TICKLESS_IDLE_MIN_TICKS are not slept; the RTOS then just enters idle again.
+*
+* Parameters:
+*  tick_count: current RTOS tick count
+*  expected_idle_ticks: ticks until the RTOS next has work to do
+*
+* Return:
+*  uint32_t: ticks to step, at most expected_idle_ticks
+*
+*******************************************************************************/
+uint32_t tickless_idle_sleep(uint32_t tick_count, uint32_t expected_idle_ticks)
+{
+    uint64_t now = mcwdt_timebase_read64();
+    uint64_t due = tickless_idle_ticks_at(now);
+    int32_t lag = (int32_t)((uint32_t)due + anchor_tick - tick_count);
+    uint64_t wake;
+    uint64_t cycles;
+    uint32_t match;
+
+    /* If SysTick lost ticks against the time base, so many that stepping
+     * them brings the RTOS to its deadline, there is nothing to sleep for */
+    if (((int64_t)expected_idle_ticks - lag) >= (int64_t)TICKLESS_IDLE_MIN_TICKS)
+    {
+        SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+        /* Wake on the time base cycle that starts the deadline tick */
+        wake = anchor_count + (((due + expected_idle_ticks - (uint64_t)(int64_t)lag) *
+                                CY_SYSCLK_WCO_FREQ) + TICKLESS_IDLE_TICK_RATE_HZ - 1u) /
+                               TICKLESS_IDLE_TICK_RATE_HZ;
+        cycles = wake - now;
+        if (cycles > TICKLESS_IDLE_MAX_CYCLES)
+        {
+            cycles = TICKLESS_IDLE_MAX_CYCLES;
+        }
+
+        match = (Cy_MCWDT_GetCount(TICKLESS_IDLE_MCWDT_HW, CY_MCWDT_COUNTER0) + (uint32_t)cycles) & 0xFFFFu;
+        Cy_MCWDT_SetMatch(TICKLESS_IDLE_MCWDT_HW, CY_MCWDT_COUNTER0, match, 0u);
+        Cy_MCWDT_ClearInterrupt(TICKLESS_IDLE_MCWDT_HW, CY_MCWDT_CTR0);
+        Cy_MCWDT_SetInterruptMask(TICKLESS_IDLE_MCWDT_HW, CY_MCWDT_CTR0);
+
+        __DSB();
+        __WFI();
+
+        Cy_MCWDT_SetInterruptMask(TICKLESS_IDLE_MCWDT_HW, 0u);
+        if (0u != (Cy_MCWDT_GetInterruptStatus(TICKLESS_IDLE_MCWDT_HW) & CY_MCWDT_CTR0))
+        {
+            Cy_MCWDT_ClearInterrupt(TICKLESS_IDLE_MCWDT_HW, CY_MCWDT_CTR0);
+        }
+        else
+        {
+            idle_stats.early_wakeups++;
+        }
+        NVIC_ClearPendingIRQ(TICKLESS_IDLE_MCWDT_IRQ);
+
+        /* Restart a full tick period from now */
+        SysTick->VAL = 0u;
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        idle_stats.sleeps++;
+
+        due = tickless_idle_ticks_at(mcwdt_timebase_read64());
+    }
+
+    if (lag > 0)
+    {
+        idle_stats.ticks_corrected += (uint32_t)lag;
+    }
+
+    /* Ticks the RTOS is behind the time base now */
+    lag = (int32_t)((uint32_t)due + anchor_tick - tick_count);
+    if (lag < 0)
+    {
+        lag = 0;
+    }
+    if ((uint32_t)lag > expected_idle_ticks)
+    {
+        lag = (int32_t)expected_idle_ticks;
+    }
+    idle_stats.ticks_stepped += (uint32_t)lag;
+
+    return (uint32_t)lag;
+}
+
+
+/*******************************************************************************
+* Function Name: tickless_idle_ticks_due
+********************************************************************************
+* Summary:
+*  Returns the RTOS tick count the time base says it should have now. The
+*  difference from the actual tick count is its error.
+*
+* Return:
+*  uint64_t: tick count due
+*
+*******************************************************************************/
+uint64_t tickless_idle_ticks_due(void)
+{
+    return tickless_idle_ticks_at(mcwdt_timebase_read64()) + anchor_tick;
+}
+
+
+/*******************************************************************************
+* Function Name: tickless_idle_get_stats
+********************************************************************************
+* Summary:
+*  Returns the counters of tickless_idle_sleep().
+*
+* Parameters:
+*  stats: receives the statistics
+*
+*******************************************************************************/
+void tickless_idle_get_stats(tickless_idle_stats_t *stats)
+{
+    *stats = idle_stats;
+}
+
+
+/* [] END OF FILE */
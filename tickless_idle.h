@@ -0,0 +1,107 @@
+/******************************************************************************
+* File Name:   tickless_idle.h
+*
+* Description: Tickless idle for an RTOS. While the RTOS is idle its tick is stopped
+*              and an MCWDT match wakes the CPU at the next deadline; on wakeup the
+*              ticks that passed are measured on the MCWDT_0 time base.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TICKLESS_IDLE_H
+#define TICKLESS_IDLE_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* RTOS tick rate, as configTICK_RATE_HZ */
+#ifndef TICKLESS_IDLE_TICK_RATE_HZ
+#define TICKLESS_IDLE_TICK_RATE_HZ          (1000u)
+#endif
+
+/* Idle periods shorter than this many ticks are not worth stopping the tick
+ * for, as configEXPECTED_IDLE_TIME_BEFORE_SLEEP */
+#ifndef TICKLESS_IDLE_MIN_TICKS
+#define TICKLESS_IDLE_MIN_TICKS             (2u)
+#endif
+
+/* MCWDT block whose Counter 0 match ends each idle period. MCWDT_0 cannot be
+ * used: its Counter 0 match feeds the cascade and its Counter 1 match extends
+ * the time base. watchdog_supervisor.c also uses MCWDT_1. */
+#define TICKLESS_IDLE_MCWDT_HW              MCWDT_STRUCT1
+#define TICKLESS_IDLE_MCWDT_IRQ             srss_interrupt_mcwdt_1_IRQn
+
+/* Longest idle period in LFCLK cycles. A match must be programmed inside one
+ * turn of the 16-bit counter. */
+#define TICKLESS_IDLE_MAX_CYCLES            (0xFF00u)
+
+/* Priority of the MCWDT_1 interrupt */
+#define TICKLESS_IDLE_INTR_PRIORITY         (7u)
+
+/* The function Cy_MCWDT_Enable() waits for some delay in microseconds before
+ * returning */
+#define TICKLESS_IDLE_MCWDT_ENABLE_DELAY    (93u)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t sleeps;            /* Idle periods with the tick stopped        */
+    uint32_t early_wakeups;     /* Ended by another interrupt before the match */
+    uint32_t ticks_stepped;     /* Ticks returned for the RTOS to step       */
+    uint32_t ticks_corrected;   /* Of those, ticks the RTOS tick had lost    */
+} tickless_idle_stats_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t tickless_idle_init(uint32_t tick_count);
+uint32_t  tickless_idle_sleep(uint32_t tick_count, uint32_t expected_idle_ticks);
+uint64_t  tickless_idle_ticks_due(void);
+void      tickless_idle_get_stats(tickless_idle_stats_t *stats);
+
+
+#endif /* TICKLESS_IDLE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,214 @@
+/******************************************************************************
+* File Name:   timer_debounce.c
+*
+* Description: Debounce of the user button sampled on MCWDT_0 Counter 2 interrupts.
+*              The debounce state machine runs in the interrupt, so the CPU sleeps
+*              between samples instead of waiting in Cy_SysLib_Delay().
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "timer_debounce.h"
+#include "mcwdt_timebase.h"
+#include "mcwdt_irq.h"
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    TIMER_DEBOUNCE_RELEASED,    /* Released, waiting for a pressed sample      */
+    TIMER_DEBOUNCE_PRESSING,    /* Counting pressed samples                    */
+    TIMER_DEBOUNCE_HELD         /* Press reported, counting released samples   */
+} timer_debounce_state_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Debounced presses, each with the time base value of its first pressed
+ * sample */
+static timestamp_ring_t press_ring;
+
+/* Debounce state, used from the interrupt only */
+static timer_debounce_state_t debounce_state = TIMER_DEBOUNCE_RELEASED;
+static uint32_t run_length;
+static uint64_t press_count;
+
+
+/*******************************************************************************
+* Function Name: timer_debounce_isr
+********************************************************************************
+* Summary:
+*  MCWDT_0 Counter 2 handler. Samples the user button once and advances the
+*  debounce state machine. A sample at the other level restarts the count.
+*
+*******************************************************************************/
+static void timer_debounce_isr(void)
+{
+    bool pressed = (0UL == Cy_GPIO_Read(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM));
+
+    switch (debounce_state)
+    {
+        case TIMER_DEBOUNCE_RELEASED:
+            if (pressed)
+            {
+                press_count = mcwdt_timebase_read64();
+                run_length = 1u;
+                debounce_state = TIMER_DEBOUNCE_PRESSING;
+            }
+            break;
+
+        case TIMER_DEBOUNCE_PRESSING:
+            if (!pressed)
+            {
+                debounce_state = TIMER_DEBOUNCE_RELEASED;
+            }
+            else if (++run_length >= TIMER_DEBOUNCE_SAMPLES)
+            {
+                (void)timestamp_ring_push(&press_ring, press_count, 0u);
+                run_length = 0u;
+                debounce_state = TIMER_DEBOUNCE_HELD;
+            }
+            else
+            {
+                /* Still within the debounce period */
+            }
+            break;
+
+        case TIMER_DEBOUNCE_HELD:
+        default:
+            if (pressed)
+            {
+                run_length = 0u;
+            }
+            else if (++run_length >= TIMER_DEBOUNCE_SAMPLES)
+            {
+                debounce_state = TIMER_DEBOUNCE_RELEASED;
+            }
+            else
+            {
+                /* Still within the debounce period */
+            }
+            break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: timer_debounce_init
+********************************************************************************
+* Summary:
+*  Starts MCWDT_0 Counter 2 with its toggle interrupt sampling the user button.
+*  Counter 0 and Counter 1 must already be running and extended to 64 bits by
+*  mcwdt_timebase_init(). Counter 2 is also used by low_power.c and
+*  timer_wheel.c, so only one of the three can be used.
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the failing cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t timer_debounce_init(void)
+{
+    cy_rslt_t result;
+
+    debounce_state = TIMER_DEBOUNCE_RELEASED;
+    timestamp_ring_init(&press_ring);
+
+    result = mcwdt_irq_register(CY_MCWDT_CTR2, timer_debounce_isr);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    Cy_MCWDT_SetToggleBit(MCWDT_0_HW, TIMER_DEBOUNCE_TOGGLE_BIT);
+    Cy_MCWDT_SetMode(MCWDT_0_HW, CY_MCWDT_COUNTER2, CY_MCWDT_MODE_INT);
+    Cy_MCWDT_Enable(MCWDT_0_HW, CY_MCWDT_CTR2, TIMER_DEBOUNCE_MCWDT_ENABLE_DELAY);
+    mcwdt_irq_enable(CY_MCWDT_CTR2);
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: timer_debounce_get_press
+********************************************************************************
+* Summary:
+*  Takes the oldest debounced press from the queue and never blocks. Call
+*  again until it returns false.
+*
+* Parameters:
+*  timestamp: receives the time base value of the first pressed sample
+*
+* Return:
+*  bool: true if a debounced press is reported
+*
+*******************************************************************************/
+bool timer_debounce_get_press(uint64_t *timestamp)
+{
+    if (0u == timestamp_ring_count(&press_ring))
+    {
+        return false;
+    }
+
+    *timestamp = timestamp_record_time(timestamp_ring_at(&press_ring, 0u));
+    timestamp_ring_release(&press_ring, 1u);
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: timer_debounce_pending
+********************************************************************************
+* Summary:
+*  Reports whether debounced presses are queued. Otherwise nothing happens
+*  until the next Counter 2 interrupt and the CPU may sleep.
+*
+* Return:
+*  bool: true if timer_debounce_get_press() has a press to report
+*
+*******************************************************************************/
+bool timer_debounce_pending(void)
+{
+    return (0u != timestamp_ring_count(&press_ring));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,90 @@
+/******************************************************************************
+* File Name:   timer_debounce.h
+*
+* Description: Debounce of the user button sampled on MCWDT_0 Counter 2 interrupts.
+*              The debounce state machine runs in the interrupt, so the CPU sleeps
+*              between samples instead of waiting in Cy_SysLib_Delay().
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TIMER_DEBOUNCE_H
+#define TIMER_DEBOUNCE_H
+
+#include "cy_pdl.h"
+#include "switch_debounce.h"
+#include "timestamp_ring.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Counter 2 bit whose toggle samples the user button. Bit 8 toggles every 256
+ * LFCLK cycles (7.8 ms at 32768 Hz). */
+#ifndef TIMER_DEBOUNCE_TOGGLE_BIT
+#define TIMER_DEBOUNCE_TOGGLE_BIT           (8u)
+#endif
+
+/* LFCLK cycles between samples */
+#define TIMER_DEBOUNCE_SAMPLE_TICKS         (1u << TIMER_DEBOUNCE_TOGGLE_BIT)
+
+/* Consecutive samples at the new level needed to accept a press or release.
+ * The first and last of them are at least the period read_switch_status()
+ * uses apart. */
+#define TIMER_DEBOUNCE_SAMPLES              (1u + ((((SWITCH_DEBOUNCE_CHECK_UNIT * \
+                                                      SWITCH_DEBOUNCE_MAX_PERIOD_UNITS * \
+                                                      CY_SYSCLK_WCO_FREQ) / 1000u) + \
+                                                    TIMER_DEBOUNCE_SAMPLE_TICKS - 1u) / \
+                                                   TIMER_DEBOUNCE_SAMPLE_TICKS))
+
+/* The function Cy_MCWDT_Enable() waits for some delay in microseconds before
+ * returning */
+#define TIMER_DEBOUNCE_MCWDT_ENABLE_DELAY   (93u)
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t timer_debounce_init(void);
+bool      timer_debounce_get_press(uint64_t *timestamp);
+bool      timer_debounce_pending(void);
+
+
+#endif /* TIMER_DEBOUNCE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,395 @@
+/******************************************************************************
+* File Name:   timer_wheel.c
+*
+* Description: Hierarchical wheel of software timers ticked by the MCWDT_0 Counter 2
+*              interrupt. Arming, cancelling and expiring a timer each take constant
+*              time, however many timers are armed.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "timer_wheel.h"
+#include "mcwdt_timebase.h"
+#include "mcwdt_irq.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TIMER_WHEEL_SLOT_MASK               (TIMER_WHEEL_SLOTS - 1u)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Slot lists, circular with the slot itself as the head. A timer due in
+ * fewer than 64^(n+1) ticks is in level n, in the slot that wheel_tick
+ * reaches last before its expiry. */
+static timer_wheel_link_t wheel_slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+
+/* Last wheel tick processed */
+static uint64_t wheel_tick;
+
+/* Timers linked into the wheel */
+static uint32_t armed_count;
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_now
+********************************************************************************
+* Summary:
+*  Returns the wheel tick of the time base, rounded down.
+*
+*******************************************************************************/
+static uint64_t timer_wheel_now(void)
+{
+    return mcwdt_timebase_read64() >> TIMER_WHEEL_TOGGLE_BIT;
+}
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_unlink
+*******************************************************************************/
+static void timer_wheel_unlink(timer_wheel_timer_t *timer)
+{
+    timer->link.prev->next = timer->link.next;
+    timer->link.next->prev = timer->link.prev;
+    timer->link.next = NULL;
+    timer->link.prev = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_insert
+********************************************************************************
+* Summary:
+*  Links a timer into the slot for its expiry tick, which must not be before
+*  wheel_tick. A timer due on wheel_tick itself goes into the level 0 slot
+*  about to be processed. A timer too far ahead for the wheel goes into the
+*  last top-level slot of the current turn and is placed again when that slot
+*  is reached. Call with interrupts disabled.
+*
+* Parameters:
+*  timer: timer with its expiry tick set
+*
+*******************************************************************************/
+static void timer_wheel_insert(timer_wheel_timer_t *timer)
+{
+    timer_wheel_link_t *head;
+    uint64_t delta = timer->expires - wheel_tick;
+    uint32_t level;
+    uint32_t slot;
+
+    for (level = 0u; level < (TIMER_WHEEL_LEVELS - 1u); level++)
+    {
+        if (0u == (delta >> (TIMER_WHEEL_LEVEL_BITS * (level + 1u))))
+        {
+            break;
+        }
+    }
+
+    if (0u != (delta >> (TIMER_WHEEL_LEVEL_BITS * TIMER_WHEEL_LEVELS)))
+    {
+        slot = (uint32_t)((wheel_tick >> (TIMER_WHEEL_LEVEL_BITS * level)) - 1u) &
+               TIMER_WHEEL_SLOT_MASK;
+    }
+    else
+    {
+        slot = (uint32_t)(timer->expires >> (TIMER_WHEEL_LEVEL_BITS * level)) &
+               TIMER_WHEEL_SLOT_MASK;
+    }
+
+    head = &wheel_slots[level][slot];
+    timer->link.next = head;
+    timer->link.prev = head->prev;
+    head->prev->next = &timer->link;
+    head->prev = &timer->link;
+}
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_cascade
+********************************************************************************
+* Summary:
+*  Places again every timer of a slot that wheel_tick has just reached. Each
+*  one moves to a lower level, or expires on this tick.
+*
+* Parameters:
+*  level: level of the slot, at least 1
+*
+*******************************************************************************/
+static void timer_wheel_cascade(uint32_t level)
+{
+    uint32_t slot = (uint32_t)(wheel_tick >> (TIMER_WHEEL_LEVEL_BITS * level)) &
+                    TIMER_WHEEL_SLOT_MASK;
+    timer_wheel_link_t *head = &wheel_slots[level][slot];
+    timer_wheel_timer_t *timer;
+
+    while (head->next != head)
+    {
+        timer = (timer_wheel_timer_t *)head->next;
+        timer_wheel_unlink(timer);
+        timer_wheel_insert(timer);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_isr
+********************************************************************************
+* Summary:
+*  MCWDT_0 Counter 2 handler. Processes every wheel tick up to the time base,
+*  so ticks are not lost if the interrupt is held off. A periodic timer is
+*  linked back in for its next expiry before its callback runs, counted from
+*  the expiry rather than from now so that it does not drift. The interrupt
+*  is masked again once no timer is armed.
+*
+*******************************************************************************/
+static void timer_wheel_isr(void)
+{
+    uint64_t now = timer_wheel_now();
+    timer_wheel_link_t *head;
+    timer_wheel_timer_t *timer;
+    uint32_t level;
+
+    while (wheel_tick < now)
+    {
+        wheel_tick++;
+
+        for (level = 1u; level < TIMER_WHEEL_LEVELS; level++)
+        {
+            if (0u != (wheel_tick & ((1uLL << (TIMER_WHEEL_LEVEL_BITS * level)) - 1u)))
+            {
+                break;
+            }
+            timer_wheel_cascade(level);
+        }
+
+        head = &wheel_slots[0][wheel_tick & TIMER_WHEEL_SLOT_MASK];
+        while (head->next != head)
+        {
+            timer = (timer_wheel_timer_t *)head->next;
+            timer_wheel_unlink(timer);
+
+            if (0u != timer->period)
+            {
+                timer->expires += timer->period;
+                if (timer->expires <= wheel_tick)
+                {
+                    timer->expires = wheel_tick + 1u;
+                }
+                timer_wheel_insert(timer);
+            }
+            else
+            {
+                armed_count--;
+            }
+
+            timer->callback(timer, timer->context);
+        }
+    }
+
+    if (0u == armed_count)
+    {
+        mcwdt_irq_disable(CY_MCWDT_CTR2);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_init
+********************************************************************************
+* Summary:
+*  Starts MCWDT_0 Counter 2 as the wheel tick, with its interrupt masked until
+*  a timer is armed. Counter 0 and Counter 1 must already be running and
+*  extended to 64 bits by mcwdt_timebase_init(). Counter 2 is also used by
+*  low_power.c and timer_debounce.c, so only one of the three can be used.
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the failing cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t timer_wheel_init(void)
+{
+    cy_rslt_t result;
+    uint32_t level;
+    uint32_t slot;
+
+    for (level = 0u; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        for (slot = 0u; slot < TIMER_WHEEL_SLOTS; slot++)
+        {
+            wheel_slots[level][slot].next = &wheel_slots[level][slot];
+            wheel_slots[level][slot].prev = &wheel_slots[level][slot];
+        }
+    }
+    armed_count = 0u;
+    wheel_tick = timer_wheel_now();
+
+    result = mcwdt_irq_register(CY_MCWDT_CTR2, timer_wheel_isr);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    Cy_MCWDT_SetToggleBit(MCWDT_0_HW, TIMER_WHEEL_TOGGLE_BIT);
+    Cy_MCWDT_SetMode(MCWDT_0_HW, CY_MCWDT_COUNTER2, CY_MCWDT_MODE_INT);
+    Cy_MCWDT_Enable(MCWDT_0_HW, CY_MCWDT_CTR2, TIMER_WHEEL_MCWDT_ENABLE_DELAY);
+    mcwdt_irq_disable(CY_MCWDT_CTR2);
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_start
+********************************************************************************
+* Summary:
+*  Arms a timer, first cancelling it if it is armed. The callback runs in the
+*  MCWDT_0 interrupt at the first wheel tick at or after the delay has passed,
+*  so never early and at most about two ticks late. The timer may be
+*  restarted or cancelled from its own callback.
+*
+* Parameters:
+*  timer: timer storage, zeroed before first use, which must stay valid while
+*         the timer is armed
+*  delay: LFCLK cycles until the first expiry
+*  period: LFCLK cycles between later expiries, rounded up to whole wheel
+*          ticks, or 0 for a one-shot timer
+*  callback: function called on each expiry
+*  context: passed to the callback
+*
+*******************************************************************************/
+void timer_wheel_start(timer_wheel_timer_t *timer, uint32_t delay, uint32_t period,
+                       timer_wheel_callback_t callback, void *context)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    uint64_t now = mcwdt_timebase_read64();
+
+    if (NULL != timer->link.next)
+    {
+        timer_wheel_unlink(timer);
+        armed_count--;
+    }
+
+    /* Nothing is armed, so the wheel can jump straight to the present */
+    if (0u == armed_count)
+    {
+        wheel_tick = now >> TIMER_WHEEL_TOGGLE_BIT;
+    }
+
+    /* The slot for wheel_tick may already have been processed */
+    timer->expires = (now + delay + TIMER_WHEEL_TICK_CYCLES - 1u) >> TIMER_WHEEL_TOGGLE_BIT;
+    if (timer->expires <= wheel_tick)
+    {
+        timer->expires = wheel_tick + 1u;
+    }
+    timer->period = (uint32_t)(((uint64_t)period + TIMER_WHEEL_TICK_CYCLES - 1u) >>
+                               TIMER_WHEEL_TOGGLE_BIT);
+    timer->callback = callback;
+    timer->context = context;
+
+    timer_wheel_insert(timer);
+    armed_count++;
+    mcwdt_irq_enable(CY_MCWDT_CTR2);
+
+    Cy_SysLib_ExitCriticalSection(intr_status);
+}
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_cancel
+********************************************************************************
+* Summary:
+*  Disarms a timer. Does nothing if it is not armed.
+*
+* Parameters:
+*  timer: timer to disarm
+*
+*******************************************************************************/
+void timer_wheel_cancel(timer_wheel_timer_t *timer)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+
+    if (NULL != timer->link.next)
+    {
+        timer_wheel_unlink(timer);
+        armed_count--;
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_status);
+}
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_active
+********************************************************************************
+* Summary:
+*  Reports whether a timer is armed. A one-shot timer is disarmed just before
+*  its callback runs.
+*
+* Parameters:
+*  timer: timer to check
+*
+* Return:
+*  bool: true if the timer is armed
+*
+*******************************************************************************/
+bool timer_wheel_active(timer_wheel_timer_t const *timer)
+{
+    return (NULL != timer->link.next);
+}
+
+
+/*******************************************************************************
+* Function Name: timer_wheel_count
+********************************************************************************
+* Summary:
+*  Returns the number of armed timers.
+*
+* Return:
+*  uint32_t: armed timers
+*
+*******************************************************************************/
+uint32_t timer_wheel_count(void)
+{
+    return armed_count;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,116 @@
+/******************************************************************************
+* File Name:   timer_wheel.h
+*
+* Description: Hierarchical wheel of software timers ticked by the MCWDT_0 Counter 2
+*              interrupt. Arming, cancelling and expiring a timer each take constant
+*              time, however many timers are armed.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Counter 2 bit whose toggle is the wheel tick. Bit 5 toggles every 32 LFCLK
+ * cycles (0.98 ms at 32768 Hz). */
+#ifndef TIMER_WHEEL_TOGGLE_BIT
+#define TIMER_WHEEL_TOGGLE_BIT              (5u)
+#endif
+
+/* LFCLK cycles per wheel tick */
+#define TIMER_WHEEL_TICK_CYCLES             (1u << TIMER_WHEEL_TOGGLE_BIT)
+
+/* Each level has 2^TIMER_WHEEL_LEVEL_BITS slots, and one slot of a level
+ * spans a whole turn of the level below. Four levels of 64 slots cover 2^24
+ * ticks (4.5 hours with 1 ms ticks) before a timer has to be carried over. */
+#define TIMER_WHEEL_LEVEL_BITS              (6u)
+#define TIMER_WHEEL_SLOTS                   (1u << TIMER_WHEEL_LEVEL_BITS)
+#define TIMER_WHEEL_LEVELS                  (4u)
+
+/* The function Cy_MCWDT_Enable() waits for some delay in microseconds before
+ * returning */
+#define TIMER_WHEEL_MCWDT_ENABLE_DELAY      (93u)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct timer_wheel_link
+{
+    struct timer_wheel_link *next;
+    struct timer_wheel_link *prev;
+} timer_wheel_link_t;
+
+struct timer_wheel_timer;
+
+/* Called from the MCWDT_0 interrupt when the timer expires */
+typedef void (*timer_wheel_callback_t)(struct timer_wheel_timer *timer, void *context);
+
+/* One software timer. The caller owns the storage, zeroed before first use,
+ * so any number of timers can be armed; the wheel only links them into its
+ * slots. */
+typedef struct timer_wheel_timer
+{
+    timer_wheel_link_t link;            /* Must be first; NULL when idle */
+    uint64_t expires;                   /* Wheel tick of the next expiry */
+    uint32_t period;                    /* Wheel ticks; 0 for one-shot   */
+    timer_wheel_callback_t callback;
+    void *context;
+} timer_wheel_timer_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t timer_wheel_init(void);
+void      timer_wheel_start(timer_wheel_timer_t *timer, uint32_t delay, uint32_t period,
+                            timer_wheel_callback_t callback, void *context);
+void      timer_wheel_cancel(timer_wheel_timer_t *timer);
+bool      timer_wheel_active(timer_wheel_timer_t const *timer);
+uint32_t  timer_wheel_count(void);
+
+
+#endif /* TIMER_WHEEL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,200 @@
+/******************************************************************************
+* File Name:   timestamp_ring.c
+*
+* Description: Lock-free single-producer, single-consumer ring of timestamp
+*              records, passing events from an interrupt to the main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "timestamp_ring.h"
+
+
+/*******************************************************************************
+* Function Name: timestamp_ring_init
+********************************************************************************
+* Summary:
+*  Empties the ring and clears its statistics. Call before the producer is
+*  started.
+*
+* Parameters:
+*  ring: ring to initialize
+*
+*******************************************************************************/
+void timestamp_ring_init(timestamp_ring_t *ring)
+{
+    ring->head = 0u;
+    ring->tail = 0u;
+    ring->pushed = 0u;
+    ring->dropped = 0u;
+    ring->high_water = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: timestamp_ring_push
+********************************************************************************
+* Summary:
+*  Producer side: appends a record, or counts it as dropped if the ring is
+*  full. The record is written before the head index is advanced, so the
+*  consumer never sees a partly written record. Never blocks.
+*
+* Parameters:
+*  ring: ring to append to
+*  timestamp: 64-bit time base value of the event
+*  event: producer-defined event code
+*
+* Return:
+*  bool: true if the record was stored
+*
+*******************************************************************************/
+bool timestamp_ring_push(timestamp_ring_t *ring, uint64_t timestamp, uint32_t event)
+{
+    uint32_t head = ring->head;
+    uint32_t used = head - ring->tail;
+    timestamp_record_t *record;
+
+    if (used >= TIMESTAMP_RING_SIZE)
+    {
+        ring->dropped++;
+        return false;
+    }
+
+    record = &ring->records[head & (TIMESTAMP_RING_SIZE - 1u)];
+    record->timestamp_lo = (uint32_t)timestamp;
+    record->timestamp_hi = (uint32_t)(timestamp >> 32);
+    record->event = event;
+
+    /* Publish the record */
+    __DMB();
+    ring->head = head + 1u;
+
+    ring->pushed++;
+    if ((used + 1u) > ring->high_water)
+    {
+        ring->high_water = used + 1u;
+    }
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: timestamp_ring_count
+********************************************************************************
+* Summary:
+*  Consumer side: returns the number of records that can be read with
+*  timestamp_ring_at(). Records pushed later are not included, so a batch can
+*  be processed against one snapshot of the head index.
+*
+* Parameters:
+*  ring: ring to read
+*
+* Return:
+*  uint32_t: number of records available
+*
+*******************************************************************************/
+uint32_t timestamp_ring_count(timestamp_ring_t const *ring)
+{
+    uint32_t count = ring->head - ring->tail;
+
+    /* Records up to the head are complete */
+    __DMB();
+
+    return count;
+}
+
+
+/*******************************************************************************
+* Function Name: timestamp_ring_at
+********************************************************************************
+* Summary:
+*  Consumer side: returns a record of the current batch without removing it.
+*
+* Parameters:
+*  ring: ring to read
+*  index: 0 for the oldest record, less than timestamp_ring_count()
+*
+* Return:
+*  timestamp_record_t const *: the record, valid until it is released
+*
+*******************************************************************************/
+timestamp_record_t const *timestamp_ring_at(timestamp_ring_t const *ring, uint32_t index)
+{
+    return &ring->records[(ring->tail + index) & (TIMESTAMP_RING_SIZE - 1u)];
+}
+
+
+/*******************************************************************************
+* Function Name: timestamp_ring_release
+********************************************************************************
+* Summary:
+*  Consumer side: removes the oldest records, handing their slots back to the
+*  producer.
+*
+* Parameters:
+*  ring: ring to update
+*  count: number of records to remove, at most timestamp_ring_count()
+*
+*******************************************************************************/
+void timestamp_ring_release(timestamp_ring_t *ring, uint32_t count)
+{
+    /* Finish reading the records before the producer may overwrite them */
+    __DMB();
+    ring->tail += count;
+}
+
+
+/*******************************************************************************
+* Function Name: timestamp_ring_get_stats
+********************************************************************************
+* Summary:
+*  Returns the number of records pushed and dropped, and the high-water mark.
+*
+* Parameters:
+*  ring: ring to query
+*  stats: receives the statistics
+*
+*******************************************************************************/
+void timestamp_ring_get_stats(timestamp_ring_t const *ring, timestamp_ring_stats_t *stats)
+{
+    stats->pushed = ring->pushed;
+    stats->dropped = ring->dropped;
+    stats->high_water = ring->high_water;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,137 @@
+/******************************************************************************
+* File Name:   timestamp_ring.h
+*
+* Description: Lock-free single-producer, single-consumer ring of timestamp
+*              records, passing events from an interrupt to the main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TIMESTAMP_RING_H
+#define TIMESTAMP_RING_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Number of records per ring. Must be a power of two. */
+#ifndef TIMESTAMP_RING_SIZE
+#define TIMESTAMP_RING_SIZE                 (64u)
+#endif
+
+/* RAM that one ring may take, in bytes. 64 records of 12 bytes and the
+ * counters take 788 bytes. */
+#ifndef TIMESTAMP_RING_RAM_BUDGET
+#define TIMESTAMP_RING_RAM_BUDGET           (1024u)
+#endif
+
+#if ((TIMESTAMP_RING_SIZE == 0u) || ((TIMESTAMP_RING_SIZE & (TIMESTAMP_RING_SIZE - 1u)) != 0u))
+#error "TIMESTAMP_RING_SIZE must be a power of two"
+#endif
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* The time base value is split into two words, so that the record is 4-byte
+ * aligned and 12 bytes long rather than padded to 16. */
+typedef struct
+{
+    uint32_t timestamp_lo;  /* 64-bit time base value, low word      */
+    uint32_t timestamp_hi;  /* 64-bit time base value, high word     */
+    uint32_t event;         /* Meaning defined by the producer       */
+} timestamp_record_t;
+
+typedef struct
+{
+    uint32_t pushed;        /* Records accepted                      */
+    uint32_t dropped;       /* Records refused because ring was full */
+    uint32_t high_water;    /* Most records ever held at once        */
+} timestamp_ring_stats_t;
+
+/* Single-producer, single-consumer ring. The indices run freely and are
+ * reduced modulo the size on access. */
+typedef struct
+{
+    volatile uint32_t head;         /* Written by the producer only */
+    volatile uint32_t tail;         /* Written by the consumer only */
+    volatile uint32_t pushed;
+    volatile uint32_t dropped;
+    volatile uint32_t high_water;
+    timestamp_record_t records[TIMESTAMP_RING_SIZE];
+} timestamp_ring_t;
+
+_Static_assert(sizeof(timestamp_ring_t) <= TIMESTAMP_RING_RAM_BUDGET,
+               "TIMESTAMP_RING_SIZE exceeds TIMESTAMP_RING_RAM_BUDGET");
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void     timestamp_ring_init(timestamp_ring_t *ring);
+bool     timestamp_ring_push(timestamp_ring_t *ring, uint64_t timestamp, uint32_t event);
+uint32_t timestamp_ring_count(timestamp_ring_t const *ring);
+timestamp_record_t const *timestamp_ring_at(timestamp_ring_t const *ring, uint32_t index);
+void     timestamp_ring_release(timestamp_ring_t *ring, uint32_t count);
+void     timestamp_ring_get_stats(timestamp_ring_t const *ring, timestamp_ring_stats_t *stats);
+
+
+/*******************************************************************************
+* Function Name: timestamp_record_time
+********************************************************************************
+* Summary:
+*  Returns the 64-bit time base value of a record.
+*
+* Parameters:
+*  record: record returned by timestamp_ring_at()
+*
+* Return:
+*  uint64_t: time base value
+*
+*******************************************************************************/
+static inline uint64_t timestamp_record_time(timestamp_record_t const *record)
+{
+    return ((uint64_t)record->timestamp_hi << 32) | record->timestamp_lo;
+}
+
+
+#endif /* TIMESTAMP_RING_H */
+
+
+/* [] END OF FILE */
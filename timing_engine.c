@@ -0,0 +1,517 @@
+/******************************************************************************
+* File Name:   timing_engine.c
+*
+* Description: Hardware-independent timing engine: torn-free reads and 64-bit
+*              extension of the cascaded MCWDT counter, press capture from
+*              timestamped edges, and intervals between presses.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#include "timing_engine.h"
+#include "timing_hw.h"
+
+
+/*******************************************************************************
+* Function Name: timing_engine_read32
+********************************************************************************
+* Summary:
+*  Returns the 32-bit value of the Counter 1:Counter 0 cascade without tearing.
+*  Counter 1 is read on both sides of Counter 0. If it changed, Counter 0 wrapped
+*  in between and is read once more; the next wrap is 65536 LFCLK cycles away,
+*  so the second pair is always consistent. This takes three counter reads, or
+*  four within one LFCLK cycle of a wrap.
+*
+* Parameters:
+*  base: MCWDT block with Counter 0 cascaded into Counter 1
+*
+* Return:
+*  uint32_t: (Counter 1 << 16) | Counter 0
+*
+*******************************************************************************/
+uint32_t timing_engine_read32(MCWDT_STRUCT_Type const *base)
+{
+    uint32_t high = timing_hw_get_count(base, CY_MCWDT_COUNTER1);
+    uint32_t low = timing_hw_get_count(base, CY_MCWDT_COUNTER0);
+    uint32_t high_check = timing_hw_get_count(base, CY_MCWDT_COUNTER1);
+
+    if (high != high_check)
+    {
+        low = timing_hw_get_count(base, CY_MCWDT_COUNTER0);
+    }
+
+    return ((high_check << 16) | low);
+}
+
+
+/*******************************************************************************
+* Function Name: timing_engine_initial_halves
+********************************************************************************
+* Summary:
+*  Returns the half-range crossing count to start from, for a time base that
+*  is first read as 'count'.
+*
+* Parameters:
+*  count: 32-bit time base value
+*
+* Return:
+*  uint32_t: 1 in the upper half of the range, 0 in the lower half
+*
+*******************************************************************************/
+uint32_t timing_engine_initial_halves(uint32_t count)
+{
+    return (0u != (count & TIMING_ENGINE_UPPER_HALF)) ? 1u : 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_engine_half_match
+********************************************************************************
+* Summary:
+*  Returns the Counter 1 match value of the next half-range crossing, half a
+*  range (about 18 hours at 32.768 kHz) after the last one counted.
+*
+* Parameters:
+*  halves: half-range crossings counted so far
+*
+* Return:
+*  uint32_t: TIMING_ENGINE_WRAP_MATCH or TIMING_ENGINE_HALF_MATCH
+*
+*******************************************************************************/
+uint32_t timing_engine_half_match(uint32_t halves)
+{
+    return (0u != (halves & 1u)) ? TIMING_ENGINE_WRAP_MATCH : TIMING_ENGINE_HALF_MATCH;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_engine_extend
+********************************************************************************
+* Summary:
+*  Extends a 32-bit time base value to 64 bits with the number of half-range
+*  crossings counted before it was read.
+*
+*  If the crossing count is odd but the 32-bit value is back in its lower
+*  half, the wrap has happened and has not been counted yet; in every other
+*  combination the count already gives the upper 32 bits. This holds as long
+*  as crossings are counted within half a range of happening.
+*
+* Parameters:
+*  halves: half-range crossings counted, read before the counters
+*  count: 32-bit time base value
+*
+* Return:
+*  uint64_t: LFCLK cycles since the time base started at zero
+*
+*******************************************************************************/
+uint64_t timing_engine_extend(uint32_t halves, uint32_t count)
+{
+    uint32_t upper = halves >> 1;
+
+    if ((0u != (halves & 1u)) && (0u == (count & TIMING_ENGINE_UPPER_HALF)))
+    {
+        upper++;
+    }
+
+    return (((uint64_t)upper << 32) | count);
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_init
+********************************************************************************
+* Summary:
+*  Starts press capture with the switch released.
+*
+* Parameters:
+*  capture: capture state
+*  window: debounce window in ticks
+*
+*******************************************************************************/
+void timing_capture_init(timing_capture_t *capture, uint64_t window)
+{
+    capture->window = window;
+    capture->state = TIMING_CAPTURE_IDLE;
+    capture->press_count = 0u;
+    capture->last_edge_count = 0u;
+    capture->last_edge_level = 1u;
+    capture->burst_count = 0u;
+
+    capture->adaptive = false;
+    capture->in_burst = false;
+    capture->ceiling = window;
+    capture->margin = 0u;
+    capture->burst_gap = 0u;
+    capture->learned_gap = 0u;
+    capture->bursts = 0u;
+    capture->fallbacks = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_adapt
+********************************************************************************
+* Summary:
+*  Turns on adaptive debounce. The window given to timing_capture_init() is
+*  kept as the conservative window: it is used until
+*  TIMING_CAPTURE_ADAPT_BURSTS bursts of edges have been seen, and again after
+*  every fallback. From then on the window is the longest quiet gap seen
+*  inside a burst, plus half of it, plus 'margin', and never more than the
+*  conservative window.
+*
+* Parameters:
+*  capture: capture state, just initialized
+*  margin: least window in ticks, also added to the learned gap
+*
+*******************************************************************************/
+void timing_capture_adapt(timing_capture_t *capture, uint64_t margin)
+{
+    capture->adaptive = true;
+    capture->margin = (margin < capture->ceiling) ? margin : capture->ceiling;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_learn
+********************************************************************************
+* Summary:
+*  Called when the window after a burst of edges has run out: takes the
+*  longest gap of the burst into the learned gap, and shortens or lengthens
+*  the window to match once enough bursts have been seen.
+*
+*******************************************************************************/
+static void timing_capture_learn(timing_capture_t *capture)
+{
+    uint64_t decayed = capture->learned_gap -
+                       (capture->learned_gap >> TIMING_CAPTURE_ADAPT_DECAY_SHIFT);
+    uint64_t window;
+
+    capture->in_burst = false;
+    if (!capture->adaptive)
+    {
+        return;
+    }
+
+    capture->learned_gap = (capture->burst_gap > decayed) ? capture->burst_gap : decayed;
+    if (capture->bursts < TIMING_CAPTURE_ADAPT_BURSTS)
+    {
+        capture->bursts++;
+    }
+    if (capture->bursts >= TIMING_CAPTURE_ADAPT_BURSTS)
+    {
+        window = capture->learned_gap + (capture->learned_gap >> 1) + capture->margin;
+        capture->window = (window < capture->ceiling) ? window : capture->ceiling;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_edge
+********************************************************************************
+* Summary:
+*  Takes a switch edge, which restarts the debounce window. The first edge
+*  after the switch was stable released is the time of the press.
+*
+*  With adaptive debounce, an edge that starts a new burst less than the
+*  conservative window after the previous edge would have belonged to the
+*  previous burst: the learned window was too short for this switch, so the
+*  conservative window is restored until it has been learned again. The
+*  switch only bounces back to the level it is leaving, so the burst cut
+*  short still ends at the right level under the restored window.
+*
+* Parameters:
+*  capture: capture state
+*  timestamp: time base value at the edge
+*  level: pin level after the edge
+*
+*******************************************************************************/
+void timing_capture_edge(timing_capture_t *capture, uint64_t timestamp, uint32_t level)
+{
+    uint64_t gap = timestamp - capture->last_edge_count;
+
+    if (capture->in_burst)
+    {
+        capture->burst_gap = (gap > capture->burst_gap) ? gap : capture->burst_gap;
+    }
+    else
+    {
+        if (capture->adaptive && (capture->window < capture->ceiling) && (gap < capture->ceiling))
+        {
+            capture->learned_gap = (gap > capture->learned_gap) ? gap : capture->learned_gap;
+            capture->window = capture->ceiling;
+            capture->bursts = 0u;
+            capture->fallbacks++;
+        }
+        capture->in_burst = true;
+        capture->burst_gap = 0u;
+        capture->burst_count = timestamp;
+    }
+
+    if (TIMING_CAPTURE_IDLE == capture->state)
+    {
+        capture->press_count = timestamp;
+        capture->state = TIMING_CAPTURE_PENDING;
+    }
+    capture->last_edge_count = timestamp;
+    capture->last_edge_level = level;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_expired
+********************************************************************************
+* Summary:
+*  Reports whether a debounce window is open and has run out by 'now', so that
+*  the switch must be settled with timing_capture_settle().
+*
+* Parameters:
+*  capture: capture state
+*  now: time base value
+*
+* Return:
+*  bool: true if the window since the latest edge has run out
+*
+*******************************************************************************/
+bool timing_capture_expired(timing_capture_t const *capture, uint64_t now)
+{
+    return ((TIMING_CAPTURE_IDLE != capture->state) &&
+            ((now - capture->last_edge_count) >= capture->window));
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_settle
+********************************************************************************
+* Summary:
+*  Ends the debounce window that was open since the last edge, with the switch
+*  at the given level throughout. A press that bounced back before the window
+*  ended is discarded.
+*
+* Parameters:
+*  capture: capture state
+*  level: pin level at the end of the window
+*  timestamp: receives the time of the press edge if a press is reported
+*
+* Return:
+*  bool: true if a press is now reported
+*
+*******************************************************************************/
+bool timing_capture_settle(timing_capture_t *capture, uint32_t level, uint64_t *timestamp)
+{
+    uint64_t settled;
+    bool pressed = (TIMING_CAPTURE_EVENT_PRESS == timing_capture_settle_event(capture, level, &settled));
+
+    if (pressed)
+    {
+        *timestamp = settled;
+    }
+
+    return pressed;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_settle_event
+********************************************************************************
+* Summary:
+*  As timing_capture_settle(), and also reports the release of a reported
+*  press, timed from the first edge of the release.
+*
+* Parameters:
+*  capture: capture state
+*  level: pin level at the end of the window
+*  timestamp: receives the time of the press or release edge
+*
+* Return:
+*  timing_capture_event_t: the press or release now reported, if any
+*
+*******************************************************************************/
+timing_capture_event_t timing_capture_settle_event(timing_capture_t *capture, uint32_t level,
+                                                   uint64_t *timestamp)
+{
+    timing_capture_event_t event = TIMING_CAPTURE_EVENT_NONE;
+
+    if (capture->in_burst)
+    {
+        timing_capture_learn(capture);
+    }
+
+    if (TIMING_CAPTURE_PENDING == capture->state)
+    {
+        if (0UL == level)
+        {
+            capture->state = TIMING_CAPTURE_HELD;
+            *timestamp = capture->press_count;
+            event = TIMING_CAPTURE_EVENT_PRESS;
+        }
+        else
+        {
+            capture->state = TIMING_CAPTURE_IDLE;
+        }
+    }
+    else if ((TIMING_CAPTURE_HELD == capture->state) && (0UL != level))
+    {
+        capture->state = TIMING_CAPTURE_IDLE;
+        *timestamp = capture->burst_count;
+        event = TIMING_CAPTURE_EVENT_RELEASE;
+    }
+    else
+    {
+        /* Idle, or still held: nothing to do until the next edge */
+    }
+
+    return event;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_poll
+********************************************************************************
+* Summary:
+*  Settles the switch at its current level if the debounce window has run out
+*  by 'now' with no edge queued after the latest one. The button is read only
+*  then.
+*
+* Parameters:
+*  capture: capture state
+*  now: time base value, read after the last edge was taken
+*  timestamp: receives the time of the press edge if a press is reported
+*
+* Return:
+*  bool: true if a press is now reported
+*
+*******************************************************************************/
+bool timing_capture_poll(timing_capture_t *capture, uint64_t now, uint64_t *timestamp)
+{
+    return (timing_capture_expired(capture, now) &&
+            timing_capture_settle(capture, timing_hw_read_button(), timestamp));
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_poll_event
+********************************************************************************
+* Summary:
+*  As timing_capture_poll(), and also reports the release of a reported press.
+*
+* Parameters:
+*  capture: capture state
+*  now: time base value, read after the last edge was taken
+*  timestamp: receives the time of the press or release edge
+*
+* Return:
+*  timing_capture_event_t: the press or release now reported, if any
+*
+*******************************************************************************/
+timing_capture_event_t timing_capture_poll_event(timing_capture_t *capture, uint64_t now,
+                                                 uint64_t *timestamp)
+{
+    return timing_capture_expired(capture, now) ?
+               timing_capture_settle_event(capture, timing_hw_read_button(), timestamp) :
+               TIMING_CAPTURE_EVENT_NONE;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_capture_busy
+********************************************************************************
+* Summary:
+*  Reports whether a press or a release is being debounced. Otherwise nothing
+*  happens until the next edge.
+*
+* Parameters:
+*  capture: capture state
+*
+* Return:
+*  bool: true while a debounce window is open
+*
+*******************************************************************************/
+bool timing_capture_busy(timing_capture_t const *capture)
+{
+    return ((TIMING_CAPTURE_PENDING == capture->state) ||
+            ((TIMING_CAPTURE_HELD == capture->state) && (0UL != capture->last_edge_level)));
+}
+
+
+/*******************************************************************************
+* Function Name: timing_interval_init
+********************************************************************************
+* Summary:
+*  Starts timing presses, with the first one timed from 'start'.
+*
+* Parameters:
+*  intervals: interval state
+*  start: time base value at start-up
+*
+*******************************************************************************/
+void timing_interval_init(timing_interval_t *intervals, uint64_t start)
+{
+    intervals->last = start;
+    intervals->pressed = false;
+}
+
+
+/*******************************************************************************
+* Function Name: timing_interval_press
+********************************************************************************
+* Summary:
+*  Returns the ticks from the previous press, or from start-up for the first
+*  press. The 64-bit time base only moves forward, so the difference is always
+*  the elapsed time.
+*
+* Parameters:
+*  intervals: interval state
+*  press: time base value of the press
+*  ticks: receives the ticks since the previous press or start-up
+*
+* Return:
+*  bool: true if there was a previous press, false for the first one
+*
+*******************************************************************************/
+bool timing_interval_press(timing_interval_t *intervals, uint64_t press, uint64_t *ticks)
+{
+    bool previous = intervals->pressed;
+
+    *ticks = press - intervals->last;
+    intervals->last = press;
+    intervals->pressed = true;
+
+    return previous;
+}
+
+
+/* [] END OF FILE */
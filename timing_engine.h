@@ -0,0 +1,155 @@
+/******************************************************************************
+* File Name:   timing_engine.h
+*
+* Description: Hardware-independent timing engine: torn-free reads and 64-bit
+*              extension of the cascaded MCWDT counter, press capture from
+*              timestamped edges, and intervals between presses.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef TIMING_ENGINE_H
+#define TIMING_ENGINE_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Counter 1 match values at which the 32-bit time base crosses half of its
+ * range and wraps */
+#define TIMING_ENGINE_HALF_MATCH            (0x8000u)
+#define TIMING_ENGINE_WRAP_MATCH            (0x0000u)
+
+/* Set in a 32-bit time base value in the upper half of its range */
+#define TIMING_ENGINE_UPPER_HALF            (0x80000000u)
+
+/* Adaptive debounce: bursts of edges observed at the conservative window
+ * before it is first shortened, and again after each fallback */
+#ifndef TIMING_CAPTURE_ADAPT_BURSTS
+#define TIMING_CAPTURE_ADAPT_BURSTS         (8u)
+#endif
+
+/* Adaptive debounce: the learned bounce gap decays by 1/2^shift of itself per
+ * burst, so that a switch that has become cleaner earns a shorter window */
+#ifndef TIMING_CAPTURE_ADAPT_DECAY_SHIFT
+#define TIMING_CAPTURE_ADAPT_DECAY_SHIFT    (6u)
+#endif
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    TIMING_CAPTURE_IDLE,        /* Released, waiting for a press edge          */
+    TIMING_CAPTURE_PENDING,     /* Press edge seen, debounce window running    */
+    TIMING_CAPTURE_HELD         /* Press reported, waiting for a stable release */
+} timing_capture_state_t;
+
+typedef enum
+{
+    TIMING_CAPTURE_EVENT_NONE,
+    TIMING_CAPTURE_EVENT_PRESS,     /* Stable pressed after being released     */
+    TIMING_CAPTURE_EVENT_RELEASE    /* Stable released after a reported press  */
+} timing_capture_event_t;
+
+/* Debounce of timestamped button edges. A press is reported once the switch
+ * has been stable in the pressed state for the window after its last edge,
+ * with the time of its first edge; the release is then debounced the same way
+ * before the next press can be captured.
+ *
+ * With adaptive debounce, the window is learned from the longest quiet gap
+ * between the edges of a burst, and falls back to the conservative window
+ * when a burst turns out to have been cut short. */
+typedef struct
+{
+    uint64_t window;                /* Debounce window in ticks               */
+    timing_capture_state_t state;
+    uint64_t press_count;           /* Time of the first edge of the press    */
+    uint64_t last_edge_count;       /* Time and pin level at the latest edge  */
+    uint32_t last_edge_level;
+    uint64_t burst_count;           /* Time of the first edge of the burst    */
+
+    bool     adaptive;
+    bool     in_burst;              /* Edges since the window last ran out    */
+    uint64_t ceiling;               /* Conservative window in ticks           */
+    uint64_t margin;                /* Added to the learned gap, in ticks     */
+    uint64_t burst_gap;             /* Longest gap of the current burst       */
+    uint64_t learned_gap;           /* Longest gap seen, decaying             */
+    uint32_t bursts;                /* Bursts observed since the last fallback */
+    uint32_t fallbacks;
+} timing_capture_t;
+
+/* Intervals between presses. The first press is timed from start-up. */
+typedef struct
+{
+    uint64_t last;                  /* Time of the previous press or start-up */
+    bool     pressed;               /* A press has been seen since start-up   */
+} timing_interval_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t timing_engine_read32(MCWDT_STRUCT_Type const *base);
+uint32_t timing_engine_initial_halves(uint32_t count);
+uint32_t timing_engine_half_match(uint32_t halves);
+uint64_t timing_engine_extend(uint32_t halves, uint32_t count);
+
+void     timing_capture_init(timing_capture_t *capture, uint64_t window);
+void     timing_capture_adapt(timing_capture_t *capture, uint64_t margin);
+void     timing_capture_edge(timing_capture_t *capture, uint64_t timestamp, uint32_t level);
+bool     timing_capture_expired(timing_capture_t const *capture, uint64_t now);
+bool     timing_capture_settle(timing_capture_t *capture, uint32_t level, uint64_t *timestamp);
+timing_capture_event_t timing_capture_settle_event(timing_capture_t *capture, uint32_t level,
+                                                   uint64_t *timestamp);
+bool     timing_capture_poll(timing_capture_t *capture, uint64_t now, uint64_t *timestamp);
+timing_capture_event_t timing_capture_poll_event(timing_capture_t *capture, uint64_t now,
+                                                 uint64_t *timestamp);
+bool     timing_capture_busy(timing_capture_t const *capture);
+
+void     timing_interval_init(timing_interval_t *intervals, uint64_t start);
+bool     timing_interval_press(timing_interval_t *intervals, uint64_t press, uint64_t *ticks);
+
+
+#endif /* TIMING_ENGINE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,115 @@
+/******************************************************************************
+* File Name:   timing_hw.h
+*
+* Description: Hardware seam of the timing engine: the MCWDT counter and user
+*              button reads it makes, bound at compile time to the PDL or to a
+*              test's mock.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef TIMING_HW_H
+#define TIMING_HW_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Hardware binding
+********************************************************************************
+* timing_engine.c reads the hardware only through the two functions below. By
+* default they are inline calls of the PDL, so the target build compiles to
+* the same register reads as calling the PDL directly. A unit test builds the
+* engine with TIMING_HW_MOCK defined, and provides timing_hw_mock_get_count()
+* and timing_hw_mock_read_button() instead; no other code changes.
+*******************************************************************************/
+#if defined(TIMING_HW_MOCK)
+
+uint32_t timing_hw_mock_get_count(MCWDT_STRUCT_Type const *base, cy_en_mcwdtcounter_t counter);
+uint32_t timing_hw_mock_read_button(void);
+
+#define timing_hw_get_count(base, counter)  timing_hw_mock_get_count((base), (counter))
+#define timing_hw_read_button()             timing_hw_mock_read_button()
+
+#else
+
+#include "cybsp.h"
+
+
+/*******************************************************************************
+* Function Name: timing_hw_get_count
+********************************************************************************
+* Summary:
+*  Returns the current value of one MCWDT counter.
+*
+* Parameters:
+*  base: MCWDT block
+*  counter: counter of the block
+*
+* Return:
+*  uint32_t: counter value
+*
+*******************************************************************************/
+static inline uint32_t timing_hw_get_count(MCWDT_STRUCT_Type const *base,
+                                           cy_en_mcwdtcounter_t counter)
+{
+    return Cy_MCWDT_GetCount(base, counter);
+}
+
+
+/*******************************************************************************
+* Function Name: timing_hw_read_button
+********************************************************************************
+* Summary:
+*  Returns the level of the user button pin, 0 while pressed.
+*
+* Return:
+*  uint32_t: pin level
+*
+*******************************************************************************/
+static inline uint32_t timing_hw_read_button(void)
+{
+    return Cy_GPIO_Read(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM);
+}
+
+#endif /* TIMING_HW_MOCK */
+
+
+#endif /* TIMING_HW_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,391 @@
+/******************************************************************************
+* File Name:   watchdog_supervisor.c
+*
+* Description: Windowed watchdog on MCWDT_1 with an early warning stage. Counter 1
+*              resets the device a period after one passes without a feed, and
+*              Counter 0 times a check when the window opens and a warning before
+*              the reset.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "watchdog_supervisor.h"
+#include "mcwdt_timebase.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Marks a valid record in the fault storage, which is not initialized at
+ * start-up */
+#define WATCHDOG_SUPERVISOR_FAULT_MAGIC     (0x57445346UL)
+
+/* Words of the exception frame stacked on interrupt entry */
+#define WATCHDOG_SUPERVISOR_FRAME_LR        (5u)
+#define WATCHDOG_SUPERVISOR_FRAME_PC        (6u)
+#define WATCHDOG_SUPERVISOR_FRAME_XPSR      (7u)
+#define WATCHDOG_SUPERVISOR_FRAME_WORDS     (8u)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t magic;
+    watchdog_supervisor_fault_t fault;
+} watchdog_supervisor_record_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+/* Not static: watchdog_supervisor_isr() branches to it by name, which a
+ * symbol local to this file does not guarantee under LTO or with one
+ * section per function */
+void watchdog_supervisor_check(uint32_t const *frame) CY_USED;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Counter 1 is the watchdog: its match sets the interrupt at the start of
+ * every period, and the third match without a feed in between resets the
+ * device, so a period that is not fed is followed by one more before the
+ * reset. Counter 0 counts freely; its match is moved to each check. Both
+ * count LFCLK from the same enable, so they stay in step. */
+static const cy_stc_mcwdt_config_t supervisor_mcwdt_config =
+{
+    .c0Match = 0xFFFFu,
+    .c1Match = WATCHDOG_SUPERVISOR_PERIOD_CYCLES - 1u,
+    .c0Mode = CY_MCWDT_MODE_INT,
+    .c1Mode = CY_MCWDT_MODE_INT_RESET,
+    .c2ToggleBit = 0u,
+    .c2Mode = CY_MCWDT_MODE_NONE,
+    .c0ClearOnMatch = false,
+    .c1ClearOnMatch = true,
+    .c0c1Cascade = false,
+    .c1c2Cascade = false,
+};
+
+volatile bool watchdog_supervisor_window_open;
+volatile bool watchdog_supervisor_fed;
+
+/* The last fault, kept across the reset it causes */
+CY_NOINIT static watchdog_supervisor_record_t supervisor_record;
+
+static watchdog_supervisor_warning_t supervisor_warning;
+static watchdog_supervisor_window_t supervisor_window;
+
+/* Returned by the window callback of the current period */
+static uint32_t supervisor_detail;
+
+/* Counter 0 value and kind of the next check */
+static uint32_t check_match;
+static bool check_open;
+
+/* A warning has been recorded and not followed by a feed yet */
+static bool supervisor_warned;
+
+
+/*******************************************************************************
+* Function Name: watchdog_supervisor_isr
+********************************************************************************
+* Summary:
+*  MCWDT_1 handler. On Arm builds with GCC or Arm Compiler 6 it passes the
+*  exception frame of the interrupted code, from the stack it was using, to
+*  watchdog_supervisor_check().
+*
+*******************************************************************************/
+#if defined(__GNUC__) && defined(__ARM_ARCH_7EM__)
+__attribute__((naked)) static void watchdog_supervisor_isr(void)
+{
+    __asm volatile(
+        "tst   lr, #4                       \n"
+        "ite   eq                           \n"
+        "mrseq r0, msp                      \n"
+        "mrsne r0, psp                      \n"
+        "b     watchdog_supervisor_check    \n");
+}
+#else
+static void watchdog_supervisor_isr(void)
+{
+    watchdog_supervisor_check(NULL);
+}
+#endif
+
+
+/*******************************************************************************
+* Function Name: watchdog_supervisor_fault
+********************************************************************************
+* Summary:
+*  Records a fault with the interrupted context and the time base value,
+*  where it survives a reset, and calls the warning callback.
+*
+* Parameters:
+*  cause: what the check found
+*  frame: exception frame of the interrupted code, or NULL
+*
+*******************************************************************************/
+static void watchdog_supervisor_fault(watchdog_supervisor_cause_t cause, uint32_t const *frame)
+{
+    watchdog_supervisor_fault_t *fault = &supervisor_record.fault;
+
+    fault->cause = cause;
+    fault->timestamp = mcwdt_timebase_read64();
+    fault->detail = supervisor_detail;
+    fault->pc = 0u;
+    fault->lr = 0u;
+    fault->xpsr = 0u;
+    fault->sp = 0u;
+    if (NULL != frame)
+    {
+        fault->pc = frame[WATCHDOG_SUPERVISOR_FRAME_PC];
+        fault->lr = frame[WATCHDOG_SUPERVISOR_FRAME_LR];
+        fault->xpsr = frame[WATCHDOG_SUPERVISOR_FRAME_XPSR];
+        fault->sp = (uint32_t)(uintptr_t)(frame + WATCHDOG_SUPERVISOR_FRAME_WORDS);
+    }
+    supervisor_record.magic = WATCHDOG_SUPERVISOR_FAULT_MAGIC;
+
+    if (NULL != supervisor_warning)
+    {
+        supervisor_warning(fault);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: watchdog_supervisor_check
+********************************************************************************
+* Summary:
+*  Runs at the two checks of every period. When the window opens, the Counter
+*  1 interrupt must still be set: if it is clear, the watchdog was fed early,
+*  and the device is reset at once. Otherwise the window callback, if any,
+*  decides whether to feed now. At the warning point it must be clear: if
+*  it is set, the fault is recorded, and the MCWDT resets the device at the
+*  end of the next period unless the watchdog is fed before then. The
+*  record is dropped at the first window opening after such a feed; until
+*  then, a starved period does not warn again.
+*
+* Parameters:
+*  frame: exception frame of the interrupted code, or NULL
+*
+*******************************************************************************/
+void watchdog_supervisor_check(uint32_t const *frame)
+{
+    bool fed = (0u == (Cy_MCWDT_GetInterruptStatus(WATCHDOG_SUPERVISOR_MCWDT_HW) & CY_MCWDT_CTR1));
+    bool open = check_open;
+    bool fed_since_open = watchdog_supervisor_fed;
+
+    Cy_MCWDT_ClearInterrupt(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_CTR0);
+
+    check_match += open ? (WATCHDOG_SUPERVISOR_WARN_CYCLES - WATCHDOG_SUPERVISOR_OPEN_CYCLES) :
+                          (WATCHDOG_SUPERVISOR_PERIOD_CYCLES - WATCHDOG_SUPERVISOR_WARN_CYCLES +
+                           WATCHDOG_SUPERVISOR_OPEN_CYCLES);
+    check_open = !open;
+    Cy_MCWDT_SetMatch(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_COUNTER0, check_match & 0xFFFFu, 0u);
+
+    if (open)
+    {
+        watchdog_supervisor_fed = false;
+        supervisor_detail = 0u;
+        if (fed)
+        {
+            watchdog_supervisor_fault(WATCHDOG_SUPERVISOR_FAULT_EARLY_FEED, frame);
+            NVIC_SystemReset();
+        }
+
+        /* A warning of the last period was followed by a feed in time */
+        if (supervisor_warned && fed_since_open)
+        {
+            supervisor_warned = false;
+            supervisor_record.magic = 0u;
+        }
+
+        if (NULL == supervisor_window)
+        {
+            watchdog_supervisor_window_open = true;
+        }
+        else
+        {
+            supervisor_detail = supervisor_window();
+            if (0u == supervisor_detail)
+            {
+                watchdog_supervisor_feed();
+            }
+        }
+    }
+    else if (!fed && !supervisor_warned)
+    {
+        supervisor_warned = true;
+        watchdog_supervisor_fault(WATCHDOG_SUPERVISOR_FAULT_STARVED, frame);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: watchdog_supervisor_init
+********************************************************************************
+* Summary:
+*  Starts the supervisor. The MCWDT_0 time base must already be running. If
+*  the window of the current period has not opened yet, the application must
+*  feed it in this period, as in any other.
+*
+* Parameters:
+*  warning: called from the supervisor interrupt on a fault, or NULL
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, or the failing cy_en_mcwdt_status_t or
+*             cy_en_sysint_status_t
+*
+*******************************************************************************/
+cy_rslt_t watchdog_supervisor_init(watchdog_supervisor_warning_t warning)
+{
+    static const cy_stc_sysint_t supervisor_intr_config =
+    {
+        .intrSrc = WATCHDOG_SUPERVISOR_MCWDT_IRQ,
+        .intrPriority = WATCHDOG_SUPERVISOR_INTR_PRIORITY
+    };
+    cy_en_mcwdt_status_t mcwdt_status;
+    cy_en_sysint_status_t status;
+    uint32_t c0;
+    uint32_t c1;
+
+    supervisor_warning = warning;
+    supervisor_window = NULL;
+    supervisor_detail = 0u;
+    supervisor_warned = false;
+    watchdog_supervisor_window_open = false;
+    watchdog_supervisor_fed = false;
+
+    mcwdt_status = Cy_MCWDT_Init(WATCHDOG_SUPERVISOR_MCWDT_HW, &supervisor_mcwdt_config);
+    if (CY_MCWDT_SUCCESS != mcwdt_status)
+    {
+        return (cy_rslt_t)mcwdt_status;
+    }
+    Cy_MCWDT_SetInterruptMask(WATCHDOG_SUPERVISOR_MCWDT_HW, 0u);
+    Cy_MCWDT_ClearInterrupt(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_CTR0 | CY_MCWDT_CTR1);
+
+    status = Cy_SysInt_Init(&supervisor_intr_config, watchdog_supervisor_isr);
+    if (CY_SYSINT_SUCCESS != status)
+    {
+        return (cy_rslt_t)status;
+    }
+    NVIC_ClearPendingIRQ(WATCHDOG_SUPERVISOR_MCWDT_IRQ);
+    NVIC_EnableIRQ(WATCHDOG_SUPERVISOR_MCWDT_IRQ);
+
+    Cy_MCWDT_Enable(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_CTR0 | CY_MCWDT_CTR1,
+                    WATCHDOG_SUPERVISOR_MCWDT_ENABLE_DELAY);
+
+    /* Read both counters on the same LFCLK cycle */
+    do
+    {
+        c1 = Cy_MCWDT_GetCount(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_COUNTER1);
+        c0 = Cy_MCWDT_GetCount(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_COUNTER0);
+    } while (c1 != Cy_MCWDT_GetCount(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_COUNTER1));
+
+    /* Treat the current period as started if its window is still to open */
+    if (c1 < WATCHDOG_SUPERVISOR_OPEN_CYCLES)
+    {
+        Cy_MCWDT_SetInterrupt(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_CTR1);
+        check_match = c0 + (WATCHDOG_SUPERVISOR_OPEN_CYCLES - c1);
+    }
+    else
+    {
+        check_match = c0 + (WATCHDOG_SUPERVISOR_PERIOD_CYCLES - c1) + WATCHDOG_SUPERVISOR_OPEN_CYCLES;
+    }
+    check_open = true;
+
+    Cy_MCWDT_SetMatch(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_COUNTER0, check_match & 0xFFFFu, 0u);
+    Cy_MCWDT_SetInterruptMask(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_CTR0);
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: watchdog_supervisor_set_window
+********************************************************************************
+* Summary:
+*  Moves the feeding into the supervisor interrupt: from the next window on,
+*  the callback decides when the window opens, and
+*  watchdog_supervisor_service() is no longer needed.
+*
+* Parameters:
+*  window: window callback, or NULL to feed from watchdog_supervisor_service()
+*
+*******************************************************************************/
+void watchdog_supervisor_set_window(watchdog_supervisor_window_t window)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+
+    supervisor_window = window;
+    Cy_SysLib_ExitCriticalSection(intr_status);
+}
+
+
+/*******************************************************************************
+* Function Name: watchdog_supervisor_get_fault
+********************************************************************************
+* Summary:
+*  Returns the fault that caused the last reset, if the supervisor caused it,
+*  and forgets it. Call at start-up, before or after watchdog_supervisor_init().
+*
+* Parameters:
+*  fault: receives the fault
+*
+* Return:
+*  bool: true if there was one
+*
+*******************************************************************************/
+bool watchdog_supervisor_get_fault(watchdog_supervisor_fault_t *fault)
+{
+    if (WATCHDOG_SUPERVISOR_FAULT_MAGIC != supervisor_record.magic)
+    {
+        return false;
+    }
+
+    *fault = supervisor_record.fault;
+    supervisor_record.magic = 0u;
+
+    return true;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,182 @@
+/******************************************************************************
+* File Name:   watchdog_supervisor.h
+*
+* Description: Interface of the windowed watchdog supervisor on MCWDT_1.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WATCHDOG_SUPERVISOR_H
+#define WATCHDOG_SUPERVISOR_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* MCWDT block of the supervisor. Counter 1 is the watchdog and Counter 0
+ * times the checks in each window. MCWDT_0 is taken by the time base, and
+ * tickless_idle.c also uses MCWDT_1, so the two cannot be used together. */
+#define WATCHDOG_SUPERVISOR_MCWDT_HW        MCWDT_STRUCT1
+#define WATCHDOG_SUPERVISOR_MCWDT_IRQ       srss_interrupt_mcwdt_1_IRQn
+
+/* Watchdog period in LFCLK cycles, at most 65536. Each period the
+ * application must feed once, after the window opens. */
+#ifndef WATCHDOG_SUPERVISOR_PERIOD_CYCLES
+#define WATCHDOG_SUPERVISOR_PERIOD_CYCLES   (32768u)
+#endif
+
+/* Cycles into each period at which the window opens (250 ms). A feed before
+ * this point is a fault, and the supervisor resets the device. */
+#ifndef WATCHDOG_SUPERVISOR_OPEN_CYCLES
+#define WATCHDOG_SUPERVISOR_OPEN_CYCLES     (8192u)
+#endif
+
+/* Cycles into each period of the early warning (875 ms). If the window has
+ * not been fed by then, the warning captures the interrupted context. The
+ * MCWDT resets the device on its third unhandled match, at the end of the
+ * next period, unless the watchdog is fed before then. */
+#ifndef WATCHDOG_SUPERVISOR_WARN_CYCLES
+#define WATCHDOG_SUPERVISOR_WARN_CYCLES     (28672u)
+#endif
+
+#if (WATCHDOG_SUPERVISOR_PERIOD_CYCLES > 65536u) || \
+    (WATCHDOG_SUPERVISOR_OPEN_CYCLES >= WATCHDOG_SUPERVISOR_WARN_CYCLES) || \
+    (WATCHDOG_SUPERVISOR_WARN_CYCLES >= WATCHDOG_SUPERVISOR_PERIOD_CYCLES)
+#error "Watchdog supervisor window does not fit its period"
+#endif
+
+/* Priority of the MCWDT_1 interrupt. It is above the other interrupts of the
+ * application, so that a handler that hangs is caught too. */
+#define WATCHDOG_SUPERVISOR_INTR_PRIORITY   (1u)
+
+/* The function Cy_MCWDT_Enable() waits for some delay in microseconds before
+ * returning */
+#define WATCHDOG_SUPERVISOR_MCWDT_ENABLE_DELAY  (93u)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    WATCHDOG_SUPERVISOR_FAULT_NONE = 0,
+    WATCHDOG_SUPERVISOR_FAULT_STARVED,      /* Not fed by the warning point */
+    WATCHDOG_SUPERVISOR_FAULT_EARLY_FEED    /* Fed before the window opened */
+} watchdog_supervisor_cause_t;
+
+/* Captured by the supervisor interrupt. The registers are those stacked on
+ * entry, so they show the code that was running; they are 0 in builds that
+ * cannot capture them. */
+typedef struct
+{
+    watchdog_supervisor_cause_t cause;
+    uint64_t timestamp;         /* MCWDT_0 time base at detection */
+    uint32_t detail;            /* From the window callback of the period */
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t xpsr;
+    uint32_t sp;
+} watchdog_supervisor_fault_t;
+
+/* Called from the supervisor interrupt before the reset */
+typedef void (*watchdog_supervisor_warning_t)(watchdog_supervisor_fault_t const *fault);
+
+/* Called from the supervisor interrupt when the window opens. Returns 0 to
+ * feed the watchdog there, or a nonzero detail for the fault record. */
+typedef uint32_t (*watchdog_supervisor_window_t)(void);
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Set when the window opens without a window callback, cleared by
+ * watchdog_supervisor_service() */
+extern volatile bool watchdog_supervisor_window_open;
+
+/* Set by watchdog_supervisor_feed(), cleared when the window opens */
+extern volatile bool watchdog_supervisor_fed;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t watchdog_supervisor_init(watchdog_supervisor_warning_t warning);
+void      watchdog_supervisor_set_window(watchdog_supervisor_window_t window);
+bool      watchdog_supervisor_get_fault(watchdog_supervisor_fault_t *fault);
+
+
+/*******************************************************************************
+* Function Name: watchdog_supervisor_feed
+********************************************************************************
+* Summary:
+*  Feeds the watchdog: one write that clears the Counter 1 interrupt set at
+*  the start of the period. A feed before the window opens is found by the
+*  window-open check; another feed in the same window does nothing.
+*
+*******************************************************************************/
+static inline void watchdog_supervisor_feed(void)
+{
+    Cy_MCWDT_ClearInterrupt(WATCHDOG_SUPERVISOR_MCWDT_HW, CY_MCWDT_CTR1);
+    watchdog_supervisor_fed = true;
+}
+
+
+/*******************************************************************************
+* Function Name: watchdog_supervisor_service
+********************************************************************************
+* Summary:
+*  Feeds the watchdog once the window is open. Call on every pass of the main
+*  loop; the window-open interrupt wakes the CPU from sleep.
+*
+*******************************************************************************/
+static inline void watchdog_supervisor_service(void)
+{
+    if (watchdog_supervisor_window_open)
+    {
+        watchdog_supervisor_window_open = false;
+        watchdog_supervisor_feed();
+    }
+}
+
+
+#endif /* WATCHDOG_SUPERVISOR_H */
+
+
+/* [] END OF FILE */
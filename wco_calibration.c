@@ -0,0 +1,308 @@
+/******************************************************************************
+* File Name:   wco_calibration.c
+*
+* Description: Measures the frequency error of the WCO against a reference clock and
+*              corrects intervals counted by the MCWDT time base. Reference points pair a
+*              reference time with the time base value at the same instant; the host can
+*              send them over the debug UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cybsp.h"
+#include "wco_calibration.h"
+#include "log_sink.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define WCO_CALIBRATION_US_PER_S            (1000000u)
+
+/* Digits of a reference time that fit in 64 bits */
+#define WCO_CALIBRATION_MAX_DIGITS          (19u)
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/* Reference time and time base value at the same instant */
+typedef struct
+{
+    uint64_t reference_us;
+    uint64_t timebase;
+} wco_calibration_point_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Reference points, oldest first from point_first; point_count are valid */
+static wco_calibration_point_t points[WCO_CALIBRATION_POINTS];
+static uint32_t point_first;
+static uint32_t point_count;
+
+static wco_calibration_stats_t cal_stats;
+
+/* Reference time line being received */
+static bool parse_active;
+static uint32_t parse_digits;
+static uint64_t parse_value;
+
+
+/*******************************************************************************
+* Function Name: wco_calibration_point
+********************************************************************************
+* Summary:
+*  Returns the i-th oldest reference point.
+*
+*******************************************************************************/
+static wco_calibration_point_t const *wco_calibration_point(uint32_t i)
+{
+    return &points[(point_first + i) % WCO_CALIBRATION_POINTS];
+}
+
+
+/*******************************************************************************
+* Function Name: wco_calibration_error
+********************************************************************************
+* Summary:
+*  Returns the frequency error of the WCO between two reference points, as
+*  a fraction: positive when it counted more ticks than nominal.
+*
+*******************************************************************************/
+static double wco_calibration_error(wco_calibration_point_t const *from,
+                                    wco_calibration_point_t const *to)
+{
+    double nominal = ((double)(to->reference_us - from->reference_us) * CY_SYSCLK_WCO_FREQ) /
+                     WCO_CALIBRATION_US_PER_S;
+
+    return ((double)(to->timebase - from->timebase) / nominal) - 1.0;
+}
+
+
+/*******************************************************************************
+* Function Name: wco_calibration_init
+********************************************************************************
+* Summary:
+*  Discards all reference points. Intervals are not corrected until enough
+*  references have been added.
+*
+*******************************************************************************/
+void wco_calibration_init(void)
+{
+    point_first = 0u;
+    point_count = 0u;
+    memset(&cal_stats, 0, sizeof(cal_stats));
+    parse_active = false;
+}
+
+
+/*******************************************************************************
+* Function Name: wco_calibration_add_reference
+********************************************************************************
+* Summary:
+*  Adds a reference time with the time base value at the same instant, and
+*  updates the correction from the oldest point to this one. The estimate is
+*  in floating point, which is slow on the CPU but only runs once per point;
+*  the correction is kept in fixed point for wco_calibration_correct().
+*
+* Parameters:
+*  reference_us: reference time in microseconds, from any origin
+*  timebase: MCWDT_0 time base value at that time
+*
+* Return:
+*  bool: true if the point was kept
+*
+*******************************************************************************/
+bool wco_calibration_add_reference(uint64_t reference_us, uint64_t timebase)
+{
+    wco_calibration_point_t point = { reference_us, timebase };
+    wco_calibration_point_t const *newest;
+    wco_calibration_point_t const *oldest;
+    double error;
+
+    if (point_count > 0u)
+    {
+        newest = wco_calibration_point(point_count - 1u);
+        if ((reference_us <= newest->reference_us) || (timebase <= newest->timebase))
+        {
+            /* The reference restarted */
+            point_count = 0u;
+            cal_stats.restarts++;
+        }
+        else if ((reference_us - newest->reference_us) <
+                 ((uint64_t)WCO_CALIBRATION_MIN_GAP_S * WCO_CALIBRATION_US_PER_S))
+        {
+            return false;
+        }
+        else
+        {
+            error = wco_calibration_error(newest, &point);
+            if ((error > (WCO_CALIBRATION_MAX_PPM * 1e-6)) ||
+                (error < -(WCO_CALIBRATION_MAX_PPM * 1e-6)))
+            {
+                point_count = 0u;
+                cal_stats.restarts++;
+            }
+        }
+    }
+
+    if (point_count == WCO_CALIBRATION_POINTS)
+    {
+        point_first = (point_first + 1u) % WCO_CALIBRATION_POINTS;
+        point_count--;
+    }
+    points[(point_first + point_count) % WCO_CALIBRATION_POINTS] = point;
+    point_count++;
+    cal_stats.references++;
+
+    oldest = wco_calibration_point(0u);
+    cal_stats.span_s = (uint32_t)((reference_us - oldest->reference_us) / WCO_CALIBRATION_US_PER_S);
+    if (cal_stats.span_s >= WCO_CALIBRATION_MIN_SPAN_S)
+    {
+        /* Nominal ticks are the counted ticks divided by 1 + error */
+        error = wco_calibration_error(oldest, &point);
+        cal_stats.error_ppb = (int32_t)(error * 1e9);
+        cal_stats.correction = (int32_t)(((1.0 / (1.0 + error)) - 1.0) *
+                                         (double)(1UL << WCO_CALIBRATION_FRAC_BITS));
+    }
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: wco_calibration_parse
+********************************************************************************
+* Summary:
+*  Takes one character received on the debug UART. A line T<microseconds>\n
+*  adds a reference point with the time base value latched by the log sink
+*  when the line end arrived. Carriage returns are ignored.
+*
+* Parameters:
+*  c: received character
+*
+* Return:
+*  bool: true if the character belonged to a reference time line
+*
+*******************************************************************************/
+bool wco_calibration_parse(char c)
+{
+    if (WCO_CALIBRATION_SYNC_CHAR == c)
+    {
+        parse_active = true;
+        parse_digits = 0u;
+        parse_value = 0u;
+        return true;
+    }
+    if (!parse_active)
+    {
+        return false;
+    }
+
+    if ((c >= '0') && (c <= '9') && (parse_digits < WCO_CALIBRATION_MAX_DIGITS))
+    {
+        parse_value = (parse_value * 10u) + (uint64_t)(c - '0');
+        parse_digits++;
+    }
+    else if ('\n' == c)
+    {
+        parse_active = false;
+        if (parse_digits > 0u)
+        {
+            (void)wco_calibration_add_reference(parse_value, log_sink_rx_line_time());
+        }
+    }
+    else if ('\r' != c)
+    {
+        /* Not a reference time line after all */
+        parse_active = false;
+        return false;
+    }
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: wco_calibration_correct
+********************************************************************************
+* Summary:
+*  Converts an interval counted by the WCO to the ticks a WCO of exactly
+*  CY_SYSCLK_WCO_FREQ Hz would have counted. One multiply and a shift.
+*  Intervals up to 2^43 ticks (8.5 years) are converted exactly to the
+*  resolution of the correction.
+*
+* Parameters:
+*  ticks: interval in WCO ticks
+*
+* Return:
+*  uint64_t: interval in nominal ticks
+*
+*******************************************************************************/
+uint64_t wco_calibration_correct(uint64_t ticks)
+{
+    int64_t delta = (int64_t)ticks * cal_stats.correction;
+
+    /* Round to nearest; the shift of a negative value is arithmetic */
+    delta = (delta + (1LL << (WCO_CALIBRATION_FRAC_BITS - 1u))) >> WCO_CALIBRATION_FRAC_BITS;
+
+    return (uint64_t)((int64_t)ticks + delta);
+}
+
+
+/*******************************************************************************
+* Function Name: wco_calibration_get_stats
+********************************************************************************
+* Summary:
+*  Returns the current estimate and the number of reference points.
+*
+* Parameters:
+*  stats: receives the statistics
+*
+*******************************************************************************/
+void wco_calibration_get_stats(wco_calibration_stats_t *stats)
+{
+    *stats = cal_stats;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,106 @@
+/******************************************************************************
+* File Name:   wco_calibration.h
+*
+* Description: Interface of the WCO calibration against a reference clock.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WCO_CALIBRATION_H
+#define WCO_CALIBRATION_H
+
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Fraction bits of the correction factor */
+#define WCO_CALIBRATION_FRAC_BITS           (30u)
+
+/* Reference points kept. The estimate is taken from the oldest to the newest,
+ * so it follows changes of the WCO over about this many times the gap. */
+#ifndef WCO_CALIBRATION_POINTS
+#define WCO_CALIBRATION_POINTS              (16u)
+#endif
+
+/* References closer than this to the last one kept are ignored */
+#ifndef WCO_CALIBRATION_MIN_GAP_S
+#define WCO_CALIBRATION_MIN_GAP_S           (30u)
+#endif
+
+/* No correction until the points span this long */
+#ifndef WCO_CALIBRATION_MIN_SPAN_S
+#define WCO_CALIBRATION_MIN_SPAN_S          (60u)
+#endif
+
+/* A reference implying a larger error than this means that the reference
+ * clock jumped, and the points are discarded */
+#define WCO_CALIBRATION_MAX_PPM             (500u)
+
+/* First character of a reference time line on the debug UART:
+ * T<microseconds>\n, sent by the host from a clock better than the WCO */
+#define WCO_CALIBRATION_SYNC_CHAR           ('T')
+
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t references;        /* Reference points accepted                 */
+    uint32_t restarts;          /* Times the points were discarded           */
+    int32_t correction;         /* Correction factor - 1, in 2^-30 units     */
+    int32_t error_ppb;          /* WCO frequency error; positive is fast     */
+    uint32_t span_s;            /* Reference time the estimate is taken over */
+} wco_calibration_stats_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void     wco_calibration_init(void);
+bool     wco_calibration_add_reference(uint64_t reference_us, uint64_t timebase);
+bool     wco_calibration_parse(char c);
+uint64_t wco_calibration_correct(uint64_t ticks);
+void     wco_calibration_get_stats(wco_calibration_stats_t *stats);
+
+
+#endif /* WCO_CALIBRATION_H */
+
+
+/* [] END OF FILE */